@@ -1,6 +1,8 @@
 #include <benchmark/benchmark.h>
 #include <algorithm>
+#include "simpledb/executor.h"
 #include "simpledb/query_runner.h"
+#include "simpledb/storage/buffer_pool_manager.h"
 
 static void Benchmark_InsertSelect(benchmark::State& state) {
     const int numRows = state.range(0);
@@ -55,6 +57,41 @@ BENCHMARK(Benchmark_InsertSelect)
     ->Iterations(3)
     ->ArgNames({"numRows"});
 
+static void Benchmark_MultiRowInsert(benchmark::State& state) {
+    const int numRows = state.range(0);
+    std::filesystem::path test_data_dir = std::filesystem::temp_directory_path() / state.name();
+    setenv("SIMPLE_DB_DATA_DIR", test_data_dir.c_str(), 1);
+    config::init_config();
+    catalog::initialize(test_data_dir);
+
+    command::InsertCommand cmd;
+    cmd.table_name = "benchmark_table";
+    for (int i = 1; i <= numRows; ++i) {
+        cmd.rows.push_back({std::to_string(i), "Name" + std::to_string(i)});
+    }
+
+    double sum_load_time = 0.0;
+    for (auto _ : state) {
+        query_runner::QueryRunner::run_query("create table benchmark_table (id INT, name TEXT);");
+        auto start_load = std::chrono::high_resolution_clock::now();
+        auto result = executor::execute_insert_command(cmd, test_data_dir);
+        benchmark::DoNotOptimize(result);
+        auto end_load = std::chrono::high_resolution_clock::now();
+        sum_load_time += std::chrono::duration_cast<std::chrono::duration<double>>(end_load - start_load).count();
+
+        query_runner::QueryRunner::run_query("drop table benchmark_table;");
+    }
+
+    state.counters["LoadTime_seconds"] = benchmark::Counter(sum_load_time, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(Benchmark_MultiRowInsert)
+    ->ArgsProduct({
+        {10000, 100000, 1000000}  // number of rows
+    })
+    ->Iterations(3)
+    ->ArgNames({"numRows"});
+
 static void Benchmark_SelectWhereClause_1M_Rows(benchmark::State& state) {
     const int rowId = state.range(0);
     std::filesystem::path test_data_dir = std::filesystem::temp_directory_path() / state.name();
@@ -62,12 +99,14 @@ static void Benchmark_SelectWhereClause_1M_Rows(benchmark::State& state) {
     config::init_config();
     catalog::initialize(test_data_dir);
 
-    // Create table and insert rows
+    // Create table and load rows
     query_runner::QueryRunner::run_query("create table benchmark_table (id INT, name TEXT);");
+    command::InsertCommand load_cmd;
+    load_cmd.table_name = "benchmark_table";
     for (int i = 1; i <= 1000000; ++i) {
-        query_runner::QueryRunner::run_query("insert into benchmark_table (id, name) values (" + std::to_string(i) +
-                                             ", 'Name" + std::to_string(i) + "');");
+        load_cmd.rows.push_back({std::to_string(i), "Name" + std::to_string(i)});
     }
+    executor::execute_insert_command(load_cmd, test_data_dir);
 
     // Measure the size of the data file created.
     std::filesystem::path table_file = test_data_dir / "benchmark_table.data";
@@ -76,6 +115,9 @@ static void Benchmark_SelectWhereClause_1M_Rows(benchmark::State& state) {
         state.SetLabel("size = " + std::to_string(file_size) + " bytes");
     }
 
+    simpledb::storage::BufferPoolManager& buffer_pool = simpledb::storage::BufferPoolManager::Instance();
+    buffer_pool.ResetStats();
+
     double sum_select_query_time = 0.0;
     for (auto _ : state) {
         auto start_select = std::chrono::high_resolution_clock::now();
@@ -92,6 +134,11 @@ static void Benchmark_SelectWhereClause_1M_Rows(benchmark::State& state) {
 
     state.counters["SelectQueryTime_seconds"] =
         benchmark::Counter(sum_select_query_time, benchmark::Counter::kAvgIterations);
+    simpledb::storage::BufferPoolStats buffer_pool_stats = buffer_pool.GetStats();
+    state.counters["BufferPoolHits"] =
+        benchmark::Counter(buffer_pool_stats.hits, benchmark::Counter::kAvgIterations);
+    state.counters["BufferPoolMisses"] =
+        benchmark::Counter(buffer_pool_stats.misses, benchmark::Counter::kAvgIterations);
 }
 
 BENCHMARK(Benchmark_SelectWhereClause_1M_Rows)
@@ -5,6 +5,7 @@
 #ifndef SIMPLE_DB_AST_H
 #define SIMPLE_DB_AST_H
 
+#include <cstddef>
 #include <optional>
 #include <string>
 #include <vector>
@@ -19,6 +20,46 @@ namespace ast {
         std::string value;
     };
 
+    enum class AggregateFunction { COUNT, SUM, MIN, MAX, AVG };
+
+    struct SelectItem {
+        // The column, or an empty string for COUNT(*).
+        std::string column_name;
+        // The aggregate function applied to the column, std::nullopt for a plain (GROUP BY) column.
+        std::optional<AggregateFunction> aggregate;
+    };
+
+    /**
+     * @brief The name of a SELECT list item's column in the result, e.g. "dept", "COUNT(*)" or "SUM(salary)".
+     */
+    inline std::string select_item_name(const SelectItem& item) {
+        if (!item.aggregate.has_value()) {
+            return item.column_name;
+        }
+        static const char* const FUNCTION_NAMES[] = {"COUNT", "SUM", "MIN", "MAX", "AVG"};
+        const std::string argument = item.column_name.empty() ? "*" : item.column_name;
+        return std::string(FUNCTION_NAMES[static_cast<int>(item.aggregate.value())]) + "(" + argument + ")";
+    }
+
+    struct OrderByItem {
+        // The column to sort by, or (with GROUP BY) an aggregate function from the SELECT list.
+        SelectItem key;
+        bool descending = false;
+    };
+
+    struct JoinClause {
+        // JOIN table_name ON left_column = right_column, where the columns may be qualified with their table's name.
+        std::string table_name;
+        std::string left_column;
+        std::string right_column;
+    };
+
+    struct LimitClause {
+        // LIMIT limit [OFFSET offset]: skip the first offset rows, then return at most limit rows.
+        size_t limit;
+        size_t offset = 0;
+    };
+
     /**
      * @brief Represents the root node of the Abstract Syntax Tree (AST) for a SELECT query.
      *
@@ -37,12 +78,29 @@ namespace ast {
         // The name of the table specified in the FROM clause.
         std::string table_name;
 
+        // Optional JOIN with a second table. Column names may be qualified with their table's name (e.g. users.id),
+        // which is required for the ones that both tables have.
+        std::optional<JoinClause> join_clause;
+
         // The projection list, representing the columns after the SELECT keyword.
         // An empty vector signifies `SELECT *`.
         std::vector<std::string> projection;
 
         // Optional WHERE clause for filtering results.
         std::optional<WhereClause> where_clause;
+
+        // The SELECT list of a query with aggregate functions or a GROUP BY clause, e.g. SELECT dept, COUNT(*). The
+        // projection is unused for these queries, and this is empty for the other ones.
+        std::vector<SelectItem> select_items;
+
+        // The columns of the GROUP BY clause, if any.
+        std::vector<std::string> group_by;
+
+        // The keys of the ORDER BY clause, if any, most significant first.
+        std::vector<OrderByItem> order_by;
+
+        // Optional LIMIT clause, which caps the number of returned rows.
+        std::optional<LimitClause> limit_clause;
     };
 }  // namespace ast
 
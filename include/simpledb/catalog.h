@@ -5,8 +5,9 @@
 #ifndef SIMPLEDB_CATALOG_H
 #define SIMPLEDB_CATALOG_H
 #include <filesystem>
-#include <optional>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "command.h"
 
@@ -26,11 +27,56 @@ namespace catalog {
      *  2. TableSchema can contain auto-generated names of constraints if the user hasn't supplied them
      *     (for example, UNIQUE constraint)
      */
+    /**
+     * @brief A secondary index on a column of a table, created with CREATE INDEX.
+     * The index itself is a B+ tree or a hash index stored next to the table's data file (see
+     * table_index::index_file_path()).
+     */
+    struct IndexDefinition {
+        std::string index_name;
+        std::string column_name;
+        command::IndexType index_type = command::IndexType::BTREE;
+        // Set for the indexes created for PRIMARY KEY and UNIQUE columns, which reject a row whose value is already
+        // in the index.
+        bool unique = false;
+    };
+    // Indexes created before hash indexes (or constraints) existed have no index_type (or unique), and load with
+    // the defaults.
+    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(IndexDefinition, index_name, column_name, index_type, unique)
+
     struct TableSchema {
         std::string table_name;
         std::vector<command::ColumnDefinition> column_definitions;
+        std::vector<IndexDefinition> indexes = {};
     };
-    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(TableSchema, table_name, column_definitions)
+
+    // Written by hand so that tables without indexes look exactly like they did before indexes existed, and so
+    // that catalogs written back then still load.
+    inline void to_json(nlohmann::json& j, const TableSchema& table_schema) {
+        j = nlohmann::json{{"table_name", table_schema.table_name},
+                           {"column_definitions", table_schema.column_definitions}};
+        if (!table_schema.indexes.empty()) {
+            j["indexes"] = table_schema.indexes;
+        }
+    }
+
+    inline void from_json(const nlohmann::json& j, TableSchema& table_schema) {
+        j.at("table_name").get_to(table_schema.table_name);
+        j.at("column_definitions").get_to(table_schema.column_definitions);
+        table_schema.indexes = j.value("indexes", std::vector<IndexDefinition>{});
+    }
+
+    /**
+     * @brief A snapshot of a table's schema, shared by everyone who looked it up.
+     * Schemas in the catalog are never modified: a change (e.g. CREATE INDEX) replaces the table's schema with a new
+     * one, so a query keeps seeing the schema it started with.
+     */
+    using TableSchemaPtr = std::shared_ptr<const TableSchema>;
+
+    /*
+     * All functions below are thread-safe. Lookups can run concurrently with each other, and only wait for a change
+     * while it is swapped in (not while it is saved to disk).
+     */
 
     /**
      * @brief Initializes the catalog system.
@@ -59,17 +105,24 @@ namespace catalog {
     bool remove_table(const std::string& table_name);
 
     /**
-     * @brief Retrieves the schema for a given table name.
+     * @brief Adds an index to a table's schema, and persists the change to disk.
+     * @return True if the index was added and persisted, false otherwise (e.g. the table doesn't exist, or it
+     *         already has an index with the same name).
+     */
+    bool add_index(const std::string& table_name, const IndexDefinition& index_definition);
+
+    /**
+     * @brief Retrieves the schema for a given table name, without copying it.
      * @param table_name The name of the table.
-     * @return An optional containing the TableSchema (if found).
+     * @return The table's current schema, or nullptr if there is no such table.
      */
-    std::optional<TableSchema> get_table_schema(const std::string& table_name);
+    TableSchemaPtr get_table_schema(const std::string& table_name);
 
     /**
      * @brief Retrieves all table schemas currently in the catalog.
      * Useful for listing tables or internal operations.
-     * @return A vector of TableSchema objects representing all tables in the catalog.
+     * @return The schemas of all tables in the catalog, in the order the tables were created.
      */
-    const std::vector<TableSchema>& get_all_schemas();
+    std::vector<TableSchemaPtr> get_all_schemas();
 }  // namespace catalog
 #endif  // SIMPLEDB_CATALOG_H
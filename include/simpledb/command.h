@@ -13,11 +13,34 @@ namespace command {
     NLOHMANN_JSON_SERIALIZE_ENUM(Datatype,
                                  {{Datatype::INT, "INT"}, {Datatype::TEXT, "TEXT"}, {Datatype::UNKNOWN, "UNKNOWN"}})
 
+    // A constraint declared on a column in CREATE TABLE. Both PRIMARY KEY and UNIQUE mean that no two rows have the
+    // same value in the column, and a table has at most one PRIMARY KEY.
+    enum class ColumnConstraint { NONE, PRIMARY_KEY, UNIQUE };
+    NLOHMANN_JSON_SERIALIZE_ENUM(ColumnConstraint,
+                                 {{ColumnConstraint::NONE, "NONE"},
+                                  {ColumnConstraint::PRIMARY_KEY, "PRIMARY KEY"},
+                                  {ColumnConstraint::UNIQUE, "UNIQUE"}})
+
     struct ColumnDefinition {
         std::string column_name;
         Datatype type = Datatype::UNKNOWN;
+        ColumnConstraint constraint = ColumnConstraint::NONE;
     };
-    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(ColumnDefinition, column_name, type)
+
+    // Written by hand so that columns without a constraint look exactly like they did before constraints existed,
+    // and so that catalogs written back then still load.
+    inline void to_json(nlohmann::json& j, const ColumnDefinition& column_definition) {
+        j = nlohmann::json{{"column_name", column_definition.column_name}, {"type", column_definition.type}};
+        if (column_definition.constraint != ColumnConstraint::NONE) {
+            j["constraint"] = column_definition.constraint;
+        }
+    }
+
+    inline void from_json(const nlohmann::json& j, ColumnDefinition& column_definition) {
+        j.at("column_name").get_to(column_definition.column_name);
+        j.at("type").get_to(column_definition.type);
+        column_definition.constraint = j.value("constraint", ColumnConstraint::NONE);
+    }
 
     struct CreateTableCommand {
         std::string table_name;
@@ -28,10 +51,34 @@ namespace command {
         std::string table_name;
     };
 
+    // BTREE indexes answer equality and range comparisons, HASH indexes only equality, but with fewer page reads.
+    enum class IndexType { BTREE, HASH };
+    NLOHMANN_JSON_SERIALIZE_ENUM(IndexType, {{IndexType::BTREE, "BTREE"}, {IndexType::HASH, "HASH"}})
+
+    /**
+     * CREATE INDEX index_name ON table_name [USING BTREE | HASH] (column_name): builds a secondary index on a
+     * column of a table.
+     */
+    struct CreateIndexCommand {
+        std::string index_name;
+        std::string table_name;
+        std::string column_name;
+        IndexType index_type = IndexType::BTREE;
+    };
+
     struct InsertCommand {
         std::string table_name;
         std::vector<std::string> columns;  // This would be empty if the user does not specify columns.
-        std::vector<std::string> values;
+        std::vector<std::vector<std::string>> rows;  // One entry per VALUES tuple, in the order they were written.
+    };
+
+    /**
+     * COPY table_name FROM 'file.csv' [WITH HEADER]: loads the rows of a CSV file into a table.
+     */
+    struct CopyCommand {
+        std::string table_name;
+        std::string file_path;
+        bool header = false;  // True if the first line of the file holds column names rather than a row.
     };
 
     struct ShowTablesCommand {};
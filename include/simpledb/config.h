@@ -4,14 +4,22 @@
 
 #ifndef SIMPLEDB_CONFIG_H
 #define SIMPLEDB_CONFIG_H
+#include <cstddef>
 #include <ostream>
 #include <filesystem>
 
 namespace config {
+    // The default work_mem: 64 MiB.
+    constexpr size_t DEFAULT_WORK_MEM = 64 * 1024 * 1024;
 
     struct Config {
         std::filesystem::path data_dir;
         std::filesystem::path history_file;
+        // How much memory (in bytes) an operator that holds on to its input, like a hash aggregation or a sort, may use
+        // before it spills to temporary files.
+        size_t work_mem = DEFAULT_WORK_MEM;
+        // The number of worker threads that run the tasks of queries (e.g. parallel scans), 0 for one per core.
+        size_t num_threads = 0;
 
         friend std::ostream &operator<<(std::ostream &os, const Config &obj);
     };
@@ -0,0 +1,73 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#ifndef SIMPLE_DB_CSV_H
+#define SIMPLE_DB_CSV_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * A small CSV parser, used to bulk load tables.
+ *
+ * Fields are separated by commas, and records by \n (or \r\n). A field may be enclosed in double quotes, in which
+ * case it may contain commas, and a double quote inside it is escaped by doubling it ("say ""hi""").
+ *
+ * Unlike full RFC 4180, a quoted field can't contain a line break. This is what lets a file be split into chunks at
+ * any newline, and the chunks be parsed independently of each other.
+ */
+namespace csv {
+
+    /**
+     * @brief Splits CSV data into chunks that can be parsed independently.
+     *
+     * Each chunk is roughly target_size bytes long, and ends right after a newline (except possibly the last one),
+     * so a record never straddles two chunks.
+     *
+     * @param data The CSV data.
+     * @param target_size The minimum size of a chunk (except for the last one), in bytes.
+     * @return Views into data, in order, covering all of it.
+     */
+    std::vector<std::string_view> split_into_chunks(std::string_view data, size_t target_size);
+
+    /**
+     * @brief Reads CSV records out of a buffer, one at a time.
+     *
+     * Empty lines are skipped. The reader doesn't copy the buffer, so the buffer must outlive it.
+     */
+    class Reader {
+       public:
+        explicit Reader(std::string_view data) : data_(data) {}
+
+        /**
+         * Reads the next record.
+         * @param fields Output parameter, filled with the record's fields. The strings already in it are reused,
+         *               so passing the same vector for every record avoids most allocations.
+         * @return False once there are no records left.
+         * @throws std::runtime_error if the record is malformed (e.g. an unterminated quoted field), in which case
+         *         line_number() tells which line it is on.
+         */
+        bool next_record(std::vector<std::string>& fields);
+
+        /**
+         * @brief The (1-based) line of the buffer that the last record was read from.
+         */
+        size_t line_number() const { return line_number_; }
+
+       private:
+        std::string_view data_;
+
+        // Position of the next character to read.
+        size_t pos_ = 0;
+
+        // Number of line breaks consumed so far.
+        size_t newlines_seen_ = 0;
+
+        size_t line_number_ = 0;
+    };
+}  // namespace csv
+
+#endif  // SIMPLE_DB_CSV_H
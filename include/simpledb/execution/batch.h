@@ -0,0 +1,125 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#ifndef SIMPLE_DB_BATCH_H
+#define SIMPLE_DB_BATCH_H
+
+#include "simpledb/command.h"
+#include "simpledb/execution/row.h"
+#include "simpledb/serializer.h"
+#include "simpledb/storage/page.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace simpledb::execution {
+
+    /**
+     * @brief The maximum number of rows in a Batch.
+     */
+    constexpr size_t BATCH_CAPACITY = 1024;
+
+    /**
+     * @brief The values of one column for all rows of a Batch.
+     *
+     * INT values are stored as int32_t in `ints`, TEXT values in `texts`: only the vector matching `type` is used.
+     * The vectors are sized to BATCH_CAPACITY once and reused by every batch that goes through them, so filling a
+     * batch doesn't allocate (beyond growing the TEXT strings).
+     */
+    struct ColumnVector {
+        command::Datatype type = command::Datatype::TEXT;
+        std::vector<int32_t> ints;
+        std::vector<std::string> texts;
+        // 1 if the row's value is NULL.
+        std::vector<uint8_t> nulls;
+
+        /**
+         * @brief Writes a row's value in the text form used by row::Row (NULL as an empty string).
+         */
+        void value_as_text(size_t row, std::string& value) const;
+    };
+
+    /**
+     * @brief A fixed-capacity batch of rows, stored column by column, that operators pass to each other.
+     *
+     * The batch holds size() rows, but only the ones in the selection vector are part of the result: filtering a
+     * batch just narrows down its selection, instead of moving values around. Without a selection vector, all rows
+     * are selected.
+     *
+     * Like a row, a batch holds the columns described by the signature of the operator that produced it.
+     */
+    class Batch {
+       public:
+        /**
+         * @brief Empties the batch (no rows, no selection) and sets up one column per given type.
+         */
+        void reset(const std::vector<command::Datatype>& column_types);
+
+        size_t num_columns() const { return columns_.size(); }
+
+        ColumnVector& column(size_t column) { return columns_[column]; }
+
+        const ColumnVector& column(size_t column) const { return columns_[column]; }
+
+        /**
+         * @brief The number of rows in the batch, selected or not.
+         */
+        size_t size() const { return size_; }
+
+        void set_size(size_t size) { size_ = size; }
+
+        bool has_selection() const { return has_selection_; }
+
+        /**
+         * @brief The number of selected rows.
+         */
+        size_t num_selected() const { return has_selection_ ? selection_.size() : size_; }
+
+        /**
+         * @brief The index of the i-th selected row.
+         */
+        size_t selected(size_t i) const { return has_selection_ ? selection_[i] : i; }
+
+        /**
+         * @brief Replaces the selection vector, which must only hold indices of rows that are currently selected.
+         *
+         * The vectors are swapped, so the given vector gets the old selection's buffer back and both buffers keep
+         * being reused.
+         */
+        void set_selection(std::vector<uint16_t>& selection);
+
+        /**
+         * @brief Makes this batch hold some columns of another batch, in the given order (columns may repeat).
+         *
+         * Columns are swapped out of the source batch rather than copied (except for repeated ones), so the
+         * source batch must be reset before it is filled again.
+         */
+        void project(Batch& source, const std::vector<int>& columns);
+
+        /**
+         * @brief Writes a row of the batch in row::Row form.
+         */
+        void get_row(size_t row, row::Row& values) const;
+
+       private:
+        std::vector<ColumnVector> columns_;
+        size_t size_ = 0;
+        bool has_selection_ = false;
+        std::vector<uint16_t> selection_;
+    };
+
+    /**
+     * @brief Reads a column of a record into a row of a column vector, INT values stay in their binary form.
+     * @param column_index The index of the column in the record's layout.
+     */
+    void read_record_column(const serializer::RecordLayout& layout,
+                            storage::RecordView record,
+                            size_t column_index,
+                            ColumnVector& column,
+                            size_t row);
+}  // namespace simpledb::execution
+
+#endif  // SIMPLE_DB_BATCH_H
@@ -0,0 +1,71 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#ifndef SIMPLE_DB_FILTER_KERNELS_H
+#define SIMPLE_DB_FILTER_KERNELS_H
+
+#include "simpledb/ast/ast.h"
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Filter kernels: tight loops that compare an array of ints against a constant, for each comparison operator.
+ *
+ * Every kernel exists for several instruction sets (SSE4.2 and AVX2 on x86, and plain scalar code everywhere),
+ * and the best one that the CPU supports is picked at runtime. The SIMD kernels compare 4 to 8 values per
+ * instruction, which is what lets the FilterOperator get through a batch of 1024 INT values in a few hundred
+ * instructions.
+ */
+namespace simpledb::execution::kernels {
+
+    enum class InstructionSet { SCALAR, SSE4_2, AVX2 };
+
+    /**
+     * @brief Writes the index of every value that satisfies "value op constant" to `selection`, in order.
+     *
+     * `selection` must have room for `count` indices (the kernels may write past the returned count), and `count`
+     * must be at most 65536 so that indices fit.
+     * @return The number of selected values.
+     */
+    template <typename T>
+    using SelectKernel = size_t (*)(const T* values, size_t count, T constant, uint16_t* selection);
+
+    /**
+     * @brief Sets bit i of `bitmap` (bit i % 64 of word i / 64) if values[i] satisfies "value op constant", and
+     * clears it otherwise. `bitmap` must have room for (count + 63) / 64 words.
+     */
+    template <typename T>
+    using BitmapKernel = void (*)(const T* values, size_t count, T constant, uint64_t* bitmap);
+
+    constexpr size_t NUM_COMPARISON_OPS = 6;
+
+    /**
+     * @brief The kernels of one instruction set, indexed by ast::ComparisonOp.
+     */
+    struct FilterKernels {
+        InstructionSet instruction_set;
+        SelectKernel<int32_t> select_int32[NUM_COMPARISON_OPS];
+        SelectKernel<int64_t> select_int64[NUM_COMPARISON_OPS];
+        BitmapKernel<int32_t> bitmap_int32[NUM_COMPARISON_OPS];
+        BitmapKernel<int64_t> bitmap_int64[NUM_COMPARISON_OPS];
+    };
+
+    /**
+     * @brief The best instruction set supported by the CPU we're running on, detected once.
+     */
+    InstructionSet detect_instruction_set();
+
+    /**
+     * @brief The kernels for the best instruction set supported by the CPU.
+     */
+    const FilterKernels& get_filter_kernels();
+
+    /**
+     * @brief The kernels for the given instruction set, or for the best one below it if the CPU doesn't support it.
+     */
+    const FilterKernels& get_filter_kernels(InstructionSet instruction_set);
+}  // namespace simpledb::execution::kernels
+
+#endif  // SIMPLE_DB_FILTER_KERNELS_H
@@ -7,6 +7,7 @@
 
 #include <optional>
 #include "simpledb/execution/operator.h"
+#include "simpledb/execution/predicate.h"
 #include "simpledb/execution/row.h"
 #include "simpledb/storage/table_heap.h"
 #include "simpledb/ast/ast.h"
@@ -16,16 +17,18 @@
 #include <vector>
 
 namespace simpledb::execution {
-    class FilterOperator : public Operator {
+    class FilterOperator : public BatchOperator {
        public:
         explicit FilterOperator(std::string table_name,
                                 std::unique_ptr<simpledb::execution::Operator> child,
                                 ast::WhereClause where_clause);
 
-        // The next method retrieves the next row from the child operator
-        // and evaluates the WHERE clause on it. If the row satisfies the
-        // condition, it is returned; otherwise, the next row is fetched.
-        std::optional<row::Row> next() override;
+        // Retrieves the next batch from the child operator and evaluates the WHERE clause on its selected rows,
+        // narrowing down the batch's selection to the rows that satisfy it. Batches where no row satisfies it are
+        // skipped.
+        bool next_batch(Batch& batch) override;
+
+        std::optional<row::Signature> signature() const override;
 
        private:
         // The name of the table from which we are filtering columns.
@@ -38,8 +41,11 @@ namespace simpledb::execution {
         // The WHERE clause to evaluate on each row.
         ast::WhereClause where_clause_;
 
-        // The index of the column in the table schema that corresponds to the WHERE clause column.
-        int where_column_index_;
+        // The WHERE clause, compiled for the type of its column and its comparison operator.
+        CompiledPredicate predicate_;
+
+        // Buffer for the selection vectors computed by the predicate, swapped with the batches' ones.
+        std::vector<uint16_t> selection_;
     };
 }  // namespace simpledb::execution
 
@@ -0,0 +1,192 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#ifndef SIMPLE_DB_HASH_AGGREGATE_OPERATOR_H
+#define SIMPLE_DB_HASH_AGGREGATE_OPERATOR_H
+
+#include "simpledb/ast/ast.h"
+#include "simpledb/catalog.h"
+#include "simpledb/command.h"
+#include "simpledb/execution/operator.h"
+#include "simpledb/execution/row.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace simpledb::execution {
+    /**
+     * @brief Computes aggregate functions (COUNT, SUM, MIN, MAX, AVG) over its child's rows, per group of rows with
+     * the same values in the GROUP BY columns (or over all rows, without GROUP BY).
+     *
+     * The groups live in an open addressing hash table (linear probing), keyed by the GROUP BY values encoded as
+     * bytes. Each group has one accumulator per aggregate function, which is updated a batch at a time: the group of
+     * each row of the batch is looked up first, then each aggregate function runs a loop over the batch that is
+     * specialized for the function and the type of its column.
+     *
+     * All the aggregate functions can be computed from partial results, so when the table grows past the memory
+     * budget, its groups (with their partial accumulators) are written to one of NUM_SPILL_PARTITIONS temporary files
+     * based on the hash of their key, and the table starts over empty. Once the child is exhausted, the partitions
+     * are read back one at a time, merging the partial results of each group. A partition that still doesn't fit is
+     * split again with the next bits of the hash.
+     *
+     * The rows it returns hold the SELECT list items in order, as TEXT (NULL for the SUM, MIN, MAX or AVG of no
+     * values). They don't map to table columns, so the operator has no signature, and must be at the top of a plan.
+     */
+    class HashAggregateOperator : public BatchOperator {
+       public:
+        static constexpr size_t NUM_SPILL_PARTITIONS = 16;
+
+        /**
+         * @param select_items The SELECT list: each item is either a GROUP BY column, or an aggregate function.
+         * @param group_by The GROUP BY columns.
+         * @param memory_budget How many bytes the hash table may take before it spills to files.
+         * @param spill_dir Where to put the spill files, created when needed.
+         * @throws std::runtime_error if a column doesn't exist, a plain column isn't in the GROUP BY clause, or SUM or
+         *         AVG is applied to a TEXT column.
+         */
+        HashAggregateOperator(const std::string& table_name,
+                              std::unique_ptr<Operator> child,
+                              std::vector<ast::SelectItem> select_items,
+                              const std::vector<std::string>& group_by,
+                              size_t memory_budget,
+                              std::filesystem::path spill_dir);
+
+        // Aggregates rows that don't come from a table of the catalog, e.g. the joined rows of two tables.
+        HashAggregateOperator(const catalog::TableSchema& table_schema,
+                              std::unique_ptr<Operator> child,
+                              std::vector<ast::SelectItem> select_items,
+                              const std::vector<std::string>& group_by,
+                              size_t memory_budget,
+                              std::filesystem::path spill_dir);
+
+        // Removes the spill files that are left, if the operator wasn't read to the end.
+        ~HashAggregateOperator() override;
+
+        bool next_batch(Batch& batch) override;
+
+        /**
+         * @brief The number of (non-empty) partitions that were written to files so far, 0 if everything fit in
+         * memory.
+         */
+        size_t num_spilled_partitions() const { return num_spilled_partitions_; }
+
+       private:
+        // The state of one aggregate function for one group.
+        struct Accumulator {
+            // Rows counted by COUNT(*), non-NULL values seen by the other functions.
+            int64_t count = 0;
+            // SUM and AVG: the sum of the values. MIN and MAX of an INT column: the smallest/largest value so far.
+            int64_t int_value = 0;
+            // MIN and MAX of a TEXT column: the smallest/largest value so far.
+            std::string text_value;
+        };
+
+        struct Aggregate {
+            ast::AggregateFunction function;
+            // The position of the column in the child's rows, std::nullopt for COUNT(*).
+            std::optional<size_t> column;
+            command::Datatype type;
+        };
+
+        // A column of the GROUP BY clause.
+        struct GroupColumn {
+            // The position of the column in the child's rows.
+            size_t column;
+            command::Datatype type;
+        };
+
+        // Where a column of the output comes from: a GROUP BY column, or an aggregate function.
+        struct OutputColumn {
+            bool is_group_column;
+            size_t index;
+        };
+
+        // A spill file, holding the partial results of some groups. Its groups have the same first depth + 1 groups
+        // of hash bits.
+        struct SpillPartition {
+            std::filesystem::path path;
+            size_t depth;
+        };
+
+        // The files the groups of the hash table are being spilled to, opened on the first spill.
+        struct SpillWriter {
+            size_t depth = 0;
+            std::vector<std::filesystem::path> paths;
+            std::vector<std::ofstream> files;
+            // The number of groups written to each file, so that empty partitions aren't read back.
+            std::vector<size_t> num_groups;
+        };
+
+        // Reads all of the child's rows into the hash table, spilling it as needed.
+        void build();
+
+        // Looks up (or adds) the group of each selected row of the batch, then updates their accumulators.
+        void add_batch(const Batch& batch);
+
+        // Returns the index of the group with the given key, adding it if needed.
+        uint32_t find_or_add_group(std::string_view key, uint64_t hash);
+
+        // Removes all groups from the hash table.
+        void clear_groups();
+
+        // Writes all groups of the hash table to the writer's partitions, then clears the table.
+        void spill_groups(SpillWriter& writer);
+
+        // Closes the writer's files, and queues up its non-empty partitions to be read back.
+        void finish_spill(SpillWriter& writer);
+
+        // Replaces the hash table's groups with the ones of the next spilled partition that has any. Returns false
+        // once there are no partitions left.
+        bool load_next_partition();
+
+        // Writes the output row for a group into the given row of the batch.
+        void output_group(uint32_t group, Batch& batch, size_t row) const;
+
+        Accumulator& accumulator(uint32_t group, size_t aggregate) {
+            return accumulators_[group * aggregates_.size() + aggregate];
+        }
+
+        std::unique_ptr<Operator> child_;
+        std::vector<ast::SelectItem> select_items_;
+        std::vector<GroupColumn> group_columns_;
+        std::vector<Aggregate> aggregates_;
+        std::vector<OutputColumn> output_columns_;
+        std::vector<command::Datatype> output_types_;
+
+        size_t memory_budget_;
+        std::filesystem::path spill_dir_;
+
+        // The hash table: slots hold a group's index + 1 (0 for an empty slot). The number of slots is a power of 2.
+        std::vector<uint32_t> slots_;
+        // Per group: the hash of its key, its key, and (in accumulators_) one accumulator per aggregate function.
+        std::vector<uint64_t> group_hashes_;
+        std::vector<std::string> group_keys_;
+        std::vector<Accumulator> accumulators_;
+        // An estimate of the memory taken by the groups, compared to the memory budget.
+        size_t memory_usage_ = 0;
+
+        // Set once the child's rows are all read.
+        bool built_ = false;
+        // The next group of the hash table to output.
+        uint32_t next_group_ = 0;
+
+        // The spilled partitions that are still to be read back, and every spill file created (to clean up).
+        std::vector<SpillPartition> pending_partitions_;
+        std::vector<std::filesystem::path> spill_files_;
+        size_t num_spilled_partitions_ = 0;
+
+        // Buffers reused for each batch: the group of each selected row, and the key being built.
+        std::vector<uint32_t> row_groups_;
+        std::string key_;
+    };
+}  // namespace simpledb::execution
+
+#endif  // SIMPLE_DB_HASH_AGGREGATE_OPERATOR_H
@@ -0,0 +1,192 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#ifndef SIMPLE_DB_HASH_JOIN_OPERATOR_H
+#define SIMPLE_DB_HASH_JOIN_OPERATOR_H
+
+#include "simpledb/command.h"
+#include "simpledb/execution/operator.h"
+#include "simpledb/execution/row.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace simpledb::execution {
+    /**
+     * @brief One of the two inputs of a join.
+     */
+    struct JoinInput {
+        std::unique_ptr<Operator> op;
+        // The position of the join key in the input's rows.
+        size_t key_column;
+        // The number of columns of the input's table (see HashJoinOperator::signature()).
+        size_t num_table_columns;
+    };
+
+    /**
+     * @brief Implements an inner equi-join, e.g. FROM a JOIN b ON a.x = b.y, with a hash table.
+     *
+     * All rows of one input (the build side, preferably the smaller one) go into a hash table on their join key.
+     * The rows of the other input (the probe side) are then streamed through it, a probe row being returned once per
+     * build row with the same key. Rows with a NULL key don't match anything.
+     *
+     * When the build side doesn't fit in the memory budget, it becomes a grace hash join: both inputs are split into
+     * NUM_SPILL_PARTITIONS temporary files based on the hash of their keys, so that matching rows end up in matching
+     * partitions, which are then joined one pair at a time. A build partition that still doesn't fit is split again
+     * with the next bits of the hash, along with its probe partition.
+     *
+     * The rows it returns hold the columns of the left input's rows followed by the right input's, as TEXT.
+     */
+    class HashJoinOperator : public BatchOperator {
+       public:
+        static constexpr size_t NUM_SPILL_PARTITIONS = 16;
+
+        enum class BuildSide { LEFT, RIGHT };
+
+        /**
+         * @param key_type The type of the join key, which must be the same on both sides.
+         * @param build_side The input to build the hash table on.
+         * @param memory_budget How many bytes the hash table may take before the inputs are partitioned to files.
+         * @param spill_dir Where to put the partitions, created when needed.
+         */
+        HashJoinOperator(JoinInput left,
+                         JoinInput right,
+                         command::Datatype key_type,
+                         BuildSide build_side,
+                         size_t memory_budget,
+                         std::filesystem::path spill_dir);
+
+        // Removes the partitions that are left, if the operator wasn't read to the end.
+        ~HashJoinOperator() override;
+
+        bool next_batch(Batch& batch) override;
+
+        /**
+         * @brief Describes the rows in terms of the joined table, whose columns are the left table's followed by the
+         * right table's: the right input's columns are shifted by the number of columns of the left table.
+         */
+        std::optional<row::Signature> signature() const override { return signature_; }
+
+        /**
+         * @brief The number of (non-empty) pairs of partitions that were written to files so far, 0 if the build side
+         * fit in memory.
+         */
+        size_t num_spilled_partitions() const { return num_spilled_partitions_; }
+
+       private:
+        // A row of the build side in the hash table.
+        struct BuildEntry {
+            row::Row row;
+            std::string key;
+            uint64_t hash;
+            // The index + 1 of the next entry in the same bucket, 0 at the end of the chain.
+            uint32_t next;
+        };
+
+        // The pair of files holding the rows of both sides whose hash have the same first depth + 1 groups of bits.
+        struct SpillPartition {
+            std::filesystem::path build_path;
+            std::filesystem::path probe_path;
+            size_t depth;
+        };
+
+        // The files the rows of one side are being partitioned to.
+        struct SpillWriter {
+            size_t depth = 0;
+            std::vector<std::filesystem::path> paths;
+            std::vector<std::ofstream> files;
+            // The number of rows written to each file, so that partitions without matches are skipped.
+            std::vector<size_t> num_rows;
+        };
+
+        // Reads the build side into the hash table, partitioning both sides if it doesn't fit.
+        void build();
+
+        // Adds a row to the hash table.
+        void insert_entry(row::Row row, std::string key, uint64_t hash);
+
+        // Removes all rows from the hash table.
+        void clear_table();
+
+        // Reads the join key of a row of a batch, false if it is NULL.
+        bool read_key(const Batch& batch, size_t row, size_t key_column, std::string& key) const;
+
+        // Creates the files of a writer.
+        void open_partitions(SpillWriter& writer, size_t depth);
+
+        // Writes a row to its partition.
+        void write_partitioned(SpillWriter& writer, const std::string& key, uint64_t hash, const row::Row& row);
+
+        // Moves the rows of the hash table to the writer's partitions.
+        void spill_table(SpillWriter& writer);
+
+        // Writes all (non-NULL key) rows of an input to the writer's partitions, then releases the input.
+        void partition_input(std::unique_ptr<Operator>& input, size_t key_column, SpillWriter& writer);
+
+        // Closes the files of both sides, and queues up the pairs of partitions that can have matches.
+        void finish_partitions(SpillWriter& build_writer, SpillWriter& probe_writer);
+
+        // Loads the next pair of partitions: its build rows into the hash table, and opens its probe rows. Returns
+        // false once there are no partitions left.
+        bool load_next_partition();
+
+        // Moves on to the next probe row (and its key), false once the probe side (or partition) is exhausted.
+        bool next_probe_row();
+
+        // Writes the joined row of the current probe row and a build row into the given row of the batch.
+        void output_row(Batch& batch, size_t row, const row::Row& build_row);
+
+        std::unique_ptr<Operator> build_child_;
+        std::unique_ptr<Operator> probe_child_;
+        size_t build_key_column_;
+        size_t probe_key_column_;
+        command::Datatype key_type_;
+        BuildSide build_side_;
+        std::optional<row::Signature> signature_;
+        std::vector<command::Datatype> output_types_;
+        size_t num_left_columns_ = 0;
+
+        size_t memory_budget_;
+        std::filesystem::path spill_dir_;
+
+        // The hash table: the entries are chained per bucket, buckets hold the index + 1 of the chain's first entry.
+        // The number of buckets is a power of 2.
+        std::vector<uint32_t> buckets_;
+        std::vector<BuildEntry> entries_;
+        // An estimate of the memory taken by the entries, compared to the memory budget.
+        size_t memory_usage_ = 0;
+
+        bool built_ = false;
+        // Whether the inputs were partitioned to files, which are then joined one pair at a time.
+        bool spilled_ = false;
+
+        // The current probe row: its key and the hash of it, and the next entry of its bucket to look at (index + 1).
+        // Rows read from a batch are only converted to a row::Row once they match.
+        std::string probe_key_;
+        uint64_t probe_hash_ = 0;
+        uint32_t next_match_ = 0;
+        row::Row probe_row_;
+        bool probe_row_ready_ = false;
+        // The batch of the probe side being read, and the position of its next selected row.
+        Batch probe_batch_;
+        size_t probe_position_ = 0;
+        size_t probe_batch_row_ = 0;
+        // The probe rows of the partition being joined.
+        std::ifstream probe_file_;
+        std::filesystem::path probe_path_;
+
+        // The pairs of partitions that are still to be joined, and every spill file created (to clean up).
+        std::vector<SpillPartition> pending_partitions_;
+        std::vector<std::filesystem::path> spill_files_;
+        size_t num_spilled_partitions_ = 0;
+    };
+}  // namespace simpledb::execution
+
+#endif  // SIMPLE_DB_HASH_JOIN_OPERATOR_H
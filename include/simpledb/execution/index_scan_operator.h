@@ -0,0 +1,118 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#ifndef SIMPLE_DB_INDEX_SCAN_OPERATOR_H
+#define SIMPLE_DB_INDEX_SCAN_OPERATOR_H
+
+#include "simpledb/catalog.h"
+#include "simpledb/execution/operator.h"
+#include "simpledb/execution/predicate.h"
+#include "simpledb/execution/row.h"
+#include "simpledb/serializer.h"
+#include "simpledb/storage/b_plus_tree.h"
+#include "simpledb/storage/table_heap.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace simpledb::execution {
+    /**
+     * @brief Returns the rows of a table that satisfy a predicate, finding them through an index on the predicate's
+     * column instead of scanning the whole table.
+     *
+     * With a B+ tree index, the predicate's operator and constant give a range of keys (a single key for EQUALS,
+     * everything below or above the constant for the other operators). The scan seeks to the start of the range in
+     * the tree, walks its leaves until the end of the range, and fetches each record it points to with
+     * TableHeap::GetRecord(). Finding the start of the range reads one page per level of the tree, and every
+     * matching record costs one more page read, so a selective predicate reads a handful of pages however large
+     * the table is.
+     *
+     * A hash index can only answer EQUALS: the scan looks the constant up when it is created (two page reads), and
+     * then fetches the matching records in the order they are stored in the table.
+     *
+     * Index keys can be lossy (see table_index), so the predicate is checked again on every fetched record.
+     * NOT_EQUALS can't be answered with a range, so the planner never uses an index for it.
+     *
+     * Like the TableScanOperator, it can be asked to deserialize only some columns.
+     */
+    class IndexScanOperator : public BatchOperator {
+       public:
+        /**
+         * @param index The index to use. It must be on the predicate's column.
+         * @param predicate The predicate that the returned rows satisfy.
+         * @param columns The indices of the columns to return (all columns, in schema order, if not given).
+         * @param at_most_one_match Whether the predicate matches at most one row, e.g. an equality on a PRIMARY KEY
+         *                          column. The scan then stops as soon as it found a row, instead of fetching
+         *                          every other record the index points to (with lossy keys, there can be many).
+         * @throws std::runtime_error if the predicate can't be answered with the index.
+         */
+        explicit IndexScanOperator(const std::string& table_name,
+                                   const std::filesystem::path& data_dir,
+                                   const catalog::IndexDefinition& index,
+                                   CompiledPredicate predicate,
+                                   std::optional<row::Signature> columns = std::nullopt,
+                                   bool at_most_one_match = false);
+
+        bool next_batch(Batch& batch) override;
+
+        std::optional<row::Signature> signature() const override { return columns_; }
+
+        // Stops the scan once it returned max_rows rows, so that it reads no pages past them.
+        void set_row_limit(size_t max_rows) override { rows_left_ = std::min(rows_left_, max_rows); }
+
+        /**
+         * @brief Whether an index can find the rows that satisfy a predicate with the given operator.
+         */
+        static bool can_use_index(const catalog::IndexDefinition& index, ast::ComparisonOp op) {
+            if (index.index_type == command::IndexType::HASH) {
+                return op == ast::ComparisonOp::EQUALS;
+            }
+            return op != ast::ComparisonOp::NOT_EQUALS;
+        }
+
+       private:
+        // Moves to the next record the index points to, returning false once there are no more.
+        bool next_record_id(storage::RecordId& record_id);
+
+        storage::TableHeap table_heap_;
+
+        serializer::RecordLayout layout_;
+
+        CompiledPredicate predicate_;
+
+        // For a B+ tree index: the tree, and the last key of the range (std::nullopt if the range goes to the end
+        // of the index).
+        std::unique_ptr<storage::BPlusTree> tree_;
+        std::optional<std::string> upper_key_;
+
+        // Positioned in the tree at the next entry to look at.
+        std::optional<storage::BPlusTree::Iterator> iterator_;
+
+        // For a hash index: the ids of the records with the predicate's key, and the position of the next one.
+        std::vector<storage::RecordId> record_ids_;
+        size_t next_record_ = 0;
+
+        bool at_most_one_match_;
+
+        // Set once the end of the range is reached (or the only match was found).
+        bool done_ = false;
+
+        // How many more rows the scan may return, see set_row_limit().
+        size_t rows_left_ = std::numeric_limits<size_t>::max();
+
+        std::optional<row::Signature> columns_;
+        row::Signature output_columns_;
+        std::vector<command::Datatype> output_types_;
+
+        // The record being looked at, reused for every fetch.
+        std::vector<char> record_data_;
+    };
+}  // namespace simpledb::execution
+
+#endif  // SIMPLE_DB_INDEX_SCAN_OPERATOR_H
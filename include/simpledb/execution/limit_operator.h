@@ -0,0 +1,57 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#ifndef SIMPLE_DB_LIMIT_OPERATOR_H
+#define SIMPLE_DB_LIMIT_OPERATOR_H
+
+#include "simpledb/execution/operator.h"
+#include "simpledb/execution/row.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace simpledb::execution {
+    /**
+     * @brief Implements LIMIT limit OFFSET offset: skips the first offset rows of its child, then returns at most
+     * limit rows.
+     *
+     * It stops pulling from its child as soon as it returned limit rows. Pulling alone would still let the child
+     * read ahead a whole batch, so the operator also tells its child, with set_row_limit(), that it needs no more
+     * than offset + limit rows: that reaches the scan (through the operators that return their child's rows one for
+     * one), which then stops reading pages once it returned them. Once the limit is reached, the child is destroyed,
+     * which releases the pages and files it held on to.
+     */
+    class LimitOperator : public BatchOperator {
+       public:
+        LimitOperator(std::unique_ptr<Operator> child, size_t limit, size_t offset = 0);
+
+        bool next_batch(Batch& batch) override;
+
+        std::optional<row::Signature> signature() const override { return signature_; }
+
+        void set_row_limit(size_t max_rows) override;
+
+       private:
+        // Tells the child how many more rows it has to return at most.
+        void limit_child();
+
+        // nullptr once the limit is reached or the child is exhausted.
+        std::unique_ptr<Operator> child_;
+
+        // The child's signature, kept for after the child is destroyed.
+        std::optional<row::Signature> signature_;
+
+        // The number of rows still to skip, and then the number of rows still to return.
+        size_t rows_to_skip_;
+        size_t rows_left_;
+
+        // Buffer for the selection vectors of batches that are partially skipped or cut off.
+        std::vector<uint16_t> selection_;
+    };
+}  // namespace simpledb::execution
+
+#endif  // SIMPLE_DB_LIMIT_OPERATOR_H
@@ -5,7 +5,9 @@
 #ifndef SIMPLE_DB_OPERATOR_H
 #define SIMPLE_DB_OPERATOR_H
 
+#include <cstddef>
 #include <optional>
+#include "simpledb/execution/batch.h"
 #include "simpledb/execution/row.h"
 
 namespace simpledb::execution {
@@ -17,6 +19,40 @@ namespace simpledb::execution {
         // Volcano model. It defines the contract that all concrete
         // operators MUST implement.
         virtual std::optional<row::Row> next() = 0;
+
+        // The vectorized counterpart of next(): fills the batch with up to BATCH_CAPACITY rows, so that operators
+        // pay for a virtual call once per batch instead of once per row. Returns false once the operator is
+        // exhausted, otherwise the batch has at least one selected row.
+        // The default implementation pulls rows through next(), and stores every column as TEXT.
+        virtual bool next_batch(Batch& batch);
+
+        // The signature of the rows returned by next(), so that the parent operator knows where each column is.
+        // std::nullopt (the default) means rows hold all columns of the table, in schema order.
+        virtual std::optional<row::Signature> signature() const { return std::nullopt; }
+
+        // Tells the operator that its parent won't ask for more than max_rows rows (e.g. because of a LIMIT), so that
+        // it doesn't read ahead past them: a scan stops reading pages once it returned that many rows, instead of
+        // filling up a whole batch. Operators that return their child's rows one for one pass it down to the child.
+        // The default implementation ignores it.
+        virtual void set_row_limit(size_t /*max_rows*/) {}
+    };
+
+    /**
+     * @brief Base class for operators that work a batch at a time.
+     *
+     * They only implement next_batch(). next() is implemented on top of it, for the consumers that still work
+     * a row at a time: it hands out the selected rows of the current batch one by one.
+     */
+    class BatchOperator : public Operator {
+       public:
+        std::optional<row::Row> next() final;
+
+        bool next_batch(Batch& batch) override = 0;
+
+       private:
+        // The batch that next() is handing out rows from, and the position of the next selected row in it.
+        Batch row_batch_;
+        size_t row_position_ = 0;
     };
 }  // namespace simpledb::execution
 
@@ -0,0 +1,143 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#ifndef SIMPLE_DB_PARALLEL_SCAN_OPERATOR_H
+#define SIMPLE_DB_PARALLEL_SCAN_OPERATOR_H
+
+#include "simpledb/ast/ast.h"
+#include "simpledb/execution/operator.h"
+#include "simpledb/execution/predicate.h"
+#include "simpledb/execution/row.h"
+#include "simpledb/execution/scheduler.h"
+#include "simpledb/execution/table_scan_operator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace simpledb::execution {
+    /**
+     * @brief Scans a table on several threads, and gathers their rows back into a single stream.
+     *
+     * The table's pages are split into morsels of MORSEL_SIZE pages, each scanned by a task on the Scheduler. The
+     * tasks take their morsel from an atomic counter, and run it through one of the operator's pipelines (there is one
+     * per task that can run at the same time): a TableScanOperator (which evaluates the pushed down predicate and only
+     * deserializes the columns the query needs) and, if the WHERE clause couldn't be pushed down, a FilterOperator.
+     *
+     * The operator itself is the gather: it returns the batches of each morsel in page order, so that the rows come
+     * out in the same order as from a serial scan. Morsels are only handed out up to MAX_MORSELS_AHEAD per worker
+     * ahead of the one being returned, which bounds the memory taken by finished morsels.
+     *
+     * The tasks are submitted by next_batch(), which must not be called from a task, as it blocks until the morsel
+     * it returns is done.
+     */
+    class ParallelScanOperator : public BatchOperator {
+       public:
+        // The number of pages of a morsel (256 KiB).
+        static constexpr uint32_t MORSEL_SIZE = 64;
+
+        // How many morsels per worker may be finished and waiting to be returned.
+        static constexpr size_t MAX_MORSELS_AHEAD = 2;
+
+        /**
+         * @param predicate The predicate pushed down into the workers' scans, if any.
+         * @param columns The indices of the columns to return (all columns, in schema order, if not given).
+         * @param where_clause The WHERE clause for the workers' FilterOperators, if it couldn't be pushed down.
+         * @param num_workers How many morsels may be scanned at the same time, at most one per morsel.
+         * @param task_group The group (usually the query's) to submit the tasks to, a new one on the process-wide
+         *                   scheduler if not given.
+         */
+        ParallelScanOperator(const std::string& table_name,
+                             const std::filesystem::path& data_dir,
+                             std::optional<CompiledPredicate> predicate,
+                             std::optional<row::Signature> columns,
+                             std::optional<ast::WhereClause> where_clause,
+                             size_t num_workers,
+                             std::shared_ptr<TaskGroup> task_group = nullptr);
+
+        // Waits for the running tasks, if the operator wasn't read to the end.
+        ~ParallelScanOperator() override;
+
+        ParallelScanOperator(const ParallelScanOperator&) = delete;
+        ParallelScanOperator& operator=(const ParallelScanOperator&) = delete;
+
+        /**
+         * @throws The exception a task failed with, if any.
+         */
+        bool next_batch(Batch& batch) override;
+
+        std::optional<row::Signature> signature() const override { return signature_; }
+
+        // Stops handing out morsels once max_rows rows were returned.
+        void set_row_limit(size_t max_rows) override { rows_left_ = std::min(rows_left_, max_rows); }
+
+        size_t num_morsels() const { return num_morsels_; }
+
+        // How many morsels may be scanned at the same time.
+        size_t num_workers() const { return num_workers_; }
+
+       private:
+        // A pipeline, and its scan to move on to the next morsel.
+        struct Worker {
+            TableScanOperator* scan;
+            std::unique_ptr<Operator> pipeline;
+        };
+
+        // The batches of a morsel, once a worker finished it.
+        struct MorselResult {
+            std::vector<Batch> batches;
+            bool done = false;
+        };
+
+        // Submits tasks for the next morsels, as far as the pipelines and MAX_MORSELS_AHEAD allow. Needs mutex_.
+        void submit_morsels(std::unique_lock<std::mutex>& lock);
+
+        // Runs the next morsel through an idle pipeline.
+        void scan_morsel();
+
+        // Stops handing out morsels, and waits for the running tasks.
+        void stop();
+
+        std::optional<row::Signature> signature_;
+        size_t num_morsels_ = 0;
+        size_t num_workers_ = 0;
+
+        std::vector<Worker> workers_;
+        std::shared_ptr<TaskGroup> task_group_;
+
+        // The next morsel for a task to scan.
+        std::atomic<size_t> next_morsel_{0};
+
+        // Protects everything below, which is shared with the tasks.
+        std::mutex mutex_;
+        // Signaled when a task is done with its morsel (or failed).
+        std::condition_variable morsel_done_;
+        // The pipelines that no task is using.
+        std::vector<Worker*> idle_workers_;
+        // The number of tasks submitted, and the number of them that are still running.
+        size_t num_submitted_ = 0;
+        size_t num_running_ = 0;
+        std::vector<MorselResult> results_;
+        // The morsel being returned, and the position of its next batch.
+        size_t next_output_ = 0;
+        size_t next_output_batch_ = 0;
+        bool stopping_ = false;
+        std::exception_ptr error_;
+
+        // How many more rows the operator may return, see set_row_limit().
+        size_t rows_left_ = std::numeric_limits<size_t>::max();
+    };
+}  // namespace simpledb::execution
+
+#endif  // SIMPLE_DB_PARALLEL_SCAN_OPERATOR_H
@@ -0,0 +1,147 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#ifndef SIMPLE_DB_PREDICATE_H
+#define SIMPLE_DB_PREDICATE_H
+
+#include "simpledb/ast/ast.h"
+#include "simpledb/catalog.h"
+#include "simpledb/command.h"
+#include "simpledb/execution/batch.h"
+#include "simpledb/execution/row.h"
+#include "simpledb/serializer.h"
+#include "simpledb/storage/page.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace simpledb::execution {
+
+    /**
+     * @brief Applies a comparison operator that is known at compile time.
+     */
+    template <ast::ComparisonOp Op, typename T>
+    inline bool compare(const T& lhs, const T& rhs) {
+        if constexpr (Op == ast::ComparisonOp::EQUALS) {
+            return lhs == rhs;
+        } else if constexpr (Op == ast::ComparisonOp::NOT_EQUALS) {
+            return lhs != rhs;
+        } else if constexpr (Op == ast::ComparisonOp::LESS_THAN) {
+            return lhs < rhs;
+        } else if constexpr (Op == ast::ComparisonOp::LESS_THAN_OR_EQUAL) {
+            return lhs <= rhs;
+        } else if constexpr (Op == ast::ComparisonOp::GREATER_THAN) {
+            return lhs > rhs;
+        } else {
+            static_assert(Op == ast::ComparisonOp::GREATER_THAN_OR_EQUAL, "Unsupported comparison operator.");
+            return lhs >= rhs;
+        }
+    }
+
+    /**
+     * @brief A "column op constant" predicate, compiled for the column's type and the comparison operator.
+     *
+     * Compiling does all the work that doesn't depend on the row once: it resolves the column, parses the constant
+     * (into an int32_t for INT columns, so that ints are compared numerically rather than as text), and picks the
+     * instantiation of the evaluation code for the (type, operator) pair. Evaluating the predicate is then a single
+     * call through a function pointer, with no switch on the operator or the type and no virtual call.
+     */
+    class CompiledPredicate {
+       public:
+        /**
+         * @throws std::runtime_error if the column doesn't exist in the table, or if the constant isn't valid for
+         *         the column's type.
+         */
+        static CompiledPredicate compile(const ast::WhereClause& where_clause,
+                                         const catalog::TableSchema& table_schema);
+
+        /**
+         * @brief Makes evaluate(row) and filter() look for the column in rows (and batches) with the given signature.
+         * By default, rows are expected to hold all columns of the table in schema order.
+         * @throws std::runtime_error if the signature doesn't include the predicate's column.
+         */
+        void set_row_signature(const row::Signature& signature);
+
+        /**
+         * @brief Checks whether a row satisfies the predicate.
+         */
+        bool evaluate(const row::Row& row) const { return evaluate_row_(*this, row); }
+
+        /**
+         * @brief Checks whether a serialized record satisfies the predicate.
+         *
+         * Only the predicate's column is read, straight from the record's bytes, so a scan can skip records
+         * without deserializing them. A NULL value never satisfies the predicate.
+         */
+        bool evaluate(const serializer::RecordLayout& layout, storage::RecordView record) const {
+            return evaluate_record_(*this, layout, record);
+        }
+
+        /**
+         * @brief Evaluates the predicate on the selected rows of a batch.
+         *
+         * The whole loop is specialized for the (type, operator) pair, so there is a single indirect call per batch.
+         * The batch's column may hold typed INT values, or the text form of the values (see Operator::next_batch()).
+         * @param selection Output parameter, set to the indices of the selected rows that satisfy the predicate.
+         */
+        void filter(const Batch& batch, std::vector<uint16_t>& selection) const {
+            filter_batch_(*this, batch, selection);
+        }
+
+        // The index of the predicate's column in the table schema.
+        size_t column_index() const { return column_index_; }
+
+        command::Datatype column_type() const { return column_type_; }
+
+        ast::ComparisonOp op() const { return op_; }
+
+        // The constant, for INT and TEXT columns respectively.
+        int32_t int_value() const { return int_value_; }
+
+        const std::string& text_value() const { return text_value_; }
+
+       private:
+        using RowEvaluator = bool (*)(const CompiledPredicate&, const row::Row&);
+        using RecordEvaluator = bool (*)(const CompiledPredicate&,
+                                         const serializer::RecordLayout&,
+                                         storage::RecordView);
+        using BatchFilter = void (*)(const CompiledPredicate&, const Batch&, std::vector<uint16_t>&);
+
+        template <command::Datatype Type, ast::ComparisonOp Op>
+        static bool evaluate_row(const CompiledPredicate& predicate, const row::Row& row);
+
+        template <command::Datatype Type, ast::ComparisonOp Op>
+        static bool evaluate_record(const CompiledPredicate& predicate,
+                                    const serializer::RecordLayout& layout,
+                                    storage::RecordView record);
+
+        template <command::Datatype Type, ast::ComparisonOp Op>
+        static void filter_batch(const CompiledPredicate& predicate,
+                                 const Batch& batch,
+                                 std::vector<uint16_t>& selection);
+
+        // Picks the instantiations for a (type, operator) pair, the one place where we switch on them.
+        template <command::Datatype Type>
+        void bind(ast::ComparisonOp op);
+
+        size_t column_index_ = 0;
+        // Where the column is in the rows the predicate is evaluated on, see set_row_signature().
+        size_t row_index_ = 0;
+        command::Datatype column_type_ = command::Datatype::UNKNOWN;
+        ast::ComparisonOp op_ = ast::ComparisonOp::EQUALS;
+
+        // The constant, parsed for the column's type. Only the one matching column_type_ is used.
+        int32_t int_value_ = 0;
+        std::string text_value_;
+
+        RowEvaluator evaluate_row_ = nullptr;
+        RecordEvaluator evaluate_record_ = nullptr;
+        BatchFilter filter_batch_ = nullptr;
+    };
+}  // namespace simpledb::execution
+
+#endif  // SIMPLE_DB_PREDICATE_H
@@ -6,6 +6,7 @@
 #define SIMPLE_DB_PROJECTION_OPERATOR_H
 
 #include <optional>
+#include "simpledb/catalog.h"
 #include "simpledb/execution/operator.h"
 #include "simpledb/execution/row.h"
 #include "simpledb/storage/table_heap.h"
@@ -15,15 +16,24 @@
 #include <vector>
 
 namespace simpledb::execution {
-    class ProjectionOperator : public Operator {
+    class ProjectionOperator : public BatchOperator {
        public:
         explicit ProjectionOperator(std::string table_name,
                                     std::unique_ptr<simpledb::execution::Operator> child,
                                     const std::vector<std::string> &projection_columns);
 
-        // The next method retrieves the next row from the child operator
-        // and projects it based on the specified columns.
-        std::optional<row::Row> next() override;
+        // Projects columns of rows that don't come from a table of the catalog, e.g. the joined rows of two tables.
+        ProjectionOperator(const catalog::TableSchema &table_schema,
+                           std::unique_ptr<simpledb::execution::Operator> child,
+                           const std::vector<std::string> &projection_columns);
+
+        // Retrieves the next batch from the child operator and projects it based on the specified columns.
+        bool next_batch(Batch& batch) override;
+
+        std::optional<row::Signature> signature() const override { return output_signature_; }
+
+        // Projecting returns one row per row of the child, so the child won't be asked for more rows either.
+        void set_row_limit(size_t max_rows) override { child_->set_row_limit(max_rows); }
 
        private:
         // The name of the table from which we are projecting columns.
@@ -36,8 +46,17 @@ namespace simpledb::execution {
         // The list of columns to project.
         std::vector<std::string> projection_columns_;
 
-        // The indices of the columns in the table schema that correspond to the projection columns.
+        // The positions, in the child's rows, of the columns to project.
         std::vector<int> projected_column_indices_;
+
+        // True if the child's rows already are the projected rows, so that they can be returned as they are.
+        bool pass_through_ = false;
+
+        // The indices of the projected columns in the table schema.
+        row::Signature output_signature_;
+
+        // The batch the child operator fills, whose columns are then moved to the projected batch.
+        Batch child_batch_;
     };
 }  // namespace simpledb::execution
 
@@ -5,11 +5,20 @@
 #ifndef SIMPLE_DB_ROW_H
 #define SIMPLE_DB_ROW_H
 
+#include <cstddef>
 #include <string>
 #include <vector>
 
 namespace row {
     using Row = std::vector<std::string>;
+
+    /**
+     * @brief Which columns of the table a row carries, and in which order.
+     *
+     * The i-th value of the row is the column at index signature[i] in the table schema. Operators use it to find
+     * the columns they need in rows that don't hold every column of the table (see Operator::signature()).
+     */
+    using Signature = std::vector<size_t>;
 }
 
 #endif  // SIMPLE_DB_ROW_H
@@ -0,0 +1,158 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#ifndef SIMPLE_DB_SCHEDULER_H
+#define SIMPLE_DB_SCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace simpledb::execution {
+    class TaskGroup;
+
+    /**
+     * @brief A pool of worker threads that run the tasks of all queries, e.g. the morsels of parallel scans.
+     *
+     * Tasks are submitted through a TaskGroup, usually one per query. Each worker has its own deque of tasks:
+     * a task submitted from inside another task (i.e. on a worker thread) goes to the back of that worker's deque,
+     * and the worker runs its own deque newest first, while its data is still in cache. A worker that runs out of
+     * tasks steals the oldest task of another worker's deque.
+     *
+     * Tasks submitted from outside the pool (e.g. by the query's thread) are queued in their group instead, and
+     * idle workers take them from the groups in turn: a query that queued thousands of tasks only gets one out of
+     * every N tasks taken while N groups have tasks queued, so it cannot starve a small query.
+     *
+     * All public methods are thread-safe.
+     */
+    class Scheduler {
+       public:
+        /**
+         * @param num_threads The number of worker threads, at least 1.
+         */
+        explicit Scheduler(size_t num_threads);
+
+        /**
+         * Waits for the queued tasks to be run, then stops the worker threads.
+         */
+        ~Scheduler();
+
+        Scheduler(const Scheduler&) = delete;
+        Scheduler& operator=(const Scheduler&) = delete;
+
+        /**
+         * @brief Returns the process-wide scheduler, created on first use. It is never destroyed, so exiting the
+         * process doesn't wait for its workers.
+         */
+        static Scheduler& instance();
+
+        /**
+         * @brief Sets the number of threads of the process-wide scheduler (the number of cores by default). Only has
+         * an effect before its first use.
+         */
+        static void configure_instance(size_t num_threads);
+
+        size_t num_threads() const { return threads_.size(); }
+
+       private:
+        friend class TaskGroup;
+
+        struct Task {
+            TaskGroup* group;
+            std::function<void()> function;
+        };
+
+        // A worker's own tasks. Its owner takes them from the back, thieves from the front.
+        struct WorkerQueue {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        // Queues a task of the group, see the class comment for where it goes.
+        void submit(TaskGroup& group, std::function<void()> function);
+
+        // Takes the next task for a worker to run: from its own deque, then from the groups' queues, then from the
+        // other workers' deques.
+        std::optional<Task> take_task(size_t worker);
+
+        // Runs a task, handing any exception it throws to its group.
+        static void run_task(Task& task);
+
+        // Whether any task is queued anywhere. Needs mutex_.
+        bool has_tasks() const;
+
+        void run_worker(size_t worker);
+
+        std::vector<std::unique_ptr<WorkerQueue>> queues_;
+        // The number of tasks in the workers' deques, so that idle workers know when there is something to steal.
+        std::atomic<size_t> num_queued_in_workers_{0};
+
+        // Protects ready_groups_, the groups' queues and stopping_. Idle workers wait on work_available_.
+        std::mutex mutex_;
+        std::condition_variable work_available_;
+        // The groups with tasks in their queue, in the order they are taken from.
+        std::deque<TaskGroup*> ready_groups_;
+        bool stopping_ = false;
+
+        std::vector<std::thread> threads_;
+    };
+
+    /**
+     * @brief The tasks of one query (or command) on the scheduler, which share the workers fairly with other groups.
+     *
+     * A group must outlive its tasks: it waits for them when it is destroyed.
+     */
+    class TaskGroup {
+       public:
+        explicit TaskGroup(Scheduler& scheduler = Scheduler::instance());
+
+        ~TaskGroup();
+
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        /**
+         * @brief Queues a task to be run by one of the scheduler's workers.
+         */
+        void submit(std::function<void()> task);
+
+        /**
+         * @brief Waits until all tasks submitted so far have been run. On a worker thread, it runs queued tasks in
+         * the meantime instead of blocking the worker.
+         * @throws The first exception thrown by one of the tasks, if any.
+         */
+        void wait();
+
+        Scheduler& scheduler() const { return scheduler_; }
+
+       private:
+        friend class Scheduler;
+
+        // Called by the scheduler when one of the group's tasks has been run.
+        void finish_task(std::exception_ptr error);
+
+        Scheduler& scheduler_;
+
+        // The group's tasks submitted from outside the scheduler, not taken by a worker yet. Protected by the
+        // scheduler's mutex.
+        std::deque<std::function<void()>> queued_;
+
+        // Protects num_pending_ and error_.
+        std::mutex mutex_;
+        std::condition_variable all_done_;
+        // The number of tasks submitted and not finished yet.
+        size_t num_pending_ = 0;
+        std::exception_ptr error_;
+    };
+}  // namespace simpledb::execution
+
+#endif  // SIMPLE_DB_SCHEDULER_H
@@ -0,0 +1,172 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#ifndef SIMPLE_DB_SORT_OPERATOR_H
+#define SIMPLE_DB_SORT_OPERATOR_H
+
+#include "simpledb/execution/operator.h"
+#include "simpledb/execution/row.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace simpledb::execution {
+    /**
+     * @brief How the values of a sort key compare.
+     *
+     * REAL is for computed values that aren't integers, like AVG.
+     */
+    enum class SortKeyType { INT, REAL, TEXT };
+
+    struct SortKey {
+        // The position of the key's column in the child's rows.
+        size_t column;
+        SortKeyType type;
+        bool descending = false;
+    };
+
+    /**
+     * @brief Implements ORDER BY: returns its child's rows sorted by the given keys.
+     *
+     * The rows are read into memory with their INT and REAL keys parsed once, so that sorting compares typed values.
+     * NULLs come after every other value (so last in ascending order, first in descending order), and rows with equal
+     * keys stay in the order the child returned them.
+     *
+     * When the rows take more memory than the budget, the ones in memory are sorted and written to a temporary file
+     * (a sorted run), and reading continues. The runs are then merged with a k-way merge, which only needs one row
+     * per run in memory. If there are more than MAX_MERGE_FAN_IN runs, groups of them are first merged into longer
+     * runs, so that the number of open files stays bounded too.
+     *
+     * If the parent won't ask for more than N rows (see set_row_limit(), e.g. for ORDER BY ... LIMIT N), only the
+     * first N rows are kept, in a bounded heap, so the memory use depends on N instead of the size of the input.
+     *
+     * The rows it returns hold the same columns as its child's, as TEXT.
+     */
+    class SortOperator : public BatchOperator {
+       public:
+        static constexpr size_t MAX_MERGE_FAN_IN = 64;
+
+        /**
+         * @param keys The sort keys, most significant first.
+         * @param memory_budget How many bytes the rows held in memory may take before they're written to a run.
+         * @param spill_dir Where to put the runs, created when needed.
+         */
+        SortOperator(std::unique_ptr<Operator> child,
+                     std::vector<SortKey> keys,
+                     size_t memory_budget,
+                     std::filesystem::path spill_dir);
+
+        // Removes the runs that are left, if the operator wasn't read to the end.
+        ~SortOperator() override;
+
+        bool next_batch(Batch& batch) override;
+
+        std::optional<row::Signature> signature() const override { return signature_; }
+
+        // Only the first max_rows rows will be read, so only those are kept: the sort becomes a top-N.
+        void set_row_limit(size_t max_rows) override { row_limit_ = std::min(row_limit_, max_rows); }
+
+        /**
+         * @brief The number of sorted runs written to files so far (including the ones from intermediate merges), 0 if
+         * everything fit in memory.
+         */
+        size_t num_runs() const { return num_runs_; }
+
+       private:
+        // A key's value, parsed for INT and REAL keys (TEXT keys are compared on the row's values).
+        struct ParsedKey {
+            bool is_null = false;
+            int64_t int_value = 0;
+            double real_value = 0;
+        };
+
+        struct SortEntry {
+            row::Row row;
+            // One per sort key.
+            std::vector<ParsedKey> keys;
+            // The position of the row in the input, so that equal rows keep their order.
+            uint64_t sequence = 0;
+        };
+
+        // A run being merged, positioned at its next row.
+        struct RunReader {
+            std::ifstream file;
+            SortEntry current;
+        };
+
+        // Reads all of the child's rows, sorting them in memory or into runs.
+        void build();
+
+        // Adds a row of the child, or (in top-N mode) drops it if it doesn't make it into the first rows.
+        void add_entry(SortEntry entry);
+
+        // Parses the keys of a row of the child's batch.
+        void parse_keys(const Batch& batch, size_t row, SortEntry& entry) const;
+
+        // Compares the keys of a and b: negative if a comes first in the sort order, 0 if their keys are equal.
+        int compare_keys(const SortEntry& a, const SortEntry& b) const;
+
+        // Whether a comes before b in the sort order, using their sequence for equal keys.
+        bool before(const SortEntry& a, const SortEntry& b) const;
+
+        // Sorts the rows held in memory, and writes them to a new run.
+        void write_run();
+
+        // Merges groups of runs until there are at most MAX_MERGE_FAN_IN of them left.
+        void merge_runs();
+
+        // Starts a k-way merge of the given runs.
+        void open_merge(const std::vector<std::filesystem::path>& runs);
+
+        // The next row of the merge, false once all runs are exhausted (the runs are then removed).
+        bool next_merged(SortEntry& entry);
+
+        // Writes a row to a run, and reads it back: false at the end of the file.
+        void write_entry(std::ofstream& file, const SortEntry& entry) const;
+        bool read_entry(std::ifstream& file, SortEntry& entry) const;
+
+        // Creates a new run, to be written with write_entry().
+        std::ofstream create_run(std::filesystem::path& path);
+
+        std::unique_ptr<Operator> child_;
+        std::optional<row::Signature> signature_;
+        std::vector<SortKey> keys_;
+        size_t memory_budget_;
+        std::filesystem::path spill_dir_;
+        size_t row_limit_ = std::numeric_limits<size_t>::max();
+
+        // The rows held in memory: a heap with the last of the first row_limit_ rows on top in top-N mode.
+        std::vector<SortEntry> entries_;
+        size_t memory_usage_ = 0;
+        bool top_n_ = false;
+
+        // The runs written and not merged yet, and every run file created (to clean up).
+        std::vector<std::filesystem::path> runs_;
+        std::vector<std::filesystem::path> run_files_;
+        size_t num_runs_ = 0;
+
+        // The merge in progress: a reader per run, and the heap of readers by their current row.
+        std::vector<std::filesystem::path> merging_runs_;
+        std::vector<std::unique_ptr<RunReader>> readers_;
+        std::vector<size_t> reader_heap_;
+
+        bool built_ = false;
+        // Whether the output comes from merging runs, rather than from entries_.
+        bool merging_ = false;
+        // The next row of entries_ to output, and how many rows were output so far.
+        size_t next_entry_ = 0;
+        size_t num_output_rows_ = 0;
+        // The number of columns of the child's rows, known from the first row.
+        size_t num_columns_ = 0;
+    };
+}  // namespace simpledb::execution
+
+#endif  // SIMPLE_DB_SORT_OPERATOR_H
@@ -6,25 +6,57 @@
 #define SIMPLE_DB_TABLE_SCAN_OPERATOR_H
 
 #include "simpledb/execution/operator.h"
+#include "simpledb/execution/predicate.h"
 #include "simpledb/execution/row.h"
+#include "simpledb/serializer.h"
 #include "simpledb/storage/table_heap.h"
 
+#include <algorithm>
 #include <filesystem>
+#include <limits>
 #include <optional>
 #include <string>
+#include <vector>
 
 namespace simpledb::execution {
     /**
      * @brief The TableScanOperator is responsible for scanning a table and returning rows one by one.
      * It implements the Operator interface, which defines the contract for all operators in the Volcano model.
+     *
+     * A predicate can be pushed down into the scan: it is then evaluated on the raw bytes of each record, and only
+     * the records that satisfy it are deserialized and returned.
+     *
+     * The scan can also be asked to deserialize only some of the columns (the ones the rest of the query needs), in
+     * which case the rows it returns only hold those columns, as described by signature().
      */
-    class TableScanOperator : public Operator {
+    class TableScanOperator : public BatchOperator {
        public:
-        // Constructor that initializes the TableScanOperator with a table name.
-        explicit TableScanOperator(const std::string& table_name, const std::filesystem::path& data_dir);
+        // Constructor that initializes the TableScanOperator with a table name, and optionally a pushed down predicate
+        // and the indices of the columns to return (all columns, in schema order, if not given).
+        explicit TableScanOperator(const std::string& table_name,
+                                   const std::filesystem::path& data_dir,
+                                   std::optional<CompiledPredicate> predicate = std::nullopt,
+                                   std::optional<row::Signature> columns = std::nullopt);
 
-        // The next method retrieves the next row from the table.
-        std::optional<row::Row> next() override;
+        // Fills the batch with the next rows of the table (that satisfy the predicate, if any).
+        bool next_batch(Batch& batch) override;
+
+        std::optional<row::Signature> signature() const override { return columns_; }
+
+        // Stops the scan once it returned max_rows rows, so that it reads no pages past them.
+        void set_row_limit(size_t max_rows) override { rows_left_ = std::min(rows_left_, max_rows); }
+
+        /**
+         * @brief Restarts the scan on a range of pages, from begin_page_id up to end_page_id (exclusive).
+         *
+         * This is how the workers of a ParallelScanOperator move their scan on to their next morsel.
+         */
+        void set_page_range(storage::PageId begin_page_id, storage::PageId end_page_id) {
+            iterator_ = table_heap_.Scan(begin_page_id, end_page_id);
+        }
+
+        // The number of pages of the table.
+        uint32_t num_pages() const { return table_heap_.GetNumPages(); }
 
        private:
         /**
@@ -42,6 +74,29 @@ namespace simpledb::execution {
          * This iterator maintains the current position (page and slot) of the scan.
          */
         storage::TableHeap::Iterator iterator_;
+
+        /**
+         * @brief Where each column lives inside the table's records, derived from the table schema.
+         */
+        serializer::RecordLayout layout_;
+
+        /**
+         * @brief The predicate pushed down into the scan, if any. Records that don't satisfy it are skipped before
+         * being deserialized.
+         */
+        std::optional<CompiledPredicate> predicate_;
+
+        /**
+         * @brief The columns to deserialize, std::nullopt for all of them.
+         */
+        std::optional<row::Signature> columns_;
+
+        // The columns to deserialize (all of them if columns_ is std::nullopt), and their types.
+        row::Signature output_columns_;
+        std::vector<command::Datatype> output_types_;
+
+        // How many more rows the scan may return, see set_row_limit().
+        size_t rows_left_ = std::numeric_limits<size_t>::max();
     };
 }  // namespace simpledb::execution
 
@@ -33,9 +33,51 @@ namespace executor {
     results::ExecutionResult execute_drop_table_command(const command::DropTableCommand& cmd,
                                                         const std::filesystem::path& table_data_dir);
 
+    /**
+     * @brief Executes a Create Index command.
+     *
+     * Builds a B+ tree over the values the column already holds (see table_index::build_index()), then adds the
+     * index to the table's schema in the catalog. From then on, inserts keep the index up to date, and the planner
+     * uses it for WHERE clauses on the column. If any step fails, the index file is removed again.
+     *
+     * @param cmd The parsed CreateIndexCommand.
+     * @param table_data_dir The directory where table data (and index) files are stored.
+     * @return ExecutionResult A string indicating success or failure.
+     */
+    results::ExecutionResult execute_create_index_command(const command::CreateIndexCommand& cmd,
+                                                          const std::filesystem::path& table_data_dir);
+
+    /**
+     * @brief Executes an INSERT command, which may have many rows.
+     *
+     * All rows are validated against the table schema first; if any row is invalid, nothing is inserted. The rows
+     * are then appended through a single TableHeap with TableHeap::InsertRecords(), which writes each page once and
+     * flushes the data file once for the whole statement. Loading rows from a file goes through COPY instead.
+     *
+     * @param cmd The parsed InsertCommand.
+     * @param table_data_dir The directory where table data files are stored.
+     * @return ExecutionResult The number of rows inserted, or an error.
+     */
     results::ExecutionResult execute_insert_command(const command::InsertCommand& cmd,
                                                     const std::filesystem::path& table_data_dir);
 
+    /**
+     * @brief Executes a COPY command, loading the rows of a CSV file into a table.
+     *
+     * The file is memory-mapped and split into chunks on record boundaries. Chunks are parsed, validated against
+     * the table schema and serialized on multiple threads, then appended to the table in file order with
+     * TableHeap::InsertRecords(), a few chunks at a time so memory use doesn't grow with the size of the file.
+     *
+     * There are no transactions yet: if a row is invalid, the rows of the chunks before it have already been
+     * loaded. The error says on which line the bad row is and how many rows were loaded.
+     *
+     * @param cmd The parsed CopyCommand.
+     * @param table_data_dir The directory where table data files are stored.
+     * @return ExecutionResult The number of rows loaded, or an error.
+     */
+    results::ExecutionResult execute_copy_command(const command::CopyCommand& cmd,
+                                                  const std::filesystem::path& table_data_dir);
+
     results::ExecutionResult execute_show_tables_command();
 }  // namespace executor
 
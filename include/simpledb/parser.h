@@ -11,8 +11,10 @@
 namespace parser {
     // A variant that can hold any of the possible parsed command types.
     using CommandVariant = std::variant<command::CreateTableCommand,
+                                        command::CreateIndexCommand,
                                         command::DropTableCommand,
                                         command::InsertCommand,
+                                        command::CopyCommand,
                                         command::ShowTablesCommand,
                                         ast::SelectCommand>;
 
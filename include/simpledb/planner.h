@@ -6,7 +6,9 @@
 #define SIMPLE_DB_PLANNER_H
 
 #include "simpledb/ast/ast.h"
+#include "simpledb/config.h"
 #include "simpledb/execution/operator.h"
+#include <cstddef>
 #include <filesystem>
 #include <memory>
 
@@ -14,10 +16,13 @@ namespace planner {
     /**
      * @brief Takes a SelectCommand AST and builds a physical execution plan.
      * @param cmd The abstract syntax tree for the SELECT query.
+     * @param work_mem How much memory operators like the hash aggregation and the sort may use before spilling to
+     *                 temporary files (which go in data_dir/tmp).
      * @return A unique_ptr to the root operator of the execution pipeline.
      */
     std::unique_ptr<simpledb::execution::Operator> plan_select(const ast::SelectCommand& cmd,
-                                                               const std::filesystem::path& data_dir);
+                                                               const std::filesystem::path& data_dir,
+                                                               size_t work_mem = config::DEFAULT_WORK_MEM);
 }  // namespace planner
 
 #endif  // SIMPLE_DB_PLANNER_H
@@ -6,16 +6,27 @@
 #define SIMPLEDB_QUERY_RUNNER_H
 
 #include "simpledb/result.h"
+#include "simpledb/result_cursor.h"
 #include "simpledb/parser.h"
 #include "simpledb/executor.h"
 #include "simpledb/planner.h"
 #include "simpledb/config.h"
 
+#include <string>
+#include <variant>
+
 namespace query_runner {
+    // What opening a query gives back: a cursor over the rows of a SELECT, or the result of any other statement (or
+    // of a query that failed before producing rows).
+    using QueryResult = std::variant<results::ExecutionResult, results::ResultCursor>;
+
     class QueryRunner {
        public:
-        // Runs the given SQL query and returns the result.
+        // Runs the given SQL query and returns the result, with all the rows of a SELECT collected into it.
         static results::ExecutionResult run_query(const std::string& query);
+
+        // Runs the given SQL query, but returns the rows of a SELECT as a cursor to read them from as they're produced.
+        static QueryResult open_query(const std::string& query);
     };
 
 }  // namespace query_runner
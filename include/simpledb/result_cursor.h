@@ -0,0 +1,65 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#ifndef SIMPLE_DB_RESULT_CURSOR_H
+#define SIMPLE_DB_RESULT_CURSOR_H
+
+#include "simpledb/execution/operator.h"
+#include "simpledb/execution/row.h"
+#include "simpledb/result.h"
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace results {
+    /**
+     * @brief Streams the rows of a query's result out of its plan, instead of collecting them all up front.
+     *
+     * Rows are produced when they are asked for: the operators of the plan only run as far as needed for the next
+     * row (or the next few rows), so memory use doesn't grow with the size of the result, and the first row is
+     * available as soon as the plan produces it. A cursor is read once, front to back.
+     *
+     * Operators report errors by throwing, so reading from a cursor can throw (e.g. if a table file is corrupt).
+     */
+    class ResultCursor {
+       public:
+        ResultCursor(std::vector<std::string> headers, std::unique_ptr<simpledb::execution::Operator> plan);
+
+        const std::vector<std::string>& headers() const { return headers_; }
+
+        /**
+         * @brief The next row of the result, or std::nullopt once all rows were read.
+         */
+        std::optional<row::Row> next();
+
+        /**
+         * @brief Reads the next rows of the result, e.g. to print them a screenful at a time.
+         * @param rows Output parameter, replaced with up to max_rows rows.
+         * @return False once all rows were read (rows is then empty).
+         */
+        bool next_rows(std::vector<row::Row>& rows, size_t max_rows);
+
+        /**
+         * @brief The number of rows read from the cursor so far.
+         */
+        size_t num_rows_read() const { return num_rows_read_; }
+
+        /**
+         * @brief Reads all the remaining rows into a ResultSet, for callers that want the whole result at once.
+         */
+        ResultSet to_result_set();
+
+       private:
+        std::vector<std::string> headers_;
+        std::unique_ptr<simpledb::execution::Operator> plan_;
+        size_t num_rows_read_ = 0;
+        // Set once the plan is exhausted, so that it isn't asked for more rows.
+        bool done_ = false;
+    };
+}  // namespace results
+
+#endif  // SIMPLE_DB_RESULT_CURSOR_H
@@ -5,12 +5,141 @@
 #ifndef SIMPLE_DB_SERIALIZER_H
 #define SIMPLE_DB_SERIALIZER_H
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "simpledb/command.h"
+#include "simpledb/storage/page.h"
+
+/**
+ * Converts rows to and from the binary record format stored in table pages.
+ *
+ * The format is schema-aware, a record of a table with N columns looks like this:
+ *
+ *   +-------------+-----------+-----------+-----+-------------+----------------------------+
+ *   | null bitmap | slot of   | slot of   | ... | slot of     | TEXT data (variable size)  |
+ *   | (N bits)    | column 0  | column 1  |     | column N-1  |                            |
+ *   +-------------+-----------+-----------+-----+-------------+----------------------------+
+ *
+ * - The null bitmap has one bit per column (rounded up to whole bytes), a set bit means the value is NULL.
+ * - Every column has a fixed-width slot at an offset that only depends on the schema:
+ *     - INT:  the value itself, as a 4-byte little-endian signed integer.
+ *     - TEXT: a 2-byte little-endian offset (from the start of the record) and a 2-byte length, pointing
+ *             into the variable-size section at the end of the record.
+ *
+ * So any column can be read in O(1), without walking the columns before it, and INT columns can be compared
+ * without parsing text.
+ */
 namespace serializer {
-    std::vector<char> serialize(const std::vector<std::string>& data);
-    std::vector<std::string> deserialize(const std::vector<char>& data);
+
+    /**
+     * @brief Where each column of a table lives inside its records.
+     *
+     * Computed once from the table schema, and then used to read and write any number of records.
+     */
+    class RecordLayout {
+       public:
+        explicit RecordLayout(const std::vector<command::ColumnDefinition>& column_definitions);
+
+        size_t num_columns() const { return column_types_.size(); }
+
+        command::Datatype column_type(size_t column) const { return column_types_[column]; }
+
+        size_t null_bitmap_size() const { return null_bitmap_size_; }
+
+        /**
+         * @brief The offset of a column's slot from the start of the record.
+         */
+        size_t slot_offset(size_t column) const { return slot_offsets_[column]; }
+
+        /**
+         * @brief The size of the fixed part of every record (null bitmap and slots), i.e. where TEXT data starts.
+         */
+        size_t fixed_size() const { return fixed_size_; }
+
+       private:
+        std::vector<command::Datatype> column_types_;
+        std::vector<size_t> slot_offsets_;
+        size_t null_bitmap_size_ = 0;
+        size_t fixed_size_ = 0;
+    };
+
+    /**
+     * @brief Parses the text form of an INT value, the way it is stored in a record.
+     * @return False if the text isn't a (32-bit) integer in its entirety.
+     */
+    bool parse_int(std::string_view text, int32_t& value);
+
+    /**
+     * @brief Serializes a row, with one value per column of the layout.
+     *
+     * Values are given in text form, INT values must be valid for parse_int().
+     * @throws std::invalid_argument if the row doesn't match the layout.
+     */
+    std::vector<char> serialize(const RecordLayout& layout, const std::vector<std::string>& values);
+
+    /**
+     * @brief Deserializes a record back into the text form of its values.
+     *
+     * NULL values are returned as empty strings, since rows can't represent NULL yet.
+     * @param values Output parameter, resized to one value per column. The strings already in it are reused, so
+     *               passing the same vector for every record of a scan avoids most allocations.
+     */
+    void deserialize(const RecordLayout& layout,
+                     simpledb::storage::RecordView record,
+                     std::vector<std::string>& values);
+
+    std::vector<std::string> deserialize(const RecordLayout& layout, simpledb::storage::RecordView record);
+
+    /**
+     * @brief Deserializes only some columns of a record, the other columns aren't even looked at.
+     * @param columns The indices of the columns to deserialize, values are returned in the same order.
+     * @param values Output parameter, resized to one value per requested column (and reused as above).
+     */
+    void deserialize(const RecordLayout& layout,
+                     simpledb::storage::RecordView record,
+                     const std::vector<size_t>& columns,
+                     std::vector<std::string>& values);
+
+    // Little-endian helpers, written byte by byte so that they work on any host (compilers turn them into plain
+    // loads and stores on little-endian machines).
+
+    inline uint16_t load_uint16(const char* data) {
+        return static_cast<uint16_t>(static_cast<uint8_t>(data[0]) | (static_cast<uint8_t>(data[1]) << 8));
+    }
+
+    inline int32_t load_int32(const char* data) {
+        uint32_t value = static_cast<uint32_t>(static_cast<uint8_t>(data[0])) |
+                         (static_cast<uint32_t>(static_cast<uint8_t>(data[1])) << 8) |
+                         (static_cast<uint32_t>(static_cast<uint8_t>(data[2])) << 16) |
+                         (static_cast<uint32_t>(static_cast<uint8_t>(data[3])) << 24);
+        return static_cast<int32_t>(value);
+    }
+
+    // O(1) accessors for a single column of a record, they don't look at any other column. They are inline since
+    // they are called for every row of a scan.
+
+    inline bool is_null(const RecordLayout& /*layout*/, simpledb::storage::RecordView record, size_t column) {
+        return (static_cast<uint8_t>(record.data[column / 8]) >> (column % 8)) & 1;
+    }
+
+    /**
+     * @brief Reads an INT column. The column must not be NULL.
+     */
+    inline int32_t read_int(const RecordLayout& layout, simpledb::storage::RecordView record, size_t column) {
+        return load_int32(record.data + layout.slot_offset(column));
+    }
+
+    /**
+     * @brief Reads a TEXT column without copying it: the view points into the record.
+     */
+    inline std::string_view read_text(const RecordLayout& layout, simpledb::storage::RecordView record, size_t column) {
+        const char* slot = record.data + layout.slot_offset(column);
+        return std::string_view(record.data + load_uint16(slot), load_uint16(slot + 2));
+    }
 }  // namespace serializer
 
 #endif  // SIMPLE_DB_SERIALIZER_H
@@ -0,0 +1,152 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#ifndef SIMPLE_DB_B_PLUS_TREE_H
+#define SIMPLE_DB_B_PLUS_TREE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "simpledb/storage/buffer_pool_manager.h"
+#include "simpledb/storage/page.h"
+#include "simpledb/storage/record_id.h"
+
+namespace simpledb::storage {
+
+    /**
+     * @brief A disk-based B+ tree that maps fixed-size keys to record ids, used for secondary indexes.
+     *
+     * Keys are byte strings of the size given when the tree is created, compared with memcmp(), so callers encode
+     * their values in an order-preserving way (see table_index::encode_key()). The same key can map to many
+     * records: entries are ordered by (key, record id), which makes every entry unique and lets duplicates be
+     * handled like any other key.
+     *
+     * The tree lives in its own file, made of pages that go through the buffer pool like the pages of a TableHeap:
+     *
+     *   - Page 0 is the meta page, holding the key size and the id of the root page.
+     *   - Every other page is a node. Leaves hold sorted (key, record id) entries and a link to the next leaf, so
+     *     that range scans can walk the leaves in order. Inner nodes hold sorted (key, record id, child) entries,
+     *     plus the leftmost child: the child after an entry holds the entries that are >= that entry.
+     *
+     * Finding a key reads one page per level, and with hundreds of entries per page a tree over millions of
+     * records is only 3 or 4 levels deep.
+     */
+    class BPlusTree {
+       public:
+        // Keys are limited so that every node, even an inner one, holds a reasonable number of entries.
+        static constexpr uint16_t MAX_KEY_SIZE = 256;
+
+        /**
+         * @brief Walks the tree's entries in order, from a starting point to the end of the tree.
+         *
+         * Like TableHeap::Iterator, it keeps the leaf it is on pinned, and can be moved but not copied.
+         */
+        class Iterator {
+           public:
+            explicit Iterator(BPlusTree* tree, PageId leaf_page_id, uint16_t position);
+
+            ~Iterator();
+
+            Iterator(Iterator&& other) noexcept;
+            Iterator& operator=(Iterator&& other) noexcept;
+            Iterator(const Iterator&) = delete;
+            Iterator& operator=(const Iterator&) = delete;
+
+            /**
+             * @brief Moves to the next entry.
+             * @param key Output parameter, set to the entry's key. It points into the pinned leaf, so it is only
+             *            valid until the next call.
+             * @param record_id Output parameter, set to the entry's record id.
+             * @return False once the end of the tree is reached.
+             */
+            bool Next(std::string_view& key, RecordId& record_id);
+
+           private:
+            void ReleasePage();
+
+            BPlusTree* tree_;
+            PageId leaf_page_id_;
+            uint16_t position_;
+            // The pinned frame holding leaf_page_id_, or nullptr if no page is pinned.
+            Page* leaf_ = nullptr;
+        };
+
+        /**
+         * Opens the tree stored in a file, creating an empty tree if the file doesn't exist (or is empty).
+         * @throws std::runtime_error if the file holds a tree with a different key size, or isn't a tree at all.
+         */
+        explicit BPlusTree(const std::string& index_file_path,
+                           uint16_t key_size,
+                           BufferPoolManager& buffer_pool = BufferPoolManager::Instance());
+
+        /**
+         * Writes back any of this tree's pages that are still dirty in the buffer pool.
+         */
+        ~BPlusTree();
+
+        BPlusTree(const BPlusTree&) = delete;
+        BPlusTree& operator=(const BPlusTree&) = delete;
+
+        /**
+         * @brief Adds an entry to the tree. Adding an entry that is already in the tree does nothing.
+         * @param key The key, exactly key_size bytes.
+         */
+        void Insert(std::string_view key, RecordId record_id);
+
+        /**
+         * @brief Builds the tree bottom-up from a batch of entries, much faster than inserting them one by one.
+         *
+         * Leaves are packed full and written in order, then each level of inner nodes is built on top of the one
+         * below it. The tree must be empty.
+         * @param entries The entries, in any order (they are sorted here).
+         */
+        void BulkLoad(std::vector<IndexEntry> entries);
+
+        /**
+         * @brief Returns an iterator at the first entry whose key is >= the given key.
+         */
+        Iterator Seek(std::string_view key);
+
+        /**
+         * @brief Returns an iterator at the first entry of the tree.
+         */
+        Iterator Begin();
+
+        uint16_t GetKeySize() const { return key_size_; }
+
+        /**
+         * @brief The number of levels of the tree, 1 if the root is a leaf.
+         */
+        uint32_t GetHeight();
+
+       private:
+        // Descends from the root to the leaf that holds (or would hold) an entry, recording the inner nodes on the
+        // way in `path` (if given). Returns the leaf pinned.
+        Page* FindLeaf(std::string_view key, RecordId record_id, PageId& leaf_page_id, std::vector<PageId>* path);
+
+        // Adds a separator (the key and record id of the first entry of the right node) to the parent of a node
+        // that was just split, splitting the parent as well if it is full.
+        void InsertIntoParent(std::vector<PageId>& path,
+                              PageId left_page_id,
+                              const std::string& separator,
+                              PageId right_page_id);
+
+        // Appends a new, pinned, zeroed page to the file.
+        Page* AllocatePage(PageId& page_id);
+
+        void SetRootPageId(PageId root_page_id);
+
+        BufferPoolManager& buffer_pool_;
+        FileId file_id_;
+        std::string file_path_;
+        uint16_t key_size_;
+        PageId root_page_id_ = 0;
+        uint32_t num_pages_ = 0;
+    };
+}  // namespace simpledb::storage
+
+#endif  // SIMPLE_DB_B_PLUS_TREE_H
@@ -0,0 +1,198 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#ifndef SIMPLE_DB_BUFFER_POOL_MANAGER_H
+#define SIMPLE_DB_BUFFER_POOL_MANAGER_H
+
+#include <cstdint>
+#include <fstream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "simpledb/storage/page.h"
+#include "simpledb/storage/replacer.h"
+
+namespace simpledb::storage {
+
+    // A FileId is a handle to a data file registered with the buffer pool.
+    using FileId = uint32_t;
+
+    /**
+     * @brief Counters describing how well the buffer pool is doing.
+     */
+    struct BufferPoolStats {
+        // Number of FetchPage() calls served from memory.
+        uint64_t hits = 0;
+
+        // Number of FetchPage() calls that had to read the page from disk.
+        uint64_t misses = 0;
+
+        // Number of frames that were reused for another page.
+        uint64_t evictions = 0;
+
+        // Number of dirty pages written back to disk (on eviction or explicit flush).
+        uint64_t writebacks = 0;
+    };
+
+    /**
+     * @brief An in-memory cache of disk pages, shared by all tables in the process.
+     *
+     * The buffer pool owns a fixed number of page-sized frames. Callers ask for a page with FetchPage(),
+     * which returns a pointer into one of the frames and "pins" it, i.e. the frame can't be reused for
+     * another page until the caller calls UnpinPage(). If the page is not cached (a miss), it is read from
+     * disk into a free frame, evicting an unpinned page picked by the Replacer if the pool is full. Dirty
+     * pages are written back to disk before their frame is reused, or when explicitly flushed.
+     *
+     * The pool also owns the file streams of all data files it caches pages for. A data file is registered
+     * once with OpenFile() and then referred to by its FileId.
+     *
+     * All public methods are thread-safe.
+     */
+    class BufferPoolManager {
+       public:
+        // Number of frames in the process-wide pool (4 MB worth of pages).
+        static constexpr size_t DEFAULT_POOL_SIZE = 1024;
+
+        BufferPoolManager(size_t pool_size, std::unique_ptr<Replacer> replacer);
+
+        /**
+         * Writes back all dirty pages before the pool goes away.
+         */
+        ~BufferPoolManager();
+
+        BufferPoolManager(const BufferPoolManager&) = delete;
+        BufferPoolManager& operator=(const BufferPoolManager&) = delete;
+
+        /**
+         * @brief Returns the process-wide buffer pool used by all tables.
+         */
+        static BufferPoolManager& Instance();
+
+        /**
+         * Registers a data file with the pool, or returns its id if it is already registered.
+         * The file must already exist.
+         * @param file_path The path to the data file.
+         * @return The id to use for this file in all other calls.
+         */
+        FileId OpenFile(const std::string& file_path);
+
+        /**
+         * Forgets everything the pool knows about a data file: cached pages are dropped *without* being
+         * written back, and the file stream is closed. Must be called before a data file is deleted or
+         * re-created, otherwise the pool would keep serving pages of the old file.
+         * @param file_path The path to the data file.
+         * @throws std::runtime_error if a page of the file is pinned, in which case nothing is discarded.
+         */
+        void DiscardFile(const std::string& file_path);
+
+        /**
+         * Calculates the number of pages of a file by looking at its size on disk.
+         * Pages created with NewPage() are only counted once they have been flushed.
+         */
+        uint32_t GetNumPagesOnDisk(FileId file_id);
+
+        /**
+         * Returns a pinned pointer to the requested page, reading it from disk if it is not cached.
+         * The caller must call UnpinPage() once it is done with the page.
+         * @throws std::runtime_error if every frame is pinned, or if the page can't be read from disk.
+         */
+        Page* FetchPage(FileId file_id, PageId page_id);
+
+        /**
+         * Returns a pinned, zeroed frame for a page that does not exist on disk yet (e.g. a page being
+         * appended to a file). The frame is marked dirty, so it will reach the disk when flushed or evicted.
+         * @throws std::runtime_error if every frame is pinned.
+         */
+        Page* NewPage(FileId file_id, PageId page_id);
+
+        /**
+         * Releases one pin on a page.
+         * @param is_dirty True if the caller modified the page.
+         * @return False if the page is not cached or was not pinned.
+         */
+        bool UnpinPage(FileId file_id, PageId page_id, bool is_dirty);
+
+        /**
+         * Writes a cached page back to disk if it is dirty.
+         * @return False if the page is not cached.
+         */
+        bool FlushPage(FileId file_id, PageId page_id);
+
+        /**
+         * Writes back all dirty pages belonging to the given file.
+         */
+        void FlushFile(FileId file_id);
+
+        /**
+         * Writes back all dirty pages in the pool.
+         */
+        void FlushAllPages();
+
+        BufferPoolStats GetStats() const;
+
+        void ResetStats();
+
+        size_t GetPoolSize() const { return frames_.size(); }
+
+       private:
+        /**
+         * The metadata kept for each frame of the pool.
+         */
+        struct Frame {
+            Page page;
+            FileId file_id = 0;
+            PageId page_id = 0;
+            int pin_count = 0;
+            bool is_dirty = false;
+        };
+
+        // The on-disk side of a registered file.
+        struct FileEntry {
+            std::string path;
+            std::fstream stream;
+        };
+
+        static uint64_t MakeKey(FileId file_id, PageId page_id) {
+            return (static_cast<uint64_t>(file_id) << 32) | page_id;
+        }
+
+        // Finds a frame for a new page: a free one if possible, otherwise an evicted one.
+        // Must be called with latch_ held.
+        FrameId AcquireFrame();
+
+        // Writes the page held by the given frame to disk. Must be called with latch_ held.
+        void WriteBack(Frame& frame);
+
+        FileEntry& GetFileEntry(FileId file_id);
+
+        void ReadPageFromDisk(FileEntry& file, PageId page_id, Page* page);
+
+        void WritePageToDisk(FileEntry& file, PageId page_id, const Page* page);
+
+        // Protects every member below.
+        mutable std::mutex latch_;
+
+        std::vector<Frame> frames_;
+
+        // Maps (file id, page id) to the frame currently holding that page.
+        std::unordered_map<uint64_t, FrameId> page_table_;
+
+        // Frames that don't hold any page.
+        std::list<FrameId> free_list_;
+
+        std::unique_ptr<Replacer> replacer_;
+
+        std::unordered_map<std::string, FileId> file_ids_;
+        std::unordered_map<FileId, FileEntry> files_;
+        FileId next_file_id_ = 0;
+
+        BufferPoolStats stats_;
+    };
+}  // namespace simpledb::storage
+
+#endif  // SIMPLE_DB_BUFFER_POOL_MANAGER_H
@@ -0,0 +1,118 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#ifndef SIMPLE_DB_HASH_INDEX_H
+#define SIMPLE_DB_HASH_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "simpledb/storage/buffer_pool_manager.h"
+#include "simpledb/storage/page.h"
+#include "simpledb/storage/record_id.h"
+
+namespace simpledb::storage {
+
+    /**
+     * @brief A disk-based hash table that maps fixed-size keys to record ids, used for indexes that only answer
+     * equality lookups.
+     *
+     * It uses linear hashing: the table starts with a single bucket, and every time the average bucket gets too
+     * full, the next bucket in round-robin order is split in two. The table grows one bucket at a time, so there
+     * is never a big rehash, and no bucket ends up with a long chain of overflow pages for long.
+     *
+     * Like a BPlusTree, it lives in its own file, made of pages that go through the buffer pool:
+     *
+     *   - Page 0 is the meta page, holding the key size, the number of buckets and entries, and the ids of the
+     *     directory pages.
+     *   - Directory pages map bucket numbers to the first page of each bucket.
+     *   - Bucket pages hold unsorted (key, record id) entries, and a link to the bucket's next (overflow) page.
+     *
+     * The meta page is read once when the index is opened, so a lookup reads the directory page of the key's
+     * bucket and then the bucket itself: two page reads however large the table is, plus one per overflow page.
+     * As with the BPlusTree, the same key can map to many records, and adding an entry twice does nothing.
+     */
+    class HashIndex {
+       public:
+        // Keys are limited so that every bucket page holds a reasonable number of entries.
+        static constexpr uint16_t MAX_KEY_SIZE = 256;
+
+        /**
+         * Opens the index stored in a file, creating an empty index if the file doesn't exist (or is empty).
+         * @throws std::runtime_error if the file holds an index with a different key size, or isn't a hash index.
+         */
+        explicit HashIndex(const std::string& index_file_path,
+                           uint16_t key_size,
+                           BufferPoolManager& buffer_pool = BufferPoolManager::Instance());
+
+        /**
+         * Writes back any of this index's pages that are still dirty in the buffer pool.
+         */
+        ~HashIndex();
+
+        HashIndex(const HashIndex&) = delete;
+        HashIndex& operator=(const HashIndex&) = delete;
+
+        /**
+         * @brief Adds an entry to the index, splitting a bucket if the index got too full.
+         * Adding an entry that is already in the index does nothing.
+         * @param key The key, exactly key_size bytes.
+         */
+        void Insert(std::string_view key, RecordId record_id);
+
+        /**
+         * @brief Fills the index from a batch of entries, sizing it for them up front instead of growing it one
+         * split at a time. The index must be empty.
+         */
+        void BulkLoad(std::vector<IndexEntry> entries);
+
+        /**
+         * @brief Finds the records with a given key.
+         * @param record_ids Output parameter, the ids of the records are appended to it (in no particular order).
+         */
+        void Find(std::string_view key, std::vector<RecordId>& record_ids);
+
+        uint16_t GetKeySize() const { return key_size_; }
+
+        uint32_t GetNumBuckets() const { return num_buckets_; }
+
+        uint64_t GetNumEntries() const { return num_entries_; }
+
+       private:
+        // The bucket a key belongs to, given the current number of buckets.
+        uint32_t BucketOf(std::string_view key) const;
+
+        // The first page of a bucket, read from the directory.
+        PageId GetBucketPageId(uint32_t bucket);
+
+        // Adds a new, empty bucket at the end of the table (and a directory page for it if needed).
+        void AddBucket();
+
+        // Splits the bucket at the split pointer, moving about half of its entries to a new bucket.
+        void Split();
+
+        // Replaces the entries of a bucket with the given ones, reusing the bucket's pages and appending overflow
+        // pages if they don't fit. Pages left over at the end of the chain are kept, empty, for later inserts.
+        void WriteBucket(PageId first_page_id, const std::vector<const char*>& entries);
+
+        // Appends a new, pinned, zeroed page to the file. A zeroed page is an empty bucket with no overflow page.
+        Page* AllocatePage(PageId& page_id);
+
+        void WriteMeta();
+
+        BufferPoolManager& buffer_pool_;
+        FileId file_id_;
+        std::string file_path_;
+        uint16_t key_size_;
+        uint32_t num_pages_ = 0;
+        uint32_t num_buckets_ = 0;
+        uint64_t num_entries_ = 0;
+        std::vector<PageId> directory_page_ids_;
+    };
+}  // namespace simpledb::storage
+
+#endif  // SIMPLE_DB_HASH_INDEX_H
@@ -0,0 +1,46 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#ifndef SIMPLE_DB_MAPPED_FILE_H
+#define SIMPLE_DB_MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace simpledb::storage {
+
+    /**
+     * @brief A read-only memory mapping of a whole file.
+     *
+     * Bulk readers (e.g. COPY) can look at the file as one contiguous buffer, and the OS pages it in as it is
+     * read, instead of everything being copied through stream buffers first. The mapping is shared by all
+     * threads, so different parts of the file can be processed in parallel.
+     */
+    class MappedFile {
+       public:
+        /**
+         * Maps the given file into memory.
+         * @throws std::runtime_error if the file can't be opened or mapped.
+         */
+        explicit MappedFile(const std::string& file_path);
+
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /**
+         * @brief Returns the contents of the file. Valid as long as this object is alive.
+         */
+        std::string_view GetData() const { return std::string_view(data_, size_); }
+
+       private:
+        // Start of the mapping, nullptr for an empty file (which can't be mapped).
+        const char* data_ = nullptr;
+        size_t size_ = 0;
+    };
+}  // namespace simpledb::storage
+
+#endif  // SIMPLE_DB_MAPPED_FILE_H
@@ -22,6 +22,31 @@ namespace simpledb::storage {
 
     constexpr size_t PAGE_SIZE = 4096;  // Size of a page in bytes
 
+    // A PageId is a unique identifier for a page in the storage system.
+    // Type alias is mostly for clarity, and future maintainability.
+    using PageId = uint32_t;
+
+    /**
+     * @brief A read-only view of a record stored on a page.
+     *
+     * Unlike Page::GetRecord(), creating a view doesn't copy anything: it simply points into the
+     * page's buffer. This also means that a view is only valid as long as the page it points into
+     * is alive, i.e. while the page is pinned in the buffer pool.
+     */
+    struct RecordView {
+        const char* data = nullptr;
+        uint16_t length = 0;
+
+        const char* begin() const { return data; }
+
+        const char* end() const { return data + length; }
+
+        /**
+         * Copies the record's data out of the page, for when it has to outlive the page's pin.
+         */
+        std::vector<char> ToVector() const { return std::vector<char>(begin(), end()); }
+    };
+
     class Page {
        public:
         // These constants define the offsets of various fields in the page header.
@@ -48,6 +73,9 @@ namespace simpledb::storage {
             uint16_t record_length;
         };
 
+        // The largest record that fits on an empty page, along with its slot.
+        static constexpr size_t MAX_RECORD_SIZE = PAGE_SIZE - HEADER_SIZE - sizeof(Slot);
+
         uint8_t GetVersion() const;
 
         void SetVersion(uint8_t version);
@@ -82,6 +110,11 @@ namespace simpledb::storage {
          */
         std::vector<char> GetRecord(const Slot& slot) const;
 
+        /**
+         * Returns a view of a record's data without copying it.
+         */
+        RecordView GetRecordView(const Slot& slot) const;
+
         /**
          * @brief Returns a const pointer to the page's raw data.
          *
@@ -0,0 +1,44 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#ifndef SIMPLE_DB_RECORD_ID_H
+#define SIMPLE_DB_RECORD_ID_H
+
+#include <cstdint>
+#include <string>
+
+#include "simpledb/storage/page.h"
+
+namespace simpledb::storage {
+
+    /**
+     * @brief The address of a record in a TableHeap: the page it lives on, and its slot on that page.
+     *
+     * Records never move once inserted, so a RecordId stays valid for as long as the table exists. This is what
+     * indexes store to point back at the table's records.
+     */
+    struct RecordId {
+        PageId page_id = 0;
+        uint16_t slot = 0;
+
+        bool operator==(const RecordId& other) const { return page_id == other.page_id && slot == other.slot; }
+
+        bool operator!=(const RecordId& other) const { return !(*this == other); }
+
+        // Orders records the way a sequential scan visits them.
+        bool operator<(const RecordId& other) const {
+            return page_id != other.page_id ? page_id < other.page_id : slot < other.slot;
+        }
+    };
+
+    /**
+     * @brief A key of an index and the record it points to.
+     */
+    struct IndexEntry {
+        std::string key;
+        RecordId record_id;
+    };
+}  // namespace simpledb::storage
+
+#endif  // SIMPLE_DB_RECORD_ID_H
@@ -0,0 +1,104 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#ifndef SIMPLE_DB_REPLACER_H
+#define SIMPLE_DB_REPLACER_H
+
+#include <cstddef>
+#include <list>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace simpledb::storage {
+
+    // A FrameId identifies one of the fixed in-memory slots of the buffer pool.
+    using FrameId = size_t;
+
+    /**
+     * @brief The eviction policy used by the BufferPoolManager.
+     *
+     * The buffer pool tells the replacer whenever a frame is accessed, and whether it may currently
+     * be evicted (i.e. nobody has it pinned). When the pool runs out of free frames, it asks the replacer
+     * to pick a victim among the evictable frames.
+     *
+     * Keeping this behind an interface lets us swap the policy (LRU, CLOCK, LRU-K, ...) without touching
+     * the buffer pool itself.
+     */
+    class Replacer {
+       public:
+        virtual ~Replacer() = default;
+
+        /**
+         * Records that the given frame was just accessed.
+         */
+        virtual void RecordAccess(FrameId frame_id) = 0;
+
+        /**
+         * Marks a frame as evictable (pin count dropped to zero) or non-evictable (frame got pinned).
+         */
+        virtual void SetEvictable(FrameId frame_id, bool evictable) = 0;
+
+        /**
+         * Picks a victim frame among the evictable frames and stops tracking it.
+         * @return The victim frame, or std::nullopt if no frame can be evicted.
+         */
+        virtual std::optional<FrameId> Evict() = 0;
+
+        /**
+         * Stops tracking the given frame, e.g. because its page was discarded.
+         */
+        virtual void Remove(FrameId frame_id) = 0;
+
+        /**
+         * @return The number of frames that can currently be evicted.
+         */
+        virtual size_t Size() const = 0;
+    };
+
+    /**
+     * @brief Evicts the frame whose last access is the oldest.
+     */
+    class LruReplacer : public Replacer {
+       public:
+        void RecordAccess(FrameId frame_id) override;
+        void SetEvictable(FrameId frame_id, bool evictable) override;
+        std::optional<FrameId> Evict() override;
+        void Remove(FrameId frame_id) override;
+        size_t Size() const override;
+
+       private:
+        // Evictable frames ordered from least recently used (front) to most recently used (back).
+        std::list<FrameId> lru_list_;
+
+        // Lets us find (and unlink) a frame in lru_list_ in O(1).
+        std::unordered_map<FrameId, std::list<FrameId>::iterator> lru_positions_;
+    };
+
+    /**
+     * @brief Approximates LRU with a single reference bit per frame (the "second chance" algorithm).
+     *
+     * The clock hand sweeps over the frames. A frame that was accessed since the last sweep gets its
+     * reference bit cleared and is skipped; the first evictable frame without a reference bit is evicted.
+     * This is cheaper than LRU because an access only sets a bit instead of reordering a list.
+     */
+    class ClockReplacer : public Replacer {
+       public:
+        explicit ClockReplacer(size_t num_frames);
+
+        void RecordAccess(FrameId frame_id) override;
+        void SetEvictable(FrameId frame_id, bool evictable) override;
+        std::optional<FrameId> Evict() override;
+        void Remove(FrameId frame_id) override;
+        size_t Size() const override;
+
+       private:
+        std::vector<bool> reference_bits_;
+        std::vector<bool> evictable_;
+        size_t clock_hand_ = 0;
+        size_t num_evictable_ = 0;
+    };
+}  // namespace simpledb::storage
+
+#endif  // SIMPLE_DB_REPLACER_H
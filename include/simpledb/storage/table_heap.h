@@ -6,20 +6,18 @@
 #define SIMPLE_DB_TABLE_HEAP_H
 
 #include <cstdint>
-#include <fstream>
+#include <limits>
 #include <string>
 #include <optional>
 #include <vector>
 
 #include "simpledb/execution/row.h"
+#include "simpledb/storage/buffer_pool_manager.h"
 #include "simpledb/storage/page.h"
+#include "simpledb/storage/record_id.h"
 
 namespace simpledb::storage {
 
-    // A PageId is a unique identifier for a page in the storage system.
-    // Type alias is mostly for clarity, and future maintainability.
-    using PageId = uint32_t;
-
     /**
      * @brief Manages the collection of pages on disk that store a single table's data.
      *
@@ -34,10 +32,16 @@ namespace simpledb::storage {
      * record placement from the higher-level query processing logic.
      *
      * Internally, the file is a sequence of fixed-size pages, and each page uses a
-     * slotted page layout to manage variable-length records.
+     * slotted page layout to manage variable-length records. All page reads and writes
+     * go through the process-wide BufferPoolManager, so a page that is read repeatedly
+     * (e.g. once per record during a scan) only hits the disk once.
+     *
+     * Every record is addressed by a RecordId (its page and slot), which is handed out when the record is inserted
+     * and never changes afterwards, since records don't move between pages.
      *
      * Its primary responsibilities include:
      *  - Inserting new records into the table.
+     *  - Fetching a single record by its RecordId.
      *  - Providing an iterator to scan all records in the table sequentially.
      */
     class TableHeap {
@@ -47,15 +51,76 @@ namespace simpledb::storage {
          *
          * This iterator moves from the first record of the first page to the last record
          * of the last page. It is the foundational tool for full table scans.
+         *
+         * The iterator works a page at a time: it keeps the page it is currently on pinned in
+         * the buffer pool and walks all of its slots before moving on, so each page is fetched
+         * exactly once per scan. The pin is released when the iterator moves to the next page
+         * or is destroyed, which is why an iterator can be moved but not copied.
+         *
+         * An iterator can also be limited to a range of pages (see TableHeap::Scan()), so that several of them
+         * can split a table between them, e.g. in a parallel scan.
          */
         class Iterator {
            public:
-            explicit Iterator(TableHeap* parent_heap, PageId page_id, uint16_t slot_num);
+            /**
+             * @param end_page_id The page to stop at (exclusive). The scan also stops at the end of the table.
+             */
+            explicit Iterator(TableHeap* parent_heap,
+                              PageId page_id,
+                              uint16_t slot_num,
+                              PageId end_page_id = std::numeric_limits<PageId>::max());
+
+            ~Iterator();
+
+            Iterator(Iterator&& other) noexcept;
+            Iterator& operator=(Iterator&& other) noexcept;
+            Iterator(const Iterator&) = delete;
+            Iterator& operator=(const Iterator&) = delete;
 
-            std::optional<std::vector<char>> next();
+            /**
+             * @brief Returns a view of the next record in the table.
+             *
+             * The view points into the pinned page, so it stays valid until the iterator moves on to
+             * another page (or is destroyed). Use RecordView::ToVector() to keep the record around longer.
+             *
+             * @return The next record, or std::nullopt once the scan is complete.
+             */
+            std::optional<RecordView> next();
+
+            /**
+             * @brief Returns views of all remaining records on the current page, and moves on to the next page.
+             *
+             * Empty pages are skipped, so the result is only empty once the scan is complete. The views point
+             * into the pinned page, and stay valid until the next call to next() or NextPage(), or until the
+             * iterator is destroyed.
+             *
+             * @return The records of one page, in slot order.
+             */
+            const std::vector<RecordView>& NextPage();
+
+            /**
+             * @brief The page that the records handed out by the last call to next() or NextPage() live on.
+             */
+            PageId GetPageId() const { return current_page_id_; }
+
+            /**
+             * @brief The id of the record returned by the last call to next(), e.g. to fetch it again later with
+             * TableHeap::GetRecord() instead of keeping a copy around.
+             */
+            RecordId GetRecordId() const { return {current_page_id_, static_cast<uint16_t>(current_slot_num_ - 1)}; }
 
            private:
-            // A pointer to the parent TableHeap, used to call its private methods like ReadPage.
+            /**
+             * Makes sure the current page is pinned and still has a record at current_slot_num_,
+             * moving on to (and pinning) the following pages as needed.
+             * @return False once there are no more records in the table.
+             */
+            bool PinPageWithRecords();
+
+            // Unpins the current page, if any.
+            void ReleasePage();
+
+            // A pointer to the parent TableHeap, used to reach its buffer pool and page count.
             TableHeap* parent_heap_;
 
             // The ID of the page the iterator is currently scanning.
@@ -63,56 +128,130 @@ namespace simpledb::storage {
 
             // The number of the slot on the current page that the iterator will read next.
             uint16_t current_slot_num_;
+
+            // The page the iterator stops at (exclusive).
+            PageId end_page_id_;
+
+            // The pinned buffer pool frame holding current_page_id_, or nullptr if no page is pinned.
+            Page* current_page_ = nullptr;
+
+            // The records handed out by the last NextPage() call. Kept as a member to reuse its capacity.
+            std::vector<RecordView> page_records_;
         };
 
         /**
-         * Constructor that opens the table's data file.
+         * Constructor that opens the table's data file, creating it if it doesn't exist.
          * @param table_data_path The path to the file that stores the table's data.
+         * @param buffer_pool The buffer pool through which all page I/O goes. Defaults to the process-wide pool.
          */
-        explicit TableHeap(const std::string& table_data_path);
+        explicit TableHeap(const std::string& table_data_path,
+                           BufferPoolManager& buffer_pool = BufferPoolManager::Instance());
+
+        /**
+         * Writes back any of this table's pages that are still dirty in the buffer pool.
+         */
+        ~TableHeap();
+
+        // Iterators keep a pointer to their heap, so a heap must not be copied around.
+        TableHeap(const TableHeap&) = delete;
+        TableHeap& operator=(const TableHeap&) = delete;
 
         /**
          * Inserts a new record into the table.
          * @param record_data The binary data of the record to insert.
-         * @return True if the insertion was successful, false otherwise.
+         * @return The id of the inserted record, or std::nullopt if the insertion failed (e.g. the record is too
+         *         large for a page).
          */
-        bool InsertRecord(const std::vector<char>& record_data);
+        std::optional<RecordId> InsertRecord(const std::vector<char>& record_data);
+
+        /**
+         * @brief Appends a batch of records to the end of the table.
+         *
+         * Unlike calling InsertRecord() in a loop, the records are packed into pages directly inside the
+         * buffer pool, and the data file is flushed once at the end of the batch. Each full page is written
+         * to disk once (when it is evicted or flushed), instead of once per record.
+         *
+         * The batch is checked up front: if any record is too large to fit on a page, nothing is inserted.
+         *
+         * @param records The binary data of the records to insert, in order.
+         * @param record_ids Optional output parameter, set to the ids of the inserted records (in the same order),
+         *                   e.g. to add them to the table's indexes.
+         * @return True if all records were inserted, false if the batch was rejected.
+         */
+        bool InsertRecords(const std::vector<std::vector<char>>& records,
+                           std::vector<RecordId>* record_ids = nullptr);
+
+        /**
+         * @brief Copies a single record out of the table, reading only the page it lives on.
+         *
+         * This is how indexes (and anything else that keeps record ids around) get back to a record, without
+         * scanning the table: a lookup costs a single page fetch, which is a memory access if the page is cached.
+         *
+         * @param record_id The id of the record, as handed out when it was inserted.
+         * @param record_data Output parameter, set to the binary data of the record. Its capacity is reused, so
+         *                    passing the same vector for many lookups avoids most allocations.
+         * @return False if there is no record with that id.
+         */
+        bool GetRecord(RecordId record_id, std::vector<char>& record_data);
 
         /**
          * @brief Returns an iterator pointing to the first record in the table.
          *
          * This method creates an iterator initialized to the very beginning of the heap
          * (page 0, slot 0). This design, where the starting point is passed to the
-         * iterator's constructor, allows for future flexibility, such as creating
-         * iterators that start at arbitrary pages for parallel scans.
+         * iterator's constructor, allows creating iterators that start at arbitrary
+         * pages, as Scan() does for parallel scans.
          *
          * @return An iterator initialized to the start of the heap.
          */
         TableHeap::Iterator begin() { return Iterator(this, 0, 0); }
 
-       private:
         /**
-         * Reads a specific page from the data file into the provided Page object.
-         * @param page_id The ID of the page to read.
-         * @param page A pointer to a Page object to be populated with data.
+         * @brief Returns an iterator over the records of a range of pages, e.g. one morsel of a parallel scan.
+         *
+         * @param begin_page_id The first page to read.
+         * @param end_page_id The page to stop at (exclusive). Pages past the end of the table are ignored.
+         * @return An iterator initialized to the start of begin_page_id.
          */
-        void ReadPage(PageId page_id, Page* page);
+        TableHeap::Iterator Scan(PageId begin_page_id, PageId end_page_id) {
+            return Iterator(this, begin_page_id, 0, end_page_id);
+        }
 
         /**
-         * Writes the data from a Page object to a specific page in the data file.
+         * @brief Returns the number of pages currently in the table.
+         *
+         * The count is kept in memory: it is read from the size of the data file once when the heap is
+         * opened, and bumped whenever a page is appended. This makes it cheap enough to call once per
+         * record, unlike seeking to the end of the file.
+         *
+         * Note that a heap only knows about the pages *it* appended, so a table must not be appended to
+         * through two TableHeap objects at the same time.
+         */
+        uint32_t GetNumPages() const { return num_pages_; }
+
+        /**
+         * Re-reads the page count from the size of the data file. Only needed when the file may have been
+         * changed behind the heap's back, e.g. when recovering from a failed write.
+         */
+        void RefreshNumPages();
+
+       private:
+        /**
+         * Writes the data from a Page object to a specific page (through the buffer pool).
+         * The page is flushed to the data file before this method returns.
          * @param page_id The ID of the page to write to.
          * @param page A pointer to the Page object containing the data to write.
          */
         void WritePage(PageId page_id, const Page* page);
 
-        /**
-         * Calculates the number of pages currently in the table file.
-         * @return The total number of pages.
-         */
-        uint32_t GetNumPages();
+        // The buffer pool that caches this table's pages and owns the data file stream.
+        BufferPoolManager& buffer_pool_;
+
+        // The id under which the data file is registered with the buffer pool.
+        FileId file_id_;
 
-        // The file stream used to read/write the table's data.
-        std::fstream file_stream_;
+        // The number of pages in the table, including appended pages that may still only live in the buffer pool.
+        uint32_t num_pages_ = 0;
 
         // The path to the file that stores the table's data.
         std::string file_path_;
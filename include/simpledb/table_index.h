@@ -0,0 +1,137 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#ifndef SIMPLE_DB_TABLE_INDEX_H
+#define SIMPLE_DB_TABLE_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "simpledb/catalog.h"
+#include "simpledb/command.h"
+#include "simpledb/serializer.h"
+#include "simpledb/storage/page.h"
+#include "simpledb/storage/record_id.h"
+
+/**
+ * Secondary indexes on table columns, created with CREATE INDEX.
+ *
+ * An index is a storage::BPlusTree (or a storage::HashIndex, for USING HASH) in its own file next to the table's
+ * data file, mapping the values of one column to the ids of the records that hold them. Trees compare keys as raw
+ * bytes, so values are encoded into fixed-size keys whose byte order matches the order of the values (hash indexes
+ * use the same keys, although they only compare them for equality):
+ *
+ * - INT: the 4 bytes of the value in big-endian order, with the sign bit flipped (so negative values come first).
+ * - TEXT: the first TEXT_KEY_SIZE bytes of the value, padded with zero bytes. Longer values that share that prefix
+ *         get the same key, so the index narrows down the records to look at but doesn't decide on its own whether
+ *         a record matches: the query rechecks its predicate on every record it fetches through the index.
+ *
+ * NULL values aren't indexed, since no predicate ever matches them.
+ *
+ * PRIMARY KEY and UNIQUE columns get an index when their table is created, marked as unique: inserts check it to
+ * reject duplicate values, and the planner knows that an equality lookup on the column finds at most one row.
+ */
+namespace table_index {
+
+    // Number of bytes of a TEXT value that go into its key.
+    constexpr uint16_t TEXT_KEY_SIZE = 16;
+
+    /**
+     * @brief The size of the keys of an index on a column of the given type.
+     */
+    uint16_t key_size(command::Datatype type);
+
+    std::string encode_int_key(int32_t value);
+
+    std::string encode_text_key(std::string_view value);
+
+    /**
+     * @brief Encodes the value of a column of a record as an index key.
+     * @param key Output parameter, set to the key.
+     * @return False if the value is NULL (and therefore not indexed).
+     */
+    bool encode_key(const serializer::RecordLayout& layout,
+                    simpledb::storage::RecordView record,
+                    size_t column,
+                    std::string& key);
+
+    /**
+     * @brief The file that stores an index, e.g. "users.users_by_age.index" for index users_by_age on table users.
+     */
+    std::filesystem::path index_file_path(const std::filesystem::path& table_data_dir,
+                                          const std::string& table_name,
+                                          const std::string& index_name);
+
+    /**
+     * @brief Finds the position of an index's column in the table schema.
+     * @throws std::runtime_error if the table has no such column.
+     */
+    size_t column_index(const catalog::TableSchema& table_schema, const catalog::IndexDefinition& index);
+
+    /**
+     * @brief Builds a new index over the records already in a table, bulk loading it in one pass.
+     * The index file must not exist yet.
+     * @return The number of records added to the index.
+     */
+    size_t build_index(const std::filesystem::path& table_data_dir,
+                       const catalog::TableSchema& table_schema,
+                       const catalog::IndexDefinition& index);
+
+    /**
+     * @brief Adds records that were just inserted into a table to all of the table's indexes.
+     * @param records The binary data of the records.
+     * @param record_ids The ids the records got, as returned by TableHeap::InsertRecords().
+     */
+    void insert_records(const std::filesystem::path& table_data_dir,
+                        const catalog::TableSchema& table_schema,
+                        const std::vector<std::vector<char>>& records,
+                        const std::vector<simpledb::storage::RecordId>& record_ids);
+
+    /**
+     * @brief The unique indexes that enforce the PRIMARY KEY and UNIQUE constraints of a new table's columns, named
+     * like in Postgres: "users_pkey" for the primary key of table users, "users_email_key" for a UNIQUE column email.
+     */
+    std::vector<catalog::IndexDefinition> constraint_indexes(const std::string& table_name,
+                                                             const std::vector<command::ColumnDefinition>& columns);
+
+    /**
+     * @brief Whether a column has a unique index, i.e. no two rows have the same value in it.
+     */
+    bool is_unique_column(const catalog::TableSchema& table_schema, const std::string& column_name);
+
+    /**
+     * @brief A record that would give a unique column a value that it already has.
+     */
+    struct UniqueViolation {
+        // The position of the record in the batch being inserted.
+        size_t record_index;
+        std::string column_name;
+        std::string value;
+    };
+
+    /**
+     * @brief Checks records that are about to be inserted into a table against the table's unique indexes: a
+     * record violates one if another record of the batch, or a record already in the table, has the same value.
+     *
+     * A lookup in the index finds the records that might have the value (keys can be lossy), and the values of
+     * those records are compared with the new one, so a check is an index probe plus a page read per candidate.
+     * @param records The binary data of the records, in the order they would be inserted.
+     * @return The first violation, or std::nullopt if the records can be inserted.
+     */
+    std::optional<UniqueViolation> find_unique_violation(const std::filesystem::path& table_data_dir,
+                                                         const catalog::TableSchema& table_schema,
+                                                         const std::vector<std::vector<char>>& records);
+
+    /**
+     * @brief Deletes the files of all of a table's indexes, e.g. when the table is dropped.
+     */
+    void remove_index_files(const std::filesystem::path& table_data_dir, const catalog::TableSchema& table_schema);
+}  // namespace table_index
+
+#endif  // SIMPLE_DB_TABLE_INDEX_H
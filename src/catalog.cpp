@@ -2,8 +2,12 @@
 // Created by Akshat Jain on 24/05/25.
 //
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 #include "simpledb/catalog.h"
 #include "simpledb/utils/logging.h"
 
@@ -11,10 +15,68 @@ using json = nlohmann::json;
 
 namespace catalog {
 
-    static std::vector<TableSchema> catalog;
+    // The tables in the order they were created, which is the order they are saved and listed in.
+    static std::vector<TableSchemaPtr> catalog;
+    // The same schemas by table name, for lookups.
+    static std::unordered_map<std::string, TableSchemaPtr> catalog_by_name;
+    // Protects catalog and catalog_by_name. Lookups take it shared, changes only take it exclusively to swap in the
+    // new tables once they are saved.
+    static std::shared_mutex catalog_mutex;
+    // Serializes the changes (and initialize()), which hold it while they save the catalog to disk. Protects
+    // catalog_file_path.
+    static std::mutex write_mutex;
     static std::filesystem::path catalog_file_path;
 
+    namespace {
+        // Replaces the in-memory catalog with the given tables. Needs write_mutex.
+        void install(std::vector<TableSchemaPtr> tables) {
+            std::unordered_map<std::string, TableSchemaPtr> by_name;
+            by_name.reserve(tables.size());
+            for (const TableSchemaPtr &table : tables) {
+                by_name.emplace(table->table_name, table);
+            }
+            std::unique_lock<std::shared_mutex> lock(catalog_mutex);
+            catalog.swap(tables);
+            catalog_by_name.swap(by_name);
+        }
+
+        // Writes the given tables to the catalog file. Needs write_mutex.
+        bool save(const std::vector<TableSchemaPtr> &tables) {
+            std::ofstream out(catalog_file_path);
+            if (!out.is_open()) {
+                logging::log.error("Failed to open catalog file for writing: {}", catalog_file_path.string());
+                std::cerr << "ERROR: Failed to open catalog file for writing: " << catalog_file_path << std::endl;
+                return false;
+            }
+
+            try {
+                json j = json::array();
+                for (const TableSchemaPtr &table : tables) {
+                    j.push_back(*table);
+                }
+                out << j.dump(2);
+                if (out.fail()) {
+                    logging::log.error("Failed to write updated catalog to disk: {}", catalog_file_path.string());
+                    std::cerr << "ERROR: Failed to write updated catalog to disk: " << catalog_file_path << std::endl;
+                    return false;
+                }
+            } catch (const std::exception &e) {
+                logging::log.error("Error while saving catalog to {}: {}", catalog_file_path.string(), e.what());
+                return false;
+            }
+            return true;
+        }
+
+        // The position of a table in the catalog, or catalog.end(). Needs write_mutex (or catalog_mutex).
+        std::vector<TableSchemaPtr>::const_iterator find_table(const std::string &table_name) {
+            return std::find_if(catalog.begin(), catalog.end(), [&](const TableSchemaPtr &ts) {
+                return ts->table_name == table_name;
+            });
+        }
+    }  // namespace
+
     void initialize(const std::filesystem::path &data_directory) {
+        std::lock_guard<std::mutex> write_guard(write_mutex);
         std::filesystem::path new_path = data_directory / "catalog.json";
 
         // If it’s already initialized for *this* path, do nothing
@@ -30,7 +92,7 @@ namespace catalog {
             // todo: In the future, we can consider refactoring this to maybe having a Catalog class returned to the
             // caller, which gets passed around instead of using a global state.
             logging::log.info("Re-initializing catalog: clearing previous state");
-            catalog.clear();
+            install({});
             catalog_file_path.clear();
         }
 
@@ -39,7 +101,7 @@ namespace catalog {
 
         if (!std::filesystem::exists(catalog_file_path)) {
             logging::log.warn("Catalog file does not exist: {}", catalog_file_path.string());
-            catalog = {};
+            install({});
             return;
         }
 
@@ -60,9 +122,13 @@ namespace catalog {
                 std::cerr << "ERROR: Failed to read data from catalog file: " << catalog_file_path << std::endl;
                 std::exit(EXIT_FAILURE);
             }
-            catalog = j.get<std::vector<TableSchema>>();
+            std::vector<TableSchemaPtr> tables;
+            for (TableSchema &table_schema : j.get<std::vector<TableSchema>>()) {
+                tables.push_back(std::make_shared<const TableSchema>(std::move(table_schema)));
+            }
             logging::log.info(
-                "Catalog loaded successfully from {}. Found {} table(s).", catalog_file_path.string(), catalog.size());
+                "Catalog loaded successfully from {}. Found {} table(s).", catalog_file_path.string(), tables.size());
+            install(std::move(tables));
         } catch (const json::parse_error &e) {
             logging::log.critical(
                 "Failed to parse JSON from catalog file {}: {}", catalog_file_path.string(), e.what());
@@ -86,113 +152,112 @@ namespace catalog {
     }
 
     bool table_exists(const std::string &table_name) {
-        return std::any_of(
-            catalog.begin(), catalog.end(), [&](const TableSchema &ts) { return ts.table_name == table_name; });
+        std::shared_lock<std::shared_mutex> lock(catalog_mutex);
+        return catalog_by_name.count(table_name) > 0;
     }
 
     bool add_table(const TableSchema &table_schema) {
+        std::lock_guard<std::mutex> write_guard(write_mutex);
         if (catalog_file_path.empty()) {
             logging::log.critical("Catalog has not been initialized. Call initialize() first.");
             return false;
         }
 
-        if (table_exists(table_schema.table_name)) {
+        if (find_table(table_schema.table_name) != catalog.end()) {
             logging::log.warn("Table '{}' already exists in the catalog.", table_schema.table_name);
             return false;
         }
 
-        catalog.push_back(table_schema);
+        // The change is saved first, and only then swapped in, so there is nothing to roll back if saving fails.
+        std::vector<TableSchemaPtr> tables = catalog;
+        tables.push_back(std::make_shared<const TableSchema>(table_schema));
         logging::log.info("Adding table '{}' to catalog.", table_schema.table_name);
-
-        std::ofstream out(catalog_file_path);
-        if (!out.is_open()) {
-            logging::log.error("Failed to open catalog file for writing: {}", catalog_file_path.string());
-            std::cerr << "ERROR: Failed to open catalog file for writing: " << catalog_file_path << std::endl;
-            catalog.pop_back();  // Rollback
-            return false;
-        }
-
-        try {
-            json j = catalog;
-            out << j.dump(2);
-            if (out.fail()) {
-                logging::log.error("Failed to write updated catalog to disk: {}", catalog_file_path.string());
-                std::cerr << "ERROR: Failed to write updated catalog to disk: " << catalog_file_path << std::endl;
-                catalog.pop_back();  // Rollback
-                return false;
-            }
-        } catch (const json::exception &e) {
-            logging::log.error(
-                "JSON serialization error while saving catalog for table '{}': {}", table_schema.table_name, e.what());
-            catalog.pop_back();  // Rollback
-            return false;
-        } catch (const std::exception &e) {
-            logging::log.error(
-                "Unexpected std::exception while saving catalog for table '{}': {}", table_schema.table_name, e.what());
-            catalog.pop_back();  // Rollback
+        if (!save(tables)) {
+            logging::log.error("Failed to save catalog for table '{}'.", table_schema.table_name);
             return false;
         }
+        install(std::move(tables));
 
         logging::log.info("Table '{}' added successfully and catalog saved.", table_schema.table_name);
         return true;
     }
 
     bool remove_table(const std::string &table_name) {
+        std::lock_guard<std::mutex> write_guard(write_mutex);
         if (catalog_file_path.empty()) {
             logging::log.critical("Catalog has not been initialized. Call initialize() first.");
             return false;
         }
 
         // Find the table
-        auto it = std::find_if(
-            catalog.begin(), catalog.end(), [&](const TableSchema &ts) { return ts.table_name == table_name; });
-
+        auto it = find_table(table_name);
         if (it == catalog.end()) {
             logging::log.warn("Attempt to remove table '{}', but it was not found in the catalog.", table_name);
             return false;  // Table not found
         }
 
-        // Table found, erase it from in-memory catalog
-        catalog.erase(it);
+        std::vector<TableSchemaPtr> tables = catalog;
+        tables.erase(tables.begin() + (it - catalog.begin()));
         logging::log.info("Removing table '{}' from catalog.", table_name);
+        if (!save(tables)) {
+            logging::log.error("Failed to save catalog after removing table '{}'.", table_name);
+            return false;
+        }
+        install(std::move(tables));
 
-        std::ofstream out(catalog_file_path);
-        if (!out.is_open()) {
-            logging::log.error("Failed to open catalog file for writing: {}", catalog_file_path.string());
-            std::cerr << "ERROR: Failed to open catalog file for writing: " << catalog_file_path << std::endl;
+        logging::log.info("Table '{}' removed successfully and catalog saved.", table_name);
+        return true;
+    }
+
+    bool add_index(const std::string &table_name, const IndexDefinition &index_definition) {
+        std::lock_guard<std::mutex> write_guard(write_mutex);
+        if (catalog_file_path.empty()) {
+            logging::log.critical("Catalog has not been initialized. Call initialize() first.");
             return false;
         }
 
-        try {
-            json j = catalog;
-            out << j.dump(2);
-            if (out.fail()) {
-                logging::log.error("Failed to write updated catalog to disk: {}", catalog_file_path.string());
-                std::cerr << "ERROR: Failed to write updated catalog to disk: " << catalog_file_path << std::endl;
-                return false;
-            }
-        } catch (const json::exception &e) {
-            logging::log.error(
-                "JSON serialization error while saving catalog after removing table '{}': {}", table_name, e.what());
+        auto it = find_table(table_name);
+        if (it == catalog.end()) {
+            logging::log.warn("Attempt to add index '{}' to table '{}', but the table was not found in the catalog.",
+                              index_definition.index_name,
+                              table_name);
             return false;
-        } catch (const std::exception &e) {
-            logging::log.error(
-                "Unexpected std::exception while saving catalog after removing table '{}': {}", table_name, e.what());
+        }
+        const TableSchema &old_schema = **it;
+        if (std::any_of(old_schema.indexes.begin(), old_schema.indexes.end(), [&](const IndexDefinition &index) {
+                return index.index_name == index_definition.index_name;
+            })) {
+            logging::log.warn("Index '{}' already exists on table '{}'.", index_definition.index_name, table_name);
             return false;
         }
 
-        logging::log.info("Table '{}' removed successfully and catalog saved.", table_name);
+        // The old schema may be in use by running queries, so the table gets a new one.
+        auto new_schema = std::make_shared<TableSchema>(old_schema);
+        new_schema->indexes.push_back(index_definition);
+        std::vector<TableSchemaPtr> tables = catalog;
+        tables[it - catalog.begin()] = std::move(new_schema);
+        logging::log.info("Adding index '{}' to table '{}' in catalog.", index_definition.index_name, table_name);
+        if (!save(tables)) {
+            logging::log.error("Failed to save catalog for index '{}'.", index_definition.index_name);
+            return false;
+        }
+        install(std::move(tables));
+
+        logging::log.info("Index '{}' added successfully and catalog saved.", index_definition.index_name);
         return true;
     }
 
-    std::optional<TableSchema> get_table_schema(const std::string &table_name) {
-        auto it = std::find_if(
-            catalog.begin(), catalog.end(), [&](const TableSchema &ts) { return ts.table_name == table_name; });
-        if (it != catalog.end()) {
-            return *it;
+    TableSchemaPtr get_table_schema(const std::string &table_name) {
+        std::shared_lock<std::shared_mutex> lock(catalog_mutex);
+        auto it = catalog_by_name.find(table_name);
+        if (it != catalog_by_name.end()) {
+            return it->second;
         }
-        return std::nullopt;
+        return nullptr;
     }
 
-    const std::vector<TableSchema> &get_all_schemas() { return catalog; }
+    std::vector<TableSchemaPtr> get_all_schemas() {
+        std::shared_lock<std::shared_mutex> lock(catalog_mutex);
+        return catalog;
+    }
 }  // namespace catalog
@@ -7,6 +7,8 @@
 #include <iostream>
 #include <filesystem>
 #include <cstring>
+#include <stdexcept>
+#include <string>
 
 #include "simpledb/utils/logging.h"
 
@@ -16,6 +18,8 @@ namespace config {
 
     const static char* ENV_DATA_DIR = "SIMPLE_DB_DATA_DIR";
     const static char* DEFAULT_DATA_DIR = "data";
+    const static char* ENV_WORK_MEM_MB = "SIMPLE_DB_WORK_MEM_MB";
+    const static char* ENV_THREADS = "SIMPLE_DB_THREADS";
 
     void init_config() {
         if (initialized) {
@@ -35,6 +39,26 @@ namespace config {
             std::cout << "Created data directory: " << config.data_dir << std::endl;
         }
 
+        // Set the memory budget of operators from the environment variable (in MiB), if given.
+        const char* env_work_mem = std::getenv(ENV_WORK_MEM_MB);
+        if (env_work_mem != nullptr && std::strlen(env_work_mem) > 0) {
+            try {
+                config.work_mem = std::stoull(env_work_mem) * 1024 * 1024;
+            } catch (const std::exception&) {
+                logging::log.error("Ignoring invalid {}: {}", ENV_WORK_MEM_MB, env_work_mem);
+            }
+        }
+
+        // Set the number of worker threads from the environment variable, if given.
+        const char* env_threads = std::getenv(ENV_THREADS);
+        if (env_threads != nullptr && std::strlen(env_threads) > 0) {
+            try {
+                config.num_threads = std::stoull(env_threads);
+            } catch (const std::exception&) {
+                logging::log.error("Ignoring invalid {}: {}", ENV_THREADS, env_threads);
+            }
+        }
+
         // Set the history file path.
         // This is done similar to ~/.sqlite_history, ~/.python_history, etc.
         config.history_file = std::filesystem::path(std::getenv("HOME")) / ".simpledb_history";
@@ -58,5 +82,8 @@ namespace config {
      * where the left operand is an output stream (like `std::cout`, which is a `std::ostream`)
      * and the right operand is a `const Config&`, this function should be called.
      */
-    std::ostream& operator<<(std::ostream& os, const Config& obj) { return os << "data_dir: " << obj.data_dir; }
+    std::ostream& operator<<(std::ostream& os, const Config& obj) {
+        return os << "data_dir: " << obj.data_dir << ", work_mem: " << obj.work_mem
+                  << ", num_threads: " << obj.num_threads;
+    }
 }  // namespace config
@@ -0,0 +1,110 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/csv.h"
+
+#include <stdexcept>
+
+namespace csv {
+    std::vector<std::string_view> split_into_chunks(std::string_view data, size_t target_size) {
+        std::vector<std::string_view> chunks;
+        size_t start = 0;
+        while (start < data.size()) {
+            size_t end = data.size();
+            if (data.size() - start > target_size) {
+                // Extend the chunk up to (and including) the next newline, so it ends on a record boundary.
+                size_t newline = data.find('\n', start + target_size - 1);
+                if (newline != std::string_view::npos) {
+                    end = newline + 1;
+                }
+            }
+            chunks.push_back(data.substr(start, end - start));
+            start = end;
+        }
+        return chunks;
+    }
+
+    bool Reader::next_record(std::vector<std::string>& fields) {
+        const size_t size = data_.size();
+
+        // 1. Skip empty lines.
+        while (pos_ < size) {
+            if (data_[pos_] == '\n') {
+                newlines_seen_++;
+                pos_++;
+            } else if (data_[pos_] == '\r' && pos_ + 1 < size && data_[pos_ + 1] == '\n') {
+                pos_++;
+            } else {
+                break;
+            }
+        }
+        if (pos_ >= size) {
+            return false;
+        }
+        line_number_ = newlines_seen_ + 1;
+
+        // 2. Read fields until the end of the line.
+        size_t num_fields = 0;
+        while (true) {
+            if (num_fields == fields.size()) {
+                fields.emplace_back();
+            }
+            std::string& field = fields[num_fields++];
+            field.clear();
+
+            if (pos_ < size && data_[pos_] == '"') {
+                // A quoted field, which ends at the next quote that isn't escaped by another quote.
+                pos_++;
+                while (true) {
+                    if (pos_ >= size || data_[pos_] == '\n') {
+                        throw std::runtime_error("Unterminated quoted field.");
+                    }
+                    char c = data_[pos_++];
+                    if (c == '"') {
+                        if (pos_ < size && data_[pos_] == '"') {
+                            field.push_back('"');
+                            pos_++;
+                            continue;
+                        }
+                        break;
+                    }
+                    field.push_back(c);
+                }
+                if (pos_ < size && data_[pos_] != ',' && data_[pos_] != '\n' && data_[pos_] != '\r') {
+                    throw std::runtime_error("Unexpected character after quoted field.");
+                }
+            } else {
+                // An unquoted field, which simply runs until the next delimiter.
+                size_t end = pos_;
+                while (end < size && data_[end] != ',' && data_[end] != '\n') {
+                    end++;
+                }
+                size_t field_end = end;
+                if (field_end > pos_ && data_[field_end - 1] == '\r' && (end == size || data_[end] == '\n')) {
+                    field_end--;  // Windows line ending.
+                }
+                field.assign(data_.data() + pos_, field_end - pos_);
+                pos_ = end;
+            }
+
+            if (pos_ < size && data_[pos_] == ',') {
+                pos_++;
+                continue;
+            }
+
+            // End of the record, consume the line break.
+            if (pos_ < size && data_[pos_] == '\r') {
+                pos_++;
+            }
+            if (pos_ < size && data_[pos_] == '\n') {
+                newlines_seen_++;
+                pos_++;
+            }
+            break;
+        }
+
+        fields.resize(num_fields);
+        return true;
+    }
+}  // namespace csv
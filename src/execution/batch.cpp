@@ -0,0 +1,98 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/execution/batch.h"
+
+#include <charconv>
+#include <string_view>
+#include <utility>
+
+namespace simpledb::execution {
+    namespace {
+        // Makes sure the vector that holds the column's values (and the null flags) has room for a full batch.
+        void reserve_batch(ColumnVector& column) {
+            if (column.type == command::Datatype::INT) {
+                if (column.ints.size() < BATCH_CAPACITY) {
+                    column.ints.resize(BATCH_CAPACITY);
+                }
+            } else if (column.texts.size() < BATCH_CAPACITY) {
+                column.texts.resize(BATCH_CAPACITY);
+            }
+            if (column.nulls.size() < BATCH_CAPACITY) {
+                column.nulls.resize(BATCH_CAPACITY);
+            }
+        }
+    }  // namespace
+
+    void ColumnVector::value_as_text(size_t row, std::string& value) const {
+        if (nulls[row]) {
+            value.clear();
+        } else if (type == command::Datatype::INT) {
+            char buffer[12];
+            char* end = std::to_chars(buffer, buffer + sizeof(buffer), ints[row]).ptr;
+            value.assign(buffer, end);
+        } else {
+            value.assign(texts[row]);
+        }
+    }
+
+    void Batch::reset(const std::vector<command::Datatype>& column_types) {
+        columns_.resize(column_types.size());
+        for (size_t i = 0; i < column_types.size(); ++i) {
+            columns_[i].type = column_types[i];
+            reserve_batch(columns_[i]);
+        }
+        size_ = 0;
+        has_selection_ = false;
+        selection_.clear();
+    }
+
+    void Batch::set_selection(std::vector<uint16_t>& selection) {
+        selection_.swap(selection);
+        has_selection_ = true;
+    }
+
+    void Batch::project(Batch& source, const std::vector<int>& columns) {
+        columns_.resize(columns.size());
+        // Where each source column went, so that a repeated column is copied from its first copy.
+        std::vector<int> moved_to(source.columns_.size(), -1);
+        for (size_t i = 0; i < columns.size(); ++i) {
+            int source_column = columns[i];
+            if (moved_to[source_column] == -1) {
+                std::swap(columns_[i], source.columns_[source_column]);
+                moved_to[source_column] = static_cast<int>(i);
+            } else {
+                columns_[i] = columns_[moved_to[source_column]];
+            }
+        }
+        size_ = source.size_;
+        has_selection_ = source.has_selection_;
+        selection_.swap(source.selection_);
+    }
+
+    void Batch::get_row(size_t row, row::Row& values) const {
+        values.resize(columns_.size());
+        for (size_t i = 0; i < columns_.size(); ++i) {
+            columns_[i].value_as_text(row, values[i]);
+        }
+    }
+
+    void read_record_column(const serializer::RecordLayout& layout,
+                            storage::RecordView record,
+                            size_t column_index,
+                            ColumnVector& column,
+                            size_t row) {
+        if (serializer::is_null(layout, record, column_index)) {
+            column.nulls[row] = 1;
+            return;
+        }
+        column.nulls[row] = 0;
+        if (column.type == command::Datatype::INT) {
+            column.ints[row] = serializer::read_int(layout, record, column_index);
+        } else {
+            std::string_view text = serializer::read_text(layout, record, column_index);
+            column.texts[row].assign(text.data(), text.size());
+        }
+    }
+}  // namespace simpledb::execution
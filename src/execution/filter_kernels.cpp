@@ -0,0 +1,75 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/execution/filter_kernels.h"
+
+#include "filter_kernels_internal.h"
+
+namespace simpledb::execution::kernels {
+    namespace {
+        // The kernel tables are indexed by ast::ComparisonOp.
+        static_assert(ast::ComparisonOp::EQUALS == 0 && ast::ComparisonOp::GREATER_THAN_OR_EQUAL == 5 &&
+                          NUM_COMPARISON_OPS == 6,
+                      "Kernel tables must have one entry per comparison operator, in ast::ComparisonOp order.");
+
+        template <ast::ComparisonOp Op, typename T>
+        size_t select_scalar(const T* values, size_t count, T constant, uint16_t* selection) {
+            return select_scalar_from<Op>(values, 0, count, constant, selection, 0);
+        }
+
+        template <ast::ComparisonOp Op, typename T>
+        void bitmap_scalar(const T* values, size_t count, T constant, uint64_t* bitmap) {
+            bitmap_scalar_from<Op>(values, 0, count, constant, bitmap);
+        }
+
+        const FilterKernels SCALAR_FILTER_KERNELS = {
+            InstructionSet::SCALAR,
+            SIMPLE_DB_FILTER_KERNEL_TABLE(select_scalar, int32_t),
+            SIMPLE_DB_FILTER_KERNEL_TABLE(select_scalar, int64_t),
+            SIMPLE_DB_FILTER_KERNEL_TABLE(bitmap_scalar, int32_t),
+            SIMPLE_DB_FILTER_KERNEL_TABLE(bitmap_scalar, int64_t),
+        };
+
+        InstructionSet detect() {
+#ifdef SIMPLE_DB_X86_FILTER_KERNELS
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) {
+                return InstructionSet::AVX2;
+            }
+            if (__builtin_cpu_supports("sse4.2")) {
+                return InstructionSet::SSE4_2;
+            }
+#endif
+            return InstructionSet::SCALAR;
+        }
+    }  // namespace
+
+    InstructionSet detect_instruction_set() {
+        static const InstructionSet instruction_set = detect();
+        return instruction_set;
+    }
+
+    const FilterKernels& get_filter_kernels() {
+        static const FilterKernels& kernels = get_filter_kernels(detect_instruction_set());
+        return kernels;
+    }
+
+    const FilterKernels& get_filter_kernels(InstructionSet instruction_set) {
+        // Never hand out kernels that the CPU can't run.
+        if (static_cast<int>(instruction_set) > static_cast<int>(detect_instruction_set())) {
+            instruction_set = detect_instruction_set();
+        }
+#ifdef SIMPLE_DB_X86_FILTER_KERNELS
+        switch (instruction_set) {
+            case InstructionSet::AVX2:
+                return AVX2_FILTER_KERNELS;
+            case InstructionSet::SSE4_2:
+                return SSE4_2_FILTER_KERNELS;
+            case InstructionSet::SCALAR:
+                break;
+        }
+#endif
+        return SCALAR_FILTER_KERNELS;
+    }
+}  // namespace simpledb::execution::kernels
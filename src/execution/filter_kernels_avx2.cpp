@@ -0,0 +1,113 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "filter_kernels_internal.h"
+
+#ifdef SIMPLE_DB_X86_FILTER_KERNELS
+
+#include <immintrin.h>
+
+#define SIMPLE_DB_AVX2 __attribute__((target("avx2")))
+
+namespace simpledb::execution::kernels {
+    namespace {
+        // 8 int32 values per register.
+        struct Int32x8 {
+            using Value = int32_t;
+            static constexpr size_t WIDTH = 8;
+
+            SIMPLE_DB_AVX2 static __m256i broadcast(int32_t value) { return _mm256_set1_epi32(value); }
+
+            SIMPLE_DB_AVX2 static __m256i load(const int32_t* values) {
+                return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values));
+            }
+
+            SIMPLE_DB_AVX2 static __m256i equal(__m256i lhs, __m256i rhs) { return _mm256_cmpeq_epi32(lhs, rhs); }
+
+            SIMPLE_DB_AVX2 static __m256i greater(__m256i lhs, __m256i rhs) { return _mm256_cmpgt_epi32(lhs, rhs); }
+
+            SIMPLE_DB_AVX2 static uint32_t mask(__m256i result) {
+                return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(result)));
+            }
+        };
+
+        // 4 int64 values per register.
+        struct Int64x4 {
+            using Value = int64_t;
+            static constexpr size_t WIDTH = 4;
+
+            SIMPLE_DB_AVX2 static __m256i broadcast(int64_t value) { return _mm256_set1_epi64x(value); }
+
+            SIMPLE_DB_AVX2 static __m256i load(const int64_t* values) {
+                return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values));
+            }
+
+            SIMPLE_DB_AVX2 static __m256i equal(__m256i lhs, __m256i rhs) { return _mm256_cmpeq_epi64(lhs, rhs); }
+
+            SIMPLE_DB_AVX2 static __m256i greater(__m256i lhs, __m256i rhs) { return _mm256_cmpgt_epi64(lhs, rhs); }
+
+            SIMPLE_DB_AVX2 static uint32_t mask(__m256i result) {
+                return static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(result)));
+            }
+        };
+
+        // Compares a register of values against the constants, one bit per value in the returned mask. There are
+        // only "equal" and "greater than" instructions, the other operators swap the operands and/or negate them.
+        template <ast::ComparisonOp Op, typename Lanes>
+        SIMPLE_DB_AVX2 inline uint32_t compare_mask(__m256i values, __m256i constants) {
+            constexpr uint32_t ALL_LANES = (1u << Lanes::WIDTH) - 1;
+            if constexpr (Op == ast::ComparisonOp::EQUALS) {
+                return Lanes::mask(Lanes::equal(values, constants));
+            } else if constexpr (Op == ast::ComparisonOp::NOT_EQUALS) {
+                return ~Lanes::mask(Lanes::equal(values, constants)) & ALL_LANES;
+            } else if constexpr (Op == ast::ComparisonOp::LESS_THAN) {
+                return Lanes::mask(Lanes::greater(constants, values));
+            } else if constexpr (Op == ast::ComparisonOp::LESS_THAN_OR_EQUAL) {
+                return ~Lanes::mask(Lanes::greater(values, constants)) & ALL_LANES;
+            } else if constexpr (Op == ast::ComparisonOp::GREATER_THAN) {
+                return Lanes::mask(Lanes::greater(values, constants));
+            } else {
+                return ~Lanes::mask(Lanes::greater(constants, values)) & ALL_LANES;
+            }
+        }
+
+        template <ast::ComparisonOp Op, typename Lanes>
+        SIMPLE_DB_AVX2 size_t select(const typename Lanes::Value* values,
+                                     size_t count,
+                                     typename Lanes::Value constant,
+                                     uint16_t* selection) {
+            const __m256i constants = Lanes::broadcast(constant);
+            size_t selected = 0;
+            size_t i = 0;
+            for (; i + Lanes::WIDTH <= count; i += Lanes::WIDTH) {
+                uint32_t mask = compare_mask<Op, Lanes>(Lanes::load(values + i), constants);
+                selected = append_mask(mask, i, selection, selected);
+            }
+            return select_scalar_from<Op>(values, i, count, constant, selection, selected);
+        }
+
+        template <ast::ComparisonOp Op, typename Lanes>
+        SIMPLE_DB_AVX2 void bitmap(const typename Lanes::Value* values,
+                                   size_t count,
+                                   typename Lanes::Value constant,
+                                   uint64_t* bitmap) {
+            const __m256i constants = Lanes::broadcast(constant);
+            size_t i = 0;
+            for (; i + Lanes::WIDTH <= count; i += Lanes::WIDTH) {
+                append_mask_to_bitmap(compare_mask<Op, Lanes>(Lanes::load(values + i), constants), i, bitmap);
+            }
+            bitmap_scalar_from<Op>(values, i, count, constant, bitmap);
+        }
+    }  // namespace
+
+    const FilterKernels AVX2_FILTER_KERNELS = {
+        InstructionSet::AVX2,
+        SIMPLE_DB_FILTER_KERNEL_TABLE(select, Int32x8),
+        SIMPLE_DB_FILTER_KERNEL_TABLE(select, Int64x4),
+        SIMPLE_DB_FILTER_KERNEL_TABLE(bitmap, Int32x8),
+        SIMPLE_DB_FILTER_KERNEL_TABLE(bitmap, Int64x4),
+    };
+}  // namespace simpledb::execution::kernels
+
+#endif  // SIMPLE_DB_X86_FILTER_KERNELS
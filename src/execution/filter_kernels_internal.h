@@ -0,0 +1,103 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#ifndef SIMPLE_DB_FILTER_KERNELS_INTERNAL_H
+#define SIMPLE_DB_FILTER_KERNELS_INTERNAL_H
+
+#include "simpledb/execution/filter_kernels.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// The SIMD kernels are written with GCC/Clang target attributes, so that they don't need any special compile flags
+// and the binary still runs on CPUs without these instruction sets.
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SIMPLE_DB_X86_FILTER_KERNELS 1
+#endif
+
+// Builds a row of an instruction set's kernel table, from a template on the comparison operator (followed by the
+// given template arguments).
+#define SIMPLE_DB_FILTER_KERNEL_TABLE(kernel, ...)                                                                    \
+    {                                                                                                                 \
+        &kernel<ast::ComparisonOp::EQUALS, __VA_ARGS__>, &kernel<ast::ComparisonOp::NOT_EQUALS, __VA_ARGS__>,         \
+            &kernel<ast::ComparisonOp::LESS_THAN, __VA_ARGS__>,                                                       \
+            &kernel<ast::ComparisonOp::LESS_THAN_OR_EQUAL, __VA_ARGS__>,                                              \
+            &kernel<ast::ComparisonOp::GREATER_THAN, __VA_ARGS__>,                                                    \
+            &kernel<ast::ComparisonOp::GREATER_THAN_OR_EQUAL, __VA_ARGS__>                                            \
+    }
+
+namespace simpledb::execution::kernels {
+#ifdef SIMPLE_DB_X86_FILTER_KERNELS
+    // Defined in filter_kernels_sse.cpp and filter_kernels_avx2.cpp.
+    extern const FilterKernels SSE4_2_FILTER_KERNELS;
+    extern const FilterKernels AVX2_FILTER_KERNELS;
+#endif
+
+    // The scalar loops are also used by the SIMD kernels, for the values that don't fill a whole register. Only the
+    // kernels' files use these helpers, hence the anonymous namespace.
+    namespace {
+        template <ast::ComparisonOp Op, typename T>
+        inline bool compare_scalar(T lhs, T rhs) {
+            if constexpr (Op == ast::ComparisonOp::EQUALS) {
+                return lhs == rhs;
+            } else if constexpr (Op == ast::ComparisonOp::NOT_EQUALS) {
+                return lhs != rhs;
+            } else if constexpr (Op == ast::ComparisonOp::LESS_THAN) {
+                return lhs < rhs;
+            } else if constexpr (Op == ast::ComparisonOp::LESS_THAN_OR_EQUAL) {
+                return lhs <= rhs;
+            } else if constexpr (Op == ast::ComparisonOp::GREATER_THAN) {
+                return lhs > rhs;
+            } else {
+                return lhs >= rhs;
+            }
+        }
+
+        // Selects the matching values in [begin, count), appending their indices after the `selected` ones.
+        template <ast::ComparisonOp Op, typename T>
+        inline size_t select_scalar_from(
+            const T* values, size_t begin, size_t count, T constant, uint16_t* selection, size_t selected) {
+            for (size_t i = begin; i < count; ++i) {
+                // Branch-free: always write the index, and only keep it (by moving on) if the value matches.
+                selection[selected] = static_cast<uint16_t>(i);
+                selected += compare_scalar<Op>(values[i], constant);
+            }
+            return selected;
+        }
+
+        // Writes the bits of the values in [begin, count), the bits before `begin` must already be written.
+        template <ast::ComparisonOp Op, typename T>
+        inline void bitmap_scalar_from(const T* values, size_t begin, size_t count, T constant, uint64_t* bitmap) {
+            for (size_t i = begin; i < count; ++i) {
+                uint64_t bit = uint64_t{1} << (i % 64);
+                if (i % 64 == 0) {
+                    bitmap[i / 64] = 0;
+                }
+                bitmap[i / 64] |= compare_scalar<Op>(values[i], constant) ? bit : 0;
+            }
+        }
+
+#ifdef SIMPLE_DB_X86_FILTER_KERNELS
+        // Appends the indices of the set bits of a SIMD comparison mask, for the values starting at `base`.
+        inline size_t append_mask(uint32_t mask, size_t base, uint16_t* selection, size_t selected) {
+            while (mask != 0) {
+                selection[selected++] = static_cast<uint16_t>(base + __builtin_ctz(mask));
+                mask &= mask - 1;
+            }
+            return selected;
+        }
+
+        // Ors a SIMD comparison mask, for the values starting at `base`, into the bitmap. The word is cleared when
+        // `base` starts it, registers never straddle two words since their widths divide 64.
+        inline void append_mask_to_bitmap(uint32_t mask, size_t base, uint64_t* bitmap) {
+            if (base % 64 == 0) {
+                bitmap[base / 64] = 0;
+            }
+            bitmap[base / 64] |= static_cast<uint64_t>(mask) << (base % 64);
+        }
+#endif
+    }  // namespace
+}  // namespace simpledb::execution::kernels
+
+#endif  // SIMPLE_DB_FILTER_KERNELS_INTERNAL_H
@@ -0,0 +1,113 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "filter_kernels_internal.h"
+
+#ifdef SIMPLE_DB_X86_FILTER_KERNELS
+
+#include <nmmintrin.h>
+
+// SSE4.2 for the int64 comparisons (the int32 ones only need SSE2).
+#define SIMPLE_DB_SSE4_2 __attribute__((target("sse4.2")))
+
+namespace simpledb::execution::kernels {
+    namespace {
+        // 4 int32 values per register.
+        struct Int32x4 {
+            using Value = int32_t;
+            static constexpr size_t WIDTH = 4;
+
+            SIMPLE_DB_SSE4_2 static __m128i broadcast(int32_t value) { return _mm_set1_epi32(value); }
+
+            SIMPLE_DB_SSE4_2 static __m128i load(const int32_t* values) {
+                return _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+            }
+
+            SIMPLE_DB_SSE4_2 static __m128i equal(__m128i lhs, __m128i rhs) { return _mm_cmpeq_epi32(lhs, rhs); }
+
+            SIMPLE_DB_SSE4_2 static __m128i greater(__m128i lhs, __m128i rhs) { return _mm_cmpgt_epi32(lhs, rhs); }
+
+            SIMPLE_DB_SSE4_2 static uint32_t mask(__m128i result) {
+                return static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(result)));
+            }
+        };
+
+        // 2 int64 values per register.
+        struct Int64x2 {
+            using Value = int64_t;
+            static constexpr size_t WIDTH = 2;
+
+            SIMPLE_DB_SSE4_2 static __m128i broadcast(int64_t value) { return _mm_set1_epi64x(value); }
+
+            SIMPLE_DB_SSE4_2 static __m128i load(const int64_t* values) {
+                return _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+            }
+
+            SIMPLE_DB_SSE4_2 static __m128i equal(__m128i lhs, __m128i rhs) { return _mm_cmpeq_epi64(lhs, rhs); }
+
+            SIMPLE_DB_SSE4_2 static __m128i greater(__m128i lhs, __m128i rhs) { return _mm_cmpgt_epi64(lhs, rhs); }
+
+            SIMPLE_DB_SSE4_2 static uint32_t mask(__m128i result) {
+                return static_cast<uint32_t>(_mm_movemask_pd(_mm_castsi128_pd(result)));
+            }
+        };
+
+        // Same as the AVX2 version, with half as many values per register.
+        template <ast::ComparisonOp Op, typename Lanes>
+        SIMPLE_DB_SSE4_2 inline uint32_t compare_mask(__m128i values, __m128i constants) {
+            constexpr uint32_t ALL_LANES = (1u << Lanes::WIDTH) - 1;
+            if constexpr (Op == ast::ComparisonOp::EQUALS) {
+                return Lanes::mask(Lanes::equal(values, constants));
+            } else if constexpr (Op == ast::ComparisonOp::NOT_EQUALS) {
+                return ~Lanes::mask(Lanes::equal(values, constants)) & ALL_LANES;
+            } else if constexpr (Op == ast::ComparisonOp::LESS_THAN) {
+                return Lanes::mask(Lanes::greater(constants, values));
+            } else if constexpr (Op == ast::ComparisonOp::LESS_THAN_OR_EQUAL) {
+                return ~Lanes::mask(Lanes::greater(values, constants)) & ALL_LANES;
+            } else if constexpr (Op == ast::ComparisonOp::GREATER_THAN) {
+                return Lanes::mask(Lanes::greater(values, constants));
+            } else {
+                return ~Lanes::mask(Lanes::greater(constants, values)) & ALL_LANES;
+            }
+        }
+
+        template <ast::ComparisonOp Op, typename Lanes>
+        SIMPLE_DB_SSE4_2 size_t select(const typename Lanes::Value* values,
+                                       size_t count,
+                                       typename Lanes::Value constant,
+                                       uint16_t* selection) {
+            const __m128i constants = Lanes::broadcast(constant);
+            size_t selected = 0;
+            size_t i = 0;
+            for (; i + Lanes::WIDTH <= count; i += Lanes::WIDTH) {
+                uint32_t mask = compare_mask<Op, Lanes>(Lanes::load(values + i), constants);
+                selected = append_mask(mask, i, selection, selected);
+            }
+            return select_scalar_from<Op>(values, i, count, constant, selection, selected);
+        }
+
+        template <ast::ComparisonOp Op, typename Lanes>
+        SIMPLE_DB_SSE4_2 void bitmap(const typename Lanes::Value* values,
+                                     size_t count,
+                                     typename Lanes::Value constant,
+                                     uint64_t* bitmap) {
+            const __m128i constants = Lanes::broadcast(constant);
+            size_t i = 0;
+            for (; i + Lanes::WIDTH <= count; i += Lanes::WIDTH) {
+                append_mask_to_bitmap(compare_mask<Op, Lanes>(Lanes::load(values + i), constants), i, bitmap);
+            }
+            bitmap_scalar_from<Op>(values, i, count, constant, bitmap);
+        }
+    }  // namespace
+
+    const FilterKernels SSE4_2_FILTER_KERNELS = {
+        InstructionSet::SSE4_2,
+        SIMPLE_DB_FILTER_KERNEL_TABLE(select, Int32x4),
+        SIMPLE_DB_FILTER_KERNEL_TABLE(select, Int64x2),
+        SIMPLE_DB_FILTER_KERNEL_TABLE(bitmap, Int32x4),
+        SIMPLE_DB_FILTER_KERNEL_TABLE(bitmap, Int64x2),
+    };
+}  // namespace simpledb::execution::kernels
+
+#endif  // SIMPLE_DB_X86_FILTER_KERNELS
@@ -5,82 +5,51 @@
 #include "simpledb/execution/filter_operator.h"
 
 #include "simpledb/catalog.h"
-#include "simpledb/serializer.h"
+#include <stdexcept>
 #include <string>
 #include <vector>
 
 namespace simpledb::execution {
-    // TODO: Implement proper type-aware comparison logic
-    // Currently all comparisons are done as strings, which works for basic cases but has limitations:
-    // Numeric comparisons use lexicographic ordering ("10" < "2" returns true)
-    // To fix this, we should ideally preserve the type information during parsing, instead of blindly converting
-    // everything to string.
-    bool evaluate(ast::ComparisonOp op, const std::string& lhs, const std::string& rhs) {
-        switch (op) {
-            case ast::ComparisonOp::EQUALS:
-                return lhs == rhs;
-            case ast::ComparisonOp::NOT_EQUALS:
-                return lhs != rhs;
-            case ast::ComparisonOp::LESS_THAN:
-                return lhs < rhs;
-            case ast::ComparisonOp::LESS_THAN_OR_EQUAL:
-                return lhs <= rhs;
-            case ast::ComparisonOp::GREATER_THAN:
-                return lhs > rhs;
-            case ast::ComparisonOp::GREATER_THAN_OR_EQUAL:
-                return lhs >= rhs;
-            default:
-                throw std::runtime_error("Unsupported comparison operator.");
+    namespace {
+        CompiledPredicate compile_where_clause(const std::string& table_name,
+                                               const ast::WhereClause& where_clause,
+                                               const Operator& child) {
+            catalog::TableSchemaPtr table_schema = catalog::get_table_schema(table_name);
+            if (!table_schema) {
+                throw std::runtime_error("Table not found in catalog: " + table_name);
+            }
+            CompiledPredicate predicate = CompiledPredicate::compile(where_clause, *table_schema);
+            // The child may not return all columns of the table, look for the WHERE column where it actually is.
+            if (std::optional<row::Signature> signature = child.signature()) {
+                predicate.set_row_signature(signature.value());
+            }
+            return predicate;
         }
-    }
+    }  // namespace
 
     FilterOperator::FilterOperator(std::string table_name,
                                    std::unique_ptr<simpledb::execution::Operator> child,
                                    ast::WhereClause where_clause)
-        : table_name_(table_name), child_(std::move(child)), where_clause_(where_clause) {
-        std::optional<catalog::TableSchema> table_schema_optional = catalog::get_table_schema(table_name_);
-        if (!table_schema_optional) {
-            throw std::runtime_error("Table not found in catalog: " + table_name_);
-        }
-
-        const catalog::TableSchema& table_schema = table_schema_optional.value();
-        for (size_t i = 0; i < table_schema.column_definitions.size(); ++i) {
-            if (table_schema.column_definitions[i].column_name == where_clause_.column_name) {
-                // todo: We might need a way to propagate the row signature through the operator pipeline.
-                // The current implementation is inherently assuming that the FilterOperator is getting the row
-                // with all columns in the same order as defined in the table schema.
-                where_column_index_ = (int)i;
-                if (table_schema.column_definitions[i].type == command::Datatype::INT) {
-                    // For INT columns, ensure the WHERE clause value is a valid integer.
-                    try {
-                        std::stoi(where_clause_.value);
-                    } catch (const std::exception& e) {
-                        throw std::runtime_error(
-                            "WHERE clause value is not a valid integer for column: " + where_clause_.column_name +
-                            ". Expected INT, got '" + where_clause_.value + "'");
-                    }
-                }
-                return;
+        : table_name_(table_name),
+          child_(std::move(child)),
+          where_clause_(where_clause),
+          predicate_(compile_where_clause(table_name_, where_clause_, *child_)) {}
+
+    bool FilterOperator::next_batch(Batch& batch) {
+        // Fetches batches from the child operator until one has rows that satisfy the WHERE clause, or the child
+        // runs out of rows.
+        while (child_->next_batch(batch)) {
+            predicate_.filter(batch, selection_);
+            batch.set_selection(selection_);
+            if (batch.num_selected() > 0) {
+                return true;
             }
         }
-
-        throw std::runtime_error("WHERE clause column \"" + where_clause_.column_name + "\" not found in table " +
-                                 table_name_);
+        return false;
     }
 
-    std::optional<row::Row> FilterOperator::next() {
-        while (true) {
-            std::optional<row::Row> next = child_->next();
-            if (!next.has_value()) {
-                // If the child operator has no more rows, return std::nullopt.
-                return std::nullopt;
-            }
-
-            if (!evaluate(where_clause_.op, next.value()[where_column_index_], where_clause_.value)) {
-                continue;  // Row does not satisfy the WHERE clause, fetch the next row.
-            }
-
-            return next;
-        }
+    std::optional<row::Signature> FilterOperator::signature() const {
+        // Filtering doesn't change the shape of the rows.
+        return child_->signature();
     }
 }  // namespace simpledb::execution
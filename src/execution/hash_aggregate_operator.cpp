@@ -0,0 +1,511 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/execution/hash_aggregate_operator.h"
+
+#include "simpledb/catalog.h"
+#include "spill_file_internal.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+namespace simpledb::execution {
+    namespace {
+        // Each level of spilling splits the groups by the next PARTITION_BITS bits of their hash (from the top, as
+        // the hash table slots use the bottom bits).
+        constexpr size_t PARTITION_BITS = 4;
+        static_assert(HashAggregateOperator::NUM_SPILL_PARTITIONS == 1 << PARTITION_BITS);
+        constexpr size_t MAX_SPILL_DEPTH = 64 / PARTITION_BITS;
+
+        constexpr size_t INITIAL_NUM_SLOTS = 1024;
+
+        uint64_t hash_key(std::string_view key) { return std::hash<std::string_view>{}(key); }
+
+        int64_t int_value(const ColumnVector& column, size_t row) {
+            // Operators that don't produce batches themselves hand out every value as TEXT.
+            return column.type == command::Datatype::INT ? column.ints[row] : std::stoll(column.texts[row]);
+        }
+
+        // Appends a GROUP BY value to a group's key: a NULL flag, then the INT's 4 bytes, or the TEXT's length and
+        // bytes.
+        void append_key_value(const ColumnVector& column, size_t row, command::Datatype type, std::string& key) {
+            if (column.nulls[row]) {
+                key.push_back(0);
+                return;
+            }
+            key.push_back(1);
+            if (type == command::Datatype::INT) {
+                int32_t value = static_cast<int32_t>(int_value(column, row));
+                key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+            } else {
+                const std::string& text = column.texts[row];
+                uint32_t length = static_cast<uint32_t>(text.size());
+                key.append(reinterpret_cast<const char*>(&length), sizeof(length));
+                key.append(text);
+            }
+        }
+
+        // Reads a GROUP BY value back from a group's key, moving the position past it. Returns false for NULL.
+        bool read_key_value(std::string_view key, size_t& position, command::Datatype type, std::string& value) {
+            if (key[position++] == 0) {
+                return false;
+            }
+            if (type == command::Datatype::INT) {
+                int32_t int_value;
+                std::memcpy(&int_value, key.data() + position, sizeof(int_value));
+                position += sizeof(int_value);
+                value = std::to_string(int_value);
+                return true;
+            }
+            uint32_t length;
+            std::memcpy(&length, key.data() + position, sizeof(length));
+            position += sizeof(length);
+            value.assign(key.data() + position, length);
+            position += length;
+            return true;
+        }
+
+        catalog::TableSchemaPtr find_table_schema(const std::string& table_name) {
+            catalog::TableSchemaPtr table_schema = catalog::get_table_schema(table_name);
+            if (table_schema == nullptr) {
+                throw std::runtime_error("Table not found in catalog: " + table_name);
+            }
+            return table_schema;
+        }
+
+        // Whether a value replaces the current MIN or MAX.
+        template <typename T>
+        bool replaces(ast::AggregateFunction function, const T& value, const T& current) {
+            return function == ast::AggregateFunction::MIN ? value < current : value > current;
+        }
+    }  // namespace
+
+    HashAggregateOperator::HashAggregateOperator(const std::string& table_name,
+                                                 std::unique_ptr<Operator> child,
+                                                 std::vector<ast::SelectItem> select_items,
+                                                 const std::vector<std::string>& group_by,
+                                                 size_t memory_budget,
+                                                 std::filesystem::path spill_dir)
+        : HashAggregateOperator(*find_table_schema(table_name),
+                                std::move(child),
+                                std::move(select_items),
+                                group_by,
+                                memory_budget,
+                                std::move(spill_dir)) {}
+
+    HashAggregateOperator::HashAggregateOperator(const catalog::TableSchema& table_schema,
+                                                 std::unique_ptr<Operator> child,
+                                                 std::vector<ast::SelectItem> select_items,
+                                                 const std::vector<std::string>& group_by,
+                                                 size_t memory_budget,
+                                                 std::filesystem::path spill_dir)
+        : child_(std::move(child)),
+          select_items_(std::move(select_items)),
+          memory_budget_(memory_budget),
+          spill_dir_(std::move(spill_dir)) {
+        const std::vector<command::ColumnDefinition>& column_definitions = table_schema.column_definitions;
+
+        // Finds a column in the child's rows, which may not hold all columns of the table.
+        std::optional<row::Signature> child_signature = child_->signature();
+        auto find_column = [&](const std::string& column_name, size_t& position, command::Datatype& type) {
+            auto it = std::find_if(column_definitions.begin(),
+                                   column_definitions.end(),
+                                   [&](const command::ColumnDefinition& c) { return c.column_name == column_name; });
+            if (it == column_definitions.end()) {
+                throw std::runtime_error("Column not found in table schema: " + column_name);
+            }
+            type = it->type;
+            position = static_cast<size_t>(it - column_definitions.begin());
+            if (child_signature.has_value()) {
+                auto child_it = std::find(child_signature->begin(), child_signature->end(), position);
+                if (child_it == child_signature->end()) {
+                    throw std::runtime_error("Column is missing from the rows of the child operator: " + column_name);
+                }
+                position = static_cast<size_t>(child_it - child_signature->begin());
+            }
+        };
+
+        for (const std::string& column_name : group_by) {
+            GroupColumn group_column{};
+            find_column(column_name, group_column.column, group_column.type);
+            group_columns_.push_back(group_column);
+        }
+
+        for (const ast::SelectItem& item : select_items_) {
+            if (!item.aggregate.has_value()) {
+                auto it = std::find(group_by.begin(), group_by.end(), item.column_name);
+                if (it == group_by.end()) {
+                    throw std::runtime_error("Column '" + item.column_name +
+                                             "' must appear in the GROUP BY clause or be used in an aggregate "
+                                             "function.");
+                }
+                output_columns_.push_back({true, static_cast<size_t>(it - group_by.begin())});
+                continue;
+            }
+
+            Aggregate aggregate{item.aggregate.value(), std::nullopt, command::Datatype::INT};
+            if (!item.column_name.empty()) {
+                size_t position = 0;
+                find_column(item.column_name, position, aggregate.type);
+                aggregate.column = position;
+            }
+            if ((aggregate.function == ast::AggregateFunction::SUM ||
+                 aggregate.function == ast::AggregateFunction::AVG) &&
+                aggregate.type == command::Datatype::TEXT) {
+                throw std::runtime_error("Can't compute " + ast::select_item_name(item) + " of a TEXT column.");
+            }
+            output_columns_.push_back({false, aggregates_.size()});
+            aggregates_.push_back(aggregate);
+        }
+        output_types_.assign(output_columns_.size(), command::Datatype::TEXT);
+        slots_.assign(INITIAL_NUM_SLOTS, 0);
+    }
+
+    HashAggregateOperator::~HashAggregateOperator() {
+        for (const std::filesystem::path& path : spill_files_) {
+            std::error_code error;
+            std::filesystem::remove(path, error);
+        }
+    }
+
+    bool HashAggregateOperator::next_batch(Batch& batch) {
+        if (!built_) {
+            build();
+            built_ = true;
+        }
+        batch.reset(output_types_);
+        size_t size = 0;
+        while (size < BATCH_CAPACITY) {
+            if (next_group_ == group_keys_.size()) {
+                if (!load_next_partition()) {
+                    break;
+                }
+                continue;
+            }
+            output_group(next_group_++, batch, size++);
+        }
+        batch.set_size(size);
+        return size > 0;
+    }
+
+    void HashAggregateOperator::build() {
+        SpillWriter writer;
+        Batch input;
+        while (child_->next_batch(input)) {
+            add_batch(input);
+            if (memory_usage_ > memory_budget_) {
+                spill_groups(writer);
+            }
+        }
+        // The child won't be read anymore, release what it holds.
+        child_.reset();
+
+        // Without GROUP BY, there is one result row even if there were no rows at all (e.g. a COUNT(*) of 0).
+        if (group_columns_.empty() && group_keys_.empty() && writer.files.empty()) {
+            find_or_add_group("", hash_key(""));
+        }
+        if (!writer.files.empty()) {
+            // Everything goes to the partitions, so that each group's partial results get merged when reading them.
+            spill_groups(writer);
+            finish_spill(writer);
+        }
+        next_group_ = 0;
+    }
+
+    void HashAggregateOperator::add_batch(const Batch& batch) {
+        const size_t num_rows = batch.num_selected();
+        row_groups_.resize(num_rows);
+        if (group_columns_.empty()) {
+            // All rows are in the one group.
+            uint32_t group = find_or_add_group("", hash_key(""));
+            std::fill(row_groups_.begin(), row_groups_.end(), group);
+        } else {
+            for (size_t i = 0; i < num_rows; ++i) {
+                const size_t row = batch.selected(i);
+                key_.clear();
+                for (const GroupColumn& group_column : group_columns_) {
+                    append_key_value(batch.column(group_column.column), row, group_column.type, key_);
+                }
+                row_groups_[i] = find_or_add_group(key_, hash_key(key_));
+            }
+        }
+
+        // One loop per aggregate function, specialized for the function and the type of its column.
+        for (size_t a = 0; a < aggregates_.size(); ++a) {
+            const Aggregate& aggregate = aggregates_[a];
+            if (!aggregate.column.has_value()) {
+                // COUNT(*)
+                for (size_t i = 0; i < num_rows; ++i) {
+                    accumulator(row_groups_[i], a).count += 1;
+                }
+                continue;
+            }
+
+            const ColumnVector& column = batch.column(aggregate.column.value());
+            switch (aggregate.function) {
+                case ast::AggregateFunction::COUNT:
+                    for (size_t i = 0; i < num_rows; ++i) {
+                        accumulator(row_groups_[i], a).count += column.nulls[batch.selected(i)] ? 0 : 1;
+                    }
+                    break;
+                case ast::AggregateFunction::SUM:
+                case ast::AggregateFunction::AVG:
+                    for (size_t i = 0; i < num_rows; ++i) {
+                        const size_t row = batch.selected(i);
+                        if (!column.nulls[row]) {
+                            Accumulator& acc = accumulator(row_groups_[i], a);
+                            acc.count += 1;
+                            acc.int_value += int_value(column, row);
+                        }
+                    }
+                    break;
+                case ast::AggregateFunction::MIN:
+                case ast::AggregateFunction::MAX:
+                    if (aggregate.type == command::Datatype::INT) {
+                        for (size_t i = 0; i < num_rows; ++i) {
+                            const size_t row = batch.selected(i);
+                            if (column.nulls[row]) {
+                                continue;
+                            }
+                            Accumulator& acc = accumulator(row_groups_[i], a);
+                            const int64_t value = int_value(column, row);
+                            if (acc.count == 0 || replaces(aggregate.function, value, acc.int_value)) {
+                                acc.int_value = value;
+                            }
+                            acc.count += 1;
+                        }
+                    } else {
+                        for (size_t i = 0; i < num_rows; ++i) {
+                            const size_t row = batch.selected(i);
+                            if (column.nulls[row]) {
+                                continue;
+                            }
+                            Accumulator& acc = accumulator(row_groups_[i], a);
+                            const std::string& value = column.texts[row];
+                            if (acc.count == 0 || replaces(aggregate.function, value, acc.text_value)) {
+                                memory_usage_ = memory_usage_ - acc.text_value.size() + value.size();
+                                acc.text_value = value;
+                            }
+                            acc.count += 1;
+                        }
+                    }
+                    break;
+            }
+        }
+    }
+
+    uint32_t HashAggregateOperator::find_or_add_group(std::string_view key, uint64_t hash) {
+        const size_t mask = slots_.size() - 1;
+        size_t slot = hash & mask;
+        while (slots_[slot] != 0) {
+            const uint32_t group = slots_[slot] - 1;
+            if (group_hashes_[group] == hash && group_keys_[group] == key) {
+                return group;
+            }
+            slot = (slot + 1) & mask;
+        }
+
+        const uint32_t group = static_cast<uint32_t>(group_keys_.size());
+        slots_[slot] = group + 1;
+        group_hashes_.push_back(hash);
+        group_keys_.emplace_back(key);
+        accumulators_.resize(accumulators_.size() + aggregates_.size());
+        // The key, the group's entries in the vectors, and its share of the slots.
+        memory_usage_ += key.size() + sizeof(uint64_t) + sizeof(std::string) +
+                         aggregates_.size() * sizeof(Accumulator) + 2 * sizeof(uint32_t);
+
+        // Keep the table at most half full, so that probe sequences stay short.
+        if (group_keys_.size() * 2 > slots_.size()) {
+            slots_.assign(slots_.size() * 2, 0);
+            const size_t new_mask = slots_.size() - 1;
+            for (uint32_t g = 0; g < group_hashes_.size(); ++g) {
+                size_t s = group_hashes_[g] & new_mask;
+                while (slots_[s] != 0) {
+                    s = (s + 1) & new_mask;
+                }
+                slots_[s] = g + 1;
+            }
+        }
+        return group;
+    }
+
+    void HashAggregateOperator::clear_groups() {
+        slots_.assign(INITIAL_NUM_SLOTS, 0);
+        group_hashes_.clear();
+        group_keys_.clear();
+        accumulators_.clear();
+        memory_usage_ = 0;
+        next_group_ = 0;
+    }
+
+    void HashAggregateOperator::spill_groups(SpillWriter& writer) {
+        if (writer.files.empty()) {
+            std::filesystem::create_directories(spill_dir_);
+            for (size_t p = 0; p < NUM_SPILL_PARTITIONS; ++p) {
+                std::filesystem::path path = spill::unique_path(spill_dir_, "aggregate");
+                writer.files.emplace_back(path, std::ios::binary | std::ios::trunc);
+                spill_files_.push_back(path);
+                if (!writer.files.back()) {
+                    throw std::runtime_error("Could not create spill file: " + path.string());
+                }
+                writer.paths.push_back(std::move(path));
+            }
+            writer.num_groups.assign(NUM_SPILL_PARTITIONS, 0);
+        }
+
+        const size_t shift = 64 - PARTITION_BITS * (writer.depth + 1);
+        for (uint32_t group = 0; group < group_keys_.size(); ++group) {
+            const size_t partition = (group_hashes_[group] >> shift) & (NUM_SPILL_PARTITIONS - 1);
+            std::ofstream& file = writer.files[partition];
+            writer.num_groups[partition] += 1;
+            spill::write_string(file, group_keys_[group]);
+            for (size_t a = 0; a < aggregates_.size(); ++a) {
+                const Accumulator& acc = accumulator(group, a);
+                spill::write_value(file, acc.count);
+                spill::write_value(file, acc.int_value);
+                spill::write_string(file, acc.text_value);
+            }
+        }
+        clear_groups();
+    }
+
+    void HashAggregateOperator::finish_spill(SpillWriter& writer) {
+        for (size_t p = 0; p < writer.files.size(); ++p) {
+            writer.files[p].close();
+            if (writer.files[p].fail()) {
+                throw std::runtime_error("Could not write spill file: " + writer.paths[p].string());
+            }
+            if (writer.num_groups[p] == 0) {
+                std::filesystem::remove(writer.paths[p]);
+                continue;
+            }
+            pending_partitions_.push_back({writer.paths[p], writer.depth});
+            num_spilled_partitions_ += 1;
+        }
+        writer.files.clear();
+        writer.paths.clear();
+        writer.num_groups.clear();
+    }
+
+    bool HashAggregateOperator::load_next_partition() {
+        while (!pending_partitions_.empty()) {
+            SpillPartition partition = std::move(pending_partitions_.back());
+            pending_partitions_.pop_back();
+            clear_groups();
+
+            // If the partition's groups don't fit in memory either, they're split with the next bits of the hash.
+            SpillWriter writer;
+            writer.depth = partition.depth + 1;
+            const bool can_split = writer.depth < MAX_SPILL_DEPTH;
+            {
+                std::ifstream file(partition.path, std::ios::binary);
+                if (!file) {
+                    throw std::runtime_error("Could not open spill file: " + partition.path.string());
+                }
+                std::string key;
+                Accumulator partial;
+                while (spill::read_string(file, key, true)) {
+                    const uint32_t group = find_or_add_group(key, hash_key(key));
+                    for (size_t a = 0; a < aggregates_.size(); ++a) {
+                        spill::read_value(file, partial.count);
+                        spill::read_value(file, partial.int_value);
+                        spill::read_string(file, partial.text_value);
+                        if (partial.count == 0) {
+                            continue;
+                        }
+
+                        // Merge the partial results into the group's.
+                        const Aggregate& aggregate = aggregates_[a];
+                        Accumulator& acc = accumulator(group, a);
+                        if (aggregate.function == ast::AggregateFunction::MIN ||
+                            aggregate.function == ast::AggregateFunction::MAX) {
+                            if (aggregate.type == command::Datatype::INT) {
+                                if (acc.count == 0 || replaces(aggregate.function, partial.int_value, acc.int_value)) {
+                                    acc.int_value = partial.int_value;
+                                }
+                            } else if (acc.count == 0 ||
+                                       replaces(aggregate.function, partial.text_value, acc.text_value)) {
+                                memory_usage_ = memory_usage_ - acc.text_value.size() + partial.text_value.size();
+                                acc.text_value = partial.text_value;
+                            }
+                        } else {
+                            acc.int_value += partial.int_value;
+                        }
+                        acc.count += partial.count;
+                    }
+                    // Splitting a single group further wouldn't help.
+                    if (can_split && memory_usage_ > memory_budget_ && group_keys_.size() > 1) {
+                        spill_groups(writer);
+                    }
+                }
+            }
+            std::filesystem::remove(partition.path);
+
+            if (!writer.files.empty()) {
+                spill_groups(writer);
+                finish_spill(writer);
+                continue;
+            }
+            if (!group_keys_.empty()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void HashAggregateOperator::output_group(uint32_t group, Batch& batch, size_t row) const {
+        // Decode the GROUP BY values from the group's key.
+        std::vector<std::string> group_values(group_columns_.size());
+        std::vector<bool> group_nulls(group_columns_.size());
+        const std::string& key = group_keys_[group];
+        size_t position = 0;
+        for (size_t i = 0; i < group_columns_.size(); ++i) {
+            group_nulls[i] = !read_key_value(key, position, group_columns_[i].type, group_values[i]);
+        }
+
+        for (size_t i = 0; i < output_columns_.size(); ++i) {
+            ColumnVector& column = batch.column(i);
+            std::string& value = column.texts[row];
+            bool is_null = false;
+            if (output_columns_[i].is_group_column) {
+                value = group_values[output_columns_[i].index];
+                is_null = group_nulls[output_columns_[i].index];
+            } else {
+                const size_t a = output_columns_[i].index;
+                const Aggregate& aggregate = aggregates_[a];
+                const Accumulator& acc = accumulators_[group * aggregates_.size() + a];
+                // Only COUNT has a value when there were no values.
+                is_null = acc.count == 0 && aggregate.function != ast::AggregateFunction::COUNT;
+                switch (aggregate.function) {
+                    case ast::AggregateFunction::COUNT:
+                        value = std::to_string(acc.count);
+                        break;
+                    case ast::AggregateFunction::SUM:
+                        value = std::to_string(acc.int_value);
+                        break;
+                    case ast::AggregateFunction::AVG: {
+                        char buffer[32];
+                        const double average = acc.count == 0 ? 0 : static_cast<double>(acc.int_value) / acc.count;
+                        snprintf(buffer, sizeof(buffer), "%.15g", average);
+                        value = buffer;
+                        break;
+                    }
+                    case ast::AggregateFunction::MIN:
+                    case ast::AggregateFunction::MAX:
+                        value = aggregate.type == command::Datatype::INT ? std::to_string(acc.int_value)
+                                                                         : acc.text_value;
+                        break;
+                }
+            }
+            if (is_null) {
+                value.clear();
+            }
+            column.nulls[row] = is_null ? 1 : 0;
+        }
+    }
+}  // namespace simpledb::execution
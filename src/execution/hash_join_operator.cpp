@@ -0,0 +1,399 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/execution/hash_join_operator.h"
+
+#include "spill_file_internal.h"
+#include <functional>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace simpledb::execution {
+    namespace {
+        // Each level of spilling splits the rows by the next PARTITION_BITS bits of their key's hash (from the top, as
+        // the hash table buckets use the bottom bits).
+        constexpr size_t PARTITION_BITS = 4;
+        static_assert(HashJoinOperator::NUM_SPILL_PARTITIONS == 1 << PARTITION_BITS);
+        constexpr size_t MAX_SPILL_DEPTH = 64 / PARTITION_BITS;
+
+        constexpr size_t INITIAL_NUM_BUCKETS = 1024;
+
+        uint64_t hash_key(std::string_view key) { return std::hash<std::string_view>{}(key); }
+
+        // The signature of an input's rows in terms of the joined table, whose columns of the input's table start at
+        // the given offset.
+        row::Signature joined_signature(const JoinInput& input, size_t offset) {
+            row::Signature signature;
+            std::optional<row::Signature> input_signature = input.op->signature();
+            if (input_signature.has_value()) {
+                for (size_t column : input_signature.value()) {
+                    signature.push_back(offset + column);
+                }
+            } else {
+                for (size_t column = 0; column < input.num_table_columns; ++column) {
+                    signature.push_back(offset + column);
+                }
+            }
+            return signature;
+        }
+
+        // A row in a partition: its join key, the key's hash, then its values.
+        void write_row(std::ofstream& file, const std::string& key, uint64_t hash, const row::Row& row) {
+            spill::write_string(file, key);
+            spill::write_value(file, hash);
+            spill::write_value(file, static_cast<uint32_t>(row.size()));
+            for (const std::string& value : row) {
+                spill::write_string(file, value);
+            }
+        }
+
+        bool read_row(std::ifstream& file, std::string& key, uint64_t& hash, row::Row& row) {
+            if (!spill::read_string(file, key, true)) {
+                return false;
+            }
+            spill::read_value(file, hash);
+            uint32_t num_values;
+            spill::read_value(file, num_values);
+            row.resize(num_values);
+            for (std::string& value : row) {
+                spill::read_string(file, value);
+            }
+            return true;
+        }
+    }  // namespace
+
+    HashJoinOperator::HashJoinOperator(JoinInput left,
+                                       JoinInput right,
+                                       command::Datatype key_type,
+                                       BuildSide build_side,
+                                       size_t memory_budget,
+                                       std::filesystem::path spill_dir)
+        : key_type_(key_type),
+          build_side_(build_side),
+          memory_budget_(memory_budget),
+          spill_dir_(std::move(spill_dir)) {
+        row::Signature signature = joined_signature(left, 0);
+        num_left_columns_ = signature.size();
+        row::Signature right_signature = joined_signature(right, left.num_table_columns);
+        signature.insert(signature.end(), right_signature.begin(), right_signature.end());
+        output_types_.assign(signature.size(), command::Datatype::TEXT);
+        signature_ = std::move(signature);
+
+        JoinInput& build = build_side == BuildSide::LEFT ? left : right;
+        JoinInput& probe = build_side == BuildSide::LEFT ? right : left;
+        build_child_ = std::move(build.op);
+        build_key_column_ = build.key_column;
+        probe_child_ = std::move(probe.op);
+        probe_key_column_ = probe.key_column;
+        buckets_.assign(INITIAL_NUM_BUCKETS, 0);
+    }
+
+    HashJoinOperator::~HashJoinOperator() {
+        probe_file_.close();
+        for (const std::filesystem::path& path : spill_files_) {
+            std::error_code error;
+            std::filesystem::remove(path, error);
+        }
+    }
+
+    bool HashJoinOperator::next_batch(Batch& batch) {
+        if (!built_) {
+            build();
+            built_ = true;
+        }
+        batch.reset(output_types_);
+        size_t size = 0;
+        while (size < BATCH_CAPACITY) {
+            if (next_match_ != 0) {
+                const BuildEntry& entry = entries_[next_match_ - 1];
+                next_match_ = entry.next;
+                if (entry.hash != probe_hash_ || entry.key != probe_key_) {
+                    continue;
+                }
+                if (!probe_row_ready_) {
+                    probe_batch_.get_row(probe_batch_row_, probe_row_);
+                    probe_row_ready_ = true;
+                }
+                output_row(batch, size++, entry.row);
+                continue;
+            }
+            if (!next_probe_row()) {
+                if (spilled_ && load_next_partition()) {
+                    continue;
+                }
+                break;
+            }
+            next_match_ = buckets_[probe_hash_ & (buckets_.size() - 1)];
+        }
+        batch.set_size(size);
+        return size > 0;
+    }
+
+    void HashJoinOperator::build() {
+        SpillWriter build_writer;
+        Batch input;
+        std::string key;
+        while (build_child_->next_batch(input)) {
+            for (size_t i = 0; i < input.num_selected(); ++i) {
+                const size_t row = input.selected(i);
+                if (!read_key(input, row, build_key_column_, key)) {
+                    continue;
+                }
+                const uint64_t hash = hash_key(key);
+                row::Row values;
+                input.get_row(row, values);
+                if (spilled_) {
+                    write_partitioned(build_writer, key, hash, values);
+                    continue;
+                }
+                insert_entry(std::move(values), key, hash);
+                if (memory_usage_ > memory_budget_) {
+                    spilled_ = true;
+                    open_partitions(build_writer, 0);
+                    spill_table(build_writer);
+                }
+            }
+        }
+        // The build side won't be read anymore, release what it holds.
+        build_child_.reset();
+        if (!spilled_) {
+            return;
+        }
+
+        // Partition the probe side the same way, the pairs of partitions are then joined by load_next_partition().
+        SpillWriter probe_writer;
+        open_partitions(probe_writer, 0);
+        partition_input(probe_child_, probe_key_column_, probe_writer);
+        finish_partitions(build_writer, probe_writer);
+    }
+
+    void HashJoinOperator::insert_entry(row::Row row, std::string key, uint64_t hash) {
+        // The entry, its values and key, and its share of the buckets.
+        memory_usage_ += sizeof(BuildEntry) + sizeof(uint32_t) + key.size();
+        for (const std::string& value : row) {
+            memory_usage_ += sizeof(std::string) + value.size();
+        }
+        entries_.push_back({std::move(row), std::move(key), hash, 0});
+
+        // Keep about one entry per bucket, so that chains stay short.
+        if (entries_.size() > buckets_.size()) {
+            buckets_.assign(buckets_.size() * 2, 0);
+            const size_t mask = buckets_.size() - 1;
+            for (uint32_t e = 0; e < entries_.size(); ++e) {
+                uint32_t& bucket = buckets_[entries_[e].hash & mask];
+                entries_[e].next = bucket;
+                bucket = e + 1;
+            }
+            return;
+        }
+        uint32_t& bucket = buckets_[hash & (buckets_.size() - 1)];
+        entries_.back().next = bucket;
+        bucket = static_cast<uint32_t>(entries_.size());
+    }
+
+    void HashJoinOperator::clear_table() {
+        buckets_.assign(INITIAL_NUM_BUCKETS, 0);
+        entries_.clear();
+        memory_usage_ = 0;
+        next_match_ = 0;
+    }
+
+    bool HashJoinOperator::read_key(const Batch& batch, size_t row, size_t key_column, std::string& key) const {
+        const ColumnVector& column = batch.column(key_column);
+        if (column.nulls[row]) {
+            return false;
+        }
+        // INT keys are compared in their text form too, so that both sides' keys look the same whether an operator
+        // handed them out as INT or as TEXT (in which case an empty string is NULL).
+        column.value_as_text(row, key);
+        return key_type_ != command::Datatype::INT || !key.empty();
+    }
+
+    void HashJoinOperator::open_partitions(SpillWriter& writer, size_t depth) {
+        std::filesystem::create_directories(spill_dir_);
+        writer.depth = depth;
+        for (size_t p = 0; p < NUM_SPILL_PARTITIONS; ++p) {
+            std::filesystem::path path = spill::unique_path(spill_dir_, "join");
+            writer.files.emplace_back(path, std::ios::binary | std::ios::trunc);
+            spill_files_.push_back(path);
+            if (!writer.files.back()) {
+                throw std::runtime_error("Could not create spill file: " + path.string());
+            }
+            writer.paths.push_back(std::move(path));
+        }
+        writer.num_rows.assign(NUM_SPILL_PARTITIONS, 0);
+    }
+
+    void HashJoinOperator::write_partitioned(SpillWriter& writer,
+                                             const std::string& key,
+                                             uint64_t hash,
+                                             const row::Row& row) {
+        const size_t shift = 64 - PARTITION_BITS * (writer.depth + 1);
+        const size_t partition = (hash >> shift) & (NUM_SPILL_PARTITIONS - 1);
+        write_row(writer.files[partition], key, hash, row);
+        writer.num_rows[partition] += 1;
+    }
+
+    void HashJoinOperator::spill_table(SpillWriter& writer) {
+        for (const BuildEntry& entry : entries_) {
+            write_partitioned(writer, entry.key, entry.hash, entry.row);
+        }
+        clear_table();
+    }
+
+    void HashJoinOperator::partition_input(std::unique_ptr<Operator>& input, size_t key_column, SpillWriter& writer) {
+        Batch batch;
+        std::string key;
+        row::Row values;
+        while (input->next_batch(batch)) {
+            for (size_t i = 0; i < batch.num_selected(); ++i) {
+                const size_t row = batch.selected(i);
+                if (!read_key(batch, row, key_column, key)) {
+                    continue;
+                }
+                batch.get_row(row, values);
+                write_partitioned(writer, key, hash_key(key), values);
+            }
+        }
+        input.reset();
+    }
+
+    void HashJoinOperator::finish_partitions(SpillWriter& build_writer, SpillWriter& probe_writer) {
+        for (size_t p = 0; p < NUM_SPILL_PARTITIONS; ++p) {
+            for (SpillWriter* writer : {&build_writer, &probe_writer}) {
+                writer->files[p].close();
+                if (writer->files[p].fail()) {
+                    throw std::runtime_error("Could not write spill file: " + writer->paths[p].string());
+                }
+            }
+            // An inner join has no rows for a partition that is empty on either side.
+            if (build_writer.num_rows[p] == 0 || probe_writer.num_rows[p] == 0) {
+                std::filesystem::remove(build_writer.paths[p]);
+                std::filesystem::remove(probe_writer.paths[p]);
+                continue;
+            }
+            pending_partitions_.push_back({build_writer.paths[p], probe_writer.paths[p], build_writer.depth});
+            num_spilled_partitions_ += 1;
+        }
+    }
+
+    bool HashJoinOperator::load_next_partition() {
+        while (!pending_partitions_.empty()) {
+            SpillPartition partition = std::move(pending_partitions_.back());
+            pending_partitions_.pop_back();
+            clear_table();
+
+            // If the partition's build rows don't fit in memory either, both sides are split with the next bits of
+            // the hash. That doesn't help if all rows have the same hash though, they're then joined as they are.
+            SpillWriter build_writer;
+            const size_t depth = partition.depth + 1;
+            const bool can_split = depth < MAX_SPILL_DEPTH;
+            bool same_hash = true;
+            {
+                std::ifstream file(partition.build_path, std::ios::binary);
+                if (!file) {
+                    throw std::runtime_error("Could not open spill file: " + partition.build_path.string());
+                }
+                std::string key;
+                uint64_t hash;
+                row::Row row;
+                while (read_row(file, key, hash, row)) {
+                    if (!build_writer.files.empty()) {
+                        write_partitioned(build_writer, key, hash, row);
+                        continue;
+                    }
+                    same_hash = same_hash && (entries_.empty() || entries_.front().hash == hash);
+                    insert_entry(std::move(row), std::move(key), hash);
+                    if (can_split && !same_hash && memory_usage_ > memory_budget_) {
+                        open_partitions(build_writer, depth);
+                        spill_table(build_writer);
+                    }
+                }
+            }
+            std::filesystem::remove(partition.build_path);
+
+            if (!build_writer.files.empty()) {
+                SpillWriter probe_writer;
+                open_partitions(probe_writer, depth);
+                {
+                    std::ifstream file(partition.probe_path, std::ios::binary);
+                    if (!file) {
+                        throw std::runtime_error("Could not open spill file: " + partition.probe_path.string());
+                    }
+                    std::string key;
+                    uint64_t hash;
+                    row::Row row;
+                    while (read_row(file, key, hash, row)) {
+                        write_partitioned(probe_writer, key, hash, row);
+                    }
+                }
+                std::filesystem::remove(partition.probe_path);
+                finish_partitions(build_writer, probe_writer);
+                continue;
+            }
+
+            probe_file_.open(partition.probe_path, std::ios::binary);
+            if (!probe_file_) {
+                throw std::runtime_error("Could not open spill file: " + partition.probe_path.string());
+            }
+            probe_path_ = partition.probe_path;
+            return true;
+        }
+        return false;
+    }
+
+    bool HashJoinOperator::next_probe_row() {
+        probe_row_ready_ = false;
+        if (spilled_) {
+            if (!probe_file_.is_open()) {
+                return false;
+            }
+            if (read_row(probe_file_, probe_key_, probe_hash_, probe_row_)) {
+                probe_row_ready_ = true;
+                return true;
+            }
+            probe_file_.close();
+            std::filesystem::remove(probe_path_);
+            return false;
+        }
+
+        // Nothing matches an empty build side, so the probe side doesn't need to be read at all.
+        if (entries_.empty()) {
+            probe_child_.reset();
+            return false;
+        }
+        while (true) {
+            if (probe_position_ == probe_batch_.num_selected()) {
+                if (!probe_child_ || !probe_child_->next_batch(probe_batch_)) {
+                    probe_child_.reset();
+                    probe_batch_.reset({});
+                    probe_position_ = 0;
+                    return false;
+                }
+                probe_position_ = 0;
+                continue;
+            }
+            probe_batch_row_ = probe_batch_.selected(probe_position_++);
+            if (read_key(probe_batch_, probe_batch_row_, probe_key_column_, probe_key_)) {
+                probe_hash_ = hash_key(probe_key_);
+                return true;
+            }
+        }
+    }
+
+    void HashJoinOperator::output_row(Batch& batch, size_t row, const row::Row& build_row) {
+        const row::Row& left_row = build_side_ == BuildSide::LEFT ? build_row : probe_row_;
+        const row::Row& right_row = build_side_ == BuildSide::LEFT ? probe_row_ : build_row;
+        for (size_t i = 0; i < left_row.size(); ++i) {
+            batch.column(i).texts[row] = left_row[i];
+            batch.column(i).nulls[row] = 0;
+        }
+        for (size_t i = 0; i < right_row.size(); ++i) {
+            batch.column(num_left_columns_ + i).texts[row] = right_row[i];
+            batch.column(num_left_columns_ + i).nulls[row] = 0;
+        }
+    }
+}  // namespace simpledb::execution
@@ -0,0 +1,149 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/execution/index_scan_operator.h"
+
+#include "simpledb/storage/hash_index.h"
+#include "simpledb/table_index.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace simpledb::execution {
+    namespace {
+        catalog::TableSchemaPtr get_table_schema(const std::string& table_name) {
+            catalog::TableSchemaPtr table_schema = catalog::get_table_schema(table_name);
+            if (table_schema == nullptr) {
+                throw std::runtime_error("Table not found in catalog: " + table_name);
+            }
+            return table_schema;
+        }
+
+        std::string predicate_key(const CompiledPredicate& predicate) {
+            if (predicate.column_type() == command::Datatype::INT) {
+                return table_index::encode_int_key(predicate.int_value());
+            }
+            return table_index::encode_text_key(predicate.text_value());
+        }
+
+        // The first key of the range the predicate covers, std::nullopt to start at the beginning of the index.
+        std::optional<std::string> lower_key(const CompiledPredicate& predicate) {
+            switch (predicate.op()) {
+                case ast::ComparisonOp::EQUALS:
+                case ast::ComparisonOp::GREATER_THAN:
+                case ast::ComparisonOp::GREATER_THAN_OR_EQUAL:
+                    return predicate_key(predicate);
+                default:
+                    return std::nullopt;
+            }
+        }
+
+        // The last key of the range the predicate covers, std::nullopt to go to the end of the index. The range
+        // includes the constant's key even for strict comparisons: with lossy TEXT keys, values other than the
+        // constant can share its key, and the recheck of the predicate drops the constant itself.
+        std::optional<std::string> upper_key(const CompiledPredicate& predicate) {
+            switch (predicate.op()) {
+                case ast::ComparisonOp::EQUALS:
+                case ast::ComparisonOp::LESS_THAN:
+                case ast::ComparisonOp::LESS_THAN_OR_EQUAL:
+                    return predicate_key(predicate);
+                default:
+                    return std::nullopt;
+            }
+        }
+
+        storage::BPlusTree::Iterator seek(storage::BPlusTree& tree, const std::optional<std::string>& key) {
+            return key.has_value() ? tree.Seek(key.value()) : tree.Begin();
+        }
+    }  // namespace
+
+    IndexScanOperator::IndexScanOperator(const std::string& table_name,
+                                         const std::filesystem::path& data_dir,
+                                         const catalog::IndexDefinition& index,
+                                         CompiledPredicate predicate,
+                                         std::optional<row::Signature> columns,
+                                         bool at_most_one_match)
+        : table_heap_(data_dir / (table_name + ".data")),
+          layout_(get_table_schema(table_name)->column_definitions),
+          predicate_(std::move(predicate)),
+          at_most_one_match_(at_most_one_match),
+          columns_(std::move(columns)) {
+        if (!can_use_index(index, predicate_.op())) {
+            throw std::runtime_error("Index '" + index.index_name + "' can't be used for this comparison.");
+        }
+        if (table_index::column_index(*get_table_schema(table_name), index) != predicate_.column_index()) {
+            throw std::runtime_error("Index '" + index.index_name + "' is not on the column of the predicate.");
+        }
+
+        const std::string path = table_index::index_file_path(data_dir, table_name, index.index_name).string();
+        const uint16_t key_size = table_index::key_size(predicate_.column_type());
+        if (index.index_type == command::IndexType::HASH) {
+            storage::HashIndex hash_index(path, key_size);
+            hash_index.Find(predicate_key(predicate_), record_ids_);
+            // Fetch the records in table order, so that records on the same page are fetched one after another.
+            std::sort(record_ids_.begin(), record_ids_.end());
+        } else {
+            tree_ = std::make_unique<storage::BPlusTree>(path, key_size);
+            upper_key_ = upper_key(predicate_);
+            iterator_.emplace(seek(*tree_, lower_key(predicate_)));
+        }
+
+        if (columns_.has_value()) {
+            output_columns_ = columns_.value();
+        } else {
+            for (size_t i = 0; i < layout_.num_columns(); ++i) {
+                output_columns_.push_back(i);
+            }
+        }
+        for (size_t column_index : output_columns_) {
+            output_types_.push_back(layout_.column_type(column_index));
+        }
+    }
+
+    bool IndexScanOperator::next_batch(Batch& batch) {
+        batch.reset(output_types_);
+        size_t size = 0;
+        storage::RecordId record_id;
+        while (!done_ && size < BATCH_CAPACITY && size < rows_left_) {
+            if (!next_record_id(record_id)) {
+                done_ = true;
+                break;
+            }
+            if (!table_heap_.GetRecord(record_id, record_data_)) {
+                throw std::runtime_error("Index entry points to a record that doesn't exist: page " +
+                                         std::to_string(record_id.page_id) + ", slot " +
+                                         std::to_string(record_id.slot));
+            }
+            storage::RecordView record{record_data_.data(), static_cast<uint16_t>(record_data_.size())};
+            if (!predicate_.evaluate(layout_, record)) {
+                continue;
+            }
+            for (size_t i = 0; i < output_columns_.size(); ++i) {
+                read_record_column(layout_, record, output_columns_[i], batch.column(i), size);
+            }
+            ++size;
+            if (at_most_one_match_) {
+                done_ = true;
+            }
+        }
+        batch.set_size(size);
+        rows_left_ -= size;
+        return size > 0;
+    }
+
+    bool IndexScanOperator::next_record_id(storage::RecordId& record_id) {
+        if (tree_ != nullptr) {
+            std::string_view key;
+            return iterator_->Next(key, record_id) && !(upper_key_.has_value() && key > upper_key_.value());
+        }
+        if (next_record_ == record_ids_.size()) {
+            return false;
+        }
+        record_id = record_ids_[next_record_++];
+        return true;
+    }
+}  // namespace simpledb::execution
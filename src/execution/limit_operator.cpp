@@ -0,0 +1,60 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/execution/limit_operator.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace simpledb::execution {
+    LimitOperator::LimitOperator(std::unique_ptr<Operator> child, size_t limit, size_t offset)
+        : child_(std::move(child)), signature_(child_->signature()), rows_to_skip_(offset), rows_left_(limit) {
+        limit_child();
+    }
+
+    void LimitOperator::set_row_limit(size_t max_rows) {
+        rows_left_ = std::min(rows_left_, max_rows);
+        limit_child();
+    }
+
+    void LimitOperator::limit_child() {
+        if (child_ == nullptr) {
+            return;
+        }
+        // Saturates instead of overflowing, for a huge LIMIT.
+        size_t max_rows = std::numeric_limits<size_t>::max();
+        if (rows_left_ <= max_rows - rows_to_skip_) {
+            max_rows = rows_to_skip_ + rows_left_;
+        }
+        child_->set_row_limit(max_rows);
+    }
+
+    bool LimitOperator::next_batch(Batch& batch) {
+        while (child_ != nullptr && rows_left_ > 0 && child_->next_batch(batch)) {
+            const size_t num_selected = batch.num_selected();
+            if (rows_to_skip_ >= num_selected) {
+                rows_to_skip_ -= num_selected;
+                continue;
+            }
+
+            // Keep the selected rows after the skipped ones, up to the limit.
+            const size_t begin = rows_to_skip_;
+            const size_t end = begin + std::min(num_selected - begin, rows_left_);
+            if (begin > 0 || end < num_selected) {
+                selection_.clear();
+                for (size_t i = begin; i < end; ++i) {
+                    selection_.push_back(static_cast<uint16_t>(batch.selected(i)));
+                }
+                batch.set_selection(selection_);
+            }
+            rows_to_skip_ = 0;
+            rows_left_ -= end - begin;
+            return true;
+        }
+        // Done: nothing more will be pulled from the child, so release what it holds right away.
+        child_.reset();
+        return false;
+    }
+}  // namespace simpledb::execution
@@ -0,0 +1,50 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/execution/operator.h"
+
+#include <vector>
+
+namespace simpledb::execution {
+    bool Operator::next_batch(Batch& batch) {
+        std::optional<row::Row> row = next();
+        if (!row.has_value()) {
+            return false;
+        }
+        batch.reset(std::vector<command::Datatype>(row->size(), command::Datatype::TEXT));
+
+        size_t size = 0;
+        while (true) {
+            for (size_t i = 0; i < row->size(); ++i) {
+                ColumnVector& column = batch.column(i);
+                column.texts[size] = std::move((*row)[i]);
+                column.nulls[size] = 0;
+            }
+            ++size;
+            if (size == BATCH_CAPACITY) {
+                break;
+            }
+            row = next();
+            if (!row.has_value()) {
+                break;
+            }
+        }
+        batch.set_size(size);
+        return true;
+    }
+
+    std::optional<row::Row> BatchOperator::next() {
+        while (row_position_ == row_batch_.num_selected()) {
+            row_position_ = 0;
+            if (!next_batch(row_batch_)) {
+                // Keep reporting the end of the data on later calls.
+                row_batch_.reset({});
+                return std::nullopt;
+            }
+        }
+        row::Row row;
+        row_batch_.get_row(row_batch_.selected(row_position_++), row);
+        return row;
+    }
+}  // namespace simpledb::execution
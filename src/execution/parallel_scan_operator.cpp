@@ -0,0 +1,128 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/execution/parallel_scan_operator.h"
+
+#include "simpledb/execution/filter_operator.h"
+#include <algorithm>
+#include <utility>
+
+namespace simpledb::execution {
+    ParallelScanOperator::ParallelScanOperator(const std::string& table_name,
+                                               const std::filesystem::path& data_dir,
+                                               std::optional<CompiledPredicate> predicate,
+                                               std::optional<row::Signature> columns,
+                                               std::optional<ast::WhereClause> where_clause,
+                                               size_t num_workers,
+                                               std::shared_ptr<TaskGroup> task_group)
+        : task_group_(task_group != nullptr ? std::move(task_group) : std::make_shared<TaskGroup>()) {
+        // The pipelines are created up front, on this thread, so that the tasks don't need the catalog. There is
+        // always at least one, for signature().
+        do {
+            auto scan = std::make_unique<TableScanOperator>(table_name, data_dir, predicate, columns);
+            if (workers_.empty()) {
+                num_morsels_ = (scan->num_pages() + MORSEL_SIZE - 1) / MORSEL_SIZE;
+                num_workers_ = std::min(std::max<size_t>(num_workers, 1), num_morsels_);
+            }
+            Worker worker{scan.get(), std::move(scan)};
+            if (where_clause.has_value()) {
+                worker.pipeline = std::make_unique<FilterOperator>(
+                    table_name, std::move(worker.pipeline), where_clause.value());
+            }
+            workers_.push_back(std::move(worker));
+        } while (workers_.size() < num_workers_);
+        signature_ = workers_.front().pipeline->signature();
+        for (Worker& worker : workers_) {
+            idle_workers_.push_back(&worker);
+        }
+        results_.resize(num_morsels_);
+    }
+
+    ParallelScanOperator::~ParallelScanOperator() { stop(); }
+
+    bool ParallelScanOperator::next_batch(Batch& batch) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopping_ && rows_left_ > 0 && next_output_ < num_morsels_) {
+            submit_morsels(lock);
+            morsel_done_.wait(lock, [this] { return error_ != nullptr || results_[next_output_].done; });
+            if (error_ != nullptr) {
+                std::rethrow_exception(error_);
+            }
+            MorselResult& result = results_[next_output_];
+            if (next_output_batch_ < result.batches.size()) {
+                batch = std::move(result.batches[next_output_batch_++]);
+                rows_left_ -= std::min(rows_left_, batch.num_selected());
+                return true;
+            }
+            // Release the morsel's batches, and move on to the next one.
+            result = MorselResult();
+            next_output_ += 1;
+            next_output_batch_ = 0;
+        }
+        lock.unlock();
+        // Done: nothing more will be returned, so don't let tasks scan morsels for nothing.
+        stop();
+        return false;
+    }
+
+    void ParallelScanOperator::submit_morsels(std::unique_lock<std::mutex>& lock) {
+        const size_t max_submitted = std::min(num_morsels_, next_output_ + MAX_MORSELS_AHEAD * num_workers_);
+        size_t num_tasks = 0;
+        while (num_running_ < num_workers_ && num_submitted_ < max_submitted) {
+            num_running_ += 1;
+            num_submitted_ += 1;
+            num_tasks += 1;
+        }
+        // The scheduler has its own lock, don't hold ours while submitting.
+        lock.unlock();
+        for (size_t t = 0; t < num_tasks; ++t) {
+            task_group_->submit([this] { scan_morsel(); });
+        }
+        lock.lock();
+    }
+
+    void ParallelScanOperator::scan_morsel() {
+        Worker* worker;
+        bool stopping;
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            worker = idle_workers_.back();
+            idle_workers_.pop_back();
+            stopping = stopping_;
+        }
+
+        const size_t morsel = next_morsel_++;
+        std::vector<Batch> batches;
+        std::exception_ptr error;
+        if (!stopping) {
+            try {
+                const auto begin_page_id = static_cast<storage::PageId>(morsel * MORSEL_SIZE);
+                worker->scan->set_page_range(begin_page_id, begin_page_id + MORSEL_SIZE);
+                Batch batch;
+                while (worker->pipeline->next_batch(batch)) {
+                    batches.push_back(std::move(batch));
+                    batch = Batch();
+                }
+            } catch (...) {
+                error = std::current_exception();
+            }
+        }
+
+        std::lock_guard<std::mutex> guard(mutex_);
+        results_[morsel].batches = std::move(batches);
+        results_[morsel].done = true;
+        if (error != nullptr && error_ == nullptr) {
+            error_ = error;
+        }
+        idle_workers_.push_back(worker);
+        num_running_ -= 1;
+        morsel_done_.notify_all();
+    }
+
+    void ParallelScanOperator::stop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        stopping_ = true;
+        morsel_done_.wait(lock, [this] { return num_running_ == 0; });
+    }
+}  // namespace simpledb::execution
@@ -0,0 +1,178 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/execution/predicate.h"
+
+#include "simpledb/execution/filter_kernels.h"
+#include "simpledb/serializer.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+
+namespace simpledb::execution {
+
+    template <command::Datatype Type, ast::ComparisonOp Op>
+    bool CompiledPredicate::evaluate_row(const CompiledPredicate& predicate, const row::Row& row) {
+        const std::string& value = row[predicate.row_index_];
+        if constexpr (Type == command::Datatype::INT) {
+            int32_t int_value;
+            // Rows coming out of a table always hold valid ints, anything else simply doesn't match.
+            return serializer::parse_int(value, int_value) && compare<Op>(int_value, predicate.int_value_);
+        } else {
+            return compare<Op>(std::string_view(value), std::string_view(predicate.text_value_));
+        }
+    }
+
+    template <command::Datatype Type, ast::ComparisonOp Op>
+    bool CompiledPredicate::evaluate_record(const CompiledPredicate& predicate,
+                                            const serializer::RecordLayout& layout,
+                                            storage::RecordView record) {
+        if (serializer::is_null(layout, record, predicate.column_index_)) {
+            return false;
+        }
+        if constexpr (Type == command::Datatype::INT) {
+            return compare<Op>(serializer::read_int(layout, record, predicate.column_index_), predicate.int_value_);
+        } else {
+            return compare<Op>(serializer::read_text(layout, record, predicate.column_index_),
+                               std::string_view(predicate.text_value_));
+        }
+    }
+
+    template <command::Datatype Type, ast::ComparisonOp Op>
+    void CompiledPredicate::filter_batch(const CompiledPredicate& predicate,
+                                         const Batch& batch,
+                                         std::vector<uint16_t>& selection) {
+        selection.clear();
+        const ColumnVector& column = batch.column(predicate.row_index_);
+        const size_t num_selected = batch.num_selected();
+        if constexpr (Type == command::Datatype::INT) {
+            if (column.type == command::Datatype::INT) {
+                const kernels::FilterKernels& filter_kernels = kernels::get_filter_kernels();
+                if (!batch.has_selection()) {
+                    // All rows are selected, the kernel writes the selection vector directly.
+                    selection.resize(batch.size());
+                    size_t selected = filter_kernels.select_int32[Op](
+                        column.ints.data(), batch.size(), predicate.int_value_, selection.data());
+                    selection.resize(selected);
+                } else {
+                    // Comparing the whole batch is cheaper than picking the selected values one by one, the
+                    // bitmap then tells which of the selected rows match.
+                    uint64_t bitmap[BATCH_CAPACITY / 64];
+                    filter_kernels.bitmap_int32[Op](column.ints.data(), batch.size(), predicate.int_value_, bitmap);
+                    for (size_t i = 0; i < num_selected; ++i) {
+                        size_t row = batch.selected(i);
+                        if ((bitmap[row / 64] >> (row % 64)) & 1) {
+                            selection.push_back(static_cast<uint16_t>(row));
+                        }
+                    }
+                }
+                // NULLs never match, whatever value their slot holds.
+                selection.erase(std::remove_if(selection.begin(),
+                                               selection.end(),
+                                               [&column](uint16_t row) { return column.nulls[row] != 0; }),
+                                selection.end());
+                return;
+            }
+        }
+        for (size_t i = 0; i < num_selected; ++i) {
+            size_t row = batch.selected(i);
+            if (column.nulls[row]) {
+                continue;
+            }
+            bool matches;
+            if constexpr (Type == command::Datatype::INT) {
+                int32_t int_value;
+                matches = serializer::parse_int(column.texts[row], int_value) &&
+                          compare<Op>(int_value, predicate.int_value_);
+            } else {
+                matches = compare<Op>(std::string_view(column.texts[row]), std::string_view(predicate.text_value_));
+            }
+            if (matches) {
+                selection.push_back(static_cast<uint16_t>(row));
+            }
+        }
+    }
+
+    template <command::Datatype Type>
+    void CompiledPredicate::bind(ast::ComparisonOp op) {
+        switch (op) {
+            case ast::ComparisonOp::EQUALS:
+                evaluate_row_ = &evaluate_row<Type, ast::ComparisonOp::EQUALS>;
+                evaluate_record_ = &evaluate_record<Type, ast::ComparisonOp::EQUALS>;
+                filter_batch_ = &filter_batch<Type, ast::ComparisonOp::EQUALS>;
+                return;
+            case ast::ComparisonOp::NOT_EQUALS:
+                evaluate_row_ = &evaluate_row<Type, ast::ComparisonOp::NOT_EQUALS>;
+                evaluate_record_ = &evaluate_record<Type, ast::ComparisonOp::NOT_EQUALS>;
+                filter_batch_ = &filter_batch<Type, ast::ComparisonOp::NOT_EQUALS>;
+                return;
+            case ast::ComparisonOp::LESS_THAN:
+                evaluate_row_ = &evaluate_row<Type, ast::ComparisonOp::LESS_THAN>;
+                evaluate_record_ = &evaluate_record<Type, ast::ComparisonOp::LESS_THAN>;
+                filter_batch_ = &filter_batch<Type, ast::ComparisonOp::LESS_THAN>;
+                return;
+            case ast::ComparisonOp::LESS_THAN_OR_EQUAL:
+                evaluate_row_ = &evaluate_row<Type, ast::ComparisonOp::LESS_THAN_OR_EQUAL>;
+                evaluate_record_ = &evaluate_record<Type, ast::ComparisonOp::LESS_THAN_OR_EQUAL>;
+                filter_batch_ = &filter_batch<Type, ast::ComparisonOp::LESS_THAN_OR_EQUAL>;
+                return;
+            case ast::ComparisonOp::GREATER_THAN:
+                evaluate_row_ = &evaluate_row<Type, ast::ComparisonOp::GREATER_THAN>;
+                evaluate_record_ = &evaluate_record<Type, ast::ComparisonOp::GREATER_THAN>;
+                filter_batch_ = &filter_batch<Type, ast::ComparisonOp::GREATER_THAN>;
+                return;
+            case ast::ComparisonOp::GREATER_THAN_OR_EQUAL:
+                evaluate_row_ = &evaluate_row<Type, ast::ComparisonOp::GREATER_THAN_OR_EQUAL>;
+                evaluate_record_ = &evaluate_record<Type, ast::ComparisonOp::GREATER_THAN_OR_EQUAL>;
+                filter_batch_ = &filter_batch<Type, ast::ComparisonOp::GREATER_THAN_OR_EQUAL>;
+                return;
+        }
+        throw std::runtime_error("Unsupported comparison operator.");
+    }
+
+    void CompiledPredicate::set_row_signature(const row::Signature& signature) {
+        for (size_t i = 0; i < signature.size(); ++i) {
+            if (signature[i] == column_index_) {
+                row_index_ = i;
+                return;
+            }
+        }
+        throw std::runtime_error("WHERE clause column is missing from the rows it is evaluated on.");
+    }
+
+    CompiledPredicate CompiledPredicate::compile(const ast::WhereClause& where_clause,
+                                                 const catalog::TableSchema& table_schema) {
+        for (size_t i = 0; i < table_schema.column_definitions.size(); ++i) {
+            const command::ColumnDefinition& column = table_schema.column_definitions[i];
+            if (column.column_name != where_clause.column_name) {
+                continue;
+            }
+
+            CompiledPredicate predicate;
+            predicate.column_index_ = i;
+            predicate.row_index_ = i;
+            predicate.column_type_ = column.type;
+            predicate.op_ = where_clause.op;
+            if (column.type == command::Datatype::INT) {
+                // For INT columns, the WHERE clause value must be a valid integer.
+                if (!serializer::parse_int(where_clause.value, predicate.int_value_)) {
+                    throw std::runtime_error("WHERE clause value is not a valid integer for column: " +
+                                             where_clause.column_name + ". Expected INT, got '" + where_clause.value +
+                                             "'");
+                }
+                predicate.bind<command::Datatype::INT>(where_clause.op);
+            } else if (column.type == command::Datatype::TEXT) {
+                predicate.text_value_ = where_clause.value;
+                predicate.bind<command::Datatype::TEXT>(where_clause.op);
+            } else {
+                throw std::runtime_error("Unsupported type for WHERE clause column: " + where_clause.column_name);
+            }
+            return predicate;
+        }
+
+        throw std::runtime_error("WHERE clause column \"" + where_clause.column_name + "\" not found in table " +
+                                 table_schema.table_name);
+    }
+}  // namespace simpledb::execution
@@ -6,26 +6,43 @@
 
 #include "simpledb/catalog.h"
 #include "simpledb/serializer.h"
+#include <algorithm>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
 namespace simpledb::execution {
+    namespace {
+        catalog::TableSchemaPtr find_table_schema(const std::string& table_name) {
+            catalog::TableSchemaPtr table_schema = catalog::get_table_schema(table_name);
+            if (!table_schema) {
+                // Or throw a more specific exception
+                throw std::runtime_error("Table not found in catalog: " + table_name);
+            }
+            return table_schema;
+        }
+    }  // namespace
+
     ProjectionOperator::ProjectionOperator(std::string table_name,
                                            std::unique_ptr<simpledb::execution::Operator> child,
                                            const std::vector<std::string>& projection_columns)
-        : table_name_(table_name), child_(std::move(child)), projection_columns_(projection_columns) {
-        std::optional<catalog::TableSchema> table_schema_optional = catalog::get_table_schema(table_name_);
-        if (!table_schema_optional) {
-            // Or throw a more specific exception
-            throw std::runtime_error("Table not found in catalog: " + table_name_);
-        }
+        : ProjectionOperator(*find_table_schema(table_name), std::move(child), projection_columns) {}
 
-        const catalog::TableSchema& table_schema = table_schema_optional.value();
+    ProjectionOperator::ProjectionOperator(const catalog::TableSchema& table_schema,
+                                           std::unique_ptr<simpledb::execution::Operator> child,
+                                           const std::vector<std::string>& projection_columns)
+        : table_name_(table_schema.table_name), child_(std::move(child)), projection_columns_(projection_columns) {
+        if (projection_columns_.empty()) {
+            // If no projection columns are specified, then we want to project all columns.
+            for (size_t j = 0; j < table_schema.column_definitions.size(); ++j) {
+                output_signature_.push_back(j);
+            }
+        }
         for (const auto& projection_column : projection_columns_) {
             bool found = false;
             for (size_t j = 0; j < table_schema.column_definitions.size(); ++j) {
                 if (table_schema.column_definitions[j].column_name == projection_column) {
-                    projected_column_indices_.push_back(j);
+                    output_signature_.push_back(j);
                     found = true;
                     break;  // Found the column, no need to check further.
                 }
@@ -34,24 +51,41 @@ namespace simpledb::execution {
                 throw std::runtime_error("Projection column not found in table schema: " + projection_column);
             }
         }
-    }
 
-    std::optional<row::Row> ProjectionOperator::next() {
-        std::optional<row::Row> next = child_->next();
-        if (!next.has_value()) {
-            // If the child operator has no more rows, return std::nullopt.
-            return std::nullopt;
+        // Find the projected columns in the child's rows, which may not hold all columns of the table.
+        std::optional<row::Signature> child_signature = child_->signature();
+        for (size_t column_index : output_signature_) {
+            if (!child_signature.has_value()) {
+                projected_column_indices_.push_back(static_cast<int>(column_index));
+                continue;
+            }
+            auto it = std::find(child_signature->begin(), child_signature->end(), column_index);
+            if (it == child_signature->end()) {
+                throw std::runtime_error("Projection column is missing from the rows of the child operator: " +
+                                         table_schema.column_definitions[column_index].column_name);
+            }
+            projected_column_indices_.push_back(static_cast<int>(it - child_signature->begin()));
         }
-        if (projection_columns_.empty()) {
-            // If no projection columns are specified, then we want to project all columns.
-            // This means we return the entire row as is.
-            return next;
+
+        size_t child_row_size =
+            child_signature.has_value() ? child_signature->size() : table_schema.column_definitions.size();
+        pass_through_ = projected_column_indices_.size() == child_row_size;
+        for (size_t i = 0; pass_through_ && i < projected_column_indices_.size(); ++i) {
+            pass_through_ = projected_column_indices_[i] == static_cast<int>(i);
         }
+    }
 
-        row::Row projected_row;
-        for (int index : projected_column_indices_) {
-            projected_row.push_back(next.value()[index]);
+    bool ProjectionOperator::next_batch(Batch& batch) {
+        if (pass_through_) {
+            // The child's rows already hold exactly the projected columns (e.g. for SELECT *), use them as they are.
+            return child_->next_batch(batch);
+        }
+        if (!child_->next_batch(child_batch_)) {
+            // If the child operator has no more rows, neither do we.
+            return false;
         }
-        return projected_row;
+        // Moves the projected columns over, no values are copied (unless a column is projected more than once).
+        batch.project(child_batch_, projected_column_indices_);
+        return true;
     }
 }  // namespace simpledb::execution
@@ -0,0 +1,202 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/execution/scheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+namespace simpledb::execution {
+    namespace {
+        // The scheduler and worker that the current thread belongs to, if it is a worker thread.
+        thread_local Scheduler* current_scheduler = nullptr;
+        thread_local size_t current_worker = 0;
+
+        // The number of threads of the process-wide scheduler, 0 for the number of cores.
+        std::atomic<size_t> instance_num_threads{0};
+    }  // namespace
+
+    Scheduler::Scheduler(size_t num_threads) {
+        num_threads = std::max<size_t>(num_threads, 1);
+        for (size_t w = 0; w < num_threads; ++w) {
+            queues_.push_back(std::make_unique<WorkerQueue>());
+        }
+        for (size_t w = 0; w < num_threads; ++w) {
+            threads_.emplace_back(&Scheduler::run_worker, this, w);
+        }
+    }
+
+    Scheduler::~Scheduler() {
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            stopping_ = true;
+            work_available_.notify_all();
+        }
+        for (std::thread& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    Scheduler& Scheduler::instance() {
+        // Never destroyed: ~Scheduler() joins the workers, which would hang exit() in a fork()ed child (e.g. a death
+        // test), since the child has none of the threads.
+        static Scheduler* instance = new Scheduler(
+            instance_num_threads > 0 ? instance_num_threads.load() : std::max(1u, std::thread::hardware_concurrency()));
+        return *instance;
+    }
+
+    void Scheduler::configure_instance(size_t num_threads) { instance_num_threads = num_threads; }
+
+    void Scheduler::submit(TaskGroup& group, std::function<void()> function) {
+        {
+            std::lock_guard<std::mutex> guard(group.mutex_);
+            group.num_pending_ += 1;
+        }
+        if (current_scheduler == this) {
+            WorkerQueue& queue = *queues_[current_worker];
+            {
+                std::lock_guard<std::mutex> guard(queue.mutex);
+                queue.tasks.push_back({&group, std::move(function)});
+            }
+            num_queued_in_workers_ += 1;
+            // Taking the lock makes sure that a worker that is about to wait sees the task.
+            std::lock_guard<std::mutex> guard(mutex_);
+            work_available_.notify_one();
+            return;
+        }
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (group.queued_.empty()) {
+            ready_groups_.push_back(&group);
+        }
+        group.queued_.push_back(std::move(function));
+        work_available_.notify_one();
+    }
+
+    std::optional<Scheduler::Task> Scheduler::take_task(size_t worker) {
+        // 1. The newest task of the worker's own deque.
+        {
+            WorkerQueue& queue = *queues_[worker];
+            std::lock_guard<std::mutex> guard(queue.mutex);
+            if (!queue.tasks.empty()) {
+                Task task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+                num_queued_in_workers_ -= 1;
+                return task;
+            }
+        }
+
+        // 2. The oldest task of the next group in turn, which then goes to the back of the line.
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            if (!ready_groups_.empty()) {
+                TaskGroup* group = ready_groups_.front();
+                ready_groups_.pop_front();
+                Task task{group, std::move(group->queued_.front())};
+                group->queued_.pop_front();
+                if (!group->queued_.empty()) {
+                    ready_groups_.push_back(group);
+                }
+                return task;
+            }
+        }
+
+        // 3. The oldest task of another worker's deque.
+        if (num_queued_in_workers_ == 0) {
+            return std::nullopt;
+        }
+        for (size_t i = 1; i < queues_.size(); ++i) {
+            WorkerQueue& queue = *queues_[(worker + i) % queues_.size()];
+            std::lock_guard<std::mutex> guard(queue.mutex);
+            if (!queue.tasks.empty()) {
+                Task task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+                num_queued_in_workers_ -= 1;
+                return task;
+            }
+        }
+        return std::nullopt;
+    }
+
+    void Scheduler::run_task(Task& task) {
+        std::exception_ptr error;
+        try {
+            task.function();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        // Release what the task holds before its group may go away.
+        task.function = nullptr;
+        task.group->finish_task(error);
+    }
+
+    bool Scheduler::has_tasks() const { return !ready_groups_.empty() || num_queued_in_workers_ > 0; }
+
+    void Scheduler::run_worker(size_t worker) {
+        current_scheduler = this;
+        current_worker = worker;
+        while (true) {
+            std::optional<Task> task = take_task(worker);
+            if (task.has_value()) {
+                run_task(task.value());
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_available_.wait(lock, [this] { return stopping_ || has_tasks(); });
+            if (stopping_ && !has_tasks()) {
+                return;
+            }
+        }
+    }
+
+    TaskGroup::TaskGroup(Scheduler& scheduler) : scheduler_(scheduler) {}
+
+    TaskGroup::~TaskGroup() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        all_done_.wait(lock, [this] { return num_pending_ == 0; });
+    }
+
+    void TaskGroup::submit(std::function<void()> task) { scheduler_.submit(*this, std::move(task)); }
+
+    void TaskGroup::wait() {
+        if (current_scheduler == &scheduler_) {
+            // Blocking would take a worker away from the tasks being waited for, so help run them instead.
+            while (true) {
+                {
+                    std::lock_guard<std::mutex> guard(mutex_);
+                    if (num_pending_ == 0) {
+                        break;
+                    }
+                }
+                std::optional<Scheduler::Task> task = scheduler_.take_task(current_worker);
+                if (task.has_value()) {
+                    Scheduler::run_task(task.value());
+                    continue;
+                }
+                // The remaining tasks are running on other workers.
+                std::unique_lock<std::mutex> lock(mutex_);
+                all_done_.wait_for(lock, std::chrono::milliseconds(1), [this] { return num_pending_ == 0; });
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        all_done_.wait(lock, [this] { return num_pending_ == 0; });
+        if (error_ != nullptr) {
+            std::exception_ptr error = std::move(error_);
+            error_ = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+    void TaskGroup::finish_task(std::exception_ptr error) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (error != nullptr && error_ == nullptr) {
+            error_ = std::move(error);
+        }
+        num_pending_ -= 1;
+        if (num_pending_ == 0) {
+            all_done_.notify_all();
+        }
+    }
+}  // namespace simpledb::execution
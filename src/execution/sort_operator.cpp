@@ -0,0 +1,332 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/execution/sort_operator.h"
+
+#include "spill_file_internal.h"
+#include <charconv>
+#include <cstdlib>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+namespace simpledb::execution {
+    namespace {
+        // Roughly how much memory an entry takes: the entry itself, its values and its parsed keys.
+        template <typename Entry>
+        size_t entry_size(const Entry& entry) {
+            size_t size = sizeof(Entry) + entry.keys.size() * sizeof(entry.keys[0]);
+            for (const std::string& value : entry.row) {
+                size += sizeof(std::string) + value.size();
+            }
+            return size;
+        }
+
+        template <typename T>
+        int compare_values(T a, T b) {
+            return (a > b) - (a < b);
+        }
+    }  // namespace
+
+    SortOperator::SortOperator(std::unique_ptr<Operator> child,
+                               std::vector<SortKey> keys,
+                               size_t memory_budget,
+                               std::filesystem::path spill_dir)
+        : child_(std::move(child)),
+          signature_(child_->signature()),
+          keys_(std::move(keys)),
+          memory_budget_(memory_budget),
+          spill_dir_(std::move(spill_dir)) {}
+
+    SortOperator::~SortOperator() {
+        readers_.clear();
+        for (const std::filesystem::path& path : run_files_) {
+            std::error_code error;
+            std::filesystem::remove(path, error);
+        }
+    }
+
+    bool SortOperator::next_batch(Batch& batch) {
+        if (!built_) {
+            build();
+            built_ = true;
+        }
+        batch.reset(std::vector<command::Datatype>(num_columns_, command::Datatype::TEXT));
+        size_t size = 0;
+        SortEntry merged;
+        while (size < BATCH_CAPACITY && num_output_rows_ < row_limit_) {
+            SortEntry* entry = nullptr;
+            if (merging_) {
+                if (!next_merged(merged)) {
+                    break;
+                }
+                entry = &merged;
+            } else {
+                if (next_entry_ == entries_.size()) {
+                    break;
+                }
+                entry = &entries_[next_entry_++];
+            }
+            for (size_t c = 0; c < num_columns_; ++c) {
+                ColumnVector& column = batch.column(c);
+                column.texts[size] = std::move(entry->row[c]);
+                column.nulls[size] = 0;
+            }
+            ++size;
+            ++num_output_rows_;
+        }
+        batch.set_size(size);
+        return size > 0;
+    }
+
+    void SortOperator::build() {
+        top_n_ = row_limit_ != std::numeric_limits<size_t>::max();
+        Batch input;
+        uint64_t sequence = 0;
+        while (child_->next_batch(input)) {
+            num_columns_ = input.num_columns();
+            for (size_t i = 0; i < input.num_selected(); ++i) {
+                const size_t row = input.selected(i);
+                SortEntry entry;
+                input.get_row(row, entry.row);
+                parse_keys(input, row, entry);
+                entry.sequence = sequence++;
+                add_entry(std::move(entry));
+            }
+        }
+        // The child won't be read anymore, release what it holds.
+        child_.reset();
+
+        auto less = [this](const SortEntry& a, const SortEntry& b) { return before(a, b); };
+        if (runs_.empty()) {
+            if (top_n_) {
+                std::sort_heap(entries_.begin(), entries_.end(), less);
+            } else {
+                std::sort(entries_.begin(), entries_.end(), less);
+            }
+            return;
+        }
+        if (!entries_.empty()) {
+            write_run();
+        }
+        merge_runs();
+        open_merge(runs_);
+        runs_.clear();
+        merging_ = true;
+    }
+
+    void SortOperator::add_entry(SortEntry entry) {
+        auto less = [this](const SortEntry& a, const SortEntry& b) { return before(a, b); };
+        if (top_n_ && entries_.size() == row_limit_) {
+            // The heap is full: the row only makes it if it comes before the last of the rows kept, which it replaces.
+            if (row_limit_ == 0 || !before(entry, entries_.front())) {
+                return;
+            }
+            std::pop_heap(entries_.begin(), entries_.end(), less);
+            memory_usage_ -= entry_size(entries_.back());
+            entries_.pop_back();
+        }
+
+        memory_usage_ += entry_size(entry);
+        entries_.push_back(std::move(entry));
+        if (top_n_) {
+            std::push_heap(entries_.begin(), entries_.end(), less);
+        }
+        if (memory_usage_ > memory_budget_) {
+            // If the first rows don't fit in memory either, this becomes a full external sort.
+            top_n_ = false;
+            write_run();
+        }
+    }
+
+    void SortOperator::parse_keys(const Batch& batch, size_t row, SortEntry& entry) const {
+        entry.keys.resize(keys_.size());
+        for (size_t k = 0; k < keys_.size(); ++k) {
+            const ColumnVector& column = batch.column(keys_[k].column);
+            ParsedKey& key = entry.keys[k];
+            key = ParsedKey{};
+            key.is_null = column.nulls[row] != 0;
+            if (key.is_null || keys_[k].type == SortKeyType::TEXT) {
+                continue;
+            }
+            if (column.type == command::Datatype::INT) {
+                key.int_value = column.ints[row];
+                key.real_value = column.ints[row];
+                continue;
+            }
+
+            // Operators that don't produce batches themselves hand out every value as TEXT, with NULL as an empty
+            // string: a value that isn't a number is NULL.
+            const std::string& text = column.texts[row];
+            if (keys_[k].type == SortKeyType::INT) {
+                auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), key.int_value);
+                key.is_null = error != std::errc() || end != text.data() + text.size();
+            } else {
+                char* end = nullptr;
+                key.real_value = std::strtod(text.c_str(), &end);
+                key.is_null = text.empty() || end != text.c_str() + text.size();
+            }
+        }
+    }
+
+    int SortOperator::compare_keys(const SortEntry& a, const SortEntry& b) const {
+        for (size_t k = 0; k < keys_.size(); ++k) {
+            const ParsedKey& a_key = a.keys[k];
+            const ParsedKey& b_key = b.keys[k];
+            int result = 0;
+            if (a_key.is_null || b_key.is_null) {
+                result = compare_values(a_key.is_null, b_key.is_null);
+            } else {
+                switch (keys_[k].type) {
+                    case SortKeyType::INT:
+                        result = compare_values(a_key.int_value, b_key.int_value);
+                        break;
+                    case SortKeyType::REAL:
+                        result = compare_values(a_key.real_value, b_key.real_value);
+                        break;
+                    case SortKeyType::TEXT:
+                        result = a.row[keys_[k].column].compare(b.row[keys_[k].column]);
+                        break;
+                }
+            }
+            if (result != 0) {
+                return keys_[k].descending ? -result : result;
+            }
+        }
+        return 0;
+    }
+
+    bool SortOperator::before(const SortEntry& a, const SortEntry& b) const {
+        const int result = compare_keys(a, b);
+        return result != 0 ? result < 0 : a.sequence < b.sequence;
+    }
+
+    void SortOperator::write_run() {
+        std::sort(entries_.begin(), entries_.end(), [this](const SortEntry& a, const SortEntry& b) {
+            return before(a, b);
+        });
+        std::filesystem::path path;
+        std::ofstream file = create_run(path);
+        for (const SortEntry& entry : entries_) {
+            write_entry(file, entry);
+        }
+        file.close();
+        if (file.fail()) {
+            throw std::runtime_error("Could not write sort run: " + path.string());
+        }
+        runs_.push_back(std::move(path));
+        entries_.clear();
+        memory_usage_ = 0;
+    }
+
+    void SortOperator::merge_runs() {
+        while (runs_.size() > MAX_MERGE_FAN_IN) {
+            std::vector<std::filesystem::path> group(runs_.begin(), runs_.begin() + MAX_MERGE_FAN_IN);
+            runs_.erase(runs_.begin(), runs_.begin() + MAX_MERGE_FAN_IN);
+            open_merge(group);
+
+            std::filesystem::path path;
+            std::ofstream file = create_run(path);
+            SortEntry entry;
+            while (next_merged(entry)) {
+                write_entry(file, entry);
+            }
+            file.close();
+            if (file.fail()) {
+                throw std::runtime_error("Could not write sort run: " + path.string());
+            }
+            runs_.push_back(std::move(path));
+        }
+    }
+
+    void SortOperator::open_merge(const std::vector<std::filesystem::path>& runs) {
+        merging_runs_ = runs;
+        readers_.clear();
+        reader_heap_.clear();
+        for (const std::filesystem::path& path : runs) {
+            auto reader = std::make_unique<RunReader>();
+            reader->file.open(path, std::ios::binary);
+            if (!reader->file) {
+                throw std::runtime_error("Could not open sort run: " + path.string());
+            }
+            if (read_entry(reader->file, reader->current)) {
+                reader_heap_.push_back(readers_.size());
+            }
+            readers_.push_back(std::move(reader));
+        }
+        // A min-heap: the reader with the first row on top.
+        std::make_heap(reader_heap_.begin(), reader_heap_.end(), [this](size_t a, size_t b) {
+            return before(readers_[b]->current, readers_[a]->current);
+        });
+    }
+
+    bool SortOperator::next_merged(SortEntry& entry) {
+        if (reader_heap_.empty()) {
+            readers_.clear();
+            for (const std::filesystem::path& path : merging_runs_) {
+                std::filesystem::remove(path);
+            }
+            merging_runs_.clear();
+            return false;
+        }
+        auto after = [this](size_t a, size_t b) { return before(readers_[b]->current, readers_[a]->current); };
+        std::pop_heap(reader_heap_.begin(), reader_heap_.end(), after);
+        RunReader& reader = *readers_[reader_heap_.back()];
+        entry = std::move(reader.current);
+        if (read_entry(reader.file, reader.current)) {
+            std::push_heap(reader_heap_.begin(), reader_heap_.end(), after);
+        } else {
+            reader_heap_.pop_back();
+        }
+        return true;
+    }
+
+    void SortOperator::write_entry(std::ofstream& file, const SortEntry& entry) const {
+        spill::write_value(file, entry.sequence);
+        spill::write_value(file, static_cast<uint32_t>(entry.row.size()));
+        for (const std::string& value : entry.row) {
+            spill::write_string(file, value);
+        }
+        // The parsed keys, so that they don't need to be parsed again when merging.
+        for (const ParsedKey& key : entry.keys) {
+            spill::write_value(file, static_cast<uint8_t>(key.is_null));
+            spill::write_value(file, key.int_value);
+            spill::write_value(file, key.real_value);
+        }
+    }
+
+    bool SortOperator::read_entry(std::ifstream& file, SortEntry& entry) const {
+        if (file.peek() == std::ifstream::traits_type::eof()) {
+            return false;
+        }
+        spill::read_value(file, entry.sequence);
+        uint32_t num_values;
+        spill::read_value(file, num_values);
+        entry.row.resize(num_values);
+        for (std::string& value : entry.row) {
+            spill::read_string(file, value);
+        }
+        entry.keys.resize(keys_.size());
+        for (ParsedKey& key : entry.keys) {
+            uint8_t is_null;
+            spill::read_value(file, is_null);
+            key.is_null = is_null != 0;
+            spill::read_value(file, key.int_value);
+            spill::read_value(file, key.real_value);
+        }
+        return true;
+    }
+
+    std::ofstream SortOperator::create_run(std::filesystem::path& path) {
+        std::filesystem::create_directories(spill_dir_);
+        path = spill::unique_path(spill_dir_, "sort");
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        run_files_.push_back(path);
+        if (!file) {
+            throw std::runtime_error("Could not create sort run: " + path.string());
+        }
+        num_runs_ += 1;
+        return file;
+    }
+}  // namespace simpledb::execution
@@ -0,0 +1,67 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#ifndef SIMPLE_DB_SPILL_FILE_INTERNAL_H
+#define SIMPLE_DB_SPILL_FILE_INTERNAL_H
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+// Helpers for the temporary files that operators spill to when their input doesn't fit in their memory budget. The
+// files only live as long as the operator that wrote them, so values are written in the machine's byte order.
+namespace simpledb::execution::spill {
+    /**
+     * @brief A new path in the directory for a spill file, unique across the operators of all processes.
+     */
+    inline std::filesystem::path unique_path(const std::filesystem::path& dir, const std::string& prefix) {
+        static std::atomic<uint64_t> next_id{0};
+        return dir / (prefix + "_" + std::to_string(::getpid()) + "_" + std::to_string(next_id.fetch_add(1)) +
+                      ".spill");
+    }
+
+    template <typename T>
+    void write_value(std::ostream& file, T value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    inline void write_string(std::ostream& file, const std::string& value) {
+        write_value(file, static_cast<uint32_t>(value.size()));
+        file.write(value.data(), static_cast<std::streamsize>(value.size()));
+    }
+
+    template <typename T>
+    void read_value(std::istream& file, T& value) {
+        if (!file.read(reinterpret_cast<char*>(&value), sizeof(value))) {
+            throw std::runtime_error("Spill file is truncated.");
+        }
+    }
+
+    /**
+     * @brief Reads a string written by write_string().
+     * @param end_allowed Whether the end of the file may be reached instead, e.g. before the first value of a record.
+     * @return False if the end of the file was reached (only if end_allowed).
+     */
+    inline bool read_string(std::istream& file, std::string& value, bool end_allowed = false) {
+        uint32_t length;
+        if (!file.read(reinterpret_cast<char*>(&length), sizeof(length))) {
+            if (end_allowed && file.gcount() == 0) {
+                return false;
+            }
+            throw std::runtime_error("Spill file is truncated.");
+        }
+        value.resize(length);
+        if (!file.read(value.data(), length)) {
+            throw std::runtime_error("Spill file is truncated.");
+        }
+        return true;
+    }
+}  // namespace simpledb::execution::spill
+
+#endif  // SIMPLE_DB_SPILL_FILE_INTERNAL_H
@@ -4,21 +4,65 @@
 
 #include "simpledb/execution/table_scan_operator.h"
 
+#include "simpledb/catalog.h"
 #include "simpledb/config.h"
-#include "simpledb/serializer.h"
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace simpledb::execution {
-    TableScanOperator::TableScanOperator(const std::string& table_name, const std::filesystem::path& data_dir)
-        : table_heap_(data_dir / (table_name + ".data")), iterator_(table_heap_.begin()) {}
+    namespace {
+        serializer::RecordLayout get_record_layout(const std::string& table_name) {
+            catalog::TableSchemaPtr table_schema = catalog::get_table_schema(table_name);
+            if (table_schema == nullptr) {
+                throw std::runtime_error("Table not found in catalog: " + table_name);
+            }
+            return serializer::RecordLayout(table_schema->column_definitions);
+        }
+    }  // namespace
+
+    TableScanOperator::TableScanOperator(const std::string& table_name,
+                                         const std::filesystem::path& data_dir,
+                                         std::optional<CompiledPredicate> predicate,
+                                         std::optional<row::Signature> columns)
+        : table_heap_(data_dir / (table_name + ".data")),
+          iterator_(table_heap_.begin()),
+          layout_(get_record_layout(table_name)),
+          predicate_(std::move(predicate)),
+          columns_(std::move(columns)) {
+        if (columns_.has_value()) {
+            output_columns_ = columns_.value();
+        } else {
+            for (size_t i = 0; i < layout_.num_columns(); ++i) {
+                output_columns_.push_back(i);
+            }
+        }
+        for (size_t column_index : output_columns_) {
+            output_types_.push_back(layout_.column_type(column_index));
+        }
+    }
 
-    std::optional<row::Row> TableScanOperator::next() {
-        std::optional<std::vector<char>> next = iterator_.next();
-        if (next.has_value()) {
-            // Deserialize the next record into a Row object.
-            return serializer::deserialize(next.value());
+    bool TableScanOperator::next_batch(Batch& batch) {
+        batch.reset(output_types_);
+        size_t size = 0;
+        while (size < BATCH_CAPACITY && size < rows_left_) {
+            std::optional<storage::RecordView> next = iterator_.next();
+            if (!next.has_value()) {
+                break;
+            }
+            // Check the predicate on the record's bytes first, so that rejected records are never deserialized.
+            if (predicate_.has_value() && !predicate_->evaluate(layout_, next.value())) {
+                continue;
+            }
+            // Deserialize the requested columns of the record into the next row of the batch.
+            for (size_t i = 0; i < output_columns_.size(); ++i) {
+                read_record_column(layout_, next.value(), output_columns_[i], batch.column(i), size);
+            }
+            ++size;
         }
-        return std::nullopt;
+        batch.set_size(size);
+        rows_left_ -= size;
+        return size > 0;
     }
 }  // namespace simpledb::execution
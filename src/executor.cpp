@@ -5,12 +5,134 @@
 #include "simpledb/executor.h"
 
 #include "simpledb/config.h"
+#include "simpledb/csv.h"
 #include "simpledb/serializer.h"
 #include "simpledb/execution/row.h"
+#include "simpledb/execution/scheduler.h"
+#include "simpledb/storage/buffer_pool_manager.h"
+#include "simpledb/storage/mapped_file.h"
 #include "simpledb/storage/table_heap.h"
+#include "simpledb/table_index.h"
 #include "simpledb/utils/logging.h"
 
+#include <algorithm>
+#include <optional>
+
 namespace executor {
+    namespace {
+        /**
+         * Checks that a row (with its values in the table's column order) matches the table schema.
+         * @return An error message if it doesn't, std::nullopt otherwise.
+         */
+        std::optional<std::string> validate_row(const catalog::TableSchema& table_schema,
+                                                const std::vector<std::string>& values) {
+            if (values.size() != table_schema.column_definitions.size()) {
+                return "ERROR: Number of values does not match number of columns in table '" +
+                       table_schema.table_name + "'.";
+            }
+            for (size_t i = 0; i < values.size(); ++i) {
+                const auto& col_def = table_schema.column_definitions[i];
+                if (col_def.type == command::Datatype::INT) {
+                    int32_t value;
+                    if (!serializer::parse_int(values[i], value)) {  // Check if it can be stored as an int
+                        return "ERROR: Value '" + values[i] + "' for column '" + col_def.column_name +
+                               "' is not a valid integer.";
+                    }
+                } else if (col_def.type == command::Datatype::TEXT) {
+                    // No specific validation for TEXT, but we could add length checks or other constraints later
+                } else {
+                    return "ERROR: Unknown data type for column '" + col_def.column_name + "'.";
+                }
+            }
+            return std::nullopt;
+        }
+
+        // Points at the offending row in an error message, unless the statement only had one row.
+        std::string with_row_number(const std::string& message, size_t row_index, size_t num_rows) {
+            if (num_rows <= 1) {
+                return message;
+            }
+            return message + " (row " + std::to_string(row_index + 1) + ")";
+        }
+
+        std::string unique_violation_message(const table_index::UniqueViolation& violation) {
+            return "ERROR: Duplicate value '" + violation.value + "' for column '" + violation.column_name +
+                   "', which must be unique.";
+        }
+
+        // Index names are unique across all tables, like in most databases.
+        bool index_exists(const std::string& index_name) {
+            for (const catalog::TableSchemaPtr& schema : catalog::get_all_schemas()) {
+                for (const catalog::IndexDefinition& index : schema->indexes) {
+                    if (index.index_name == index_name) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        // Creates the (empty) file of a new index, replacing any leftover file (e.g. from a failed CREATE INDEX)
+        // that must not be mistaken for it.
+        size_t create_index_file(const std::filesystem::path& table_data_dir,
+                                 const catalog::TableSchema& table_schema,
+                                 const catalog::IndexDefinition& index) {
+            std::filesystem::path index_path =
+                table_index::index_file_path(table_data_dir, table_schema.table_name, index.index_name);
+            simpledb::storage::BufferPoolManager::Instance().DiscardFile(index_path.string());
+            std::filesystem::remove(index_path);
+            return table_index::build_index(table_data_dir, table_schema, index);
+        }
+
+        std::string rows_inserted_message(size_t num_rows) {
+            return std::to_string(num_rows) + (num_rows == 1 ? " row inserted." : " rows inserted.");
+        }
+
+        // COPY hands each thread this much of the file at a time.
+        constexpr size_t COPY_CHUNK_SIZE = 4 * 1024 * 1024;
+
+        /**
+         * The outcome of parsing one chunk of a CSV file for COPY.
+         */
+        struct CopyChunk {
+            // The serialized rows of the chunk, in file order.
+            std::vector<std::vector<char>> records;
+
+            // Number of lines in the chunk, so that errors can be reported with a line number of the whole file.
+            size_t num_lines = 0;
+
+            // If a row is invalid: what is wrong with it, and its line within the chunk (1-based).
+            std::optional<std::string> error;
+            size_t error_line = 0;
+        };
+
+        // Parses, validates and serializes one chunk of a CSV file. Runs on a worker thread.
+        CopyChunk parse_copy_chunk(std::string_view chunk,
+                                   const catalog::TableSchema& table_schema,
+                                   const serializer::RecordLayout& layout) {
+            CopyChunk result;
+            result.num_lines = std::count(chunk.begin(), chunk.end(), '\n');
+
+            csv::Reader reader(chunk);
+            std::vector<std::string> values;
+            try {
+                while (reader.next_record(values)) {
+                    std::optional<std::string> validation_error = validate_row(table_schema, values);
+                    if (validation_error.has_value()) {
+                        result.error = validation_error;
+                        result.error_line = reader.line_number();
+                        return result;
+                    }
+                    result.records.push_back(serializer::serialize(layout, values));
+                }
+            } catch (const std::runtime_error& e) {
+                result.error = "ERROR: Malformed CSV. " + std::string(e.what());
+                result.error_line = reader.line_number();
+            }
+            return result;
+        }
+    }  // namespace
+
     results::ExecutionResult execute_create_table_command(const command::CreateTableCommand& cmd,
                                                           const std::filesystem::path& table_data_dir) {
         if (catalog::table_exists(cmd.table_name)) {
@@ -18,7 +140,22 @@ namespace executor {
             return results::ExecutionResult::Error("ERROR: Table " + cmd.table_name + " already exists.");
         }
 
-        catalog::TableSchema table_schema = {cmd.table_name, cmd.column_definitions};
+        if (std::count_if(cmd.column_definitions.begin(), cmd.column_definitions.end(), [](const auto& col_def) {
+                return col_def.constraint == command::ColumnConstraint::PRIMARY_KEY;
+            }) > 1) {
+            return results::ExecutionResult::Error("ERROR: Table " + cmd.table_name +
+                                                   " can't have more than one PRIMARY KEY.");
+        }
+
+        // PRIMARY KEY and UNIQUE columns are enforced through an index, created along with the table.
+        catalog::TableSchema table_schema = {cmd.table_name,
+                                             cmd.column_definitions,
+                                             table_index::constraint_indexes(cmd.table_name, cmd.column_definitions)};
+        for (const catalog::IndexDefinition& index : table_schema.indexes) {
+            if (index_exists(index.index_name)) {
+                return results::ExecutionResult::Error("ERROR: Index " + index.index_name + " already exists.");
+            }
+        }
 
         // --- Transaction-like block for catalog update and data file creation ---
         bool catalog_successfully_updated = false;
@@ -35,6 +172,8 @@ namespace executor {
 
             // --- Step 2: Create data file ---
             table_data_path = table_data_dir / (table_schema.table_name + ".data");
+            // The buffer pool must not serve pages of an older file that used to live at the same path.
+            simpledb::storage::BufferPoolManager::Instance().DiscardFile(table_data_path.string());
             std::ofstream table_data_file(table_data_path);
             if (!table_data_file.is_open()) {
                 throw std::runtime_error("Failed to create data file (could not open). Path: " +
@@ -49,6 +188,11 @@ namespace executor {
                               table_schema.table_name,
                               table_data_path.string());
 
+            // --- Step 3: Create the files of the constraints' indexes ---
+            for (const catalog::IndexDefinition& index : table_schema.indexes) {
+                create_index_file(table_data_dir, table_schema, index);
+            }
+
             // If all steps succeeded
             return results::ExecutionResult::Ok("OK (Table '" + table_schema.table_name + "' created successfully)");
         } catch (const std::exception& e) {
@@ -68,6 +212,7 @@ namespace executor {
                 std::filesystem::remove(table_data_path);
                 logging::log.info("Removed data file for table: {}", cmd.table_name);
             }
+            table_index::remove_index_files(table_data_dir, table_schema);
 
             return results::ExecutionResult::Error("ERROR: " + std::string(e.what()) + " Table creation aborted.");
         }
@@ -76,13 +221,27 @@ namespace executor {
     results::ExecutionResult execute_drop_table_command(const command::DropTableCommand& cmd,
                                                         const std::filesystem::path& table_data_dir) {
         std::string table_name = cmd.table_name;
-        if (!catalog::table_exists(table_name)) {
+        catalog::TableSchemaPtr table_schema = catalog::get_table_schema(table_name);
+        if (table_schema == nullptr) {
             return results::ExecutionResult::Error("ERROR: Table '" + table_name + "' does not exist.");
         }
         logging::log.info("Attempting to drop table '{}'", table_name);
         std::filesystem::path table_data_path = table_data_dir / (table_name + ".data");
         // --- Transaction-like block for catalog update and data file deletion ---
 
+        try {
+            // Drop the cached pages of the table and its indexes first, so they are neither served nor written back
+            // later. This fails (and leaves the table alone) while a query is still reading them.
+            simpledb::storage::BufferPoolManager::Instance().DiscardFile(table_data_path.string());
+            for (const catalog::IndexDefinition& index : table_schema->indexes) {
+                simpledb::storage::BufferPoolManager::Instance().DiscardFile(
+                    table_index::index_file_path(table_data_dir, table_name, index.index_name).string());
+            }
+        } catch (const std::exception& e) {
+            return results::ExecutionResult::Error("ERROR: DROP TABLE failed for table '" + table_name +
+                                                   "'. Reason: " + e.what());
+        }
+
         bool catalog_successfully_updated = false;
         try {
             // --- Step 1: Remove table from catalog (in-memory and disk) ---
@@ -100,6 +259,7 @@ namespace executor {
                 logging::log.warn(
                     "Data file for table '{}' does not exist at {}", table_name, table_data_path.string());
             }
+            table_index::remove_index_files(table_data_dir, *table_schema);
             return results::ExecutionResult::Ok("OK (Table '" + table_name + "' dropped successfully)");
         } catch (const std::exception& e) {
             if (catalog_successfully_updated) {
@@ -116,12 +276,120 @@ namespace executor {
         }
     }
 
+    results::ExecutionResult execute_create_index_command(const command::CreateIndexCommand& cmd,
+                                                          const std::filesystem::path& table_data_dir) {
+        catalog::TableSchemaPtr table_schema = catalog::get_table_schema(cmd.table_name);
+        if (table_schema == nullptr) {
+            return results::ExecutionResult::Error("ERROR: Table '" + cmd.table_name + "' does not exist.");
+        }
+        const std::vector<command::ColumnDefinition>& column_definitions = table_schema->column_definitions;
+        if (std::none_of(column_definitions.begin(), column_definitions.end(), [&](const auto& col_def) {
+                return col_def.column_name == cmd.column_name;
+            })) {
+            return results::ExecutionResult::Error("ERROR: Column '" + cmd.column_name +
+                                                   "' does not exist in table '" + cmd.table_name + "'.");
+        }
+        if (index_exists(cmd.index_name)) {
+            return results::ExecutionResult::Error("ERROR: Index " + cmd.index_name + " already exists.");
+        }
+
+        catalog::IndexDefinition index{cmd.index_name, cmd.column_name, cmd.index_type};
+        std::filesystem::path index_path = table_index::index_file_path(table_data_dir, cmd.table_name, cmd.index_name);
+        try {
+            size_t num_entries = create_index_file(table_data_dir, *table_schema, index);
+            if (!catalog::add_index(cmd.table_name, index)) {
+                throw std::runtime_error("Failed to add index to catalog and persist catalog changes.");
+            }
+            logging::log.info("Index '{}' created with {} entries.", cmd.index_name, num_entries);
+            return results::ExecutionResult::Ok("OK (Index '" + cmd.index_name + "' created successfully)");
+        } catch (const std::exception& e) {
+            logging::log.error("Error occurred while creating index '{}': {}", cmd.index_name, e.what());
+            simpledb::storage::BufferPoolManager::Instance().DiscardFile(index_path.string());
+            std::filesystem::remove(index_path);
+            return results::ExecutionResult::Error("ERROR: " + std::string(e.what()) + " Index creation aborted.");
+        }
+    }
+
+    results::ExecutionResult execute_copy_command(const command::CopyCommand& cmd,
+                                                  const std::filesystem::path& table_data_dir) {
+        catalog::TableSchemaPtr table_schema = catalog::get_table_schema(cmd.table_name);
+        if (table_schema == nullptr) {
+            return results::ExecutionResult::Error("ERROR: Table '" + cmd.table_name + "' does not exist.");
+        }
+        if (!std::filesystem::is_regular_file(cmd.file_path)) {
+            return results::ExecutionResult::Error("ERROR: File '" + cmd.file_path + "' does not exist.");
+        }
+        logging::log.info("Copying rows from '{}' into table '{}'", cmd.file_path, cmd.table_name);
+
+        size_t rows_loaded = 0;
+        try {
+            simpledb::storage::MappedFile file(cmd.file_path);
+            std::string_view data = file.GetData();
+
+            // Line number (in the whole file) of the line before the current chunk.
+            size_t lines_before_chunk = 0;
+            if (cmd.header) {
+                size_t header_end = data.find('\n');
+                data = header_end == std::string_view::npos ? std::string_view() : data.substr(header_end + 1);
+                lines_before_chunk = 1;
+            }
+
+            std::vector<std::string_view> chunks = csv::split_into_chunks(data, COPY_CHUNK_SIZE);
+            const serializer::RecordLayout layout(table_schema->column_definitions);
+            simpledb::execution::TaskGroup task_group;
+            const size_t num_threads = task_group.scheduler().num_threads();
+            simpledb::storage::TableHeap table_heap((table_data_dir / (cmd.table_name + ".data")).string());
+            std::vector<simpledb::storage::RecordId> record_ids;
+
+            // Parse one chunk per worker thread at a time, so at most num_threads chunks are held in memory.
+            for (size_t round_start = 0; round_start < chunks.size(); round_start += num_threads) {
+                size_t round_end = std::min(chunks.size(), round_start + num_threads);
+                std::vector<CopyChunk> parsed_chunks(round_end - round_start);
+                for (size_t i = round_start; i < round_end; ++i) {
+                    task_group.submit([&, i] {
+                        parsed_chunks[i - round_start] = parse_copy_chunk(chunks[i], *table_schema, layout);
+                    });
+                }
+                task_group.wait();
+
+                // Append in file order, so the table ends up in the same order as the file.
+                for (CopyChunk& chunk : parsed_chunks) {
+                    if (chunk.error.has_value()) {
+                        return results::ExecutionResult::Error(
+                            *chunk.error + " (line " + std::to_string(lines_before_chunk + chunk.error_line) + ") " +
+                            std::to_string(rows_loaded) + " row(s) were loaded before the error.");
+                    }
+                    std::optional<table_index::UniqueViolation> violation =
+                        table_index::find_unique_violation(table_data_dir, *table_schema, chunk.records);
+                    if (violation.has_value()) {
+                        return results::ExecutionResult::Error(unique_violation_message(*violation) + " " +
+                                                               std::to_string(rows_loaded) +
+                                                               " row(s) were loaded before the error.");
+                    }
+                    if (!table_heap.InsertRecords(chunk.records, &record_ids)) {
+                        return results::ExecutionResult::Error(
+                            "ERROR: Failed to load rows. A record may be too large for a page. " +
+                            std::to_string(rows_loaded) + " row(s) were loaded before the error.");
+                    }
+                    table_index::insert_records(table_data_dir, *table_schema, chunk.records, record_ids);
+                    rows_loaded += chunk.records.size();
+                    lines_before_chunk += chunk.num_lines;
+                }
+            }
+        } catch (const std::exception& e) {
+            logging::log.error("Error occurred while copying into table '{}': {}", cmd.table_name, e.what());
+            return results::ExecutionResult::Error("ERROR: COPY failed for table '" + cmd.table_name +
+                                                   "'. Reason: " + e.what());
+        }
+        return results::ExecutionResult::Ok(rows_inserted_message(rows_loaded));
+    }
+
     results::ExecutionResult execute_show_tables_command() {
-        const std::vector<catalog::TableSchema>& table_schemas = catalog::get_all_schemas();
+        const std::vector<catalog::TableSchemaPtr> table_schemas = catalog::get_all_schemas();
         std::vector<std::string> headers = {"Table Name"};
         std::vector<row::Row> data;
         for (const auto& schema : table_schemas) {
-            data.push_back({schema.table_name});
+            data.push_back({schema->table_name});
         }
         results::ResultSet result_set{headers, data};
         return results::ExecutionResult::SuccessWithData(result_set, std::nullopt);
@@ -129,78 +397,91 @@ namespace executor {
 
     results::ExecutionResult execute_insert_command(const command::InsertCommand& cmd,
                                                     const std::filesystem::path& table_data_dir) {
-        std::optional<catalog::TableSchema> table_schema = catalog::get_table_schema(cmd.table_name);
-        if (!table_schema.has_value()) {
+        catalog::TableSchemaPtr table_schema = catalog::get_table_schema(cmd.table_name);
+        if (table_schema == nullptr) {
             return results::ExecutionResult::Error("ERROR: Table '" + cmd.table_name + "' does not exist.");
         }
-        logging::log.info("Inserting data into table '{}'", cmd.table_name);
-        std::filesystem::path table_data_path = table_data_dir / (cmd.table_name + ".data");
+        logging::log.info("Inserting {} row(s) into table '{}'", cmd.rows.size(), cmd.table_name);
+        const size_t num_columns = table_schema->column_definitions.size();
 
         // INSERT INTO can be of 2 types:
-        // 1. INSERT INTO table_name VALUES (val1, val2, ...);
-        // 2. INSERT INTO table_name (col1, col2, ...) VALUES (val1, val2, ...);
-        // todo: We don't handle multiple rows in a single INSERT command yet.
-
-        std::vector<std::string> ordered_values;
-
-        if (cmd.columns.empty()) {
-            // Type 1: INSERT INTO table_name VALUES (val1, val2, ...);
-            if (cmd.values.size() != table_schema->column_definitions.size()) {
-                return results::ExecutionResult::Error(
-                    "ERROR: Number of values does not match number of columns in table '" + cmd.table_name + "'.");
-            }
-            ordered_values = cmd.values;  // Use values directly as they are in order
-        } else {
-            // Type 2: INSERT INTO table_name (col1, col2, ...) VALUES (val1, val2, ...);
-            if (cmd.columns.size() != cmd.values.size()) {
-                return results::ExecutionResult::Error(
-                    "ERROR: Number of columns does not match number of values in INSERT command for table '" +
-                    cmd.table_name + "'.");
-            }
+        // 1. INSERT INTO table_name VALUES (val1, val2, ...), (val1, val2, ...), ...;
+        // 2. INSERT INTO table_name (col1, col2, ...) VALUES (val1, val2, ...), (val1, val2, ...), ...;
 
+        // For type 2, map the specified columns to their position in the table once for the whole statement.
+        std::vector<size_t> column_positions;
+        if (!cmd.columns.empty()) {
             // Validate that the provided columns exist in the table schema
             std::unordered_map<std::string, size_t> column_index_map;
-            for (size_t i = 0; i < table_schema->column_definitions.size(); ++i) {
+            for (size_t i = 0; i < num_columns; ++i) {
                 column_index_map[table_schema->column_definitions[i].column_name] = i;
             }
 
-            ordered_values.resize(table_schema->column_definitions.size(), "");
-            for (size_t i = 0; i < cmd.columns.size(); ++i) {
-                const auto& col = cmd.columns[i];
-                if (column_index_map.find(col) == column_index_map.end()) {
+            for (const auto& col : cmd.columns) {
+                auto it = column_index_map.find(col);
+                if (it == column_index_map.end()) {
                     return results::ExecutionResult::Error("ERROR: Column '" + col + "' does not exist in table '" +
                                                            cmd.table_name + "'.");
                 }
-                ordered_values[column_index_map[col]] = cmd.values[i];
+                column_positions.push_back(it->second);
             }
         }
 
-        // Validate the values against the table schema
-        for (size_t i = 0; i < ordered_values.size(); ++i) {
-            const auto& col_def = table_schema->column_definitions[i];
-            if (col_def.type == command::Datatype::INT) {
-                try {
-                    std::stoi(ordered_values[i]);  // Check if it can be converted to int
-                } catch (const std::invalid_argument&) {
-                    return results::ExecutionResult::Error("ERROR: Value '" + ordered_values[i] + "' for column '" +
-                                                           col_def.column_name + "' is not a valid integer.");
+        // Validate and serialize every row before touching the table, so a bad row inserts nothing.
+        const serializer::RecordLayout layout(table_schema->column_definitions);
+        std::vector<std::vector<char>> records;
+        records.reserve(cmd.rows.size());
+        std::vector<std::string> ordered_values;
+        for (size_t row_index = 0; row_index < cmd.rows.size(); ++row_index) {
+            const std::vector<std::string>& values = cmd.rows[row_index];
+
+            if (cmd.columns.empty()) {
+                // Type 1: Use values directly as they are in order
+                if (values.size() != num_columns) {
+                    return results::ExecutionResult::Error(with_row_number(
+                        "ERROR: Number of values does not match number of columns in table '" + cmd.table_name + "'.",
+                        row_index,
+                        cmd.rows.size()));
                 }
-            } else if (col_def.type == command::Datatype::TEXT) {
-                // No specific validation for TEXT, but we could add length checks or other constraints later
+                ordered_values = values;
             } else {
-                return results::ExecutionResult::Error("ERROR: Unknown data type for column '" + col_def.column_name +
-                                                       "'.");
+                // Type 2: Put each value in the position of its column
+                if (values.size() != cmd.columns.size()) {
+                    return results::ExecutionResult::Error(
+                        with_row_number("ERROR: Number of columns does not match number of values in INSERT command "
+                                        "for table '" +
+                                            cmd.table_name + "'.",
+                                        row_index,
+                                        cmd.rows.size()));
+                }
+                ordered_values.assign(num_columns, "");
+                for (size_t i = 0; i < values.size(); ++i) {
+                    ordered_values[column_positions[i]] = values[i];
+                }
             }
+
+            // Validate the values against the table schema
+            std::optional<std::string> validation_error = validate_row(*table_schema, ordered_values);
+            if (validation_error.has_value()) {
+                return results::ExecutionResult::Error(
+                    with_row_number(*validation_error, row_index, cmd.rows.size()));
+            }
+            records.push_back(serializer::serialize(layout, ordered_values));
         }
 
-        // Serialize the ordered values into a vector<char> format
-        // We will use a format [length of value][value][length of value][value]...
-        std::vector<char> record_data = serializer::serialize(ordered_values);
+        std::optional<table_index::UniqueViolation> violation =
+            table_index::find_unique_violation(table_data_dir, *table_schema, records);
+        if (violation.has_value()) {
+            return results::ExecutionResult::Error(
+                with_row_number(unique_violation_message(*violation), violation->record_index, cmd.rows.size()));
+        }
 
-        // Insert the record into the table heap.
-        simpledb::storage::TableHeap table_heap(table_data_path.string());
-        if (table_heap.InsertRecord(record_data)) {
-            return results::ExecutionResult::Ok("1 row inserted.");
+        // Append the whole batch through one heap, with a single flush at the end.
+        simpledb::storage::TableHeap table_heap((table_data_dir / (cmd.table_name + ".data")).string());
+        std::vector<simpledb::storage::RecordId> record_ids;
+        if (table_heap.InsertRecords(records, &record_ids)) {
+            table_index::insert_records(table_data_dir, *table_schema, records, record_ids);
+            return results::ExecutionResult::Ok(rows_inserted_message(records.size()));
         } else {
             // If it fails (e.g., record too big), return an error.
             return results::ExecutionResult::Error(
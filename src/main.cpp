@@ -6,16 +6,22 @@
 #include <readline/readline.h>
 #include <readline/history.h>
 #include <variant>
+#include <vector>
 
 #include "simpledb/history.h"
 #include "simpledb/config.h"
 #include "simpledb/utils/logging.h"
 #include "simpledb/catalog.h"
 #include "simpledb/executor.h"
+#include "simpledb/execution/scheduler.h"
 #include "simpledb/query_runner.h"
 
+// How many rows of a query's result are read and printed at a time.
+constexpr size_t ROWS_PER_PRINT = 1024;
+
 int main() {
     config::init_config();
+    simpledb::execution::Scheduler::configure_instance(config::get_config().num_threads);
     catalog::initialize(config::get_config().data_dir);
     history::init();
     // Register history::save to be called on normal program exit
@@ -75,24 +81,36 @@ int main() {
             continue;
         }
 
-        results::ExecutionResult result = query_runner::QueryRunner::run_query(input_line);
+        query_runner::QueryResult query_result = query_runner::QueryRunner::open_query(input_line);
 
-        if (result.get_message().has_value()) {
-            std::cout << result.get_message().value() << std::endl;
-        }
-        if (result.has_data()) {
-            // todo: Handle the data in a more structured way, maybe with a table format.
-            const results::ResultSet& result_set = result.get_data();
-            for (const auto& item : result_set.headers) {
-                std::cout << item << "\t";
+        if (auto* result = std::get_if<results::ExecutionResult>(&query_result)) {
+            if (result->get_message().has_value()) {
+                std::cout << result->get_message().value() << std::endl;
             }
-            std::cout << std::endl;
-            for (const auto& row : result_set.rows) {
-                for (const auto& col : row) {
-                    std::cout << col << "\t";
+            continue;
+        }
+
+        // todo: Handle the data in a more structured way, maybe with a table format.
+        // The rows are printed a batch at a time as the query produces them, so the first rows show up right away,
+        // and a large result is never held in memory all at once.
+        results::ResultCursor& cursor = std::get<results::ResultCursor>(query_result);
+        for (const auto& item : cursor.headers()) {
+            std::cout << item << "\t";
+        }
+        std::cout << std::endl;
+        try {
+            std::vector<row::Row> rows;
+            while (cursor.next_rows(rows, ROWS_PER_PRINT)) {
+                for (const auto& row : rows) {
+                    for (const auto& col : row) {
+                        std::cout << col << "\t";
+                    }
+                    std::cout << '\n';
                 }
-                std::cout << std::endl;
+                std::cout.flush();
             }
+        } catch (const std::exception& e) {
+            std::cout << e.what() << std::endl;
         }
     }
 
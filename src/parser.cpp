@@ -39,12 +39,18 @@ namespace parser {
         if (result.type() == typeid(command::CreateTableCommand)) {
             return std::any_cast<command::CreateTableCommand>(result);
         }
+        if (result.type() == typeid(command::CreateIndexCommand)) {
+            return std::any_cast<command::CreateIndexCommand>(result);
+        }
         if (result.type() == typeid(command::DropTableCommand)) {
             return std::any_cast<command::DropTableCommand>(result);
         }
         if (result.type() == typeid(command::InsertCommand)) {
             return std::any_cast<command::InsertCommand>(result);
         }
+        if (result.type() == typeid(command::CopyCommand)) {
+            return std::any_cast<command::CopyCommand>(result);
+        }
         if (result.type() == typeid(command::ShowTablesCommand)) {
             return std::any_cast<command::ShowTablesCommand>(result);
         }
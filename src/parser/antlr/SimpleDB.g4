@@ -11,21 +11,64 @@ grammar SimpleDB;
 // The entry point for any command. It can be one of the following statements,
 // optionally followed by a semicolon, and then the End-Of-File marker.
 query
-    : (createStatement | dropStatement | insertStatement | showStatement | selectStatement) SEMICOLON? EOF
+    : (createStatement | createIndexStatement | dropStatement | insertStatement | copyStatement | showStatement
+       | selectStatement) SEMICOLON? EOF
     ;
 
 // --- SELECT Statement ---
 selectStatement
-    : SELECT projection FROM tableName=IDENTIFIER whereClause?
+    : SELECT projection FROM tableName=identifier joinClause? whereClause? groupByClause? orderByClause? limitClause?
+    ;
+
+// e.g. SELECT users.name, orders.total FROM users JOIN orders ON users.id = orders.user_id
+joinClause
+    : INNER? JOIN tableName=identifier ON leftColumn=columnRef '=' rightColumn=columnRef
+    ;
+
+// A column, optionally qualified with its table's name, e.g. users.id
+columnRef
+    : (tableName=identifier DOT)? columnName=identifier
     ;
 
 projection
     : ASTERISK
-    | columnList
+    | selectItem (COMMA selectItem)*
+    ;
+
+// A column, or an aggregate function of a column, e.g. SELECT dept, COUNT(*), AVG(salary) FROM employees GROUP BY dept
+selectItem
+    : columnRef
+    | aggregateCall
+    ;
+
+aggregateCall
+    : COUNT LPAREN ASTERISK RPAREN
+    | aggregateFunction LPAREN columnRef RPAREN
+    ;
+
+aggregateFunction
+    : COUNT
+    | SUM
+    | MIN
+    | MAX
+    | AVG
     ;
 
 columnList
-    : IDENTIFIER (COMMA IDENTIFIER)*
+    : identifier (COMMA identifier)*
+    ;
+
+// The name of a table, column or index. Besides plain identifiers, this accepts the keywords that only mean
+// something in one spot of one statement, so that e.g. a column can still be called "header". The keywords that
+// start or structure statements (SELECT, FROM, WHERE, ...) stay reserved.
+identifier
+    : IDENTIFIER
+    | COPY | WITH | HEADER
+    | INDEX | USING | BTREE | HASH
+    | PRIMARY | KEY | UNIQUE
+    | LIMIT | OFFSET
+    | COUNT | SUM | MIN | MAX | AVG
+    | ASC | DESC
     ;
 
 // TODO: Extend WHERE clause support for more complex expressions
@@ -37,13 +80,32 @@ columnList
 // - Support for expressions on both sides: WHERE col1 = col2 AND col3 > col4 + 5
 // - Subqueries: WHERE id IN (SELECT user_id FROM orders)
 // - Functions: WHERE UPPER(name) = 'ALICE' or WHERE LENGTH(name) > 5
-whereClause: WHERE IDENTIFIER comparisonOp value;
+whereClause: WHERE columnRef comparisonOp value;
 
 comparisonOp: '=' | '<' | '>' | '<=' | '>=' | '!=' ;
 
+groupByClause
+    : GROUP BY columnRef (COMMA columnRef)*
+    ;
+
+// e.g. SELECT * FROM users ORDER BY age DESC, name. With GROUP BY, the keys are items of the SELECT list, e.g.
+// SELECT dept, COUNT(*) FROM users GROUP BY dept ORDER BY COUNT(*) DESC
+orderByClause
+    : ORDER BY orderItem (COMMA orderItem)*
+    ;
+
+orderItem
+    : selectItem (ASC | DESC)?
+    ;
+
+// e.g. SELECT * FROM users LIMIT 10 OFFSET 20
+limitClause
+    : LIMIT limit=INTEGER_LITERAL (OFFSET offset=INTEGER_LITERAL)?
+    ;
+
 // --- CREATE TABLE Statement ---
 createStatement
-    : CREATE TABLE tableName=IDENTIFIER LPAREN columnDefinitions RPAREN
+    : CREATE TABLE tableName=identifier LPAREN columnDefinitions RPAREN
     ;
 
 columnDefinitions
@@ -51,7 +113,13 @@ columnDefinitions
     ;
 
 columnDef
-    : columnName=IDENTIFIER columnType=dataType
+    : columnName=identifier columnType=dataType columnConstraint?
+    ;
+
+// e.g. CREATE TABLE users (id INT PRIMARY KEY, email TEXT UNIQUE, name TEXT)
+columnConstraint
+    : PRIMARY KEY
+    | UNIQUE
     ;
 
 dataType
@@ -59,14 +127,31 @@ dataType
     | TEXT_TYPE
     ;
 
+// --- CREATE INDEX Statement ---
+// Builds a secondary index on a column, e.g. CREATE INDEX users_by_age ON users (age).
+// Indexes are B+ trees unless USING HASH is given, e.g. CREATE INDEX users_by_id ON users USING HASH (id)
+createIndexStatement
+    : CREATE INDEX indexName=identifier ON tableName=identifier indexMethod? LPAREN columnName=identifier RPAREN
+    ;
+
+indexMethod
+    : USING BTREE
+    | USING HASH
+    ;
+
 // --- DROP TABLE Statement ---
 dropStatement
-    : DROP TABLE tableName=IDENTIFIER
+    : DROP TABLE tableName=identifier
     ;
 
 // --- INSERT Statement ---
 insertStatement
-    : INSERT INTO tableName=IDENTIFIER (LPAREN columnList RPAREN)? VALUES LPAREN valueList RPAREN
+    : INSERT INTO tableName=identifier (LPAREN columnList RPAREN)? VALUES valueRow (COMMA valueRow)*
+    ;
+
+// One row of an INSERT, e.g. (1, 'Alice'). A single INSERT can carry many of them.
+valueRow
+    : LPAREN valueList RPAREN
     ;
 
 valueList
@@ -81,6 +166,12 @@ value
     | INTEGER_LITERAL
     ;
 
+// --- COPY Statement ---
+// Loads a CSV file into a table, e.g. COPY users FROM '/tmp/users.csv' WITH HEADER
+copyStatement
+    : COPY tableName=identifier FROM filePath=STRING_LITERAL (WITH HEADER)?
+    ;
+
 // --- SHOW TABLES Statement ---
 showStatement
     : SHOW TABLES
@@ -102,12 +193,37 @@ showStatement
 SELECT : S E L E C T;
 FROM   : F R O M;
 WHERE  : W H E R E;
+GROUP  : G R O U P;
+BY     : B Y;
+ORDER  : O R D E R;
+ASC    : A S C;
+DESC   : D E S C;
+COUNT  : C O U N T;
+SUM    : S U M;
+MIN    : M I N;
+MAX    : M A X;
+AVG    : A V G;
+LIMIT  : L I M I T;
+OFFSET : O F F S E T;
+INNER  : I N N E R;
+JOIN   : J O I N;
 CREATE : C R E A T E;
 TABLE  : T A B L E;
+INDEX  : I N D E X;
+ON     : O N;
+USING  : U S I N G;
+BTREE  : B T R E E;
+HASH   : H A S H;
+PRIMARY: P R I M A R Y;
+KEY    : K E Y;
+UNIQUE : U N I Q U E;
 DROP   : D R O P;
 INSERT : I N S E R T;
 INTO   : I N T O;
 VALUES : V A L U E S;
+COPY   : C O P Y;
+WITH   : W I T H;
+HEADER : H E A D E R;
 SHOW   : S H O W;
 TABLES : T A B L E S;
 INT_TYPE : I N T;
@@ -130,6 +246,7 @@ IDENTIFIER
 
 // --- Punctuation and Symbols ---
 COMMA    : ',';
+DOT      : '.';
 ASTERISK : '*';
 SEMICOLON: ';';
 LPAREN   : '(';
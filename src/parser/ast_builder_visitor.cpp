@@ -5,8 +5,23 @@
 #include "ast_builder_visitor.h"
 #include "simpledb/command.h"
 #include "simpledb/ast/ast.h"
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
 #include <vector>
 
+namespace {
+    // Parses the row count of a LIMIT or OFFSET, which the grammar already restricts to digits.
+    size_t parse_row_count(const std::string &text) {
+        size_t count = 0;
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), count);
+        if (error != std::errc() || end != text.data() + text.size()) {
+            throw std::runtime_error("Row count out of range: " + text);
+        }
+        return count;
+    }
+}  // namespace
+
 std::string AstBuilderVisitor::processIdentifier(const std::string &identifier) {
     if (identifier.front() == '"' && identifier.back() == '"' && identifier.length() >= 2) {
         // Remove outer quotes and convert escaped quotes
@@ -26,12 +41,18 @@ std::any AstBuilderVisitor::visitQuery(SimpleDBParser::QueryContext *ctx) {
     if (ctx->createStatement()) {
         return visit(ctx->createStatement());
     }
+    if (ctx->createIndexStatement()) {
+        return visit(ctx->createIndexStatement());
+    }
     if (ctx->dropStatement()) {
         return visit(ctx->dropStatement());
     }
     if (ctx->insertStatement()) {
         return visit(ctx->insertStatement());
     }
+    if (ctx->copyStatement()) {
+        return visit(ctx->copyStatement());
+    }
     if (ctx->showStatement()) {
         return visit(ctx->showStatement());
     }
@@ -44,28 +65,119 @@ std::any AstBuilderVisitor::visitQuery(SimpleDBParser::QueryContext *ctx) {
 std::any AstBuilderVisitor::visitSelectStatement(SimpleDBParser::SelectStatementContext *ctx) {
     ast::SelectCommand command;
     command.table_name = processIdentifier(ctx->tableName->getText());
-    command.projection = std::any_cast<std::vector<std::string>>(visit(ctx->projection()));
+    if (ctx->joinClause()) {
+        command.join_clause = std::any_cast<ast::JoinClause>(visit(ctx->joinClause()));
+    }
+    auto select_items = std::any_cast<std::vector<ast::SelectItem>>(visit(ctx->projection()));
+    if (ctx->groupByClause()) {
+        for (SimpleDBParser::ColumnRefContext *column : ctx->groupByClause()->columnRef()) {
+            command.group_by.push_back(std::any_cast<std::string>(visit(column)));
+        }
+    }
+    const bool has_aggregates = std::any_of(select_items.begin(), select_items.end(), [](const ast::SelectItem &item) {
+        return item.aggregate.has_value();
+    });
+    if (has_aggregates || !command.group_by.empty()) {
+        if (select_items.empty()) {
+            throw std::runtime_error("SELECT * can't be used with GROUP BY.");
+        }
+        command.select_items = std::move(select_items);
+    } else {
+        for (const ast::SelectItem &item : select_items) {
+            command.projection.push_back(item.column_name);
+        }
+    }
     if (ctx->whereClause()) {
         command.where_clause = std::any_cast<ast::WhereClause>(visit(ctx->whereClause()));
     }
+    if (ctx->orderByClause()) {
+        for (SimpleDBParser::OrderItemContext *item : ctx->orderByClause()->orderItem()) {
+            command.order_by.push_back(std::any_cast<ast::OrderByItem>(visit(item)));
+        }
+    }
+    if (ctx->limitClause()) {
+        command.limit_clause = std::any_cast<ast::LimitClause>(visit(ctx->limitClause()));
+    }
     return command;
 }
 
+std::any AstBuilderVisitor::visitJoinClause(SimpleDBParser::JoinClauseContext *ctx) {
+    ast::JoinClause join_clause;
+    join_clause.table_name = processIdentifier(ctx->tableName->getText());
+    join_clause.left_column = std::any_cast<std::string>(visit(ctx->leftColumn));
+    join_clause.right_column = std::any_cast<std::string>(visit(ctx->rightColumn));
+    return join_clause;
+}
+
+std::any AstBuilderVisitor::visitColumnRef(SimpleDBParser::ColumnRefContext *ctx) {
+    // A qualified column is kept as "table.column", which the planner resolves.
+    std::string column_name = processIdentifier(ctx->columnName->getText());
+    if (ctx->tableName) {
+        return processIdentifier(ctx->tableName->getText()) + "." + column_name;
+    }
+    return column_name;
+}
+
 std::any AstBuilderVisitor::visitProjection(SimpleDBParser::ProjectionContext *ctx) {
-    if (ctx->ASTERISK()) {
-        return std::vector<std::string>();
+    // SELECT * is an empty list.
+    std::vector<ast::SelectItem> select_items;
+    for (SimpleDBParser::SelectItemContext *item : ctx->selectItem()) {
+        select_items.push_back(std::any_cast<ast::SelectItem>(visit(item)));
     }
-    return visit(ctx->columnList());
+    return select_items;
+}
+
+std::any AstBuilderVisitor::visitSelectItem(SimpleDBParser::SelectItemContext *ctx) {
+    if (ctx->aggregateCall()) {
+        return visit(ctx->aggregateCall());
+    }
+    return ast::SelectItem{std::any_cast<std::string>(visit(ctx->columnRef())), std::nullopt};
+}
+
+std::any AstBuilderVisitor::visitAggregateCall(SimpleDBParser::AggregateCallContext *ctx) {
+    if (!ctx->aggregateFunction()) {
+        // COUNT(*)
+        return ast::SelectItem{"", ast::AggregateFunction::COUNT};
+    }
+    return ast::SelectItem{std::any_cast<std::string>(visit(ctx->columnRef())),
+                           std::any_cast<ast::AggregateFunction>(visit(ctx->aggregateFunction()))};
+}
+
+std::any AstBuilderVisitor::visitAggregateFunction(SimpleDBParser::AggregateFunctionContext *ctx) {
+    if (ctx->COUNT()) {
+        return ast::AggregateFunction::COUNT;
+    } else if (ctx->SUM()) {
+        return ast::AggregateFunction::SUM;
+    } else if (ctx->MIN()) {
+        return ast::AggregateFunction::MIN;
+    } else if (ctx->MAX()) {
+        return ast::AggregateFunction::MAX;
+    } else if (ctx->AVG()) {
+        return ast::AggregateFunction::AVG;
+    }
+    throw std::runtime_error("Unsupported aggregate function in AST builder visitor.");
 }
 
 std::any AstBuilderVisitor::visitWhereClause(SimpleDBParser::WhereClauseContext *ctx) {
     ast::WhereClause where_clause;
-    where_clause.column_name = processIdentifier(ctx->IDENTIFIER()->getText());
+    where_clause.column_name = std::any_cast<std::string>(visit(ctx->columnRef()));
     where_clause.op = std::any_cast<ast::ComparisonOp>(visit(ctx->comparisonOp()));
     where_clause.value = std::any_cast<std::string>(visit(ctx->value()));
     return where_clause;
 }
 
+std::any AstBuilderVisitor::visitOrderItem(SimpleDBParser::OrderItemContext *ctx) {
+    return ast::OrderByItem{std::any_cast<ast::SelectItem>(visit(ctx->selectItem())), ctx->DESC() != nullptr};
+}
+
+std::any AstBuilderVisitor::visitLimitClause(SimpleDBParser::LimitClauseContext *ctx) {
+    ast::LimitClause limit_clause{parse_row_count(ctx->limit->getText())};
+    if (ctx->offset) {
+        limit_clause.offset = parse_row_count(ctx->offset->getText());
+    }
+    return limit_clause;
+}
+
 std::any AstBuilderVisitor::visitComparisonOp(SimpleDBParser::ComparisonOpContext *ctx) {
     if (ctx->getText() == "=") {
         return ast::ComparisonOp::EQUALS;
@@ -85,7 +197,7 @@ std::any AstBuilderVisitor::visitComparisonOp(SimpleDBParser::ComparisonOpContex
 
 std::any AstBuilderVisitor::visitColumnList(SimpleDBParser::ColumnListContext *ctx) {
     std::vector<std::string> columns;
-    for (const auto &item : ctx->IDENTIFIER()) {
+    for (const auto &item : ctx->identifier()) {
         columns.push_back(processIdentifier(item->getText()));
     }
     return columns;
@@ -110,9 +222,19 @@ std::any AstBuilderVisitor::visitColumnDef(SimpleDBParser::ColumnDefContext *ctx
     command::ColumnDefinition column_def;
     column_def.column_name = processIdentifier(ctx->columnName->getText());
     column_def.type = std::any_cast<command::Datatype>(visit(ctx->dataType()));
+    if (ctx->columnConstraint()) {
+        column_def.constraint = std::any_cast<command::ColumnConstraint>(visit(ctx->columnConstraint()));
+    }
     return column_def;
 }
 
+std::any AstBuilderVisitor::visitColumnConstraint(SimpleDBParser::ColumnConstraintContext *ctx) {
+    if (ctx->PRIMARY()) {
+        return command::ColumnConstraint::PRIMARY_KEY;
+    }
+    return command::ColumnConstraint::UNIQUE;
+}
+
 std::any AstBuilderVisitor::visitDataType(SimpleDBParser::DataTypeContext *ctx) {
     if (ctx->INT_TYPE()) {
         return command::Datatype::INT;
@@ -122,6 +244,24 @@ std::any AstBuilderVisitor::visitDataType(SimpleDBParser::DataTypeContext *ctx)
     throw std::runtime_error("Unsupported data type in AST builder visitor.");
 }
 
+std::any AstBuilderVisitor::visitCreateIndexStatement(SimpleDBParser::CreateIndexStatementContext *ctx) {
+    command::CreateIndexCommand command;
+    command.index_name = processIdentifier(ctx->indexName->getText());
+    command.table_name = processIdentifier(ctx->tableName->getText());
+    command.column_name = processIdentifier(ctx->columnName->getText());
+    if (ctx->indexMethod()) {
+        command.index_type = std::any_cast<command::IndexType>(visit(ctx->indexMethod()));
+    }
+    return command;
+}
+
+std::any AstBuilderVisitor::visitIndexMethod(SimpleDBParser::IndexMethodContext *ctx) {
+    if (ctx->HASH()) {
+        return command::IndexType::HASH;
+    }
+    return command::IndexType::BTREE;
+}
+
 std::any AstBuilderVisitor::visitDropStatement(SimpleDBParser::DropStatementContext *ctx) {
     command::DropTableCommand command;
     command.table_name = processIdentifier(ctx->tableName->getText());
@@ -134,10 +274,14 @@ std::any AstBuilderVisitor::visitInsertStatement(SimpleDBParser::InsertStatement
     if (ctx->columnList()) {
         command.columns = std::any_cast<std::vector<std::string>>(visit(ctx->columnList()));
     }
-    command.values = std::any_cast<std::vector<std::string>>(visit(ctx->valueList()));
+    for (const auto &row : ctx->valueRow()) {
+        command.rows.push_back(std::any_cast<std::vector<std::string>>(visit(row)));
+    }
     return command;
 }
 
+std::any AstBuilderVisitor::visitValueRow(SimpleDBParser::ValueRowContext *ctx) { return visit(ctx->valueList()); }
+
 std::any AstBuilderVisitor::visitValueList(SimpleDBParser::ValueListContext *ctx) {
     std::vector<std::string> values;
     for (const auto &item : ctx->value()) {
@@ -146,6 +290,16 @@ std::any AstBuilderVisitor::visitValueList(SimpleDBParser::ValueListContext *ctx
     return values;
 }
 
+std::any AstBuilderVisitor::visitCopyStatement(SimpleDBParser::CopyStatementContext *ctx) {
+    command::CopyCommand command;
+    command.table_name = processIdentifier(ctx->tableName->getText());
+    // Remove the surrounding single quotes
+    std::string file_path = ctx->filePath->getText();
+    command.file_path = file_path.substr(1, file_path.length() - 2);
+    command.header = ctx->HEADER() != nullptr;
+    return command;
+}
+
 std::any AstBuilderVisitor::visitValue(SimpleDBParser::ValueContext *ctx) {
     if (ctx->STRING_LITERAL()) {
         std::string text = ctx->STRING_LITERAL()->getText();
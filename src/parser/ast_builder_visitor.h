@@ -16,10 +16,24 @@ class AstBuilderVisitor : public SimpleDBBaseVisitor {
 
     std::any visitSelectStatement(SimpleDBParser::SelectStatementContext *ctx) override;
 
+    std::any visitJoinClause(SimpleDBParser::JoinClauseContext *ctx) override;
+
+    std::any visitColumnRef(SimpleDBParser::ColumnRefContext *ctx) override;
+
     std::any visitProjection(SimpleDBParser::ProjectionContext *ctx) override;
 
+    std::any visitSelectItem(SimpleDBParser::SelectItemContext *ctx) override;
+
+    std::any visitAggregateCall(SimpleDBParser::AggregateCallContext *ctx) override;
+
+    std::any visitAggregateFunction(SimpleDBParser::AggregateFunctionContext *ctx) override;
+
     std::any visitWhereClause(SimpleDBParser::WhereClauseContext *ctx) override;
 
+    std::any visitOrderItem(SimpleDBParser::OrderItemContext *ctx) override;
+
+    std::any visitLimitClause(SimpleDBParser::LimitClauseContext *ctx) override;
+
     std::any visitComparisonOp(SimpleDBParser::ComparisonOpContext *ctx) override;
 
     std::any visitColumnList(SimpleDBParser::ColumnListContext *ctx) override;
@@ -30,16 +44,26 @@ class AstBuilderVisitor : public SimpleDBBaseVisitor {
 
     std::any visitColumnDef(SimpleDBParser::ColumnDefContext *ctx) override;
 
+    std::any visitColumnConstraint(SimpleDBParser::ColumnConstraintContext *ctx) override;
+
     std::any visitDataType(SimpleDBParser::DataTypeContext *ctx) override;
 
+    std::any visitCreateIndexStatement(SimpleDBParser::CreateIndexStatementContext *ctx) override;
+
+    std::any visitIndexMethod(SimpleDBParser::IndexMethodContext *ctx) override;
+
     std::any visitDropStatement(SimpleDBParser::DropStatementContext *ctx) override;
 
     std::any visitInsertStatement(SimpleDBParser::InsertStatementContext *ctx) override;
 
+    std::any visitValueRow(SimpleDBParser::ValueRowContext *ctx) override;
+
     std::any visitValueList(SimpleDBParser::ValueListContext *ctx) override;
 
     std::any visitValue(SimpleDBParser::ValueContext *ctx) override;
 
+    std::any visitCopyStatement(SimpleDBParser::CopyStatementContext *ctx) override;
+
     std::any visitShowStatement(SimpleDBParser::ShowStatementContext *ctx) override;
 };
 
@@ -4,36 +4,504 @@
 
 #include "simpledb/planner.h"
 
+#include "simpledb/catalog.h"
 #include "simpledb/execution/filter_operator.h"
+#include "simpledb/execution/hash_aggregate_operator.h"
+#include "simpledb/execution/hash_join_operator.h"
+#include "simpledb/execution/index_scan_operator.h"
+#include "simpledb/execution/limit_operator.h"
+#include "simpledb/execution/parallel_scan_operator.h"
+#include "simpledb/execution/predicate.h"
+#include "simpledb/execution/scheduler.h"
+#include "simpledb/execution/sort_operator.h"
 #include "simpledb/execution/table_scan_operator.h"
 #include "simpledb/execution/projection_operator.h"
+#include "simpledb/table_index.h"
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
 
 namespace planner {
+    namespace {
+        /**
+         * @brief Compiles the WHERE clause for evaluation inside the TableScan, if the scan can evaluate it.
+         *
+         * The scan can evaluate "column op constant" predicates on a column of the scanned table, since it reads
+         * the column straight from the records. Other predicates (not expressible in the grammar yet) are left to a
+         * FilterOperator above the scan, for example:
+         * - Joins: predicates involving multiple tables
+         * - Complex expressions: functions or calculations over several columns
+         * - Subqueries and aggregations: predicates on values that aren't stored in the table
+         * @return std::nullopt if the predicate can't be pushed down.
+         */
+        std::optional<simpledb::execution::CompiledPredicate> push_down(const ast::WhereClause& where_clause,
+                                                                        const std::string& table_name) {
+            catalog::TableSchemaPtr table_schema = catalog::get_table_schema(table_name);
+            if (table_schema == nullptr) {
+                return std::nullopt;
+            }
+            return simpledb::execution::CompiledPredicate::compile(where_clause, *table_schema);
+        }
+
+        /**
+         * @brief Finds an index that can answer a pushed down predicate, i.e. an index on its column that supports
+         * the comparison. A hash index is preferred for EQUALS, since it finds the key with fewer page reads.
+         */
+        std::optional<catalog::IndexDefinition> find_index(const ast::WhereClause& where_clause,
+                                                           const std::string& table_name) {
+            catalog::TableSchemaPtr table_schema = catalog::get_table_schema(table_name);
+            if (table_schema == nullptr) {
+                return std::nullopt;
+            }
+            std::optional<catalog::IndexDefinition> found;
+            for (const catalog::IndexDefinition& index : table_schema->indexes) {
+                if (index.column_name != where_clause.column_name ||
+                    !simpledb::execution::IndexScanOperator::can_use_index(index, where_clause.op)) {
+                    continue;
+                }
+                if (index.index_type == command::IndexType::HASH) {
+                    return index;
+                }
+                if (!found.has_value()) {
+                    found = index;
+                }
+            }
+            return found;
+        }
+
+        /**
+         * @brief Computes the columns the TableScan has to deserialize: the projected (or grouped and aggregated)
+         * ones, and the WHERE column if the predicate is evaluated by a FilterOperator (a pushed down predicate reads
+         * its column from the records).
+         * @return The indices of the columns in schema order, or std::nullopt if all columns are needed (or if a
+         *         column can't be resolved, which the operators report).
+         */
+        std::optional<row::Signature> needed_columns(const ast::SelectCommand& cmd, bool needs_filter) {
+            std::vector<std::string> column_names;
+            if (!cmd.select_items.empty()) {
+                // An aggregation only needs the GROUP BY columns and the aggregated ones (none for COUNT(*)).
+                column_names = cmd.group_by;
+                for (const ast::SelectItem& item : cmd.select_items) {
+                    if (item.aggregate.has_value() && !item.column_name.empty()) {
+                        column_names.push_back(item.column_name);
+                    }
+                }
+            } else if (cmd.projection.empty()) {
+                return std::nullopt;
+            } else {
+                column_names = cmd.projection;
+                // The rows are sorted before the projection, so the ORDER BY columns must be read too.
+                for (const ast::OrderByItem& item : cmd.order_by) {
+                    column_names.push_back(item.key.column_name);
+                }
+            }
+            catalog::TableSchemaPtr table_schema = catalog::get_table_schema(cmd.table_name);
+            if (table_schema == nullptr) {
+                return std::nullopt;
+            }
+
+            if (needs_filter) {
+                column_names.push_back(cmd.where_clause->column_name);
+            }
+            const std::vector<command::ColumnDefinition>& column_definitions = table_schema->column_definitions;
+            std::set<size_t> columns;
+            for (const std::string& column_name : column_names) {
+                bool found = false;
+                for (size_t i = 0; i < column_definitions.size(); ++i) {
+                    if (column_definitions[i].column_name == column_name) {
+                        columns.insert(i);
+                        found = true;
+                        break;
+                    }
+                }
+                if (!found) {
+                    return std::nullopt;
+                }
+            }
+            if (columns.size() == column_definitions.size()) {
+                return std::nullopt;
+            }
+            return row::Signature(columns.begin(), columns.end());
+        }
+
+        /**
+         * @brief Resolves the ORDER BY items to the columns of the rows being sorted.
+         *
+         * An aggregate query sorts the rows of the HashAggregateOperator, so each item must be in its SELECT list.
+         * Otherwise, the rows of the table are sorted (before the projection), and each item must be one of its
+         * columns.
+         */
+        std::vector<simpledb::execution::SortKey> sort_keys(const ast::SelectCommand& cmd,
+                                                            const catalog::TableSchema& table_schema,
+                                                            const std::optional<row::Signature>& child_signature) {
+            using simpledb::execution::SortKeyType;
+            const std::vector<command::ColumnDefinition>& column_definitions = table_schema.column_definitions;
+            auto column_type = [&](const std::string& column_name) {
+                for (const command::ColumnDefinition& column : column_definitions) {
+                    if (column.column_name == column_name) {
+                        return column.type == command::Datatype::INT ? SortKeyType::INT : SortKeyType::TEXT;
+                    }
+                }
+                throw std::runtime_error("Column not found in table schema: " + column_name);
+            };
+
+            std::vector<simpledb::execution::SortKey> keys;
+            for (const ast::OrderByItem& item : cmd.order_by) {
+                simpledb::execution::SortKey key{0, SortKeyType::TEXT, item.descending};
+                if (!cmd.select_items.empty()) {
+                    auto it = std::find_if(cmd.select_items.begin(), cmd.select_items.end(), [&](const auto& s) {
+                        return s.column_name == item.key.column_name && s.aggregate == item.key.aggregate;
+                    });
+                    if (it == cmd.select_items.end()) {
+                        throw std::runtime_error("ORDER BY " + ast::select_item_name(item.key) +
+                                                 " must appear in the SELECT list of an aggregate query.");
+                    }
+                    key.column = static_cast<size_t>(it - cmd.select_items.begin());
+                    if (!item.key.aggregate.has_value()) {
+                        key.type = column_type(item.key.column_name);
+                    } else if (item.key.aggregate == ast::AggregateFunction::AVG) {
+                        key.type = SortKeyType::REAL;
+                    } else if (item.key.aggregate == ast::AggregateFunction::MIN ||
+                               item.key.aggregate == ast::AggregateFunction::MAX) {
+                        key.type = column_type(item.key.column_name);
+                    } else {
+                        key.type = SortKeyType::INT;
+                    }
+                } else {
+                    if (item.key.aggregate.has_value()) {
+                        throw std::runtime_error("Can't ORDER BY " + ast::select_item_name(item.key) +
+                                                 " in a query without aggregates.");
+                    }
+                    key.type = column_type(item.key.column_name);
+                    auto it = std::find_if(column_definitions.begin(), column_definitions.end(), [&](const auto& c) {
+                        return c.column_name == item.key.column_name;
+                    });
+                    key.column = static_cast<size_t>(it - column_definitions.begin());
+                    if (child_signature.has_value()) {
+                        auto child_it = std::find(child_signature->begin(), child_signature->end(), key.column);
+                        if (child_it == child_signature->end()) {
+                            throw std::runtime_error("Column is missing from the rows of the child operator: " +
+                                                     item.key.column_name);
+                        }
+                        key.column = static_cast<size_t>(child_it - child_signature->begin());
+                    }
+                }
+                keys.push_back(key);
+            }
+            return keys;
+        }
+
+        catalog::TableSchemaPtr find_table_schema(const std::string& table_name) {
+            catalog::TableSchemaPtr table_schema = catalog::get_table_schema(table_name);
+            if (table_schema == nullptr) {
+                throw std::runtime_error("Table not found in catalog: " + table_name);
+            }
+            return table_schema;
+        }
+
+        /**
+         * @brief Calls the function on (a reference to) every column name of the query.
+         */
+        template <typename Function>
+        void for_each_column_name(ast::SelectCommand& cmd, Function function) {
+            for (std::string& column_name : cmd.projection) {
+                function(column_name);
+            }
+            if (cmd.where_clause.has_value()) {
+                function(cmd.where_clause->column_name);
+            }
+            for (ast::SelectItem& item : cmd.select_items) {
+                if (!item.column_name.empty()) {
+                    function(item.column_name);
+                }
+            }
+            for (std::string& column_name : cmd.group_by) {
+                function(column_name);
+            }
+            for (ast::OrderByItem& item : cmd.order_by) {
+                if (!item.key.column_name.empty()) {
+                    function(item.key.column_name);
+                }
+            }
+        }
+
+        /**
+         * @brief Whether a full scan of the query's table is worth running on several threads: when the table has
+         * more than one morsel, and no LIMIT would stop a serial scan after its first pages anyway.
+         */
+        bool scan_in_parallel(const ast::SelectCommand& cmd,
+                              const std::filesystem::path& data_dir,
+                              size_t num_threads) {
+            const bool limit_reaches_scan =
+                cmd.limit_clause.has_value() && cmd.select_items.empty() && cmd.order_by.empty();
+            if (num_threads < 2 || limit_reaches_scan) {
+                return false;
+            }
+            constexpr uintmax_t MORSEL_BYTES =
+                simpledb::execution::ParallelScanOperator::MORSEL_SIZE * simpledb::storage::PAGE_SIZE;
+            std::error_code error;
+            const uintmax_t size = std::filesystem::file_size(data_dir / (cmd.table_name + ".data"), error);
+            return !error && size > MORSEL_BYTES;
+        }
+
+        /**
+         * @brief Creates the operators that read the table's rows: steps 1 to 3 of plan_select().
+         * @param task_group The query's tasks on the scheduler, for a parallel scan.
+         */
+        std::unique_ptr<simpledb::execution::Operator> plan_scan(
+            const ast::SelectCommand& cmd,
+            const std::filesystem::path& data_dir,
+            const std::shared_ptr<simpledb::execution::TaskGroup>& task_group) {
+            // 1. If there's a WHERE clause, try to push it down into the TableScan.
+            std::optional<simpledb::execution::CompiledPredicate> pushed_down_predicate;
+            if (cmd.where_clause.has_value()) {
+                pushed_down_predicate = push_down(cmd.where_clause.value(), cmd.table_name);
+            }
+            const bool needs_filter = cmd.where_clause.has_value() && !pushed_down_predicate.has_value();
+
+            // 2. Create the bottom-most operator, which only deserializes the columns the query needs: an IndexScan
+            //    if the pushed down predicate's column has an index, a ParallelScan for a full scan of a large table,
+            //    a TableScan otherwise.
+            std::optional<catalog::IndexDefinition> index;
+            if (pushed_down_predicate.has_value()) {
+                index = find_index(cmd.where_clause.value(), cmd.table_name);
+            }
+            const size_t num_threads = task_group->scheduler().num_threads();
+            std::unique_ptr<simpledb::execution::Operator> op;
+            if (index.has_value()) {
+                // An equality on a PRIMARY KEY or UNIQUE column matches at most one row, so the scan can stop there.
+                const bool at_most_one_match =
+                    cmd.where_clause->op == ast::ComparisonOp::EQUALS &&
+                    table_index::is_unique_column(*find_table_schema(cmd.table_name),
+                                                  index->column_name);
+                op = std::make_unique<simpledb::execution::IndexScanOperator>(cmd.table_name,
+                                                                               data_dir,
+                                                                               index.value(),
+                                                                               std::move(pushed_down_predicate.value()),
+                                                                               needed_columns(cmd, needs_filter),
+                                                                               at_most_one_match);
+            } else if (scan_in_parallel(cmd, data_dir, num_threads)) {
+                // Its workers each run a TableScan (with the FilterOperator of step 3, if needed) on their morsels.
+                return std::make_unique<simpledb::execution::ParallelScanOperator>(
+                    cmd.table_name,
+                    data_dir,
+                    std::move(pushed_down_predicate),
+                    needed_columns(cmd, needs_filter),
+                    needs_filter ? cmd.where_clause : std::nullopt,
+                    num_threads,
+                    task_group);
+            } else {
+                op = std::make_unique<simpledb::execution::TableScanOperator>(
+                    cmd.table_name, data_dir, std::move(pushed_down_predicate), needed_columns(cmd, needs_filter));
+            }
+
+            // 3. If the WHERE clause couldn't be pushed down, wrap the TableScan with a FilterOperator.
+            if (needs_filter) {
+                op = std::make_unique<simpledb::execution::FilterOperator>(
+                    cmd.table_name, std::move(op), cmd.where_clause.value());
+            }
+            return op;
+        }
+
+        /**
+         * @brief Creates the operators that turn the (possibly joined) rows into the result: steps 4 and 5 of
+         * plan_select().
+         * @param table_schema The schema of the rows, whose columns the query's column names refer to.
+         */
+        std::unique_ptr<simpledb::execution::Operator> plan_output(std::unique_ptr<simpledb::execution::Operator> op,
+                                                                   const ast::SelectCommand& cmd,
+                                                                   const catalog::TableSchema& table_schema,
+                                                                   const std::filesystem::path& data_dir,
+                                                                   size_t work_mem) {
+            // 4. Create the HashAggregateOperator for a query with aggregates or GROUP BY, which outputs the SELECT
+            //    list itself, with a SortOperator above it for an ORDER BY. Otherwise, create the SortOperator (which
+            //    needs the ORDER BY columns, even if they aren't projected) and then the ProjectionOperator.
+            if (!cmd.select_items.empty()) {
+                op = std::make_unique<simpledb::execution::HashAggregateOperator>(
+                    table_schema, std::move(op), cmd.select_items, cmd.group_by, work_mem, data_dir / "tmp");
+                if (!cmd.order_by.empty()) {
+                    std::vector<simpledb::execution::SortKey> keys = sort_keys(cmd, table_schema, std::nullopt);
+                    op = std::make_unique<simpledb::execution::SortOperator>(
+                        std::move(op), std::move(keys), work_mem, data_dir / "tmp");
+                }
+            } else {
+                if (!cmd.order_by.empty()) {
+                    std::vector<simpledb::execution::SortKey> keys = sort_keys(cmd, table_schema, op->signature());
+                    op = std::make_unique<simpledb::execution::SortOperator>(
+                        std::move(op), std::move(keys), work_mem, data_dir / "tmp");
+                }
+                op = std::make_unique<simpledb::execution::ProjectionOperator>(
+                    table_schema, std::move(op), cmd.projection);
+            }
+
+            // 5. If there's a LIMIT clause, put a LimitOperator on top, which also stops the scan once it has enough
+            //    rows (or turns the sort into a top-N).
+            if (cmd.limit_clause.has_value()) {
+                op = std::make_unique<simpledb::execution::LimitOperator>(
+                    std::move(op), cmd.limit_clause->limit, cmd.limit_clause->offset);
+            }
+
+            return op;
+        }
+
+        /**
+         * @brief Plans a query with a JOIN: each table is scanned on its own (with the WHERE clause pushed down to
+         * the table of its column), then the rows are joined by a HashJoinOperator, which builds its hash table on the
+         * smaller table. The rest of the plan works on the joined rows, whose columns are named "table.column".
+         */
+        std::unique_ptr<simpledb::execution::Operator> plan_join(
+            const ast::SelectCommand& cmd,
+            const std::filesystem::path& data_dir,
+            size_t work_mem,
+            const std::shared_ptr<simpledb::execution::TaskGroup>& task_group) {
+            const ast::JoinClause& join_clause = cmd.join_clause.value();
+            if (join_clause.table_name == cmd.table_name) {
+                throw std::runtime_error("Can't join a table with itself: " + cmd.table_name);
+            }
+            const catalog::TableSchemaPtr tables[2] = {find_table_schema(cmd.table_name),
+                                                       find_table_schema(join_clause.table_name)};
+            catalog::TableSchema joined_schema{tables[0]->table_name + " JOIN " + tables[1]->table_name, {}};
+            for (const catalog::TableSchemaPtr& table : tables) {
+                for (const command::ColumnDefinition& column : table->column_definitions) {
+                    joined_schema.column_definitions.push_back({table->table_name + "." + column.column_name,
+                                                                column.type});
+                }
+            }
+
+            // Qualifies every column name with its table, which is required if both tables have the column.
+            auto find_column = [&](const std::string& column_name, std::string& table_column) -> int {
+                int found = -1;
+                for (int t = 0; t < 2; ++t) {
+                    const std::string prefix = tables[t]->table_name + ".";
+                    for (const command::ColumnDefinition& column : tables[t]->column_definitions) {
+                        if (column_name == prefix + column.column_name) {
+                            table_column = column.column_name;
+                            return t;
+                        }
+                        if (column_name == column.column_name) {
+                            if (found != -1) {
+                                throw std::runtime_error("Column reference is ambiguous: " + column_name);
+                            }
+                            found = t;
+                            table_column = column.column_name;
+                        }
+                    }
+                }
+                if (found == -1) {
+                    throw std::runtime_error("Column not found in the joined tables: " + column_name);
+                }
+                return found;
+            };
+            auto qualify = [&](std::string& column_name) {
+                std::string table_column;
+                const int t = find_column(column_name, table_column);
+                column_name = tables[t]->table_name + "." + table_column;
+            };
+            ast::SelectCommand resolved = cmd;
+            for_each_column_name(resolved, qualify);
+
+            // The scan of each table only reads the columns the query uses, and the join key.
+            ast::SelectCommand scans[2];
+            size_t key_columns[2];
+            std::string key_names[2];
+            for (const std::string& key : {join_clause.left_column, join_clause.right_column}) {
+                std::string table_column;
+                const int t = find_column(key, table_column);
+                if (!key_names[t].empty()) {
+                    throw std::runtime_error("The JOIN condition must compare a column of each table.");
+                }
+                key_names[t] = table_column;
+            }
+            for (int t = 0; t < 2; ++t) {
+                scans[t].table_name = tables[t]->table_name;
+                const std::vector<command::ColumnDefinition>& columns = tables[t]->column_definitions;
+                auto it = std::find_if(columns.begin(), columns.end(), [&](const auto& c) {
+                    return c.column_name == key_names[t];
+                });
+                key_columns[t] = static_cast<size_t>(it - columns.begin());
+            }
+            const command::Datatype key_type = tables[0]->column_definitions[key_columns[0]].type;
+            if (key_type != tables[1]->column_definitions[key_columns[1]].type) {
+                throw std::runtime_error("The JOIN condition compares columns of different types.");
+            }
+            const bool select_all = resolved.projection.empty() && resolved.select_items.empty();
+            if (!select_all) {
+                ast::SelectCommand used_columns = resolved;
+                used_columns.where_clause.reset();
+                for_each_column_name(used_columns, [&](std::string& column_name) {
+                    std::string table_column;
+                    const int t = find_column(column_name, table_column);
+                    scans[t].projection.push_back(table_column);
+                });
+                for (int t = 0; t < 2; ++t) {
+                    scans[t].projection.push_back(key_names[t]);
+                }
+            }
+            if (resolved.where_clause.has_value()) {
+                ast::WhereClause where_clause = resolved.where_clause.value();
+                std::string table_column;
+                const int t = find_column(where_clause.column_name, table_column);
+                where_clause.column_name = table_column;
+                scans[t].where_clause = std::move(where_clause);
+            }
+
+            simpledb::execution::JoinInput inputs[2];
+            for (int t = 0; t < 2; ++t) {
+                std::unique_ptr<simpledb::execution::Operator> scan = plan_scan(scans[t], data_dir, task_group);
+                size_t key_column = key_columns[t];
+                std::optional<row::Signature> signature = scan->signature();
+                if (signature.has_value()) {
+                    key_column = static_cast<size_t>(std::find(signature->begin(), signature->end(), key_column) -
+                                                     signature->begin());
+                }
+                inputs[t] = {std::move(scan), key_column, tables[t]->column_definitions.size()};
+            }
+
+            // Build the hash table on the smaller table, going by the size of the data files.
+            auto table_size = [&](const std::string& table_name) -> uintmax_t {
+                std::error_code error;
+                uintmax_t size = std::filesystem::file_size(data_dir / (table_name + ".data"), error);
+                return error ? 0 : size;
+            };
+            const auto build_side = table_size(tables[0]->table_name) < table_size(tables[1]->table_name)
+                                        ? simpledb::execution::HashJoinOperator::BuildSide::LEFT
+                                        : simpledb::execution::HashJoinOperator::BuildSide::RIGHT;
+            std::unique_ptr<simpledb::execution::Operator> op = std::make_unique<simpledb::execution::HashJoinOperator>(
+                std::move(inputs[0]), std::move(inputs[1]), key_type, build_side, work_mem, data_dir / "tmp");
+            return plan_output(std::move(op), resolved, joined_schema, data_dir, work_mem);
+        }
+    }  // namespace
+
     std::unique_ptr<simpledb::execution::Operator> plan_select(const ast::SelectCommand& cmd,
-                                                               const std::filesystem::path& data_dir) {
-        // 1. Create the bottom-most operator: the TableScan.
-        std::unique_ptr<simpledb::execution::Operator> op =
-            std::make_unique<simpledb::execution::TableScanOperator>(cmd.table_name, data_dir);
-
-        // 2. If there's a WHERE clause, wrap the TableScan with a FilterOperator.
-        // TODO: Implement predicate push-down optimization
-        // Currently WHERE clauses are always applied as separate FilterOperator after TableScan.
-        // We could push simple predicates down to storage layer: TableScan could accept WHERE conditions and filter
-        // during page scanning We would continue to use FilterOperator for complex predicates that cannot be pushed
-        // down. For example:
-        // - Joins: Cannot push down predicates involving multiple tables
-        // - Complex expressions: Functions or calculations that storage layer cannot evaluate
-        // - Subqueries: Cannot push down predicates involving subqueries
-        // - Aggregations: Cannot push down predicates on aggregated results
-        if (cmd.where_clause.has_value()) {
-            op = std::make_unique<simpledb::execution::FilterOperator>(
-                cmd.table_name, std::move(op), cmd.where_clause.value());
-        }
-
-        // 3. Create the ProjectionOperator, giving it the current operator as its child.
-        op = std::make_unique<simpledb::execution::ProjectionOperator>(cmd.table_name, std::move(op), cmd.projection);
-
-        // 4. Return the top-most operator in the pipeline.
+                                                               const std::filesystem::path& data_dir,
+                                                               size_t work_mem) {
+        // The tasks of the query's parallel operators share the scheduler's workers fairly with other queries'.
+        auto task_group = std::make_shared<simpledb::execution::TaskGroup>();
+        if (cmd.join_clause.has_value()) {
+            return plan_join(cmd, data_dir, work_mem, task_group);
+        }
+
+        // Column names may be qualified with the table's name, which isn't needed for a single table.
+        ast::SelectCommand resolved = cmd;
+        const std::string prefix = cmd.table_name + ".";
+        for_each_column_name(resolved, [&](std::string& column_name) {
+            if (column_name.compare(0, prefix.size(), prefix) == 0) {
+                column_name.erase(0, prefix.size());
+            }
+        });
+
+        // Steps 1 to 3: the scan, and the filter if needed. Steps 4 and 5: the aggregation or the projection, the
+        // sort and the limit.
+        std::unique_ptr<simpledb::execution::Operator> op = plan_scan(resolved, data_dir, task_group);
+        op = plan_output(std::move(op), resolved, *find_table_schema(cmd.table_name), data_dir, work_mem);
+
+        // 6. Return the top-most operator in the pipeline.
         return op;
     }
 }  // namespace planner
@@ -4,8 +4,36 @@
 
 #include "simpledb/query_runner.h"
 
+#include "simpledb/catalog.h"
+
+#include <stdexcept>
+#include <utility>
+
 namespace query_runner {
+    namespace {
+        catalog::TableSchemaPtr find_table_schema(const std::string& table_name) {
+            catalog::TableSchemaPtr table_schema = catalog::get_table_schema(table_name);
+            if (table_schema == nullptr) {
+                throw std::runtime_error("Table not found in catalog: " + table_name);
+            }
+            return table_schema;
+        }
+    }  // namespace
+
     results::ExecutionResult QueryRunner::run_query(const std::string& query) {
+        QueryResult query_result = open_query(query);
+        auto* cursor = std::get_if<results::ResultCursor>(&query_result);
+        if (cursor == nullptr) {
+            return std::get<results::ExecutionResult>(std::move(query_result));
+        }
+        try {
+            return results::ExecutionResult::SuccessWithData(cursor->to_result_set());
+        } catch (const std::exception& e) {
+            return results::ExecutionResult::Error(e.what());
+        }
+    }
+
+    QueryResult QueryRunner::open_query(const std::string& query) {
         try {
             auto parse_result = parser::parse_sql(query);
 
@@ -18,6 +46,11 @@ namespace query_runner {
                 return executor::execute_create_table_command(*cmd, config::get_config().data_dir);
             }
 
+            // Check if it holds a CreateIndexCommand
+            if (auto* cmd = std::get_if<command::CreateIndexCommand>(&(*parse_result))) {
+                return executor::execute_create_index_command(*cmd, config::get_config().data_dir);
+            }
+
             // Check if it holds a DropTableCommand
             if (auto* cmd = std::get_if<command::DropTableCommand>(&(*parse_result))) {
                 return executor::execute_drop_table_command(*cmd, config::get_config().data_dir);
@@ -28,6 +61,11 @@ namespace query_runner {
                 return executor::execute_insert_command(*cmd, config::get_config().data_dir);
             }
 
+            // Check if it holds a CopyCommand
+            if (auto* cmd = std::get_if<command::CopyCommand>(&(*parse_result))) {
+                return executor::execute_copy_command(*cmd, config::get_config().data_dir);
+            }
+
             // Check if it holds a ShowTablesCommand
             if (auto* cmd = std::get_if<command::ShowTablesCommand>(&(*parse_result))) {
                 return executor::execute_show_tables_command();
@@ -35,27 +73,31 @@ namespace query_runner {
 
             // Check if it holds a SelectCommand
             if (auto* cmd = std::get_if<ast::SelectCommand>(&(*parse_result))) {
-                auto plan = planner::plan_select(*cmd, config::get_config().data_dir);
+                auto plan = planner::plan_select(*cmd, config::get_config().data_dir, config::get_config().work_mem);
 
                 // Collect headers
                 std::vector<std::string> headers;
-                if (cmd->projection.empty()) {  // SELECT *
-                    auto schema = catalog::get_table_schema(cmd->table_name).value();
-                    for (const auto& col_def : schema.column_definitions) {
+                if (!cmd->select_items.empty()) {  // Aggregates or GROUP BY
+                    for (const ast::SelectItem& item : cmd->select_items) {
+                        headers.push_back(ast::select_item_name(item));
+                    }
+                } else if (cmd->projection.empty() && cmd->join_clause.has_value()) {  // SELECT * of a JOIN
+                    for (const std::string& table_name : {cmd->table_name, cmd->join_clause->table_name}) {
+                        for (const auto& col_def : find_table_schema(table_name)->column_definitions) {
+                            headers.push_back(table_name + "." + col_def.column_name);
+                        }
+                    }
+                } else if (cmd->projection.empty()) {  // SELECT *
+                    catalog::TableSchemaPtr schema = find_table_schema(cmd->table_name);
+                    for (const auto& col_def : schema->column_definitions) {
                         headers.push_back(col_def.column_name);
                     }
                 } else {
                     headers = cmd->projection;
                 }
 
-                // Collect rows
-                std::vector<row::Row> rows;
-                while (auto row = plan->next()) {
-                    rows.push_back(*row);
-                }
-
-                results::ResultSet result_set{headers, rows};
-                return results::ExecutionResult::SuccessWithData(result_set);
+                // The rows are read from the plan as the caller asks for them.
+                return results::ResultCursor(std::move(headers), std::move(plan));
             }
 
             // If it's none of the above, something is wrong.
@@ -0,0 +1,45 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/result_cursor.h"
+
+#include <utility>
+
+namespace results {
+    ResultCursor::ResultCursor(std::vector<std::string> headers, std::unique_ptr<simpledb::execution::Operator> plan)
+        : headers_(std::move(headers)), plan_(std::move(plan)) {}
+
+    std::optional<row::Row> ResultCursor::next() {
+        if (done_) {
+            return std::nullopt;
+        }
+        std::optional<row::Row> row = plan_->next();
+        if (!row.has_value()) {
+            done_ = true;
+            return std::nullopt;
+        }
+        num_rows_read_ += 1;
+        return row;
+    }
+
+    bool ResultCursor::next_rows(std::vector<row::Row>& rows, size_t max_rows) {
+        rows.clear();
+        while (rows.size() < max_rows) {
+            std::optional<row::Row> row = next();
+            if (!row.has_value()) {
+                break;
+            }
+            rows.push_back(std::move(row.value()));
+        }
+        return !rows.empty();
+    }
+
+    ResultSet ResultCursor::to_result_set() {
+        ResultSet result_set{headers_, {}};
+        while (std::optional<row::Row> row = next()) {
+            result_set.rows.push_back(std::move(row.value()));
+        }
+        return result_set;
+    }
+}  // namespace results
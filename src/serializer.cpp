@@ -4,39 +4,133 @@
 
 #include "simpledb/serializer.h"
 
+#include <charconv>
 #include <cstdint>
 #include <cstring>
+#include <stdexcept>
 
 namespace serializer {
-    std::vector<char> serialize(const std::vector<std::string>& data) {
-        std::vector<char> record_data;
-        for (const auto& value : data) {
-            // First, we need to store the length of the value as a 16-bit unsigned integer
-            uint16_t length = static_cast<uint16_t>(value.size());
-            // Create a pointer to the length and reinterpret it as a char array
-            const char* len_ptr = reinterpret_cast<const char*>(&length);
-            // Insert the length as a 2-byte value
-            record_data.insert(record_data.end(), len_ptr, len_ptr + sizeof(uint16_t));
-            // Now insert the actual value
-            record_data.insert(record_data.end(), value.begin(), value.end());
+    namespace {
+        // Size of a column's fixed-width slot in a record.
+        size_t slot_size(command::Datatype type) {
+            switch (type) {
+                case command::Datatype::INT:
+                    return sizeof(int32_t);
+                case command::Datatype::TEXT:
+                    return 2 * sizeof(uint16_t);  // Offset and length of the data.
+                default:
+                    throw std::invalid_argument("Unsupported column type in record layout.");
+            }
+        }
+
+        void store_uint16(char* data, uint16_t value) {
+            data[0] = static_cast<char>(value & 0xFF);
+            data[1] = static_cast<char>(value >> 8);
+        }
+
+        void store_int32(char* data, int32_t value) {
+            uint32_t bits = static_cast<uint32_t>(value);
+            for (int i = 0; i < 4; ++i) {
+                data[i] = static_cast<char>((bits >> (8 * i)) & 0xFF);
+            }
+        }
+    }  // namespace
+
+    RecordLayout::RecordLayout(const std::vector<command::ColumnDefinition>& column_definitions) {
+        null_bitmap_size_ = (column_definitions.size() + 7) / 8;
+        size_t offset = null_bitmap_size_;
+        for (const auto& column : column_definitions) {
+            column_types_.push_back(column.type);
+            slot_offsets_.push_back(offset);
+            offset += slot_size(column.type);
+        }
+        fixed_size_ = offset;
+    }
+
+    bool parse_int(std::string_view text, int32_t& value) {
+        const char* end = text.data() + text.size();
+        auto [ptr, error] = std::from_chars(text.data(), end, value);
+        return error == std::errc() && ptr == end && !text.empty();
+    }
+
+    std::vector<char> serialize(const RecordLayout& layout, const std::vector<std::string>& values) {
+        if (values.size() != layout.num_columns()) {
+            throw std::invalid_argument("Expected " + std::to_string(layout.num_columns()) + " values, got " +
+                                        std::to_string(values.size()) + ".");
+        }
+
+        // 1. Size the record: the fixed part, followed by the data of all TEXT values.
+        size_t record_size = layout.fixed_size();
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (layout.column_type(i) == command::Datatype::TEXT) {
+                record_size += values[i].size();
+            }
+        }
+
+        // 2. Fill in the slots. The null bitmap stays zeroed: nothing produces NULL values yet.
+        std::vector<char> record_data(record_size, 0);
+        size_t text_offset = layout.fixed_size();
+        for (size_t i = 0; i < values.size(); ++i) {
+            char* slot = record_data.data() + layout.slot_offset(i);
+            if (layout.column_type(i) == command::Datatype::INT) {
+                int32_t value;
+                if (!parse_int(values[i], value)) {
+                    throw std::invalid_argument("Value '" + values[i] + "' is not a valid integer.");
+                }
+                store_int32(slot, value);
+            } else {
+                // Offsets and lengths that don't fit in 16 bits would make the record too large for a page anyway,
+                // the heap rejects it.
+                store_uint16(slot, static_cast<uint16_t>(text_offset));
+                store_uint16(slot + 2, static_cast<uint16_t>(values[i].size()));
+                memcpy(record_data.data() + text_offset, values[i].data(), values[i].size());
+                text_offset += values[i].size();
+            }
         }
         return record_data;
     }
 
-    std::vector<std::string> deserialize(const std::vector<char>& data) {
-        std::vector<std::string> values;
-        size_t pos = 0;
-        while (pos < data.size()) {
-            // 1. Read the 2-byte length prefix.
-            uint16_t len;
-            memcpy(&len, &data[pos], sizeof(uint16_t));
-            pos += sizeof(uint16_t);
-
-            // 2. Read the string data of that length.
-            std::string value(data.begin() + pos, data.begin() + pos + len);
-            values.push_back(value);
-            pos += len;
+    namespace {
+        void deserialize_column(const RecordLayout& layout,
+                                simpledb::storage::RecordView record,
+                                size_t column,
+                                std::string& value) {
+            if (is_null(layout, record, column)) {
+                value.clear();
+            } else if (layout.column_type(column) == command::Datatype::INT) {
+                // Format the int straight into the (reused) string, instead of going through std::to_string().
+                char buffer[12];
+                char* end = std::to_chars(buffer, buffer + sizeof(buffer), read_int(layout, record, column)).ptr;
+                value.assign(buffer, end);
+            } else {
+                std::string_view text = read_text(layout, record, column);
+                value.assign(text.data(), text.size());
+            }
+        }
+    }  // namespace
+
+    void deserialize(const RecordLayout& layout,
+                     simpledb::storage::RecordView record,
+                     std::vector<std::string>& values) {
+        values.resize(layout.num_columns());
+        for (size_t i = 0; i < layout.num_columns(); ++i) {
+            deserialize_column(layout, record, i, values[i]);
         }
+    }
+
+    void deserialize(const RecordLayout& layout,
+                     simpledb::storage::RecordView record,
+                     const std::vector<size_t>& columns,
+                     std::vector<std::string>& values) {
+        values.resize(columns.size());
+        for (size_t i = 0; i < columns.size(); ++i) {
+            deserialize_column(layout, record, columns[i], values[i]);
+        }
+    }
+
+    std::vector<std::string> deserialize(const RecordLayout& layout, simpledb::storage::RecordView record) {
+        std::vector<std::string> values;
+        deserialize(layout, record, values);
         return values;
     }
 }  // namespace serializer
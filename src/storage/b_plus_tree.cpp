@@ -0,0 +1,557 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/storage/b_plus_tree.h"
+#include "simpledb/utils/logging.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+
+namespace simpledb::storage {
+    namespace {
+        // Meta page (page 0) layout.
+        constexpr uint32_t MAGIC = 0x49424453;  // "SDBI"
+        constexpr size_t MAGIC_OFFSET = 0;
+        constexpr size_t KEY_SIZE_OFFSET = 4;
+        constexpr size_t ROOT_PAGE_ID_OFFSET = 8;
+
+        constexpr PageId META_PAGE_ID = 0;
+
+        // Page 0 is the meta page, so no node ever links to it: a link of 0 means "no next leaf".
+        constexpr PageId NO_PAGE = 0;
+
+        // Size of a record id as stored in an entry: page id, then slot.
+        constexpr size_t RECORD_ID_SIZE = sizeof(PageId) + sizeof(uint16_t);
+
+        /*
+            Node layout:
+            +---------+---+-------------+-------------+------------------------------+
+            | is_leaf | - | num_entries |    link     | entries, sorted by (key, rid) |
+            +---------+---+-------------+-------------+------------------------------+
+            0         1   2             4             8
+
+            A leaf entry is (key, record id), and the link is the next leaf.
+            An inner entry is (key, record id, child), and the link is the leftmost child.
+         */
+        constexpr size_t IS_LEAF_OFFSET = 0;
+        constexpr size_t NUM_ENTRIES_OFFSET = 2;
+        constexpr size_t LINK_OFFSET = 4;
+        constexpr size_t NODE_HEADER_SIZE = 8;
+
+        template <typename T>
+        T read_field(const char* data) {
+            T value;
+            memcpy(&value, data, sizeof(T));
+            return value;
+        }
+
+        template <typename T>
+        void write_field(char* data, T value) {
+            memcpy(data, &value, sizeof(T));
+        }
+
+        RecordId read_record_id(const char* data) {
+            return {read_field<PageId>(data), read_field<uint16_t>(data + sizeof(PageId))};
+        }
+
+        void write_record_id(char* data, RecordId record_id) {
+            write_field(data, record_id.page_id);
+            write_field(data + sizeof(PageId), record_id.slot);
+        }
+
+        /**
+         * Typed access to the bytes of a node page.
+         */
+        class Node {
+           public:
+            Node(char* data, uint16_t key_size)
+                : data_(data),
+                  key_size_(key_size),
+                  entry_size_(key_size + RECORD_ID_SIZE + (IsLeaf() ? 0 : sizeof(PageId))) {}
+
+            static void Initialize(char* data, bool is_leaf) {
+                memset(data, 0, PAGE_SIZE);
+                data[IS_LEAF_OFFSET] = is_leaf ? 1 : 0;
+            }
+
+            static uint16_t Capacity(uint16_t key_size, bool is_leaf) {
+                return static_cast<uint16_t>((PAGE_SIZE - NODE_HEADER_SIZE) /
+                                             (key_size + RECORD_ID_SIZE + (is_leaf ? 0 : sizeof(PageId))));
+            }
+
+            bool IsLeaf() const { return data_[IS_LEAF_OFFSET] != 0; }
+
+            uint16_t Size() const { return read_field<uint16_t>(data_ + NUM_ENTRIES_OFFSET); }
+
+            void SetSize(uint16_t size) { write_field(data_ + NUM_ENTRIES_OFFSET, size); }
+
+            PageId Link() const { return read_field<PageId>(data_ + LINK_OFFSET); }
+
+            void SetLink(PageId page_id) { write_field(data_ + LINK_OFFSET, page_id); }
+
+            size_t EntrySize() const { return entry_size_; }
+
+            uint16_t Capacity() const { return Capacity(key_size_, IsLeaf()); }
+
+            char* Entry(size_t i) const { return data_ + NODE_HEADER_SIZE + i * entry_size_; }
+
+            RecordId GetRecordId(size_t i) const { return read_record_id(Entry(i) + key_size_); }
+
+            // The child holding the entries >= entry i (inner nodes only).
+            PageId Child(size_t i) const { return read_field<PageId>(Entry(i) + key_size_ + RECORD_ID_SIZE); }
+
+            // Compares entry i with (key, record_id).
+            int Compare(size_t i, std::string_view key, RecordId record_id) const {
+                int result = memcmp(Entry(i), key.data(), key_size_);
+                if (result != 0) {
+                    return result;
+                }
+                RecordId entry_record_id = GetRecordId(i);
+                if (entry_record_id < record_id) {
+                    return -1;
+                }
+                return record_id < entry_record_id ? 1 : 0;
+            }
+
+            // The position of the first entry >= (key, record_id).
+            uint16_t LowerBound(std::string_view key, RecordId record_id) const {
+                uint16_t low = 0;
+                uint16_t high = Size();
+                while (low < high) {
+                    uint16_t middle = low + (high - low) / 2;
+                    if (Compare(middle, key, record_id) < 0) {
+                        low = middle + 1;
+                    } else {
+                        high = middle;
+                    }
+                }
+                return low;
+            }
+
+            // The position of the first entry > (key, record_id).
+            uint16_t UpperBound(std::string_view key, RecordId record_id) const {
+                uint16_t low = 0;
+                uint16_t high = Size();
+                while (low < high) {
+                    uint16_t middle = low + (high - low) / 2;
+                    if (Compare(middle, key, record_id) <= 0) {
+                        low = middle + 1;
+                    } else {
+                        high = middle;
+                    }
+                }
+                return low;
+            }
+
+            // The child to descend into to find (key, record_id) (inner nodes only).
+            PageId FindChild(std::string_view key, RecordId record_id) const {
+                uint16_t position = UpperBound(key, record_id);
+                return position == 0 ? Link() : Child(position - 1);
+            }
+
+            // Inserts an entry at the given position, shifting the following entries. The node must have room.
+            void InsertAt(uint16_t position, const char* entry) {
+                uint16_t size = Size();
+                memmove(Entry(position + 1), Entry(position), (size - position) * entry_size_);
+                memcpy(Entry(position), entry, entry_size_);
+                SetSize(size + 1);
+            }
+
+           private:
+            char* data_;
+            uint16_t key_size_;
+            size_t entry_size_;
+        };
+
+        // Builds the bytes of an entry: the key and record id, followed by the child for inner entries.
+        std::string make_entry(std::string_view key, RecordId record_id, std::optional<PageId> child) {
+            std::string entry(key.size() + RECORD_ID_SIZE + (child ? sizeof(PageId) : 0), '\0');
+            memcpy(entry.data(), key.data(), key.size());
+            write_record_id(entry.data() + key.size(), record_id);
+            if (child) {
+                write_field(entry.data() + key.size() + RECORD_ID_SIZE, *child);
+            }
+            return entry;
+        }
+    }  // namespace
+
+    BPlusTree::Iterator::Iterator(BPlusTree* tree, PageId leaf_page_id, uint16_t position)
+        : tree_(tree), leaf_page_id_(leaf_page_id), position_(position) {}
+
+    BPlusTree::Iterator::~Iterator() { ReleasePage(); }
+
+    BPlusTree::Iterator::Iterator(Iterator&& other) noexcept
+        : tree_(other.tree_), leaf_page_id_(other.leaf_page_id_), position_(other.position_), leaf_(other.leaf_) {
+        // The pin now belongs to this iterator.
+        other.leaf_ = nullptr;
+    }
+
+    BPlusTree::Iterator& BPlusTree::Iterator::operator=(Iterator&& other) noexcept {
+        if (this != &other) {
+            ReleasePage();
+            tree_ = other.tree_;
+            leaf_page_id_ = other.leaf_page_id_;
+            position_ = other.position_;
+            leaf_ = other.leaf_;
+            other.leaf_ = nullptr;
+        }
+        return *this;
+    }
+
+    bool BPlusTree::Iterator::Next(std::string_view& key, RecordId& record_id) {
+        while (true) {
+            if (leaf_ == nullptr) {
+                if (leaf_page_id_ == NO_PAGE) {
+                    return false;
+                }
+                leaf_ = tree_->buffer_pool_.FetchPage(tree_->file_id_, leaf_page_id_);
+            }
+
+            Node node(leaf_->GetData(), tree_->key_size_);
+            if (position_ < node.Size()) {
+                key = std::string_view(node.Entry(position_), tree_->key_size_);
+                record_id = node.GetRecordId(position_);
+                position_ += 1;
+                return true;
+            }
+
+            // Done with this leaf, follow the link to the next one (leaves can be empty, e.g. an empty tree's root).
+            PageId next_leaf_page_id = node.Link();
+            ReleasePage();
+            leaf_page_id_ = next_leaf_page_id;
+            position_ = 0;
+        }
+    }
+
+    void BPlusTree::Iterator::ReleasePage() {
+        if (leaf_ != nullptr) {
+            tree_->buffer_pool_.UnpinPage(tree_->file_id_, leaf_page_id_, false);
+            leaf_ = nullptr;
+        }
+    }
+
+    BPlusTree::BPlusTree(const std::string& index_file_path, uint16_t key_size, BufferPoolManager& buffer_pool)
+        : buffer_pool_(buffer_pool), file_path_(index_file_path), key_size_(key_size) {
+        if (key_size_ == 0 || key_size_ > MAX_KEY_SIZE) {
+            throw std::runtime_error("Invalid index key size: " + std::to_string(key_size_));
+        }
+
+        if (!std::filesystem::exists(file_path_)) {
+            std::ofstream create_stream(file_path_, std::ios::out | std::ios::binary);
+            if (!create_stream.is_open()) {
+                throw std::runtime_error("Could not open or create index file: " + file_path_);
+            }
+            create_stream.close();
+            buffer_pool_.DiscardFile(file_path_);
+        }
+
+        file_id_ = buffer_pool_.OpenFile(file_path_);
+        num_pages_ = buffer_pool_.GetNumPagesOnDisk(file_id_);
+
+        if (num_pages_ == 0) {
+            // A new tree: the meta page, and an empty leaf as the root.
+            Page* meta = buffer_pool_.NewPage(file_id_, META_PAGE_ID);
+            num_pages_ = 1;
+            write_field(meta->GetData() + MAGIC_OFFSET, MAGIC);
+            write_field(meta->GetData() + KEY_SIZE_OFFSET, key_size_);
+            buffer_pool_.UnpinPage(file_id_, META_PAGE_ID, true);
+
+            PageId root_page_id;
+            Page* root = AllocatePage(root_page_id);
+            Node::Initialize(root->GetData(), true);
+            buffer_pool_.UnpinPage(file_id_, root_page_id, true);
+            SetRootPageId(root_page_id);
+            buffer_pool_.FlushFile(file_id_);
+            return;
+        }
+
+        Page* meta = buffer_pool_.FetchPage(file_id_, META_PAGE_ID);
+        uint32_t magic = read_field<uint32_t>(meta->GetData() + MAGIC_OFFSET);
+        uint16_t stored_key_size = read_field<uint16_t>(meta->GetData() + KEY_SIZE_OFFSET);
+        root_page_id_ = read_field<PageId>(meta->GetData() + ROOT_PAGE_ID_OFFSET);
+        buffer_pool_.UnpinPage(file_id_, META_PAGE_ID, false);
+        if (magic != MAGIC) {
+            throw std::runtime_error("Not an index file: " + file_path_);
+        }
+        if (stored_key_size != key_size_) {
+            throw std::runtime_error("Index file " + file_path_ + " has keys of " + std::to_string(stored_key_size) +
+                                     " bytes, expected " + std::to_string(key_size_));
+        }
+    }
+
+    BPlusTree::~BPlusTree() {
+        try {
+            buffer_pool_.FlushFile(file_id_);
+        } catch (const std::exception& e) {
+            logging::log.error("Failed to flush index file {}: {}", file_path_, e.what());
+        }
+    }
+
+    void BPlusTree::Insert(std::string_view key, RecordId record_id) {
+        std::vector<PageId> path;
+        PageId leaf_page_id;
+        Page* page = FindLeaf(key, record_id, leaf_page_id, &path);
+        Node leaf(page->GetData(), key_size_);
+        uint16_t position = leaf.LowerBound(key, record_id);
+        if (position < leaf.Size() && leaf.Compare(position, key, record_id) == 0) {
+            buffer_pool_.UnpinPage(file_id_, leaf_page_id, false);
+            return;
+        }
+
+        std::string entry = make_entry(key, record_id, std::nullopt);
+        if (leaf.Size() < leaf.Capacity()) {
+            leaf.InsertAt(position, entry.data());
+            buffer_pool_.UnpinPage(file_id_, leaf_page_id, true);
+            return;
+        }
+
+        // The leaf is full: lay out all of its entries plus the new one, and move the upper half to a new leaf.
+        const size_t entry_size = leaf.EntrySize();
+        const uint16_t total = leaf.Size() + 1;
+        std::string entries(total * entry_size, '\0');
+        memcpy(entries.data(), leaf.Entry(0), position * entry_size);
+        memcpy(entries.data() + position * entry_size, entry.data(), entry_size);
+        memcpy(entries.data() + (position + 1) * entry_size,
+               leaf.Entry(position),
+               (leaf.Size() - position) * entry_size);
+
+        const uint16_t left_size = total / 2;
+        PageId right_page_id;
+        Page* right_page = AllocatePage(right_page_id);
+        Node::Initialize(right_page->GetData(), true);
+        Node right(right_page->GetData(), key_size_);
+
+        memcpy(leaf.Entry(0), entries.data(), left_size * entry_size);
+        leaf.SetSize(left_size);
+        memcpy(right.Entry(0), entries.data() + left_size * entry_size, (total - left_size) * entry_size);
+        right.SetSize(total - left_size);
+        right.SetLink(leaf.Link());
+        leaf.SetLink(right_page_id);
+
+        std::string separator(right.Entry(0), key_size_ + RECORD_ID_SIZE);
+        buffer_pool_.UnpinPage(file_id_, right_page_id, true);
+        buffer_pool_.UnpinPage(file_id_, leaf_page_id, true);
+
+        InsertIntoParent(path, leaf_page_id, separator, right_page_id);
+    }
+
+    void BPlusTree::InsertIntoParent(std::vector<PageId>& path,
+                                     PageId left_page_id,
+                                     const std::string& separator,
+                                     PageId right_page_id) {
+        std::string_view separator_key(separator.data(), key_size_);
+        RecordId separator_record_id = read_record_id(separator.data() + key_size_);
+        std::string entry = make_entry(separator_key, separator_record_id, right_page_id);
+
+        if (path.empty()) {
+            // The root was split: grow the tree by one level.
+            PageId root_page_id;
+            Page* root_page = AllocatePage(root_page_id);
+            Node::Initialize(root_page->GetData(), false);
+            Node root(root_page->GetData(), key_size_);
+            root.SetLink(left_page_id);
+            root.InsertAt(0, entry.data());
+            buffer_pool_.UnpinPage(file_id_, root_page_id, true);
+            SetRootPageId(root_page_id);
+            return;
+        }
+
+        PageId parent_page_id = path.back();
+        path.pop_back();
+        Page* parent_page = buffer_pool_.FetchPage(file_id_, parent_page_id);
+        Node parent(parent_page->GetData(), key_size_);
+        uint16_t position = parent.UpperBound(separator_key, separator_record_id);
+        if (parent.Size() < parent.Capacity()) {
+            parent.InsertAt(position, entry.data());
+            buffer_pool_.UnpinPage(file_id_, parent_page_id, true);
+            return;
+        }
+
+        // The parent is full too. Unlike in a leaf, the middle entry moves up instead of being copied: its key
+        // becomes the separator in the grandparent, and its child becomes the leftmost child of the new node.
+        const size_t entry_size = parent.EntrySize();
+        const uint16_t total = parent.Size() + 1;
+        std::string entries(total * entry_size, '\0');
+        memcpy(entries.data(), parent.Entry(0), position * entry_size);
+        memcpy(entries.data() + position * entry_size, entry.data(), entry_size);
+        memcpy(entries.data() + (position + 1) * entry_size,
+               parent.Entry(position),
+               (parent.Size() - position) * entry_size);
+
+        const uint16_t middle = total / 2;
+        const char* middle_entry = entries.data() + middle * entry_size;
+        PageId new_page_id;
+        Page* new_page = AllocatePage(new_page_id);
+        Node::Initialize(new_page->GetData(), false);
+        Node new_node(new_page->GetData(), key_size_);
+
+        memcpy(parent.Entry(0), entries.data(), middle * entry_size);
+        parent.SetSize(middle);
+        new_node.SetLink(read_field<PageId>(middle_entry + key_size_ + RECORD_ID_SIZE));
+        memcpy(new_node.Entry(0), middle_entry + entry_size, (total - middle - 1) * entry_size);
+        new_node.SetSize(total - middle - 1);
+
+        std::string parent_separator(middle_entry, key_size_ + RECORD_ID_SIZE);
+        buffer_pool_.UnpinPage(file_id_, new_page_id, true);
+        buffer_pool_.UnpinPage(file_id_, parent_page_id, true);
+
+        InsertIntoParent(path, parent_page_id, parent_separator, new_page_id);
+    }
+
+    void BPlusTree::BulkLoad(std::vector<IndexEntry> entries) {
+        {
+            Page* root_page = buffer_pool_.FetchPage(file_id_, root_page_id_);
+            Node root(root_page->GetData(), key_size_);
+            bool is_empty = root.IsLeaf() && root.Size() == 0;
+            buffer_pool_.UnpinPage(file_id_, root_page_id_, false);
+            if (!is_empty) {
+                throw std::runtime_error("Can only bulk load an empty index: " + file_path_);
+            }
+        }
+        for (const IndexEntry& entry : entries) {
+            if (entry.key.size() != key_size_) {
+                throw std::invalid_argument("Index key has " + std::to_string(entry.key.size()) +
+                                            " bytes, expected " + std::to_string(key_size_));
+            }
+        }
+        if (entries.empty()) {
+            return;
+        }
+
+        std::sort(entries.begin(), entries.end(), [](const IndexEntry& lhs, const IndexEntry& rhs) {
+            int result = lhs.key.compare(rhs.key);
+            return result != 0 ? result < 0 : lhs.record_id < rhs.record_id;
+        });
+        entries.erase(std::unique(entries.begin(),
+                                  entries.end(),
+                                  [](const IndexEntry& lhs, const IndexEntry& rhs) {
+                                      return lhs.key == rhs.key && lhs.record_id == rhs.record_id;
+                                  }),
+                      entries.end());
+
+        // The first entry of every node of the level being built, and the node's page.
+        struct LevelEntry {
+            const IndexEntry* first;
+            PageId page_id;
+        };
+        std::vector<LevelEntry> level;
+
+        // Leaves. The first one reuses the empty root, the others are appended one after the other, so the link
+        // to the next leaf is always the next page to be allocated.
+        const uint16_t leaf_capacity = Node::Capacity(key_size_, true);
+        for (size_t begin = 0; begin < entries.size(); begin += leaf_capacity) {
+            size_t end = std::min(entries.size(), begin + leaf_capacity);
+            PageId page_id = root_page_id_;
+            Page* page = begin == 0 ? buffer_pool_.FetchPage(file_id_, page_id) : AllocatePage(page_id);
+            Node::Initialize(page->GetData(), true);
+            Node leaf(page->GetData(), key_size_);
+            for (size_t i = begin; i < end; ++i) {
+                memcpy(leaf.Entry(i - begin), entries[i].key.data(), key_size_);
+                write_record_id(leaf.Entry(i - begin) + key_size_, entries[i].record_id);
+            }
+            leaf.SetSize(static_cast<uint16_t>(end - begin));
+            leaf.SetLink(end < entries.size() ? num_pages_ : NO_PAGE);
+            buffer_pool_.UnpinPage(file_id_, page_id, true);
+            level.push_back({&entries[begin], page_id});
+        }
+
+        // Inner levels, until a single node is left: each node takes the next (capacity + 1) nodes of the level
+        // below, the first as its leftmost child and the others as entries keyed by their first entry.
+        const uint16_t inner_capacity = Node::Capacity(key_size_, false);
+        while (level.size() > 1) {
+            std::vector<LevelEntry> parents;
+            for (size_t begin = 0; begin < level.size(); begin += inner_capacity + 1) {
+                size_t end = std::min(level.size(), begin + inner_capacity + 1);
+                PageId page_id;
+                Page* page = AllocatePage(page_id);
+                Node::Initialize(page->GetData(), false);
+                Node inner(page->GetData(), key_size_);
+                inner.SetLink(level[begin].page_id);
+                for (size_t i = begin + 1; i < end; ++i) {
+                    std::string entry = make_entry(level[i].first->key, level[i].first->record_id, level[i].page_id);
+                    memcpy(inner.Entry(i - begin - 1), entry.data(), entry.size());
+                }
+                inner.SetSize(static_cast<uint16_t>(end - begin - 1));
+                buffer_pool_.UnpinPage(file_id_, page_id, true);
+                parents.push_back({level[begin].first, page_id});
+            }
+            level = std::move(parents);
+        }
+
+        SetRootPageId(level.front().page_id);
+        buffer_pool_.FlushFile(file_id_);
+    }
+
+    BPlusTree::Iterator BPlusTree::Seek(std::string_view key) {
+        // Record ids start at (0, 0), so this finds the first entry with the key (or the next larger key).
+        PageId leaf_page_id;
+        Page* page = FindLeaf(key, RecordId{}, leaf_page_id, nullptr);
+        uint16_t position = Node(page->GetData(), key_size_).LowerBound(key, RecordId{});
+        buffer_pool_.UnpinPage(file_id_, leaf_page_id, false);
+        return Iterator(this, leaf_page_id, position);
+    }
+
+    BPlusTree::Iterator BPlusTree::Begin() { return Seek(std::string(key_size_, '\0')); }
+
+    uint32_t BPlusTree::GetHeight() {
+        uint32_t height = 1;
+        PageId page_id = root_page_id_;
+        while (true) {
+            Page* page = buffer_pool_.FetchPage(file_id_, page_id);
+            Node node(page->GetData(), key_size_);
+            bool is_leaf = node.IsLeaf();
+            PageId child_page_id = node.Link();
+            buffer_pool_.UnpinPage(file_id_, page_id, false);
+            if (is_leaf) {
+                return height;
+            }
+            page_id = child_page_id;
+            height += 1;
+        }
+    }
+
+    Page* BPlusTree::FindLeaf(std::string_view key,
+                              RecordId record_id,
+                              PageId& leaf_page_id,
+                              std::vector<PageId>* path) {
+        if (key.size() != key_size_) {
+            throw std::invalid_argument("Index key has " + std::to_string(key.size()) + " bytes, expected " +
+                                        std::to_string(key_size_));
+        }
+
+        PageId page_id = root_page_id_;
+        while (true) {
+            Page* page = buffer_pool_.FetchPage(file_id_, page_id);
+            Node node(page->GetData(), key_size_);
+            if (node.IsLeaf()) {
+                leaf_page_id = page_id;
+                return page;
+            }
+            if (path != nullptr) {
+                path->push_back(page_id);
+            }
+            PageId child_page_id = node.FindChild(key, record_id);
+            buffer_pool_.UnpinPage(file_id_, page_id, false);
+            page_id = child_page_id;
+        }
+    }
+
+    Page* BPlusTree::AllocatePage(PageId& page_id) {
+        page_id = num_pages_;
+        Page* page = buffer_pool_.NewPage(file_id_, page_id);
+        num_pages_++;
+        return page;
+    }
+
+    void BPlusTree::SetRootPageId(PageId root_page_id) {
+        root_page_id_ = root_page_id;
+        Page* meta = buffer_pool_.FetchPage(file_id_, META_PAGE_ID);
+        write_field(meta->GetData() + ROOT_PAGE_ID_OFFSET, root_page_id_);
+        buffer_pool_.UnpinPage(file_id_, META_PAGE_ID, true);
+    }
+}  // namespace simpledb::storage
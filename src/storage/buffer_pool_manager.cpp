@@ -0,0 +1,322 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/storage/buffer_pool_manager.h"
+
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+namespace simpledb::storage {
+
+    namespace {
+        // Two spellings of the same file (e.g. "data/t.data" and "./data/t.data") must map to the same FileId.
+        std::string NormalizePath(const std::string& file_path) {
+            return std::filesystem::absolute(file_path).lexically_normal().string();
+        }
+    }  // namespace
+
+    BufferPoolManager::BufferPoolManager(size_t pool_size, std::unique_ptr<Replacer> replacer)
+        : frames_(pool_size), replacer_(std::move(replacer)) {
+        if (pool_size == 0) {
+            throw std::invalid_argument("Buffer pool size must be greater than zero.");
+        }
+        for (FrameId frame_id = 0; frame_id < pool_size; ++frame_id) {
+            free_list_.push_back(frame_id);
+        }
+    }
+
+    BufferPoolManager::~BufferPoolManager() {
+        // Best effort: there is nobody left to report an error to at this point.
+        try {
+            FlushAllPages();
+        } catch (const std::exception&) {
+        }
+    }
+
+    BufferPoolManager& BufferPoolManager::Instance() {
+        static BufferPoolManager instance(DEFAULT_POOL_SIZE, std::make_unique<LruReplacer>());
+        return instance;
+    }
+
+    FileId BufferPoolManager::OpenFile(const std::string& file_path) {
+        std::lock_guard<std::mutex> guard(latch_);
+        std::string path = NormalizePath(file_path);
+        auto it = file_ids_.find(path);
+        if (it != file_ids_.end()) {
+            return it->second;
+        }
+
+        FileEntry entry;
+        entry.path = path;
+        entry.stream.open(path, std::ios::in | std::ios::out | std::ios::binary);
+        if (!entry.stream.is_open()) {
+            throw std::runtime_error("Could not open data file: " + path);
+        }
+
+        FileId file_id = next_file_id_++;
+        files_.emplace(file_id, std::move(entry));
+        file_ids_[path] = file_id;
+        return file_id;
+    }
+
+    void BufferPoolManager::DiscardFile(const std::string& file_path) {
+        std::lock_guard<std::mutex> guard(latch_);
+        std::string path = NormalizePath(file_path);
+        auto it = file_ids_.find(path);
+        if (it == file_ids_.end()) {
+            return;
+        }
+        FileId file_id = it->second;
+
+        // A pinned page is still being read (e.g. by an open cursor), so its frame must not be reused for another
+        // page. Check them all first, so that nothing is discarded if the file is in use.
+        for (const auto& [key, frame_id] : page_table_) {
+            const Frame& frame = frames_[frame_id];
+            if (frame.file_id == file_id && frame.pin_count > 0) {
+                throw std::runtime_error("File " + path + " is in use: page " + std::to_string(frame.page_id) +
+                                         " is pinned " + std::to_string(frame.pin_count) + " time(s).");
+            }
+        }
+
+        for (auto entry = page_table_.begin(); entry != page_table_.end();) {
+            Frame& frame = frames_[entry->second];
+            if (frame.file_id != file_id) {
+                ++entry;
+                continue;
+            }
+            replacer_->Remove(entry->second);
+            frame.is_dirty = false;
+            free_list_.push_back(entry->second);
+            entry = page_table_.erase(entry);
+        }
+
+        files_.erase(file_id);
+        file_ids_.erase(it);
+    }
+
+    uint32_t BufferPoolManager::GetNumPagesOnDisk(FileId file_id) {
+        std::lock_guard<std::mutex> guard(latch_);
+        std::fstream& stream = GetFileEntry(file_id).stream;
+        stream.seekg(0, std::ios::end);
+        std::streamoff file_size = stream.tellg();
+        if (file_size <= 0) {
+            // If the file is empty or an error occurred, return 0 pages.
+            stream.clear();
+            return 0;
+        }
+        return static_cast<uint32_t>(file_size / PAGE_SIZE);
+    }
+
+    Page* BufferPoolManager::FetchPage(FileId file_id, PageId page_id) {
+        std::lock_guard<std::mutex> guard(latch_);
+        uint64_t key = MakeKey(file_id, page_id);
+
+        auto it = page_table_.find(key);
+        if (it != page_table_.end()) {
+            stats_.hits++;
+            Frame& frame = frames_[it->second];
+            frame.pin_count++;
+            replacer_->RecordAccess(it->second);
+            replacer_->SetEvictable(it->second, false);
+            return &frame.page;
+        }
+
+        stats_.misses++;
+        FileEntry& file = GetFileEntry(file_id);
+        FrameId frame_id = AcquireFrame();
+        Frame& frame = frames_[frame_id];
+        try {
+            ReadPageFromDisk(file, page_id, &frame.page);
+        } catch (...) {
+            free_list_.push_back(frame_id);
+            throw;
+        }
+
+        frame.file_id = file_id;
+        frame.page_id = page_id;
+        frame.pin_count = 1;
+        frame.is_dirty = false;
+        page_table_[key] = frame_id;
+        replacer_->RecordAccess(frame_id);
+        replacer_->SetEvictable(frame_id, false);
+        return &frame.page;
+    }
+
+    Page* BufferPoolManager::NewPage(FileId file_id, PageId page_id) {
+        std::lock_guard<std::mutex> guard(latch_);
+        uint64_t key = MakeKey(file_id, page_id);
+        if (page_table_.count(key) > 0) {
+            throw std::logic_error("Page " + std::to_string(page_id) + " is already present in the buffer pool.");
+        }
+
+        GetFileEntry(file_id);  // Validates the file id.
+        FrameId frame_id = AcquireFrame();
+        Frame& frame = frames_[frame_id];
+        std::memset(frame.page.GetData(), 0, PAGE_SIZE);
+        frame.file_id = file_id;
+        frame.page_id = page_id;
+        frame.pin_count = 1;
+        frame.is_dirty = true;
+        page_table_[key] = frame_id;
+        replacer_->RecordAccess(frame_id);
+        replacer_->SetEvictable(frame_id, false);
+        return &frame.page;
+    }
+
+    bool BufferPoolManager::UnpinPage(FileId file_id, PageId page_id, bool is_dirty) {
+        std::lock_guard<std::mutex> guard(latch_);
+        auto it = page_table_.find(MakeKey(file_id, page_id));
+        if (it == page_table_.end()) {
+            return false;
+        }
+
+        Frame& frame = frames_[it->second];
+        if (frame.pin_count <= 0) {
+            return false;
+        }
+        frame.is_dirty = frame.is_dirty || is_dirty;
+        frame.pin_count--;
+        if (frame.pin_count == 0) {
+            replacer_->SetEvictable(it->second, true);
+        }
+        return true;
+    }
+
+    bool BufferPoolManager::FlushPage(FileId file_id, PageId page_id) {
+        std::lock_guard<std::mutex> guard(latch_);
+        auto it = page_table_.find(MakeKey(file_id, page_id));
+        if (it == page_table_.end()) {
+            return false;
+        }
+        Frame& frame = frames_[it->second];
+        if (frame.is_dirty) {
+            WriteBack(frame);
+            GetFileEntry(file_id).stream.flush();
+        }
+        return true;
+    }
+
+    void BufferPoolManager::FlushFile(FileId file_id) {
+        std::lock_guard<std::mutex> guard(latch_);
+        for (const auto& [key, frame_id] : page_table_) {
+            Frame& frame = frames_[frame_id];
+            if (frame.file_id == file_id && frame.is_dirty) {
+                WriteBack(frame);
+            }
+        }
+        auto it = files_.find(file_id);
+        if (it != files_.end()) {
+            it->second.stream.flush();
+        }
+    }
+
+    void BufferPoolManager::FlushAllPages() {
+        std::lock_guard<std::mutex> guard(latch_);
+        for (const auto& [key, frame_id] : page_table_) {
+            Frame& frame = frames_[frame_id];
+            if (frame.is_dirty) {
+                WriteBack(frame);
+            }
+        }
+        for (auto& [file_id, file] : files_) {
+            file.stream.flush();
+        }
+    }
+
+    BufferPoolStats BufferPoolManager::GetStats() const {
+        std::lock_guard<std::mutex> guard(latch_);
+        return stats_;
+    }
+
+    void BufferPoolManager::ResetStats() {
+        std::lock_guard<std::mutex> guard(latch_);
+        stats_ = BufferPoolStats{};
+    }
+
+    FrameId BufferPoolManager::AcquireFrame() {
+        if (!free_list_.empty()) {
+            FrameId frame_id = free_list_.front();
+            free_list_.pop_front();
+            return frame_id;
+        }
+
+        std::optional<FrameId> victim = replacer_->Evict();
+        if (!victim.has_value()) {
+            throw std::runtime_error("Buffer pool is full: all " + std::to_string(frames_.size()) +
+                                     " frames are pinned.");
+        }
+
+        Frame& frame = frames_[*victim];
+        if (frame.is_dirty) {
+            try {
+                WriteBack(frame);
+            } catch (...) {
+                // The frame still holds its page, so give it back to the replacer to be chosen again later.
+                replacer_->RecordAccess(*victim);
+                replacer_->SetEvictable(*victim, true);
+                throw;
+            }
+        }
+        page_table_.erase(MakeKey(frame.file_id, frame.page_id));
+        stats_.evictions++;
+        return *victim;
+    }
+
+    void BufferPoolManager::WriteBack(Frame& frame) {
+        auto it = files_.find(frame.file_id);
+        if (it == files_.end()) {
+            throw std::logic_error("Dirty page " + std::to_string(frame.page_id) + " belongs to an unknown file.");
+        }
+        WritePageToDisk(it->second, frame.page_id, &frame.page);
+        frame.is_dirty = false;
+        stats_.writebacks++;
+    }
+
+    BufferPoolManager::FileEntry& BufferPoolManager::GetFileEntry(FileId file_id) {
+        auto it = files_.find(file_id);
+        if (it == files_.end()) {
+            throw std::logic_error("File id " + std::to_string(file_id) + " is not registered with the buffer pool.");
+        }
+        return it->second;
+    }
+
+    void BufferPoolManager::ReadPageFromDisk(FileEntry& file, PageId page_id, Page* page) {
+        // Calculate the offset for the page we want to read.
+        size_t offset = static_cast<size_t>(page_id) * PAGE_SIZE;
+
+        // Move the file pointer to the correct position.
+        file.stream.seekg(offset);
+        if (file.stream.fail()) {
+            file.stream.clear();
+            throw std::runtime_error("Failed to seek to page " + std::to_string(page_id));
+        }
+
+        // Read the page data into the provided Page object.
+        file.stream.read(page->GetData(), PAGE_SIZE);
+        if (file.stream.fail()) {
+            file.stream.clear();
+            throw std::runtime_error("Failed to read page " + std::to_string(page_id));
+        }
+    }
+
+    void BufferPoolManager::WritePageToDisk(FileEntry& file, PageId page_id, const Page* page) {
+        // Calculate the offset for the page we want to write.
+        size_t offset = static_cast<size_t>(page_id) * PAGE_SIZE;
+
+        // Move the file pointer to the correct position.
+        file.stream.seekp(offset);
+        if (file.stream.fail()) {
+            file.stream.clear();
+            throw std::runtime_error("Failed to seek to page " + std::to_string(page_id));
+        }
+
+        // Write the page data from the provided Page object.
+        file.stream.write(page->GetData(), PAGE_SIZE);
+        if (file.stream.fail()) {
+            file.stream.clear();
+            throw std::runtime_error("Failed to write page " + std::to_string(page_id));
+        }
+    }
+}  // namespace simpledb::storage
@@ -0,0 +1,464 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/storage/hash_index.h"
+#include "simpledb/utils/logging.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+
+namespace simpledb::storage {
+    namespace {
+        /*
+            Meta page (page 0) layout:
+            +-------+----------+-------------+---------------------+-------------+---------------------------+
+            | magic | key_size | num_buckets | num_directory_pages | num_entries | directory page ids ...    |
+            +-------+----------+-------------+---------------------+-------------+---------------------------+
+            0       4          8             12                    16            24
+         */
+        constexpr uint32_t MAGIC = 0x48424453;  // "SDBH"
+        constexpr size_t MAGIC_OFFSET = 0;
+        constexpr size_t KEY_SIZE_OFFSET = 4;
+        constexpr size_t NUM_BUCKETS_OFFSET = 8;
+        constexpr size_t NUM_DIRECTORY_PAGES_OFFSET = 12;
+        constexpr size_t NUM_ENTRIES_OFFSET = 16;
+        constexpr size_t DIRECTORY_PAGE_IDS_OFFSET = 24;
+
+        constexpr PageId META_PAGE_ID = 0;
+
+        // A directory page is an array of bucket page ids, and the meta page has room for this many of them.
+        constexpr uint32_t BUCKETS_PER_DIRECTORY_PAGE = PAGE_SIZE / sizeof(PageId);
+        constexpr uint32_t MAX_DIRECTORY_PAGES = (PAGE_SIZE - DIRECTORY_PAGE_IDS_OFFSET) / sizeof(PageId);
+        constexpr uint32_t MAX_BUCKETS = BUCKETS_PER_DIRECTORY_PAGE * MAX_DIRECTORY_PAGES;
+
+        // Page 0 is the meta page, so no bucket page ever links to it: a link of 0 means "no overflow page".
+        constexpr PageId NO_PAGE = 0;
+
+        // Size of a record id as stored in an entry: page id, then slot.
+        constexpr size_t RECORD_ID_SIZE = sizeof(PageId) + sizeof(uint16_t);
+
+        /*
+            Bucket page layout:
+            +-------------+---+---------------+--------------------------------+
+            | num_entries | - | overflow page | entries: (key, record id) ...  |
+            +-------------+---+---------------+--------------------------------+
+            0             2   4               8
+         */
+        constexpr size_t BUCKET_NUM_ENTRIES_OFFSET = 0;
+        constexpr size_t BUCKET_OVERFLOW_OFFSET = 4;
+        constexpr size_t BUCKET_HEADER_SIZE = 8;
+
+        // A bucket is split once the index holds more entries per bucket than this fraction of a page's worth.
+        constexpr double MAX_LOAD_FACTOR = 0.75;
+
+        // BulkLoad() sizes the index so that buckets are about half full, leaving room for later inserts.
+        constexpr double BULK_LOAD_FACTOR = 0.5;
+
+        template <typename T>
+        T read_field(const char* data) {
+            T value;
+            memcpy(&value, data, sizeof(T));
+            return value;
+        }
+
+        template <typename T>
+        void write_field(char* data, T value) {
+            memcpy(data, &value, sizeof(T));
+        }
+
+        RecordId read_record_id(const char* data) {
+            return {read_field<PageId>(data), read_field<uint16_t>(data + sizeof(PageId))};
+        }
+
+        void write_record_id(char* data, RecordId record_id) {
+            write_field(data, record_id.page_id);
+            write_field(data + sizeof(PageId), record_id.slot);
+        }
+
+        // 64-bit FNV-1a, followed by a final mix so that the low bits (which pick the bucket) depend on every byte
+        // of the key. It is stored on disk implicitly (through where entries live), so it must never change.
+        uint64_t hash_key(std::string_view key) {
+            uint64_t hash = 0xcbf29ce484222325ULL;
+            for (char c : key) {
+                hash ^= static_cast<unsigned char>(c);
+                hash *= 0x100000001b3ULL;
+            }
+            hash ^= hash >> 33;
+            hash *= 0xff51afd7ed558ccdULL;
+            hash ^= hash >> 33;
+            return hash;
+        }
+
+        /**
+         * Typed access to the bytes of a bucket page.
+         */
+        class Bucket {
+           public:
+            Bucket(char* data, uint16_t key_size) : data_(data), entry_size_(key_size + RECORD_ID_SIZE) {}
+
+            static uint16_t Capacity(uint16_t key_size) {
+                return static_cast<uint16_t>((PAGE_SIZE - BUCKET_HEADER_SIZE) / (key_size + RECORD_ID_SIZE));
+            }
+
+            uint16_t Size() const { return read_field<uint16_t>(data_ + BUCKET_NUM_ENTRIES_OFFSET); }
+
+            void SetSize(uint16_t size) { write_field(data_ + BUCKET_NUM_ENTRIES_OFFSET, size); }
+
+            PageId Overflow() const { return read_field<PageId>(data_ + BUCKET_OVERFLOW_OFFSET); }
+
+            void SetOverflow(PageId page_id) { write_field(data_ + BUCKET_OVERFLOW_OFFSET, page_id); }
+
+            size_t EntrySize() const { return entry_size_; }
+
+            char* Entry(size_t i) const { return data_ + BUCKET_HEADER_SIZE + i * entry_size_; }
+
+           private:
+            char* data_;
+            size_t entry_size_;
+        };
+    }  // namespace
+
+    HashIndex::HashIndex(const std::string& index_file_path, uint16_t key_size, BufferPoolManager& buffer_pool)
+        : buffer_pool_(buffer_pool), file_path_(index_file_path), key_size_(key_size) {
+        if (key_size_ == 0 || key_size_ > MAX_KEY_SIZE) {
+            throw std::runtime_error("Invalid index key size: " + std::to_string(key_size_));
+        }
+
+        if (!std::filesystem::exists(file_path_)) {
+            std::ofstream create_stream(file_path_, std::ios::out | std::ios::binary);
+            if (!create_stream.is_open()) {
+                throw std::runtime_error("Could not open or create index file: " + file_path_);
+            }
+            create_stream.close();
+            buffer_pool_.DiscardFile(file_path_);
+        }
+
+        file_id_ = buffer_pool_.OpenFile(file_path_);
+        num_pages_ = buffer_pool_.GetNumPagesOnDisk(file_id_);
+
+        if (num_pages_ == 0) {
+            // A new index: the meta page, and a single empty bucket.
+            buffer_pool_.NewPage(file_id_, META_PAGE_ID);
+            num_pages_ = 1;
+            buffer_pool_.UnpinPage(file_id_, META_PAGE_ID, true);
+            AddBucket();
+            buffer_pool_.FlushFile(file_id_);
+            return;
+        }
+
+        Page* meta = buffer_pool_.FetchPage(file_id_, META_PAGE_ID);
+        const char* data = meta->GetData();
+        uint32_t magic = read_field<uint32_t>(data + MAGIC_OFFSET);
+        uint16_t stored_key_size = read_field<uint16_t>(data + KEY_SIZE_OFFSET);
+        num_buckets_ = read_field<uint32_t>(data + NUM_BUCKETS_OFFSET);
+        uint32_t num_directory_pages = read_field<uint32_t>(data + NUM_DIRECTORY_PAGES_OFFSET);
+        num_entries_ = read_field<uint64_t>(data + NUM_ENTRIES_OFFSET);
+        if (magic == MAGIC && num_directory_pages <= MAX_DIRECTORY_PAGES) {
+            for (uint32_t i = 0; i < num_directory_pages; ++i) {
+                directory_page_ids_.push_back(
+                    read_field<PageId>(data + DIRECTORY_PAGE_IDS_OFFSET + i * sizeof(PageId)));
+            }
+        }
+        buffer_pool_.UnpinPage(file_id_, META_PAGE_ID, false);
+        if (magic != MAGIC) {
+            throw std::runtime_error("Not a hash index file: " + file_path_);
+        }
+        if (stored_key_size != key_size_) {
+            throw std::runtime_error("Index file " + file_path_ + " has keys of " + std::to_string(stored_key_size) +
+                                     " bytes, expected " + std::to_string(key_size_));
+        }
+    }
+
+    HashIndex::~HashIndex() {
+        try {
+            buffer_pool_.FlushFile(file_id_);
+        } catch (const std::exception& e) {
+            logging::log.error("Failed to flush index file {}: {}", file_path_, e.what());
+        }
+    }
+
+    void HashIndex::Insert(std::string_view key, RecordId record_id) {
+        if (key.size() != key_size_) {
+            throw std::invalid_argument("Index key has " + std::to_string(key.size()) + " bytes, expected " +
+                                        std::to_string(key_size_));
+        }
+
+        // Walk the bucket's pages, looking for the entry and for the first page with room for it.
+        const uint16_t capacity = Bucket::Capacity(key_size_);
+        PageId page_id = GetBucketPageId(BucketOf(key));
+        PageId free_page_id = NO_PAGE;
+        PageId last_page_id = NO_PAGE;
+        while (page_id != NO_PAGE) {
+            Page* page = buffer_pool_.FetchPage(file_id_, page_id);
+            Bucket bucket(page->GetData(), key_size_);
+            for (uint16_t i = 0; i < bucket.Size(); ++i) {
+                const char* entry = bucket.Entry(i);
+                if (memcmp(entry, key.data(), key_size_) == 0 && read_record_id(entry + key_size_) == record_id) {
+                    buffer_pool_.UnpinPage(file_id_, page_id, false);
+                    return;
+                }
+            }
+            if (free_page_id == NO_PAGE && bucket.Size() < capacity) {
+                free_page_id = page_id;
+            }
+            last_page_id = page_id;
+            PageId overflow_page_id = bucket.Overflow();
+            buffer_pool_.UnpinPage(file_id_, page_id, false);
+            page_id = overflow_page_id;
+        }
+
+        if (free_page_id == NO_PAGE) {
+            // Every page of the bucket is full: chain a new overflow page to the last one.
+            AllocatePage(free_page_id);
+            buffer_pool_.UnpinPage(file_id_, free_page_id, true);
+            Page* last_page = buffer_pool_.FetchPage(file_id_, last_page_id);
+            Bucket(last_page->GetData(), key_size_).SetOverflow(free_page_id);
+            buffer_pool_.UnpinPage(file_id_, last_page_id, true);
+        }
+
+        Page* page = buffer_pool_.FetchPage(file_id_, free_page_id);
+        Bucket bucket(page->GetData(), key_size_);
+        char* entry = bucket.Entry(bucket.Size());
+        memcpy(entry, key.data(), key_size_);
+        write_record_id(entry + key_size_, record_id);
+        bucket.SetSize(bucket.Size() + 1);
+        buffer_pool_.UnpinPage(file_id_, free_page_id, true);
+
+        num_entries_ += 1;
+        if (num_entries_ > MAX_LOAD_FACTOR * capacity * num_buckets_ && num_buckets_ < MAX_BUCKETS) {
+            Split();
+        }
+        WriteMeta();
+    }
+
+    void HashIndex::BulkLoad(std::vector<IndexEntry> entries) {
+        if (num_entries_ != 0) {
+            throw std::runtime_error("Can only bulk load an empty index: " + file_path_);
+        }
+        for (const IndexEntry& entry : entries) {
+            if (entry.key.size() != key_size_) {
+                throw std::invalid_argument("Index key has " + std::to_string(entry.key.size()) +
+                                            " bytes, expected " + std::to_string(key_size_));
+            }
+        }
+        if (entries.empty()) {
+            return;
+        }
+
+        // Create all the buckets first, so that every entry goes straight to its final bucket.
+        const uint16_t capacity = Bucket::Capacity(key_size_);
+        const double num_buckets = std::ceil(static_cast<double>(entries.size()) / (capacity * BULK_LOAD_FACTOR));
+        const uint32_t target_num_buckets = static_cast<uint32_t>(std::min<double>(num_buckets, MAX_BUCKETS));
+        while (num_buckets_ < target_num_buckets) {
+            AddBucket();
+        }
+
+        // Group the entries by bucket, dropping duplicates (which end up next to each other).
+        std::vector<uint32_t> buckets(entries.size());
+        for (size_t i = 0; i < entries.size(); ++i) {
+            buckets[i] = BucketOf(entries[i].key);
+        }
+        std::vector<size_t> order(entries.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+            if (buckets[lhs] != buckets[rhs]) {
+                return buckets[lhs] < buckets[rhs];
+            }
+            int result = entries[lhs].key.compare(entries[rhs].key);
+            return result != 0 ? result < 0 : entries[lhs].record_id < entries[rhs].record_id;
+        });
+
+        const size_t entry_size = key_size_ + RECORD_ID_SIZE;
+        std::string data;
+        data.reserve(entries.size() * entry_size);
+        std::vector<uint32_t> data_buckets;
+        for (size_t k = 0; k < order.size(); ++k) {
+            const IndexEntry& entry = entries[order[k]];
+            if (k > 0) {
+                const IndexEntry& previous = entries[order[k - 1]];
+                if (entry.key == previous.key && entry.record_id == previous.record_id) {
+                    continue;
+                }
+            }
+            char record_id[RECORD_ID_SIZE];
+            write_record_id(record_id, entry.record_id);
+            data.append(entry.key);
+            data.append(record_id, RECORD_ID_SIZE);
+            data_buckets.push_back(buckets[order[k]]);
+        }
+
+        std::vector<const char*> bucket_entries;
+        for (size_t begin = 0; begin < data_buckets.size();) {
+            size_t end = begin;
+            bucket_entries.clear();
+            while (end < data_buckets.size() && data_buckets[end] == data_buckets[begin]) {
+                bucket_entries.push_back(data.data() + end * entry_size);
+                ++end;
+            }
+            WriteBucket(GetBucketPageId(data_buckets[begin]), bucket_entries);
+            begin = end;
+        }
+
+        num_entries_ = data_buckets.size();
+        WriteMeta();
+        buffer_pool_.FlushFile(file_id_);
+    }
+
+    void HashIndex::Find(std::string_view key, std::vector<RecordId>& record_ids) {
+        if (key.size() != key_size_) {
+            throw std::invalid_argument("Index key has " + std::to_string(key.size()) + " bytes, expected " +
+                                        std::to_string(key_size_));
+        }
+        PageId page_id = GetBucketPageId(BucketOf(key));
+        while (page_id != NO_PAGE) {
+            Page* page = buffer_pool_.FetchPage(file_id_, page_id);
+            Bucket bucket(page->GetData(), key_size_);
+            for (uint16_t i = 0; i < bucket.Size(); ++i) {
+                const char* entry = bucket.Entry(i);
+                if (memcmp(entry, key.data(), key_size_) == 0) {
+                    record_ids.push_back(read_record_id(entry + key_size_));
+                }
+            }
+            PageId overflow_page_id = bucket.Overflow();
+            buffer_pool_.UnpinPage(file_id_, page_id, false);
+            page_id = overflow_page_id;
+        }
+    }
+
+    uint32_t HashIndex::BucketOf(std::string_view key) const {
+        // With 2^level <= num_buckets < 2^(level + 1), the buckets below num_buckets - 2^level have already been
+        // split in this round and are addressed with level + 1 bits of the hash, the others with level bits.
+        uint64_t hash = hash_key(key);
+        uint64_t round_size = 1;
+        while (round_size * 2 <= num_buckets_) {
+            round_size *= 2;
+        }
+        uint64_t bucket = hash & (round_size * 2 - 1);
+        if (bucket >= num_buckets_) {
+            bucket = hash & (round_size - 1);
+        }
+        return static_cast<uint32_t>(bucket);
+    }
+
+    PageId HashIndex::GetBucketPageId(uint32_t bucket) {
+        PageId directory_page_id = directory_page_ids_.at(bucket / BUCKETS_PER_DIRECTORY_PAGE);
+        Page* directory = buffer_pool_.FetchPage(file_id_, directory_page_id);
+        PageId page_id = read_field<PageId>(directory->GetData() +
+                                            (bucket % BUCKETS_PER_DIRECTORY_PAGE) * sizeof(PageId));
+        buffer_pool_.UnpinPage(file_id_, directory_page_id, false);
+        return page_id;
+    }
+
+    void HashIndex::AddBucket() {
+        const uint32_t bucket = num_buckets_;
+        if (bucket / BUCKETS_PER_DIRECTORY_PAGE == directory_page_ids_.size()) {
+            PageId directory_page_id;
+            AllocatePage(directory_page_id);
+            buffer_pool_.UnpinPage(file_id_, directory_page_id, true);
+            directory_page_ids_.push_back(directory_page_id);
+        }
+
+        PageId bucket_page_id;
+        AllocatePage(bucket_page_id);
+        buffer_pool_.UnpinPage(file_id_, bucket_page_id, true);
+
+        PageId directory_page_id = directory_page_ids_[bucket / BUCKETS_PER_DIRECTORY_PAGE];
+        Page* directory = buffer_pool_.FetchPage(file_id_, directory_page_id);
+        write_field(directory->GetData() + (bucket % BUCKETS_PER_DIRECTORY_PAGE) * sizeof(PageId), bucket_page_id);
+        buffer_pool_.UnpinPage(file_id_, directory_page_id, true);
+
+        num_buckets_ += 1;
+        WriteMeta();
+    }
+
+    void HashIndex::Split() {
+        uint32_t round_size = 1;
+        while (round_size * 2 <= num_buckets_) {
+            round_size *= 2;
+        }
+        const uint32_t split_bucket = num_buckets_ - round_size;
+        const PageId split_page_id = GetBucketPageId(split_bucket);
+
+        // Copy the bucket's entries out, since its pages are about to be rewritten.
+        std::string data;
+        PageId page_id = split_page_id;
+        while (page_id != NO_PAGE) {
+            Page* page = buffer_pool_.FetchPage(file_id_, page_id);
+            Bucket bucket(page->GetData(), key_size_);
+            data.append(bucket.Entry(0), bucket.Size() * bucket.EntrySize());
+            PageId overflow_page_id = bucket.Overflow();
+            buffer_pool_.UnpinPage(file_id_, page_id, false);
+            page_id = overflow_page_id;
+        }
+
+        // With one more bucket, the entries of the split bucket are addressed with one more bit of their hash:
+        // each one either stays, or moves to the new bucket.
+        AddBucket();
+        const size_t entry_size = key_size_ + RECORD_ID_SIZE;
+        std::vector<const char*> staying;
+        std::vector<const char*> moving;
+        for (size_t offset = 0; offset < data.size(); offset += entry_size) {
+            const char* entry = data.data() + offset;
+            if (BucketOf(std::string_view(entry, key_size_)) == split_bucket) {
+                staying.push_back(entry);
+            } else {
+                moving.push_back(entry);
+            }
+        }
+        WriteBucket(split_page_id, staying);
+        WriteBucket(GetBucketPageId(num_buckets_ - 1), moving);
+    }
+
+    void HashIndex::WriteBucket(PageId first_page_id, const std::vector<const char*>& entries) {
+        const uint16_t capacity = Bucket::Capacity(key_size_);
+        size_t written = 0;
+        PageId page_id = first_page_id;
+        while (page_id != NO_PAGE) {
+            Page* page = buffer_pool_.FetchPage(file_id_, page_id);
+            Bucket bucket(page->GetData(), key_size_);
+            const uint16_t count = static_cast<uint16_t>(std::min<size_t>(capacity, entries.size() - written));
+            for (uint16_t i = 0; i < count; ++i) {
+                memcpy(bucket.Entry(i), entries[written + i], bucket.EntrySize());
+            }
+            bucket.SetSize(count);
+            written += count;
+
+            PageId overflow_page_id = bucket.Overflow();
+            if (overflow_page_id == NO_PAGE && written < entries.size()) {
+                AllocatePage(overflow_page_id);
+                buffer_pool_.UnpinPage(file_id_, overflow_page_id, true);
+                bucket.SetOverflow(overflow_page_id);
+            }
+            buffer_pool_.UnpinPage(file_id_, page_id, true);
+            page_id = overflow_page_id;
+        }
+    }
+
+    Page* HashIndex::AllocatePage(PageId& page_id) {
+        page_id = num_pages_;
+        Page* page = buffer_pool_.NewPage(file_id_, page_id);
+        memset(page->GetData(), 0, PAGE_SIZE);
+        num_pages_++;
+        return page;
+    }
+
+    void HashIndex::WriteMeta() {
+        Page* meta = buffer_pool_.FetchPage(file_id_, META_PAGE_ID);
+        char* data = meta->GetData();
+        write_field(data + MAGIC_OFFSET, MAGIC);
+        write_field(data + KEY_SIZE_OFFSET, key_size_);
+        write_field(data + NUM_BUCKETS_OFFSET, num_buckets_);
+        write_field(data + NUM_DIRECTORY_PAGES_OFFSET, static_cast<uint32_t>(directory_page_ids_.size()));
+        write_field(data + NUM_ENTRIES_OFFSET, num_entries_);
+        for (size_t i = 0; i < directory_page_ids_.size(); ++i) {
+            write_field(data + DIRECTORY_PAGE_IDS_OFFSET + i * sizeof(PageId), directory_page_ids_[i]);
+        }
+        buffer_pool_.UnpinPage(file_id_, META_PAGE_ID, true);
+    }
+}  // namespace simpledb::storage
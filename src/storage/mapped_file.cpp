@@ -0,0 +1,53 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/storage/mapped_file.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace simpledb::storage {
+
+    MappedFile::MappedFile(const std::string& file_path) {
+        int fd = open(file_path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Could not open file " + file_path + ": " + std::strerror(errno));
+        }
+
+        struct stat file_stat {};
+        if (fstat(fd, &file_stat) != 0) {
+            int error = errno;
+            close(fd);
+            throw std::runtime_error("Could not stat file " + file_path + ": " + std::strerror(error));
+        }
+        size_ = static_cast<size_t>(file_stat.st_size);
+        if (size_ == 0) {
+            // mmap() rejects empty mappings, an empty file is simply an empty buffer.
+            close(fd);
+            return;
+        }
+
+        void* mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        int error = errno;
+        // The mapping keeps its own reference to the file, the descriptor isn't needed anymore.
+        close(fd);
+        if (mapping == MAP_FAILED) {
+            throw std::runtime_error("Could not map file " + file_path + ": " + std::strerror(error));
+        }
+        // The file is read front to back, so let the OS read ahead aggressively. Only a hint, failure is fine.
+        madvise(mapping, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(mapping);
+    }
+
+    MappedFile::~MappedFile() {
+        if (data_ != nullptr) {
+            munmap(const_cast<char*>(data_), size_);
+        }
+    }
+}  // namespace simpledb::storage
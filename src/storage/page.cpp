@@ -88,10 +88,10 @@ namespace simpledb::storage {
         return true;
     }
 
-    std::vector<char> Page::GetRecord(const Page::Slot& slot) const {
-        std::vector<char> record_data(slot.record_length);
-        memcpy(record_data.data(), &data_[slot.record_offset], slot.record_length);
-        return record_data;
+    std::vector<char> Page::GetRecord(const Page::Slot& slot) const { return GetRecordView(slot).ToVector(); }
+
+    RecordView Page::GetRecordView(const Page::Slot& slot) const {
+        return RecordView{&data_[slot.record_offset], slot.record_length};
     }
 
     const char* Page::GetData() const { return data_.data(); }
@@ -0,0 +1,87 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/storage/replacer.h"
+
+namespace simpledb::storage {
+
+    void LruReplacer::RecordAccess(FrameId frame_id) {
+        auto it = lru_positions_.find(frame_id);
+        if (it == lru_positions_.end()) {
+            // Pinned frames are not tracked, their position is decided when they become evictable again.
+            return;
+        }
+        lru_list_.splice(lru_list_.end(), lru_list_, it->second);
+    }
+
+    void LruReplacer::SetEvictable(FrameId frame_id, bool evictable) {
+        auto it = lru_positions_.find(frame_id);
+        if (evictable && it == lru_positions_.end()) {
+            lru_positions_[frame_id] = lru_list_.insert(lru_list_.end(), frame_id);
+        } else if (!evictable && it != lru_positions_.end()) {
+            lru_list_.erase(it->second);
+            lru_positions_.erase(it);
+        }
+    }
+
+    std::optional<FrameId> LruReplacer::Evict() {
+        if (lru_list_.empty()) {
+            return std::nullopt;
+        }
+        FrameId victim = lru_list_.front();
+        lru_list_.pop_front();
+        lru_positions_.erase(victim);
+        return victim;
+    }
+
+    void LruReplacer::Remove(FrameId frame_id) { SetEvictable(frame_id, false); }
+
+    size_t LruReplacer::Size() const { return lru_list_.size(); }
+
+    ClockReplacer::ClockReplacer(size_t num_frames)
+        : reference_bits_(num_frames, false), evictable_(num_frames, false) {}
+
+    void ClockReplacer::RecordAccess(FrameId frame_id) { reference_bits_.at(frame_id) = true; }
+
+    void ClockReplacer::SetEvictable(FrameId frame_id, bool evictable) {
+        if (evictable_.at(frame_id) == evictable) {
+            return;
+        }
+        evictable_[frame_id] = evictable;
+        if (evictable) {
+            num_evictable_++;
+        } else {
+            num_evictable_--;
+        }
+    }
+
+    std::optional<FrameId> ClockReplacer::Evict() {
+        if (num_evictable_ == 0) {
+            return std::nullopt;
+        }
+        // At most two full sweeps: the first one may only clear reference bits.
+        for (size_t step = 0; step < 2 * evictable_.size(); ++step) {
+            FrameId candidate = clock_hand_;
+            clock_hand_ = (clock_hand_ + 1) % evictable_.size();
+            if (!evictable_[candidate]) {
+                continue;
+            }
+            if (reference_bits_[candidate]) {
+                reference_bits_[candidate] = false;  // Give it a second chance.
+                continue;
+            }
+            evictable_[candidate] = false;
+            num_evictable_--;
+            return candidate;
+        }
+        return std::nullopt;
+    }
+
+    void ClockReplacer::Remove(FrameId frame_id) {
+        SetEvictable(frame_id, false);
+        reference_bits_.at(frame_id) = false;
+    }
+
+    size_t ClockReplacer::Size() const { return num_evictable_; }
+}  // namespace simpledb::storage
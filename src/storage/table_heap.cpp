@@ -6,74 +6,135 @@
 #include "simpledb/storage/table_heap.h"
 #include "simpledb/utils/logging.h"
 
-#include <iostream>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <stdexcept>
 
 namespace simpledb::storage {
 
-    TableHeap::Iterator::Iterator(TableHeap* parent_heap, PageId page_id, uint16_t slot_num)
-        : parent_heap_(parent_heap), current_page_id_(page_id), current_slot_num_(slot_num) {}
+    TableHeap::Iterator::Iterator(TableHeap* parent_heap, PageId page_id, uint16_t slot_num, PageId end_page_id)
+        : parent_heap_(parent_heap),
+          current_page_id_(page_id),
+          current_slot_num_(slot_num),
+          end_page_id_(end_page_id) {}
+
+    TableHeap::Iterator::~Iterator() { ReleasePage(); }
+
+    TableHeap::Iterator::Iterator(Iterator&& other) noexcept
+        : parent_heap_(other.parent_heap_),
+          current_page_id_(other.current_page_id_),
+          current_slot_num_(other.current_slot_num_),
+          end_page_id_(other.end_page_id_),
+          current_page_(other.current_page_),
+          page_records_(std::move(other.page_records_)) {
+        // The pin now belongs to this iterator.
+        other.current_page_ = nullptr;
+    }
 
-    std::optional<std::vector<char>> TableHeap::Iterator::next() {
-        uint32_t num_pages = parent_heap_->GetNumPages();
-        while (true) {
-            if (current_page_id_ >= num_pages) {
-                // No more pages left, return std::nullopt to signal end of iteration.
-                return std::nullopt;
-            }
+    TableHeap::Iterator& TableHeap::Iterator::operator=(Iterator&& other) noexcept {
+        if (this != &other) {
+            ReleasePage();
+            parent_heap_ = other.parent_heap_;
+            current_page_id_ = other.current_page_id_;
+            current_slot_num_ = other.current_slot_num_;
+            end_page_id_ = other.end_page_id_;
+            current_page_ = other.current_page_;
+            page_records_ = std::move(other.page_records_);
+            other.current_page_ = nullptr;
+        }
+        return *this;
+    }
+
+    std::optional<RecordView> TableHeap::Iterator::next() {
+        if (!PinPageWithRecords()) {
+            // No more records left, return std::nullopt to signal end of iteration.
+            return std::nullopt;
+        }
 
-            Page page;
-            parent_heap_->ReadPage(current_page_id_, &page);
+        RecordView record = current_page_->GetRecordView(current_page_->GetSlot(current_slot_num_));
+        current_slot_num_ += 1;  // Move to the next slot for the next call.
+        return record;
+    }
 
-            if (current_slot_num_ >= page.GetNumRecords()) {
-                // If we have exhausted the current page, move to the next page.
-                current_slot_num_ = 0;
-                current_page_id_ += 1;
-                continue;  // Re-check the new page.
-            }
+    const std::vector<RecordView>& TableHeap::Iterator::NextPage() {
+        page_records_.clear();
+        if (!PinPageWithRecords()) {
+            return page_records_;
+        }
 
-            // If we have a valid slot, break out of the loop to return the record.
-            std::vector<char> record = page.GetRecord(page.GetSlot(current_slot_num_));
-            current_slot_num_ += 1;  // Move to the next slot for the next call.
-            return record;
+        const uint16_t num_records = current_page_->GetNumRecords();
+        for (; current_slot_num_ < num_records; ++current_slot_num_) {
+            page_records_.push_back(current_page_->GetRecordView(current_page_->GetSlot(current_slot_num_)));
         }
+        // The page stays pinned (so the views stay valid), the next call moves on to the next page.
+        return page_records_;
     }
 
-    TableHeap::TableHeap(const std::string& table_data_path) : file_path_(table_data_path) {
-        // Try to open the file for both reading and writing in binary mode.
-        // This will succeed if the file already exists.
-        file_stream_.open(file_path_, std::ios::in | std::ios::out | std::ios::binary);
+    bool TableHeap::Iterator::PinPageWithRecords() {
+        while (true) {
+            if (current_page_ == nullptr) {
+                if (current_page_id_ >= end_page_id_ || current_page_id_ >= parent_heap_->GetNumPages()) {
+                    return false;
+                }
+                current_page_ = parent_heap_->buffer_pool_.FetchPage(parent_heap_->file_id_, current_page_id_);
+            }
 
-        if (!file_stream_.is_open()) {
-            // Clear the error state of the stream.
-            file_stream_.clear();
+            if (current_slot_num_ < current_page_->GetNumRecords()) {
+                return true;
+            }
 
-            // Open the file in output mode. This will create an empty file.
-            // We can close it immediately because we just wanted to ensure it exists.
-            file_stream_.open(file_path_, std::ios::out | std::ios::binary);
-            file_stream_.close();
+            // If we have exhausted the current page, move to the next page.
+            ReleasePage();
+            current_slot_num_ = 0;
+            current_page_id_ += 1;
+        }
+    }
 
-            // Now that the file is guaranteed to exist, re-open it in the
-            // correct read/write mode.
-            file_stream_.open(file_path_, std::ios::in | std::ios::out | std::ios::binary);
+    void TableHeap::Iterator::ReleasePage() {
+        if (current_page_ != nullptr) {
+            parent_heap_->buffer_pool_.UnpinPage(parent_heap_->file_id_, current_page_id_, false);
+            current_page_ = nullptr;
         }
+    }
 
-        // Perform a final check. If the file is still not open after all our attempts,
-        // something is seriously wrong (e.g., bad permissions, invalid path).
-        if (!file_stream_.is_open()) {
-            throw std::runtime_error("Could not open or create table heap file: " + file_path_);
+    TableHeap::TableHeap(const std::string& table_data_path, BufferPoolManager& buffer_pool)
+        : buffer_pool_(buffer_pool), file_path_(table_data_path) {
+        if (!std::filesystem::exists(file_path_)) {
+            // Create an empty file. Anything the buffer pool still remembers about a previous file at this path
+            // (e.g. one that was deleted behind its back) is stale now.
+            std::ofstream create_stream(file_path_, std::ios::out | std::ios::binary);
+            if (!create_stream.is_open()) {
+                throw std::runtime_error("Could not open or create table heap file: " + file_path_);
+            }
+            create_stream.close();
+            buffer_pool_.DiscardFile(file_path_);
         }
+
+        file_id_ = buffer_pool_.OpenFile(file_path_);
+        RefreshNumPages();
     }
 
-    bool TableHeap::InsertRecord(const std::vector<char>& record_data) {
-        uint32_t num_pages = GetNumPages();
+    TableHeap::~TableHeap() {
+        try {
+            buffer_pool_.FlushFile(file_id_);
+        } catch (const std::exception& e) {
+            logging::log.error("Failed to flush table heap file {}: {}", file_path_, e.what());
+        }
+    }
+
+    std::optional<RecordId> TableHeap::InsertRecord(const std::vector<char>& record_data) {
+        uint32_t num_pages = num_pages_;
         if (num_pages > 0) {
+            // Modify the last page in place inside the buffer pool instead of copying it out and back.
             uint32_t last_page_id = num_pages - 1;
-            Page last_page;
-            ReadPage(last_page_id, &last_page);
-            if (last_page.AddRecord(record_data)) {
-                WritePage(last_page_id, &last_page);
-                return true;
+            Page* last_page = buffer_pool_.FetchPage(file_id_, last_page_id);
+            bool added = last_page->AddRecord(record_data);
+            uint16_t slot = last_page->GetNumRecords() - 1;
+            buffer_pool_.UnpinPage(file_id_, last_page_id, added);
+            if (added) {
+                buffer_pool_.FlushPage(file_id_, last_page_id);
+                return RecordId{last_page_id, slot};
             }
         }
 
@@ -83,78 +144,103 @@ namespace simpledb::storage {
         if (!new_page.AddRecord(record_data)) {
             logging::log.error("Failed to add record to the new page. Record size may be too large: {} bytes.",
                                record_data.size());
-            return false;
+            return std::nullopt;
         }
         WritePage(num_pages, &new_page);
-        return true;
+        return RecordId{num_pages, 0};
     }
 
-    void TableHeap::ReadPage(PageId page_id, Page* page) {
-        if (!file_stream_.is_open()) {
-            throw std::runtime_error("File stream is not open for reading.");
+    bool TableHeap::InsertRecords(const std::vector<std::vector<char>>& records, std::vector<RecordId>* record_ids) {
+        for (const auto& record_data : records) {
+            if (record_data.size() > Page::MAX_RECORD_SIZE) {
+                logging::log.error("Rejecting batch of {} records: a record of {} bytes doesn't fit on a page.",
+                                   records.size(),
+                                   record_data.size());
+                return false;
+            }
         }
-
-        if (page_id >= GetNumPages()) {
-            throw std::out_of_range("Page ID " + std::to_string(page_id) + " is out of range.");
+        if (record_ids != nullptr) {
+            record_ids->clear();
+            record_ids->reserve(records.size());
+        }
+        if (records.empty()) {
+            return true;
         }
 
-        // Calculate the offset for the page we want to read.
-        size_t offset = static_cast<size_t>(page_id) * PAGE_SIZE;
+        // Start filling the last page (if any), the page stays pinned while we append to it.
+        PageId page_id;
+        Page* page;
+        if (num_pages_ > 0) {
+            page_id = num_pages_ - 1;
+            page = buffer_pool_.FetchPage(file_id_, page_id);
+        } else {
+            page_id = 0;
+            page = buffer_pool_.NewPage(file_id_, page_id);
+            page->Initialize();
+            num_pages_++;
+        }
 
-        // Move the file pointer to the correct position.
-        file_stream_.seekg(offset);
-        if (file_stream_.fail()) {
-            throw std::runtime_error("Failed to seek to page " + std::to_string(page_id));
+        for (const auto& record_data : records) {
+            if (page->AddRecord(record_data)) {
+                if (record_ids != nullptr) {
+                    record_ids->push_back({page_id, static_cast<uint16_t>(page->GetNumRecords() - 1)});
+                }
+                continue;
+            }
+            // The page is full. Unpinning it (as dirty) lets the buffer pool write it out whenever it needs the
+            // frame, so a long batch doesn't need more frames than a short one.
+            buffer_pool_.UnpinPage(file_id_, page_id, true);
+            page_id = num_pages_;
+            page = buffer_pool_.NewPage(file_id_, page_id);
+            page->Initialize();
+            num_pages_++;
+            // Can't fail: the record fits on an empty page, we checked that above.
+            page->AddRecord(record_data);
+            if (record_ids != nullptr) {
+                record_ids->push_back({page_id, 0});
+            }
         }
+        buffer_pool_.UnpinPage(file_id_, page_id, true);
+
+        buffer_pool_.FlushFile(file_id_);
+        return true;
+    }
 
-        // Read the page data into the provided Page object.
-        file_stream_.read(page->GetData(), PAGE_SIZE);
-        if (file_stream_.fail()) {
-            throw std::runtime_error("Failed to read page " + std::to_string(page_id));
+    bool TableHeap::GetRecord(RecordId record_id, std::vector<char>& record_data) {
+        if (record_id.page_id >= num_pages_) {
+            return false;
+        }
+        Page* page = buffer_pool_.FetchPage(file_id_, record_id.page_id);
+        bool found = record_id.slot < page->GetNumRecords();
+        if (found) {
+            RecordView record = page->GetRecordView(page->GetSlot(record_id.slot));
+            record_data.assign(record.begin(), record.end());
         }
-        file_stream_.seekg(0);
+        buffer_pool_.UnpinPage(file_id_, record_id.page_id, false);
+        return found;
     }
 
     void TableHeap::WritePage(PageId page_id, const Page* page) {
-        if (!file_stream_.is_open()) {
-            throw std::runtime_error("File stream is not open for writing.");
+        if (page_id > num_pages_) {
+            throw std::out_of_range("Page ID " + std::to_string(page_id) + " is out of range.");
         }
 
-        uint32_t num_pages = GetNumPages();
-        if (page_id > num_pages) {
-            throw std::out_of_range("Page ID " + std::to_string(page_id) + " is out of range.");
-        } else if (page_id == num_pages) {
+        Page* frame;
+        if (page_id == num_pages_) {
             // If the page_id is equal to the number of pages, we are appending a new page.
             logging::log.info("Appending new page with ID {}.", page_id);
+            frame = buffer_pool_.NewPage(file_id_, page_id);
+        } else {
+            frame = buffer_pool_.FetchPage(file_id_, page_id);
         }
-
-        // Calculate the offset for the page we want to write.
-        size_t offset = static_cast<size_t>(page_id) * PAGE_SIZE;
-
-        // Move the file pointer to the correct position.
-        file_stream_.seekp(offset);
-        if (file_stream_.fail()) {
-            throw std::runtime_error("Failed to seek to page " + std::to_string(page_id));
+        memcpy(frame->GetData(), page->GetData(), PAGE_SIZE);
+        buffer_pool_.UnpinPage(file_id_, page_id, true);
+        if (page_id == num_pages_) {
+            num_pages_++;
         }
-
-        // Write the page data from the provided Page object.
-        file_stream_.write(page->GetData(), PAGE_SIZE);
-        if (file_stream_.fail()) {
-            throw std::runtime_error("Failed to write page " + std::to_string(page_id));
-        }
-
-        file_stream_.flush();
-        file_stream_.seekp(0);
+        buffer_pool_.FlushPage(file_id_, page_id);
     }
 
-    uint32_t TableHeap::GetNumPages() {
-        file_stream_.seekg(0, std::ios::end);
-        std::streamoff file_size = file_stream_.tellg();
-        if (file_size <= 0) {
-            // If the file is empty or an error occurred, return 0 pages.
-            return 0;
-        }
-        return static_cast<uint32_t>(file_size / PAGE_SIZE);
-    }
+    void TableHeap::RefreshNumPages() { num_pages_ = buffer_pool_.GetNumPagesOnDisk(file_id_); }
 
 }  // namespace simpledb::storage
@@ -0,0 +1,280 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/table_index.h"
+
+#include "simpledb/storage/b_plus_tree.h"
+#include "simpledb/storage/buffer_pool_manager.h"
+#include "simpledb/storage/hash_index.h"
+#include "simpledb/storage/table_heap.h"
+#include "simpledb/utils/logging.h"
+
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+
+namespace table_index {
+    namespace {
+        // Adds the keys of a column of some records to an index (a BPlusTree or a HashIndex).
+        template <typename Index>
+        void insert_keys(Index& index,
+                         const serializer::RecordLayout& layout,
+                         size_t column,
+                         const std::vector<std::vector<char>>& records,
+                         const std::vector<simpledb::storage::RecordId>& record_ids) {
+            std::string key;
+            for (size_t i = 0; i < records.size(); ++i) {
+                simpledb::storage::RecordView record{records[i].data(), static_cast<uint16_t>(records[i].size())};
+                if (encode_key(layout, record, column, key)) {
+                    index.Insert(key, record_ids[i]);
+                }
+            }
+        }
+
+        // The text of a column's value, as it would be shown in a result (the column must not be NULL).
+        std::string column_value(const serializer::RecordLayout& layout,
+                                 simpledb::storage::RecordView record,
+                                 size_t column) {
+            if (layout.column_type(column) == command::Datatype::INT) {
+                return std::to_string(serializer::read_int(layout, record, column));
+            }
+            return std::string(serializer::read_text(layout, record, column));
+        }
+
+        void find_key(simpledb::storage::BPlusTree& tree,
+                      std::string_view key,
+                      std::vector<simpledb::storage::RecordId>& record_ids) {
+            simpledb::storage::BPlusTree::Iterator iterator = tree.Seek(key);
+            std::string_view entry_key;
+            simpledb::storage::RecordId record_id;
+            while (iterator.Next(entry_key, record_id) && entry_key == key) {
+                record_ids.push_back(record_id);
+            }
+        }
+
+        void find_key(simpledb::storage::HashIndex& index,
+                      std::string_view key,
+                      std::vector<simpledb::storage::RecordId>& record_ids) {
+            index.Find(key, record_ids);
+        }
+
+        // Finds the first record of a batch whose value in a column is already in the batch or in the table.
+        template <typename Index>
+        std::optional<size_t> find_duplicate(Index& index,
+                                             simpledb::storage::TableHeap& table_heap,
+                                             const serializer::RecordLayout& layout,
+                                             size_t column,
+                                             const std::vector<std::vector<char>>& records) {
+            std::unordered_set<std::string> batch_values;
+            std::string key;
+            std::vector<simpledb::storage::RecordId> record_ids;
+            std::vector<char> record_data;
+            for (size_t i = 0; i < records.size(); ++i) {
+                simpledb::storage::RecordView record{records[i].data(), static_cast<uint16_t>(records[i].size())};
+                if (!encode_key(layout, record, column, key)) {
+                    continue;
+                }
+                std::string value = column_value(layout, record, column);
+                if (!batch_values.insert(value).second) {
+                    return i;
+                }
+                record_ids.clear();
+                find_key(index, key, record_ids);
+                for (const simpledb::storage::RecordId& record_id : record_ids) {
+                    if (!table_heap.GetRecord(record_id, record_data)) {
+                        continue;
+                    }
+                    simpledb::storage::RecordView existing{record_data.data(),
+                                                           static_cast<uint16_t>(record_data.size())};
+                    if (column_value(layout, existing, column) == value) {
+                        return i;
+                    }
+                }
+            }
+            return std::nullopt;
+        }
+    }  // namespace
+
+    uint16_t key_size(command::Datatype type) { return type == command::Datatype::INT ? 4 : TEXT_KEY_SIZE; }
+
+    std::string encode_int_key(int32_t value) {
+        // Flipping the sign bit maps INT32_MIN..INT32_MAX onto 0..UINT32_MAX, and big-endian bytes compare like
+        // the unsigned number they hold.
+        uint32_t biased = static_cast<uint32_t>(value) ^ 0x80000000u;
+        std::string key(4, '\0');
+        for (int i = 3; i >= 0; --i) {
+            key[i] = static_cast<char>(biased & 0xFF);
+            biased >>= 8;
+        }
+        return key;
+    }
+
+    std::string encode_text_key(std::string_view value) {
+        std::string key(TEXT_KEY_SIZE, '\0');
+        std::copy_n(value.data(), std::min<size_t>(value.size(), TEXT_KEY_SIZE), key.begin());
+        return key;
+    }
+
+    bool encode_key(const serializer::RecordLayout& layout,
+                    simpledb::storage::RecordView record,
+                    size_t column,
+                    std::string& key) {
+        if (serializer::is_null(layout, record, column)) {
+            return false;
+        }
+        if (layout.column_type(column) == command::Datatype::INT) {
+            key = encode_int_key(serializer::read_int(layout, record, column));
+        } else {
+            key = encode_text_key(serializer::read_text(layout, record, column));
+        }
+        return true;
+    }
+
+    std::filesystem::path index_file_path(const std::filesystem::path& table_data_dir,
+                                          const std::string& table_name,
+                                          const std::string& index_name) {
+        return table_data_dir / (table_name + "." + index_name + ".index");
+    }
+
+    size_t column_index(const catalog::TableSchema& table_schema, const catalog::IndexDefinition& index) {
+        const std::vector<command::ColumnDefinition>& column_definitions = table_schema.column_definitions;
+        for (size_t i = 0; i < column_definitions.size(); ++i) {
+            if (column_definitions[i].column_name == index.column_name) {
+                return i;
+            }
+        }
+        throw std::runtime_error("Column '" + index.column_name + "' of index '" + index.index_name +
+                                 "' does not exist in table '" + table_schema.table_name + "'.");
+    }
+
+    size_t build_index(const std::filesystem::path& table_data_dir,
+                       const catalog::TableSchema& table_schema,
+                       const catalog::IndexDefinition& index) {
+        const size_t column = column_index(table_schema, index);
+        const serializer::RecordLayout layout(table_schema.column_definitions);
+
+        // Collect the keys of all records in one scan, then build the tree bottom-up: much faster than inserting
+        // the records one by one, and it packs the leaves full.
+        std::vector<simpledb::storage::IndexEntry> entries;
+        simpledb::storage::TableHeap table_heap((table_data_dir / (table_schema.table_name + ".data")).string());
+        simpledb::storage::TableHeap::Iterator iterator = table_heap.begin();
+        std::string key;
+        while (true) {
+            const std::vector<simpledb::storage::RecordView>& records = iterator.NextPage();
+            if (records.empty()) {
+                break;
+            }
+            // A fresh iterator hands out every page from its first slot.
+            simpledb::storage::RecordId record_id{iterator.GetPageId(), 0};
+            for (const simpledb::storage::RecordView& record : records) {
+                if (encode_key(layout, record, column, key)) {
+                    entries.push_back({key, record_id});
+                }
+                record_id.slot += 1;
+            }
+        }
+
+        const size_t num_entries = entries.size();
+        const std::string path = index_file_path(table_data_dir, table_schema.table_name, index.index_name).string();
+        const uint16_t index_key_size = key_size(table_schema.column_definitions[column].type);
+        if (index.index_type == command::IndexType::HASH) {
+            simpledb::storage::HashIndex(path, index_key_size).BulkLoad(std::move(entries));
+        } else {
+            simpledb::storage::BPlusTree(path, index_key_size).BulkLoad(std::move(entries));
+        }
+        logging::log.info("Built index '{}' on {}({}) with {} entries.",
+                          index.index_name,
+                          table_schema.table_name,
+                          index.column_name,
+                          num_entries);
+        return num_entries;
+    }
+
+    void insert_records(const std::filesystem::path& table_data_dir,
+                        const catalog::TableSchema& table_schema,
+                        const std::vector<std::vector<char>>& records,
+                        const std::vector<simpledb::storage::RecordId>& record_ids) {
+        if (table_schema.indexes.empty()) {
+            return;
+        }
+        const serializer::RecordLayout layout(table_schema.column_definitions);
+        for (const catalog::IndexDefinition& index : table_schema.indexes) {
+            const size_t column = column_index(table_schema, index);
+            const std::string path =
+                index_file_path(table_data_dir, table_schema.table_name, index.index_name).string();
+            const uint16_t index_key_size = key_size(table_schema.column_definitions[column].type);
+            if (index.index_type == command::IndexType::HASH) {
+                simpledb::storage::HashIndex hash_index(path, index_key_size);
+                insert_keys(hash_index, layout, column, records, record_ids);
+            } else {
+                simpledb::storage::BPlusTree tree(path, index_key_size);
+                insert_keys(tree, layout, column, records, record_ids);
+            }
+        }
+    }
+
+    std::vector<catalog::IndexDefinition> constraint_indexes(const std::string& table_name,
+                                                             const std::vector<command::ColumnDefinition>& columns) {
+        std::vector<catalog::IndexDefinition> indexes;
+        for (const command::ColumnDefinition& column : columns) {
+            if (column.constraint == command::ColumnConstraint::PRIMARY_KEY) {
+                indexes.push_back({table_name + "_pkey", column.column_name, command::IndexType::BTREE, true});
+            } else if (column.constraint == command::ColumnConstraint::UNIQUE) {
+                std::string index_name = table_name + "_" + column.column_name + "_key";
+                indexes.push_back({index_name, column.column_name, command::IndexType::BTREE, true});
+            }
+        }
+        return indexes;
+    }
+
+    bool is_unique_column(const catalog::TableSchema& table_schema, const std::string& column_name) {
+        return std::any_of(
+            table_schema.indexes.begin(), table_schema.indexes.end(), [&](const catalog::IndexDefinition& index) {
+                return index.unique && index.column_name == column_name;
+            });
+    }
+
+    std::optional<UniqueViolation> find_unique_violation(const std::filesystem::path& table_data_dir,
+                                                         const catalog::TableSchema& table_schema,
+                                                         const std::vector<std::vector<char>>& records) {
+        const serializer::RecordLayout layout(table_schema.column_definitions);
+        std::optional<simpledb::storage::TableHeap> table_heap;
+        for (const catalog::IndexDefinition& index : table_schema.indexes) {
+            if (!index.unique) {
+                continue;
+            }
+            if (!table_heap.has_value()) {
+                table_heap.emplace((table_data_dir / (table_schema.table_name + ".data")).string());
+            }
+            const size_t column = column_index(table_schema, index);
+            const std::string path =
+                index_file_path(table_data_dir, table_schema.table_name, index.index_name).string();
+            const uint16_t index_key_size = key_size(table_schema.column_definitions[column].type);
+            std::optional<size_t> duplicate;
+            if (index.index_type == command::IndexType::HASH) {
+                simpledb::storage::HashIndex hash_index(path, index_key_size);
+                duplicate = find_duplicate(hash_index, *table_heap, layout, column, records);
+            } else {
+                simpledb::storage::BPlusTree tree(path, index_key_size);
+                duplicate = find_duplicate(tree, *table_heap, layout, column, records);
+            }
+            if (duplicate.has_value()) {
+                simpledb::storage::RecordView record{records[*duplicate].data(),
+                                                     static_cast<uint16_t>(records[*duplicate].size())};
+                return UniqueViolation{*duplicate, index.column_name, column_value(layout, record, column)};
+            }
+        }
+        return std::nullopt;
+    }
+
+    void remove_index_files(const std::filesystem::path& table_data_dir, const catalog::TableSchema& table_schema) {
+        for (const catalog::IndexDefinition& index : table_schema.indexes) {
+            std::filesystem::path path = index_file_path(table_data_dir, table_schema.table_name, index.index_name);
+            simpledb::storage::BufferPoolManager::Instance().DiscardFile(path.string());
+            std::filesystem::remove(path);
+        }
+    }
+}  // namespace table_index
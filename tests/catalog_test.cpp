@@ -8,7 +8,10 @@
 #include <fstream>
 #include "simpledb/command.h"
 #include "simpledb/utils/logging.h"
+#include <atomic>
 #include <filesystem>
+#include <string>
+#include <thread>
 #include <vector>
 #include <nlohmann/json.hpp>
 
@@ -82,6 +85,36 @@ TEST(JsonSerde, TableSchema) {
     }
 }
 
+TEST(JsonSerde, TableSchemaWithConstraintsAndIndexes) {
+    catalog::TableSchema original_ts;
+    original_ts.table_name = "users";
+    original_ts.column_definitions.push_back({"id", command::Datatype::INT, command::ColumnConstraint::PRIMARY_KEY});
+    original_ts.column_definitions.push_back({"email", command::Datatype::TEXT, command::ColumnConstraint::UNIQUE});
+    original_ts.column_definitions.push_back({"name", command::Datatype::TEXT});
+    original_ts.indexes.push_back({"users_pkey", "id", command::IndexType::BTREE, true});
+    original_ts.indexes.push_back({"users_by_name", "name", command::IndexType::HASH});
+
+    json j = original_ts;
+    ASSERT_EQ(j["column_definitions"][0]["constraint"], "PRIMARY KEY");
+    ASSERT_EQ(j["column_definitions"][1]["constraint"], "UNIQUE");
+    ASSERT_FALSE(j["column_definitions"][2].contains("constraint"));
+
+    catalog::TableSchema deserialized_ts = j.get<catalog::TableSchema>();
+    ASSERT_EQ(deserialized_ts.column_definitions[0].constraint, command::ColumnConstraint::PRIMARY_KEY);
+    ASSERT_EQ(deserialized_ts.column_definitions[1].constraint, command::ColumnConstraint::UNIQUE);
+    ASSERT_EQ(deserialized_ts.column_definitions[2].constraint, command::ColumnConstraint::NONE);
+    ASSERT_EQ(deserialized_ts.indexes.size(), 2);
+    ASSERT_TRUE(deserialized_ts.indexes[0].unique);
+    ASSERT_EQ(deserialized_ts.indexes[1].index_type, command::IndexType::HASH);
+    ASSERT_FALSE(deserialized_ts.indexes[1].unique);
+
+    // Indexes written before index types and constraints existed load as plain B+ trees.
+    json old_index = {{"index_name", "users_by_name"}, {"column_name", "name"}};
+    catalog::IndexDefinition index = old_index.get<catalog::IndexDefinition>();
+    ASSERT_EQ(index.index_type, command::IndexType::BTREE);
+    ASSERT_FALSE(index.unique);
+}
+
 TEST(JsonSerde, CatalogData) {
     std::vector<catalog::TableSchema> original_data;
     original_data.push_back({"table1", {{"column1", command::Datatype::INT}, {"column2", command::Datatype::TEXT}}});
@@ -153,6 +186,69 @@ TEST_F(CatalogTest, AddMultipleTablesAndVerifyPersistence) {
     std::filesystem::remove(catalog_path);
 }
 
+TEST_F(CatalogTest, GetTableSchemaReturnsSharedSnapshots) {
+    catalog::initialize(test_data_dir);
+    ASSERT_TRUE(catalog::add_table({"people", {{"id", command::Datatype::INT}, {"name", command::Datatype::TEXT}}}));
+    ASSERT_EQ(catalog::get_table_schema("missing"), nullptr);
+
+    // Lookups share the same schema instead of copying it.
+    catalog::TableSchemaPtr before = catalog::get_table_schema("people");
+    ASSERT_NE(before, nullptr);
+    ASSERT_EQ(catalog::get_table_schema("people"), before);
+
+    // A change replaces the schema: whoever holds the old one keeps seeing it unchanged.
+    ASSERT_TRUE(catalog::add_index("people", {"people_id", "id"}));
+    catalog::TableSchemaPtr after = catalog::get_table_schema("people");
+    ASSERT_NE(after, before);
+    ASSERT_TRUE(before->indexes.empty());
+    ASSERT_EQ(after->indexes.size(), 1);
+    ASSERT_EQ(catalog::get_all_schemas(), std::vector<catalog::TableSchemaPtr>{after});
+
+    ASSERT_TRUE(catalog::remove_table("people"));
+    ASSERT_EQ(catalog::get_table_schema("people"), nullptr);
+    ASSERT_EQ(before->table_name, "people");
+}
+
+TEST_F(CatalogTest, LookupsRunConcurrentlyWithChanges) {
+    catalog::initialize(test_data_dir);
+    ASSERT_TRUE(catalog::add_table({"fixed", {{"id", command::Datatype::INT}}}));
+
+    std::atomic<bool> done{false};
+    std::atomic<int> num_failed_lookups{0};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&] {
+            while (!done) {
+                catalog::TableSchemaPtr schema = catalog::get_table_schema("fixed");
+                if (schema == nullptr || schema->column_definitions.size() != 1) {
+                    num_failed_lookups += 1;
+                }
+                // Tables are only added, so every listed table can be looked up.
+                for (const catalog::TableSchemaPtr& table : catalog::get_all_schemas()) {
+                    if (!catalog::table_exists(table->table_name)) {
+                        num_failed_lookups += 1;
+                    }
+                }
+            }
+        });
+    }
+    for (int i = 0; i < 20; ++i) {
+        const std::string table_name = "table_" + std::to_string(i);
+        ASSERT_TRUE(catalog::add_table({table_name, {{"id", command::Datatype::INT}}}));
+        ASSERT_TRUE(catalog::add_index(table_name, {table_name + "_id", "id"}));
+    }
+    done = true;
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+
+    ASSERT_EQ(num_failed_lookups, 0);
+    ASSERT_EQ(catalog::get_all_schemas().size(), 21);
+    auto loaded_catalog = loadCatalogFromDisk();
+    ASSERT_TRUE(loaded_catalog.has_value());
+    ASSERT_EQ(loaded_catalog->size(), 21);
+}
+
 TEST_F(CatalogTest, InitializeWithNonExistentFileResultsInEmptyCatalog) {
     catalog::initialize(test_data_dir);
     const auto& schemas_in_memory = catalog::get_all_schemas();
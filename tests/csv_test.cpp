@@ -0,0 +1,49 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/csv.h"
+
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+TEST(CsvReaderTest, ReadsPlainAndQuotedFields) {
+    csv::Reader reader("1,Alice\r\n\n2,\"Smith, \"\"Bob\"\"\",\n");
+    std::vector<std::string> fields;
+
+    ASSERT_TRUE(reader.next_record(fields));
+    ASSERT_EQ(fields, std::vector<std::string>({"1", "Alice"}));
+    ASSERT_EQ(reader.line_number(), 1);
+
+    // The empty line is skipped, and a trailing comma means a trailing empty field.
+    ASSERT_TRUE(reader.next_record(fields));
+    ASSERT_EQ(fields, std::vector<std::string>({"2", "Smith, \"Bob\"", ""}));
+    ASSERT_EQ(reader.line_number(), 3);
+
+    ASSERT_FALSE(reader.next_record(fields));
+}
+
+TEST(CsvReaderTest, ThrowsOnUnterminatedQuotedField) {
+    csv::Reader reader("1,Alice\n2,\"Bob\n3,Carol\n");
+    std::vector<std::string> fields;
+
+    ASSERT_TRUE(reader.next_record(fields));
+    ASSERT_THROW(reader.next_record(fields), std::runtime_error);
+    ASSERT_EQ(reader.line_number(), 2);
+}
+
+TEST(CsvSplitTest, ChunksEndOnRecordBoundaries) {
+    std::string data = "1,aaaa\n2,bbbb\n3,cccc\n4,dddd";
+    std::vector<std::string_view> chunks = csv::split_into_chunks(data, 10);
+
+    ASSERT_EQ(chunks.size(), 2);
+    ASSERT_EQ(chunks[0], "1,aaaa\n2,bbbb\n");
+    ASSERT_EQ(chunks[1], "3,cccc\n4,dddd");
+
+    // A chunk size larger than the data gives a single chunk, and no data gives no chunks.
+    ASSERT_EQ(csv::split_into_chunks(data, 1000).size(), 1);
+    ASSERT_TRUE(csv::split_into_chunks("", 10).empty());
+}
@@ -0,0 +1,96 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/execution/filter_kernels.h"
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace kernels = simpledb::execution::kernels;
+
+namespace {
+    template <typename T>
+    bool reference_compare(ast::ComparisonOp op, T lhs, T rhs) {
+        switch (op) {
+            case ast::ComparisonOp::EQUALS:
+                return lhs == rhs;
+            case ast::ComparisonOp::NOT_EQUALS:
+                return lhs != rhs;
+            case ast::ComparisonOp::LESS_THAN:
+                return lhs < rhs;
+            case ast::ComparisonOp::LESS_THAN_OR_EQUAL:
+                return lhs <= rhs;
+            case ast::ComparisonOp::GREATER_THAN:
+                return lhs > rhs;
+            case ast::ComparisonOp::GREATER_THAN_OR_EQUAL:
+                return lhs >= rhs;
+        }
+        return false;
+    }
+
+    // Small values so that every operator sees equal, smaller and larger values, plus the extremes of the type. The
+    // count isn't a multiple of any register width, so the scalar tail of the SIMD kernels is exercised too.
+    template <typename T>
+    std::vector<T> make_values(size_t count) {
+        std::mt19937 generator(42);
+        std::uniform_int_distribution<int> distribution(-5, 5);
+        std::vector<T> values(count);
+        for (T& value : values) {
+            value = static_cast<T>(distribution(generator));
+        }
+        values[0] = std::numeric_limits<T>::min();
+        values[count - 1] = std::numeric_limits<T>::max();
+        return values;
+    }
+
+    // Checks the select and bitmap kernels of every operator against the plain definition of the comparison.
+    template <typename T>
+    void check_kernels(const kernels::SelectKernel<T>* select_kernels, const kernels::BitmapKernel<T>* bitmap_kernels) {
+        const std::vector<T> values = make_values<T>(1021);
+        for (T constant : {T{-1}, T{0}, T{3}, std::numeric_limits<T>::min(), std::numeric_limits<T>::max()}) {
+            for (size_t op = 0; op < kernels::NUM_COMPARISON_OPS; ++op) {
+                auto comparison_op = static_cast<ast::ComparisonOp>(op);
+                std::vector<uint16_t> expected;
+                for (size_t i = 0; i < values.size(); ++i) {
+                    if (reference_compare(comparison_op, values[i], constant)) {
+                        expected.push_back(static_cast<uint16_t>(i));
+                    }
+                }
+
+                std::vector<uint16_t> selection(values.size());
+                selection.resize(select_kernels[op](values.data(), values.size(), constant, selection.data()));
+                ASSERT_EQ(selection, expected) << "op " << op << ", constant " << constant;
+
+                std::vector<uint64_t> bitmap((values.size() + 63) / 64, ~uint64_t{0});
+                bitmap_kernels[op](values.data(), values.size(), constant, bitmap.data());
+                std::vector<uint16_t> from_bitmap;
+                for (size_t i = 0; i < values.size(); ++i) {
+                    if ((bitmap[i / 64] >> (i % 64)) & 1) {
+                        from_bitmap.push_back(static_cast<uint16_t>(i));
+                    }
+                }
+                ASSERT_EQ(from_bitmap, expected) << "op " << op << ", constant " << constant;
+            }
+        }
+    }
+}  // namespace
+
+TEST(FilterKernelsTest, AllInstructionSetsMatchScalarComparison) {
+    for (kernels::InstructionSet instruction_set :
+         {kernels::InstructionSet::SCALAR, kernels::InstructionSet::SSE4_2, kernels::InstructionSet::AVX2}) {
+        // Instruction sets that the CPU doesn't support fall back to a lower one.
+        const kernels::FilterKernels& filter_kernels = kernels::get_filter_kernels(instruction_set);
+        ASSERT_LE(static_cast<int>(filter_kernels.instruction_set), static_cast<int>(instruction_set));
+
+        check_kernels<int32_t>(filter_kernels.select_int32, filter_kernels.bitmap_int32);
+        check_kernels<int64_t>(filter_kernels.select_int64, filter_kernels.bitmap_int64);
+    }
+}
+
+TEST(FilterKernelsTest, DefaultKernelsUseDetectedInstructionSet) {
+    ASSERT_EQ(kernels::get_filter_kernels().instruction_set, kernels::detect_instruction_set());
+}
@@ -5,7 +5,9 @@
 #include "simpledb/execution/filter_operator.h"
 #include "simpledb/execution/operator.h"
 #include "simpledb/execution/row.h"
+#include "simpledb/execution/table_scan_operator.h"
 #include "simpledb/catalog.h"
+#include "simpledb/executor.h"
 #include "simpledb/ast/ast.h"
 
 #include <gtest/gtest.h>
@@ -22,8 +24,9 @@
  */
 class MockScanOperator : public simpledb::execution::Operator {
    public:
-    // Constructor takes the data it should produce.
-    explicit MockScanOperator(std::vector<row::Row> data) : data_(std::move(data)), current_index_(0) {}
+    // Constructor takes the data it should produce, and optionally the signature of its rows.
+    explicit MockScanOperator(std::vector<row::Row> data, std::optional<row::Signature> signature = std::nullopt)
+        : data_(std::move(data)), current_index_(0), signature_(std::move(signature)) {}
 
     // The next() method returns the next row from the internal vector.
     std::optional<row::Row> next() override {
@@ -36,9 +39,12 @@ class MockScanOperator : public simpledb::execution::Operator {
         return std::nullopt;
     }
 
+    std::optional<row::Signature> signature() const override { return signature_; }
+
    private:
     std::vector<row::Row> data_;
     size_t current_index_;
+    std::optional<row::Signature> signature_;
 };
 
 class FilterOperatorTest : public ::testing::Test {
@@ -324,4 +330,133 @@ TEST_F(FilterOperatorTest, FilterThrowsOnNonExistentTable) {
     // Should throw when constructing FilterOperator
     ASSERT_THROW(simpledb::execution::FilterOperator("non_existent_table", std::move(mock_scan), where_clause),
                  std::runtime_error);
-}
\ No newline at end of file
+}
+TEST_F(FilterOperatorTest, FilterComparesIntsNumerically) {
+    // Add the schema to the catalog
+    std::string table_name = "products";
+    catalog::TableSchema schema;
+    schema.table_name = table_name;
+    schema.column_definitions = {{"id", command::Datatype::INT}, {"price", command::Datatype::INT}};
+    catalog::add_table(schema);
+
+    // As text, "100" < "9" and "-5" > "-10" would both be wrong.
+    std::vector<row::Row> source_data = {{"1", "9"}, {"2", "100"}, {"3", "-5"}, {"4", "-10"}};
+    auto mock_scan = std::make_unique<MockScanOperator>(source_data);
+
+    ast::WhereClause where_clause;
+    where_clause.column_name = "price";
+    where_clause.op = ast::ComparisonOp::GREATER_THAN;
+    where_clause.value = "-7";
+
+    simpledb::execution::FilterOperator filter_op(table_name, std::move(mock_scan), where_clause);
+
+    std::vector<std::string> actual_ids;
+    while (auto row = filter_op.next()) {
+        actual_ids.push_back((*row)[0]);
+    }
+    ASSERT_EQ(actual_ids, std::vector<std::string>({"1", "2", "3"}));
+}
+
+TEST_F(FilterOperatorTest, FilterThrowsOnInvalidIntConstant) {
+    std::string table_name = "users";
+    catalog::TableSchema schema;
+    schema.table_name = table_name;
+    schema.column_definitions = {{"id", command::Datatype::INT}, {"name", command::Datatype::TEXT}};
+    catalog::add_table(schema);
+
+    auto mock_scan = std::make_unique<MockScanOperator>(std::vector<row::Row>{{"1", "Alice"}});
+
+    ast::WhereClause where_clause;
+    where_clause.column_name = "id";
+    where_clause.op = ast::ComparisonOp::EQUALS;
+    where_clause.value = "Alice";
+
+    ASSERT_THROW(simpledb::execution::FilterOperator(table_name, std::move(mock_scan), where_clause),
+                 std::runtime_error);
+}
+
+TEST_F(FilterOperatorTest, FilterFindsColumnThroughRowSignature) {
+    std::string table_name = "users";
+    catalog::TableSchema schema;
+    schema.table_name = table_name;
+    schema.column_definitions = {
+        {"id", command::Datatype::INT}, {"name", command::Datatype::TEXT}, {"email", command::Datatype::TEXT}};
+    catalog::add_table(schema);
+
+    // The child only returns the email and id columns, in that order.
+    std::vector<row::Row> source_data = {{"alice@example.com", "1"}, {"bob@example.com", "2"}};
+    auto mock_scan = std::make_unique<MockScanOperator>(source_data, row::Signature{2, 0});
+
+    simpledb::execution::FilterOperator filter_op(
+        table_name, std::move(mock_scan), ast::WhereClause{"id", ast::ComparisonOp::EQUALS, "2"});
+    ASSERT_EQ(filter_op.signature(), std::optional<row::Signature>(row::Signature{2, 0}));
+
+    auto row = filter_op.next();
+    ASSERT_TRUE(row.has_value());
+    ASSERT_EQ(*row, row::Row({"bob@example.com", "2"}));
+    ASSERT_FALSE(filter_op.next().has_value());
+
+    // A WHERE column that the child doesn't return can't be evaluated.
+    auto narrow_scan = std::make_unique<MockScanOperator>(source_data, row::Signature{2, 0});
+    ASSERT_THROW(simpledb::execution::FilterOperator(
+                     table_name, std::move(narrow_scan), ast::WhereClause{"name", ast::ComparisonOp::EQUALS, "Bob"}),
+                 std::runtime_error);
+}
+
+TEST_F(FilterOperatorTest, FilterNarrowsBatchSelection) {
+    std::string table_name = "users";
+    catalog::TableSchema schema;
+    schema.table_name = table_name;
+    schema.column_definitions = {{"id", command::Datatype::INT}, {"name", command::Datatype::TEXT}};
+    catalog::add_table(schema);
+
+    // The mock only implements next(), so its batches hold the text form of the values.
+    std::vector<row::Row> source_data = {{"1", "Alice"}, {"2", "Bob"}, {"3", "Charlie"}, {"4", "Dave"}};
+    auto mock_scan = std::make_unique<MockScanOperator>(source_data);
+
+    auto id_filter = std::make_unique<simpledb::execution::FilterOperator>(
+        table_name, std::move(mock_scan), ast::WhereClause{"id", ast::ComparisonOp::GREATER_THAN, "1"});
+    // A second filter only looks at the rows the first one selected.
+    simpledb::execution::FilterOperator name_filter(
+        table_name, std::move(id_filter), ast::WhereClause{"name", ast::ComparisonOp::NOT_EQUALS, "Charlie"});
+
+    simpledb::execution::Batch batch;
+    ASSERT_TRUE(name_filter.next_batch(batch));
+    ASSERT_EQ(batch.size(), 4);
+    ASSERT_TRUE(batch.has_selection());
+    ASSERT_EQ(batch.num_selected(), 2);
+    ASSERT_EQ(batch.selected(0), 1);
+    ASSERT_EQ(batch.selected(1), 3);
+    ASSERT_FALSE(name_filter.next_batch(batch));
+}
+
+TEST_F(FilterOperatorTest, FilterEvaluatesTypedIntBatches) {
+    command::CreateTableCommand create_cmd;
+    create_cmd.table_name = "numbers";
+    create_cmd.column_definitions = {{"id", command::Datatype::INT}, {"parity", command::Datatype::INT}};
+    executor::execute_create_table_command(create_cmd, test_data_dir);
+
+    command::InsertCommand load_cmd;
+    load_cmd.table_name = "numbers";
+    for (int i = 0; i < 3000; ++i) {
+        load_cmd.rows.push_back({std::to_string(i), std::to_string(i % 2)});
+    }
+    executor::execute_insert_command(load_cmd, test_data_dir);
+
+    // The first filter sees full batches of ints (selection vector kernel), the second one batches that already
+    // have a selection (bitmap kernel).
+    auto scan = std::make_unique<simpledb::execution::TableScanOperator>("numbers", test_data_dir);
+    auto id_filter = std::make_unique<simpledb::execution::FilterOperator>(
+        "numbers", std::move(scan), ast::WhereClause{"id", ast::ComparisonOp::GREATER_THAN_OR_EQUAL, "1000"});
+    simpledb::execution::FilterOperator parity_filter(
+        "numbers", std::move(id_filter), ast::WhereClause{"parity", ast::ComparisonOp::EQUALS, "1"});
+
+    int count = 0;
+    int expected_id = 1001;
+    while (auto row = parity_filter.next()) {
+        ASSERT_EQ((*row)[0], std::to_string(expected_id));
+        expected_id += 2;
+        count++;
+    }
+    ASSERT_EQ(count, 1000);
+}
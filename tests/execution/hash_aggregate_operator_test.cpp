@@ -0,0 +1,213 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/execution/hash_aggregate_operator.h"
+#include "simpledb/execution/table_scan_operator.h"
+#include "simpledb/ast/ast.h"
+#include "simpledb/catalog.h"
+#include "simpledb/command.h"
+#include "simpledb/executor.h"
+#include "simpledb/planner.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using simpledb::execution::HashAggregateOperator;
+
+namespace {
+    ast::SelectItem column(const std::string& column_name) { return {column_name, std::nullopt}; }
+
+    ast::SelectItem aggregate(ast::AggregateFunction function, const std::string& column_name = "") {
+        return {column_name, function};
+    }
+
+    std::vector<row::Row> collect(simpledb::execution::Operator& op) {
+        std::vector<row::Row> rows;
+        while (auto row = op.next()) {
+            rows.push_back(*row);
+        }
+        std::sort(rows.begin(), rows.end());
+        return rows;
+    }
+}  // namespace
+
+class HashAggregateOperatorTest : public ::testing::Test {
+   protected:
+    static constexpr int NUM_ROWS = 12000;
+    std::filesystem::path test_data_dir;
+
+    void SetUp() override {
+        // Create a unique temporary file path for each test.
+        const ::testing::TestInfo* const test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+        test_data_dir = std::filesystem::temp_directory_path().string() + "/simpledb_" + test_info->test_suite_name() +
+                        "_" + test_info->name();
+        if (std::filesystem::exists(test_data_dir)) {
+            std::filesystem::remove_all(test_data_dir);
+        }
+        std::filesystem::create_directories(test_data_dir);
+
+        catalog::initialize(test_data_dir);
+
+        command::CreateTableCommand create_cmd;
+        create_cmd.table_name = "sales";
+        create_cmd.column_definitions.push_back({"region", command::Datatype::TEXT});
+        create_cmd.column_definitions.push_back({"amount", command::Datatype::INT});
+        create_cmd.column_definitions.push_back({"product", command::Datatype::TEXT});
+        executor::execute_create_table_command(create_cmd, test_data_dir);
+        create_cmd.table_name = "empty_sales";
+        executor::execute_create_table_command(create_cmd, test_data_dir);
+
+        command::InsertCommand load_cmd;
+        load_cmd.table_name = "sales";
+        for (int i = 0; i < NUM_ROWS; ++i) {
+            load_cmd.rows.push_back({"region_" + std::to_string(i % 37),
+                                     std::to_string((i * 7919) % 1000 - 300),
+                                     "product_" + std::to_string(i % 5000)});
+        }
+        executor::execute_insert_command(load_cmd, test_data_dir);
+    }
+
+    void TearDown() override {
+        if (std::filesystem::exists(test_data_dir)) {
+            std::filesystem::remove_all(test_data_dir);
+        }
+    }
+
+    std::vector<row::Row> select(const std::string& table_name,
+                                 std::vector<ast::SelectItem> select_items,
+                                 std::vector<std::string> group_by = {},
+                                 std::optional<ast::WhereClause> where_clause = std::nullopt) {
+        ast::SelectCommand select_cmd;
+        select_cmd.table_name = table_name;
+        select_cmd.select_items = std::move(select_items);
+        select_cmd.group_by = std::move(group_by);
+        select_cmd.where_clause = std::move(where_clause);
+        auto plan = planner::plan_select(select_cmd, test_data_dir);
+        return collect(*plan);
+    }
+
+    // Aggregates the whole sales table by product, with the given memory budget.
+    std::vector<row::Row> aggregate_by_product(size_t memory_budget, size_t& num_spilled_partitions) {
+        std::vector<ast::SelectItem> select_items = {column("product"),
+                                                     aggregate(ast::AggregateFunction::COUNT),
+                                                     aggregate(ast::AggregateFunction::SUM, "amount"),
+                                                     aggregate(ast::AggregateFunction::MAX, "region")};
+        HashAggregateOperator op("sales",
+                                 std::make_unique<simpledb::execution::TableScanOperator>("sales", test_data_dir),
+                                 select_items,
+                                 {"product"},
+                                 memory_budget,
+                                 test_data_dir / "tmp");
+        std::vector<row::Row> rows = collect(op);
+        num_spilled_partitions = op.num_spilled_partitions();
+        return rows;
+    }
+};
+
+TEST_F(HashAggregateOperatorTest, CountsAllRowsWithoutGroupBy) {
+    ASSERT_EQ(select("sales", {aggregate(ast::AggregateFunction::COUNT)}), std::vector<row::Row>({{"12000"}}));
+
+    // Counting the rows that satisfy a WHERE clause.
+    int expected = 0;
+    for (int i = 0; i < NUM_ROWS; ++i) {
+        expected += (i * 7919) % 1000 - 300 > 500 ? 1 : 0;
+    }
+    ast::WhereClause where_clause{"amount", ast::ComparisonOp::GREATER_THAN, "500"};
+    ASSERT_EQ(select("sales", {aggregate(ast::AggregateFunction::COUNT)}, {}, where_clause),
+              std::vector<row::Row>({{std::to_string(expected)}}));
+}
+
+TEST_F(HashAggregateOperatorTest, ComputesEveryFunctionPerGroup) {
+    struct Expected {
+        int64_t count = 0;
+        int64_t sum = 0;
+        int min = 1000000;
+        int max = -1000000;
+        std::string min_product;
+        std::string max_product;
+    };
+    std::map<std::string, Expected> groups;
+    for (int i = 0; i < NUM_ROWS; ++i) {
+        Expected& group = groups["region_" + std::to_string(i % 37)];
+        const int amount = (i * 7919) % 1000 - 300;
+        const std::string product = "product_" + std::to_string(i % 5000);
+        group.count += 1;
+        group.sum += amount;
+        group.min = std::min(group.min, amount);
+        group.max = std::max(group.max, amount);
+        group.min_product = group.min_product.empty() ? product : std::min(group.min_product, product);
+        group.max_product = std::max(group.max_product, product);
+    }
+    std::vector<row::Row> expected;
+    for (const auto& [region, group] : groups) {
+        char average[32];
+        snprintf(average, sizeof(average), "%.15g", static_cast<double>(group.sum) / group.count);
+        expected.push_back({std::to_string(group.count),
+                            region,
+                            std::to_string(group.sum),
+                            std::to_string(group.min),
+                            std::to_string(group.max),
+                            average,
+                            group.min_product,
+                            group.max_product,
+                            std::to_string(group.count)});
+    }
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<row::Row> rows = select("sales",
+                                        {aggregate(ast::AggregateFunction::COUNT),
+                                         column("region"),
+                                         aggregate(ast::AggregateFunction::SUM, "amount"),
+                                         aggregate(ast::AggregateFunction::MIN, "amount"),
+                                         aggregate(ast::AggregateFunction::MAX, "amount"),
+                                         aggregate(ast::AggregateFunction::AVG, "amount"),
+                                         aggregate(ast::AggregateFunction::MIN, "product"),
+                                         aggregate(ast::AggregateFunction::MAX, "product"),
+                                         aggregate(ast::AggregateFunction::COUNT, "product")},
+                                        {"region"});
+    ASSERT_EQ(rows, expected);
+}
+
+TEST_F(HashAggregateOperatorTest, AggregatesAnEmptyTable) {
+    // One row without GROUP BY, with NULLs for the functions that had no values.
+    ASSERT_EQ(select("empty_sales",
+                     {aggregate(ast::AggregateFunction::COUNT),
+                      aggregate(ast::AggregateFunction::SUM, "amount"),
+                      aggregate(ast::AggregateFunction::MAX, "product")}),
+              std::vector<row::Row>({{"0", "", ""}}));
+    // No groups at all with GROUP BY.
+    ASSERT_TRUE(
+        select("empty_sales", {column("region"), aggregate(ast::AggregateFunction::COUNT)}, {"region"}).empty());
+}
+
+TEST_F(HashAggregateOperatorTest, SpillsToPartitionsOverTheMemoryBudget) {
+    size_t num_spilled_partitions = 0;
+    std::vector<row::Row> in_memory = aggregate_by_product(1 << 30, num_spilled_partitions);
+    ASSERT_EQ(in_memory.size(), 5000);
+    ASSERT_EQ(num_spilled_partitions, 0);
+
+    // Spilled once: each partition then fits in memory.
+    ASSERT_EQ(aggregate_by_product(128 * 1024, num_spilled_partitions), in_memory);
+    ASSERT_EQ(num_spilled_partitions, HashAggregateOperator::NUM_SPILL_PARTITIONS);
+
+    // The partitions don't fit either, and are split again.
+    ASSERT_EQ(aggregate_by_product(4 * 1024, num_spilled_partitions), in_memory);
+    ASSERT_GT(num_spilled_partitions, HashAggregateOperator::NUM_SPILL_PARTITIONS);
+
+    // The spill files are all removed.
+    ASSERT_TRUE(std::filesystem::is_empty(test_data_dir / "tmp"));
+}
+
+TEST_F(HashAggregateOperatorTest, RejectsInvalidSelectLists) {
+    // A column that is neither grouped nor aggregated.
+    ASSERT_THROW(select("sales", {column("product"), aggregate(ast::AggregateFunction::COUNT)}, {"region"}),
+                 std::runtime_error);
+    ASSERT_THROW(select("sales", {aggregate(ast::AggregateFunction::SUM, "product")}), std::runtime_error);
+    ASSERT_THROW(select("sales", {aggregate(ast::AggregateFunction::MIN, "price")}), std::runtime_error);
+}
@@ -0,0 +1,222 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/execution/hash_join_operator.h"
+#include "simpledb/execution/table_scan_operator.h"
+#include "simpledb/ast/ast.h"
+#include "simpledb/catalog.h"
+#include "simpledb/command.h"
+#include "simpledb/executor.h"
+#include "simpledb/planner.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using simpledb::execution::HashJoinOperator;
+
+namespace {
+    std::vector<row::Row> collect(simpledb::execution::Operator& op) {
+        std::vector<row::Row> rows;
+        while (auto row = op.next()) {
+            rows.push_back(*row);
+        }
+        std::sort(rows.begin(), rows.end());
+        return rows;
+    }
+}  // namespace
+
+class HashJoinOperatorTest : public ::testing::Test {
+   protected:
+    static constexpr int NUM_USERS = 500;
+    static constexpr int NUM_ORDERS = 6000;
+    std::filesystem::path test_data_dir;
+    std::vector<row::Row> users;   // id, name, city
+    std::vector<row::Row> orders;  // id, user_id, total
+
+    void SetUp() override {
+        // Create a unique temporary file path for each test.
+        const ::testing::TestInfo* const test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+        test_data_dir = std::filesystem::temp_directory_path().string() + "/simpledb_" + test_info->test_suite_name() +
+                        "_" + test_info->name();
+        if (std::filesystem::exists(test_data_dir)) {
+            std::filesystem::remove_all(test_data_dir);
+        }
+        std::filesystem::create_directories(test_data_dir);
+
+        catalog::initialize(test_data_dir);
+
+        command::CreateTableCommand create_cmd;
+        create_cmd.table_name = "users";
+        create_cmd.column_definitions.push_back({"id", command::Datatype::INT});
+        create_cmd.column_definitions.push_back({"name", command::Datatype::TEXT});
+        create_cmd.column_definitions.push_back({"city", command::Datatype::TEXT});
+        executor::execute_create_table_command(create_cmd, test_data_dir);
+
+        create_cmd = {};
+        create_cmd.table_name = "orders";
+        create_cmd.column_definitions.push_back({"id", command::Datatype::INT});
+        create_cmd.column_definitions.push_back({"user_id", command::Datatype::INT});
+        create_cmd.column_definitions.push_back({"total", command::Datatype::INT});
+        executor::execute_create_table_command(create_cmd, test_data_dir);
+
+        command::InsertCommand load_cmd;
+        load_cmd.table_name = "users";
+        for (int i = 0; i < NUM_USERS; ++i) {
+            users.push_back({std::to_string(i), "user_" + std::to_string(i), "city_" + std::to_string(i % 7)});
+        }
+        load_cmd.rows = users;
+        executor::execute_insert_command(load_cmd, test_data_dir);
+
+        // Some orders belong to users that don't exist.
+        load_cmd.table_name = "orders";
+        for (int i = 0; i < NUM_ORDERS; ++i) {
+            orders.push_back(
+                {std::to_string(i), std::to_string((i * 7919) % (NUM_USERS + 50)), std::to_string(i % 300)});
+        }
+        load_cmd.rows = orders;
+        executor::execute_insert_command(load_cmd, test_data_dir);
+    }
+
+    void TearDown() override {
+        if (std::filesystem::exists(test_data_dir)) {
+            std::filesystem::remove_all(test_data_dir);
+        }
+    }
+
+    // All rows of users JOIN orders ON users.id = orders.user_id, computed with a nested loop.
+    std::vector<row::Row> expected_join() const {
+        std::vector<row::Row> expected;
+        for (const row::Row& user : users) {
+            for (const row::Row& order : orders) {
+                if (user[0] == order[1]) {
+                    row::Row joined = user;
+                    joined.insert(joined.end(), order.begin(), order.end());
+                    expected.push_back(joined);
+                }
+            }
+        }
+        std::sort(expected.begin(), expected.end());
+        return expected;
+    }
+
+    // Joins the whole tables with the given build side and memory budget.
+    std::vector<row::Row> join(HashJoinOperator::BuildSide build_side,
+                               size_t memory_budget,
+                               size_t& num_spilled_partitions) {
+        HashJoinOperator op({std::make_unique<simpledb::execution::TableScanOperator>("users", test_data_dir), 0, 3},
+                            {std::make_unique<simpledb::execution::TableScanOperator>("orders", test_data_dir), 1, 3},
+                            command::Datatype::INT,
+                            build_side,
+                            memory_budget,
+                            test_data_dir / "tmp");
+        std::vector<row::Row> rows = collect(op);
+        num_spilled_partitions = op.num_spilled_partitions();
+        return rows;
+    }
+
+    ast::SelectCommand join_command() const {
+        ast::SelectCommand select_cmd;
+        select_cmd.table_name = "users";
+        select_cmd.join_clause = ast::JoinClause{"orders", "users.id", "orders.user_id"};
+        return select_cmd;
+    }
+};
+
+TEST_F(HashJoinOperatorTest, BuildsOnEitherSide) {
+    const std::vector<row::Row> expected = expected_join();
+    ASSERT_GT(expected.size(), 0);
+    ASSERT_LT(expected.size(), NUM_ORDERS);
+
+    // The columns are the left table's then the right table's, whichever side the hash table is built on.
+    size_t num_spilled_partitions = 0;
+    ASSERT_EQ(join(HashJoinOperator::BuildSide::LEFT, 1 << 30, num_spilled_partitions), expected);
+    ASSERT_EQ(join(HashJoinOperator::BuildSide::RIGHT, 1 << 30, num_spilled_partitions), expected);
+    ASSERT_EQ(num_spilled_partitions, 0);
+}
+
+TEST_F(HashJoinOperatorTest, PartitionsBothSidesOverTheMemoryBudget) {
+    const std::vector<row::Row> expected = expected_join();
+
+    // Spilled once: each build partition then fits in memory.
+    size_t num_spilled_partitions = 0;
+    ASSERT_EQ(join(HashJoinOperator::BuildSide::RIGHT, 256 * 1024, num_spilled_partitions), expected);
+    ASSERT_GT(num_spilled_partitions, 0);
+    ASSERT_LE(num_spilled_partitions, HashJoinOperator::NUM_SPILL_PARTITIONS);
+
+    // The build partitions don't fit either, and are split again along with their probe partitions.
+    ASSERT_EQ(join(HashJoinOperator::BuildSide::RIGHT, 4 * 1024, num_spilled_partitions), expected);
+    ASSERT_GT(num_spilled_partitions, HashJoinOperator::NUM_SPILL_PARTITIONS);
+    ASSERT_EQ(join(HashJoinOperator::BuildSide::LEFT, 1024, num_spilled_partitions), expected);
+
+    // The spill files are all removed.
+    ASSERT_TRUE(std::filesystem::is_empty(test_data_dir / "tmp"));
+}
+
+TEST_F(HashJoinOperatorTest, RunsJoinQueriesThroughThePlanner) {
+    // Qualified and unqualified column names, and a WHERE clause on one of the tables.
+    ast::SelectCommand select_cmd = join_command();
+    select_cmd.projection = {"name", "orders.total", "orders.id"};
+    select_cmd.where_clause = ast::WhereClause{"total", ast::ComparisonOp::GREATER_THAN, "250"};
+    std::vector<row::Row> expected;
+    for (const row::Row& row : expected_join()) {
+        if (std::stoi(row[5]) > 250) {
+            expected.push_back({row[1], row[5], row[3]});
+        }
+    }
+    std::sort(expected.begin(), expected.end());
+    ASSERT_EQ(collect(*planner::plan_select(select_cmd, test_data_dir)), expected);
+
+    // The ON condition can name the tables in either order.
+    select_cmd.join_clause = ast::JoinClause{"orders", "user_id", "users.id"};
+    ASSERT_EQ(collect(*planner::plan_select(select_cmd, test_data_dir)), expected);
+
+    // SELECT *
+    ASSERT_EQ(collect(*planner::plan_select(join_command(), test_data_dir)), expected_join());
+
+    // Aggregating and sorting the joined rows.
+    select_cmd = join_command();
+    select_cmd.select_items = {{"city", std::nullopt}, {"", ast::AggregateFunction::COUNT}};
+    select_cmd.group_by = {"users.city"};
+    select_cmd.order_by = {{{"", ast::AggregateFunction::COUNT}, true}, {{"users.city", std::nullopt}, false}};
+    std::vector<row::Row> rows;
+    auto plan = planner::plan_select(select_cmd, test_data_dir);
+    while (auto row = plan->next()) {
+        rows.push_back(*row);
+    }
+    ASSERT_EQ(rows.size(), 7);
+    int64_t total_count = 0;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        total_count += std::stoll(rows[i][1]);
+        if (i > 0) {
+            ASSERT_GE(std::stoll(rows[i - 1][1]), std::stoll(rows[i][1]));
+        }
+    }
+    ASSERT_EQ(total_count, expected_join().size());
+}
+
+TEST_F(HashJoinOperatorTest, RejectsInvalidJoins) {
+    // Both tables have an id column.
+    ast::SelectCommand select_cmd = join_command();
+    select_cmd.projection = {"id"};
+    ASSERT_THROW(planner::plan_select(select_cmd, test_data_dir), std::runtime_error);
+
+    // A column that neither table has.
+    select_cmd.projection = {"users.total"};
+    ASSERT_THROW(planner::plan_select(select_cmd, test_data_dir), std::runtime_error);
+
+    // The ON condition must compare a column of each table, of the same type.
+    select_cmd = join_command();
+    select_cmd.join_clause = ast::JoinClause{"orders", "orders.id", "orders.user_id"};
+    ASSERT_THROW(planner::plan_select(select_cmd, test_data_dir), std::runtime_error);
+    select_cmd.join_clause = ast::JoinClause{"orders", "users.name", "orders.user_id"};
+    ASSERT_THROW(planner::plan_select(select_cmd, test_data_dir), std::runtime_error);
+
+    // Self-joins need table aliases, which aren't supported.
+    select_cmd.join_clause = ast::JoinClause{"users", "users.id", "users.id"};
+    ASSERT_THROW(planner::plan_select(select_cmd, test_data_dir), std::runtime_error);
+}
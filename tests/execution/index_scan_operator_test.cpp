@@ -0,0 +1,220 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/execution/index_scan_operator.h"
+#include "simpledb/execution/table_scan_operator.h"
+#include "simpledb/catalog.h"
+#include "simpledb/command.h"
+#include "simpledb/executor.h"
+#include "simpledb/planner.h"
+#include "simpledb/storage/buffer_pool_manager.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+class IndexScanOperatorTest : public ::testing::Test {
+   protected:
+    std::filesystem::path test_data_dir;
+
+    void SetUp() override {
+        // Create a unique temporary file path for each test.
+        const ::testing::TestInfo* const test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+        test_data_dir = std::filesystem::temp_directory_path().string() + "/simpledb_" + test_info->test_suite_name() +
+                        "_" + test_info->name();
+        if (std::filesystem::exists(test_data_dir)) {
+            std::filesystem::remove_all(test_data_dir);
+        }
+        std::filesystem::create_directories(test_data_dir);
+
+        catalog::initialize(test_data_dir);
+
+        // A table of (id, name) rows, where many rows share each id, and an index on each column.
+        command::CreateTableCommand create_cmd;
+        create_cmd.table_name = "people";
+        create_cmd.column_definitions.push_back({"id", command::Datatype::INT});
+        create_cmd.column_definitions.push_back({"name", command::Datatype::TEXT});
+        executor::execute_create_table_command(create_cmd, test_data_dir);
+
+        command::InsertCommand load_cmd;
+        load_cmd.table_name = "people";
+        for (int i = 0; i < 5000; ++i) {
+            int id = (i * 7919) % 500 - 250;
+            load_cmd.rows.push_back({std::to_string(id), "person_with_a_long_name_" + std::to_string(i % 50)});
+        }
+        executor::execute_insert_command(load_cmd, test_data_dir);
+
+        executor::execute_create_index_command({"people_by_id", "people", "id"}, test_data_dir);
+        executor::execute_create_index_command({"people_by_name", "people", "name"}, test_data_dir);
+    }
+
+    void TearDown() override {
+        if (std::filesystem::exists(test_data_dir)) {
+            std::filesystem::remove_all(test_data_dir);
+        }
+    }
+
+    static std::vector<row::Row> collect(simpledb::execution::Operator& op) {
+        std::vector<row::Row> rows;
+        while (auto row = op.next()) {
+            rows.push_back(*row);
+        }
+        std::sort(rows.begin(), rows.end());
+        return rows;
+    }
+
+    // Runs the predicate through the index and through a full scan, which must return the same rows.
+    void check_against_table_scan(const std::string& index_name,
+                                  const ast::WhereClause& where_clause,
+                                  command::IndexType index_type = command::IndexType::BTREE) {
+        catalog::TableSchema schema = *catalog::get_table_schema("people");
+        auto predicate = simpledb::execution::CompiledPredicate::compile(where_clause, schema);
+        simpledb::execution::IndexScanOperator index_scan(
+            "people", test_data_dir, {index_name, where_clause.column_name, index_type}, predicate);
+        simpledb::execution::TableScanOperator table_scan("people", test_data_dir, predicate);
+        ASSERT_EQ(collect(index_scan), collect(table_scan))
+            << where_clause.column_name << " op " << where_clause.op << " " << where_clause.value;
+    }
+};
+
+TEST_F(IndexScanOperatorTest, IntIndexAnswersEveryIndexableOperator) {
+    for (std::string value : {"-251", "-250", "-3", "0", "17", "249", "250"}) {
+        for (ast::ComparisonOp op : {ast::ComparisonOp::EQUALS,
+                                     ast::ComparisonOp::LESS_THAN,
+                                     ast::ComparisonOp::LESS_THAN_OR_EQUAL,
+                                     ast::ComparisonOp::GREATER_THAN,
+                                     ast::ComparisonOp::GREATER_THAN_OR_EQUAL}) {
+            check_against_table_scan("people_by_id", {"id", op, value});
+        }
+    }
+}
+
+TEST_F(IndexScanOperatorTest, TextIndexRechecksValuesThatShareAKey) {
+    // All names share their first 16 bytes, so they all have the same key: the index can only narrow the scan down
+    // to that key, and the predicate has to tell the names apart.
+    for (std::string value : {"person_with_a_long_name_7", "person_with_a_long_name_", "person", "zzz"}) {
+        for (ast::ComparisonOp op : {ast::ComparisonOp::EQUALS,
+                                     ast::ComparisonOp::LESS_THAN,
+                                     ast::ComparisonOp::GREATER_THAN_OR_EQUAL}) {
+            check_against_table_scan("people_by_name", {"name", op, value});
+        }
+    }
+}
+
+TEST_F(IndexScanOperatorTest, ReturnsRequestedColumnsOnly) {
+    catalog::TableSchema schema = *catalog::get_table_schema("people");
+    auto predicate =
+        simpledb::execution::CompiledPredicate::compile({"id", ast::ComparisonOp::EQUALS, "-250"}, schema);
+    simpledb::execution::IndexScanOperator index_scan(
+        "people", test_data_dir, {"people_by_id", "id"}, predicate, row::Signature{1});
+
+    std::vector<row::Row> rows = collect(index_scan);
+    // 5000 rows over 500 ids.
+    ASSERT_EQ(rows.size(), 10);
+    for (const row::Row& row : rows) {
+        ASSERT_EQ(row.size(), 1);
+        ASSERT_EQ(row[0].rfind("person_with_a_long_name_", 0), 0);
+    }
+}
+
+TEST_F(IndexScanOperatorTest, RejectsNotEquals) {
+    catalog::TableSchema schema = *catalog::get_table_schema("people");
+    auto predicate =
+        simpledb::execution::CompiledPredicate::compile({"id", ast::ComparisonOp::NOT_EQUALS, "3"}, schema);
+    ASSERT_THROW(
+        simpledb::execution::IndexScanOperator("people", test_data_dir, {"people_by_id", "id"}, predicate),
+        std::runtime_error);
+}
+
+TEST_F(IndexScanOperatorTest, PlannerUsesIndexAndSeesNewRows) {
+    command::InsertCommand insert_cmd;
+    insert_cmd.table_name = "people";
+    insert_cmd.rows = {{"1000", "Zed"}};
+    executor::execute_insert_command(insert_cmd, test_data_dir);
+
+    ast::SelectCommand select_cmd;
+    select_cmd.table_name = "people";
+    select_cmd.projection = {"name"};
+    select_cmd.where_clause = ast::WhereClause{"id", ast::ComparisonOp::GREATER_THAN_OR_EQUAL, "250"};
+    auto plan = planner::plan_select(select_cmd, test_data_dir);
+    std::vector<row::Row> rows = collect(*plan);
+    ASSERT_EQ(rows, std::vector<row::Row>({{"Zed"}}));
+}
+
+TEST_F(IndexScanOperatorTest, HashIndexAnswersEqualsOnly) {
+    command::CreateIndexCommand create_index_cmd{"people_by_id_hash", "people", "id", command::IndexType::HASH};
+    ASSERT_EQ(executor::execute_create_index_command(create_index_cmd, test_data_dir).get_status(),
+              results::ResultStatus::SUCCESS);
+    create_index_cmd = {"people_by_name_hash", "people", "name", command::IndexType::HASH};
+    ASSERT_EQ(executor::execute_create_index_command(create_index_cmd, test_data_dir).get_status(),
+              results::ResultStatus::SUCCESS);
+
+    for (std::string value : {"-251", "-250", "-3", "0", "17", "249"}) {
+        check_against_table_scan(
+            "people_by_id_hash", {"id", ast::ComparisonOp::EQUALS, value}, command::IndexType::HASH);
+    }
+    for (std::string value : {"person_with_a_long_name_7", "person_with_a_long_name_", "zzz"}) {
+        check_against_table_scan(
+            "people_by_name_hash", {"name", ast::ComparisonOp::EQUALS, value}, command::IndexType::HASH);
+    }
+
+    catalog::TableSchema schema = *catalog::get_table_schema("people");
+    auto predicate =
+        simpledb::execution::CompiledPredicate::compile({"id", ast::ComparisonOp::LESS_THAN, "3"}, schema);
+    ASSERT_THROW(simpledb::execution::IndexScanOperator(
+                     "people", test_data_dir, {"people_by_id_hash", "id", command::IndexType::HASH}, predicate),
+                 std::runtime_error);
+}
+
+TEST_F(IndexScanOperatorTest, PlannerUsesHashIndexAndSeesNewRows) {
+    command::CreateIndexCommand create_index_cmd{"people_by_id_hash", "people", "id", command::IndexType::HASH};
+    executor::execute_create_index_command(create_index_cmd, test_data_dir);
+
+    command::InsertCommand insert_cmd;
+    insert_cmd.table_name = "people";
+    insert_cmd.rows = {{"1000", "Zed"}, {"1000", "Amy"}, {"1001", "Bob"}};
+    executor::execute_insert_command(insert_cmd, test_data_dir);
+
+    ast::SelectCommand select_cmd;
+    select_cmd.table_name = "people";
+    select_cmd.projection = {"name"};
+    select_cmd.where_clause = ast::WhereClause{"id", ast::ComparisonOp::EQUALS, "1000"};
+    auto plan = planner::plan_select(select_cmd, test_data_dir);
+    ASSERT_EQ(collect(*plan), std::vector<row::Row>({{"Amy"}, {"Zed"}}));
+
+    // Range predicates still go through the B+ tree.
+    select_cmd.where_clause = ast::WhereClause{"id", ast::ComparisonOp::GREATER_THAN, "1000"};
+    plan = planner::plan_select(select_cmd, test_data_dir);
+    ASSERT_EQ(collect(*plan), std::vector<row::Row>({{"Bob"}}));
+}
+
+TEST_F(IndexScanOperatorTest, PrimaryKeyLookupStopsAtTheOnlyMatch) {
+    command::CreateTableCommand create_cmd;
+    create_cmd.table_name = "accounts";
+    create_cmd.column_definitions.push_back({"name", command::Datatype::TEXT, command::ColumnConstraint::PRIMARY_KEY});
+    create_cmd.column_definitions.push_back({"balance", command::Datatype::INT});
+    executor::execute_create_table_command(create_cmd, test_data_dir);
+
+    // All names share their first 16 bytes, so they all have the same index key.
+    command::InsertCommand load_cmd;
+    load_cmd.table_name = "accounts";
+    for (int i = 0; i < 2000; ++i) {
+        load_cmd.rows.push_back({"account_number_" + std::to_string(100000 + i), std::to_string(i)});
+    }
+    executor::execute_insert_command(load_cmd, test_data_dir);
+
+    ast::SelectCommand select_cmd;
+    select_cmd.table_name = "accounts";
+    select_cmd.projection = {"balance"};
+    select_cmd.where_clause = ast::WhereClause{"name", ast::ComparisonOp::EQUALS, "account_number_100005"};
+
+    simpledb::storage::BufferPoolManager::Instance().ResetStats();
+    auto plan = planner::plan_select(select_cmd, test_data_dir);
+    ASSERT_EQ(collect(*plan), std::vector<row::Row>({{"5"}}));
+    // Without stopping at the match, the scan would fetch the record of every entry with the same key.
+    simpledb::storage::BufferPoolStats stats = simpledb::storage::BufferPoolManager::Instance().GetStats();
+    ASSERT_LT(stats.hits + stats.misses, 50);
+}
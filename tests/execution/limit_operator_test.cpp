@@ -0,0 +1,132 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/execution/limit_operator.h"
+#include "simpledb/execution/table_scan_operator.h"
+#include "simpledb/ast/ast.h"
+#include "simpledb/catalog.h"
+#include "simpledb/command.h"
+#include "simpledb/executor.h"
+#include "simpledb/planner.h"
+#include "simpledb/storage/buffer_pool_manager.h"
+
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+using simpledb::storage::BufferPoolManager;
+using simpledb::storage::BufferPoolStats;
+
+class LimitOperatorTest : public ::testing::Test {
+   protected:
+    static constexpr int NUM_ROWS = 20000;
+    std::filesystem::path test_data_dir;
+
+    void SetUp() override {
+        // Create a unique temporary file path for each test.
+        const ::testing::TestInfo* const test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+        test_data_dir = std::filesystem::temp_directory_path().string() + "/simpledb_" + test_info->test_suite_name() +
+                        "_" + test_info->name();
+        if (std::filesystem::exists(test_data_dir)) {
+            std::filesystem::remove_all(test_data_dir);
+        }
+        std::filesystem::create_directories(test_data_dir);
+
+        catalog::initialize(test_data_dir);
+
+        // A table spanning many pages, where row i has id i.
+        command::CreateTableCommand create_cmd;
+        create_cmd.table_name = "big";
+        create_cmd.column_definitions.push_back({"id", command::Datatype::INT});
+        create_cmd.column_definitions.push_back({"payload", command::Datatype::TEXT});
+        executor::execute_create_table_command(create_cmd, test_data_dir);
+
+        command::InsertCommand load_cmd;
+        load_cmd.table_name = "big";
+        for (int i = 0; i < NUM_ROWS; ++i) {
+            load_cmd.rows.push_back({std::to_string(i), "a_reasonably_long_payload_" + std::to_string(i)});
+        }
+        executor::execute_insert_command(load_cmd, test_data_dir);
+    }
+
+    void TearDown() override {
+        if (std::filesystem::exists(test_data_dir)) {
+            std::filesystem::remove_all(test_data_dir);
+        }
+    }
+
+    // The ids returned by SELECT id FROM big [WHERE where_clause] LIMIT limit OFFSET offset.
+    std::vector<std::string> select_ids(size_t limit,
+                                        size_t offset,
+                                        std::optional<ast::WhereClause> where_clause = std::nullopt) {
+        ast::SelectCommand select_cmd;
+        select_cmd.table_name = "big";
+        select_cmd.projection = {"id"};
+        select_cmd.where_clause = std::move(where_clause);
+        select_cmd.limit_clause = ast::LimitClause{limit, offset};
+        std::unique_ptr<simpledb::execution::Operator> plan = planner::plan_select(select_cmd, test_data_dir);
+        std::vector<std::string> ids;
+        while (auto row = plan->next()) {
+            ids.push_back(row->at(0));
+        }
+        return ids;
+    }
+
+    static std::vector<std::string> id_range(int begin, int end) {
+        std::vector<std::string> ids;
+        for (int i = begin; i < end; ++i) {
+            ids.push_back(std::to_string(i));
+        }
+        return ids;
+    }
+};
+
+TEST_F(LimitOperatorTest, ReturnsRowsBetweenOffsetAndLimit) {
+    ASSERT_EQ(select_ids(3, 0), id_range(0, 3));
+    // Across a batch boundary.
+    ASSERT_EQ(select_ids(10, 1020), id_range(1020, 1030));
+    ASSERT_EQ(select_ids(2000, 500), id_range(500, 2500));
+    // Past the end of the table.
+    ASSERT_EQ(select_ids(100, NUM_ROWS - 5), id_range(NUM_ROWS - 5, NUM_ROWS));
+    ASSERT_TRUE(select_ids(100, NUM_ROWS).empty());
+    ASSERT_TRUE(select_ids(0, 0).empty());
+    ASSERT_EQ(select_ids(std::numeric_limits<size_t>::max(), 7).size(), NUM_ROWS - 7);
+    // With a WHERE clause, the offset and the limit count the matching rows.
+    ASSERT_EQ(select_ids(4, 2, ast::WhereClause{"id", ast::ComparisonOp::GREATER_THAN_OR_EQUAL, "15000"}),
+              id_range(15002, 15006));
+}
+
+TEST_F(LimitOperatorTest, SmallLimitReadsOnlyTheFirstPage) {
+    ast::SelectCommand select_cmd;
+    select_cmd.table_name = "big";
+    select_cmd.limit_clause = ast::LimitClause{10};
+
+    BufferPoolManager::Instance().ResetStats();
+    std::unique_ptr<simpledb::execution::Operator> plan = planner::plan_select(select_cmd, test_data_dir);
+    size_t num_rows = 0;
+    while (plan->next().has_value()) {
+        ++num_rows;
+    }
+    BufferPoolStats stats = BufferPoolManager::Instance().GetStats();
+    ASSERT_EQ(num_rows, 10);
+    // A whole batch of rows would span several pages, only the ten rows are read.
+    ASSERT_LE(stats.hits + stats.misses, 2);
+}
+
+TEST_F(LimitOperatorTest, StopsPullingFromTheChild) {
+    auto scan = std::make_unique<simpledb::execution::TableScanOperator>("big", test_data_dir);
+    simpledb::execution::LimitOperator limit(std::move(scan), 5, 1);
+    // The outer operator asks for even fewer rows.
+    limit.set_row_limit(2);
+
+    BufferPoolManager::Instance().ResetStats();
+    ASSERT_EQ(limit.next(), row::Row({"1", "a_reasonably_long_payload_1"}));
+    ASSERT_EQ(limit.next(), row::Row({"2", "a_reasonably_long_payload_2"}));
+    ASSERT_FALSE(limit.next().has_value());
+    ASSERT_FALSE(limit.next().has_value());
+    ASSERT_LE(BufferPoolManager::Instance().GetStats().hits + BufferPoolManager::Instance().GetStats().misses, 1);
+}
@@ -0,0 +1,161 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/execution/parallel_scan_operator.h"
+#include "simpledb/execution/filter_operator.h"
+#include "simpledb/execution/scheduler.h"
+#include "simpledb/execution/table_scan_operator.h"
+#include "simpledb/ast/ast.h"
+#include "simpledb/catalog.h"
+#include "simpledb/command.h"
+#include "simpledb/executor.h"
+#include "simpledb/planner.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using simpledb::execution::ParallelScanOperator;
+
+namespace {
+    std::vector<row::Row> collect(simpledb::execution::Operator& op) {
+        std::vector<row::Row> rows;
+        while (auto row = op.next()) {
+            rows.push_back(*row);
+        }
+        return rows;
+    }
+}  // namespace
+
+class ParallelScanOperatorTest : public ::testing::Test {
+   protected:
+    static constexpr int NUM_ROWS = 40000;
+    std::filesystem::path test_data_dir;
+    // The morsels are scanned by 4 threads, however many cores the machine has.
+    simpledb::execution::Scheduler scheduler{4};
+
+    void SetUp() override {
+        // Create a unique temporary file path for each test.
+        const ::testing::TestInfo* const test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+        test_data_dir = std::filesystem::temp_directory_path().string() + "/simpledb_" + test_info->test_suite_name() +
+                        "_" + test_info->name();
+        if (std::filesystem::exists(test_data_dir)) {
+            std::filesystem::remove_all(test_data_dir);
+        }
+        std::filesystem::create_directories(test_data_dir);
+
+        catalog::initialize(test_data_dir);
+
+        command::CreateTableCommand create_cmd;
+        create_cmd.table_name = "users";
+        create_cmd.column_definitions.push_back({"id", command::Datatype::INT});
+        create_cmd.column_definitions.push_back({"name", command::Datatype::TEXT});
+        create_cmd.column_definitions.push_back({"age", command::Datatype::INT});
+        executor::execute_create_table_command(create_cmd, test_data_dir);
+
+        command::InsertCommand load_cmd;
+        load_cmd.table_name = "users";
+        for (int i = 0; i < NUM_ROWS; ++i) {
+            load_cmd.rows.push_back({std::to_string(i), "user_" + std::to_string(i), std::to_string(i % 90)});
+        }
+        executor::execute_insert_command(load_cmd, test_data_dir);
+    }
+
+    void TearDown() override {
+        if (std::filesystem::exists(test_data_dir)) {
+            std::filesystem::remove_all(test_data_dir);
+        }
+    }
+
+    std::shared_ptr<simpledb::execution::TaskGroup> task_group() {
+        return std::make_shared<simpledb::execution::TaskGroup>(scheduler);
+    }
+
+    simpledb::execution::CompiledPredicate compile(const ast::WhereClause& where_clause) const {
+        return simpledb::execution::CompiledPredicate::compile(where_clause, *catalog::get_table_schema("users"));
+    }
+};
+
+TEST_F(ParallelScanOperatorTest, ReturnsTheRowsOfASerialScanInOrder) {
+    const ast::WhereClause where_clause{"age", ast::ComparisonOp::LESS_THAN, "30"};
+    simpledb::execution::TableScanOperator serial_scan(
+        "users", test_data_dir, compile(where_clause), row::Signature{2, 0});
+    const std::vector<row::Row> expected = collect(serial_scan);
+    ASSERT_GT(expected.size(), 0);
+    ASSERT_LT(expected.size(), NUM_ROWS);
+
+    ParallelScanOperator parallel_scan(
+        "users", test_data_dir, compile(where_clause), row::Signature{2, 0}, std::nullopt, 4, task_group());
+    ASSERT_GT(parallel_scan.num_morsels(), 4);
+    ASSERT_EQ(parallel_scan.num_workers(), 4);
+    ASSERT_EQ(parallel_scan.signature(), row::Signature({2, 0}));
+    ASSERT_EQ(collect(parallel_scan), expected);
+}
+
+TEST_F(ParallelScanOperatorTest, RunsAFilterOperatorInEachPipeline) {
+    const ast::WhereClause where_clause{"name", ast::ComparisonOp::GREATER_THAN_OR_EQUAL, "user_5"};
+    simpledb::execution::FilterOperator serial_filter(
+        "users", std::make_unique<simpledb::execution::TableScanOperator>("users", test_data_dir), where_clause);
+    const std::vector<row::Row> expected = collect(serial_filter);
+    ASSERT_GT(expected.size(), 0);
+    ASSERT_LT(expected.size(), NUM_ROWS);
+
+    ParallelScanOperator parallel_scan(
+        "users", test_data_dir, std::nullopt, std::nullopt, where_clause, 3, task_group());
+    ASSERT_EQ(collect(parallel_scan), expected);
+}
+
+TEST_F(ParallelScanOperatorTest, StopsEarly) {
+    // At most one pipeline per morsel.
+    command::CreateTableCommand create_cmd;
+    create_cmd.table_name = "empty_table";
+    create_cmd.column_definitions.push_back({"id", command::Datatype::INT});
+    executor::execute_create_table_command(create_cmd, test_data_dir);
+    ParallelScanOperator empty_scan(
+        "empty_table", test_data_dir, std::nullopt, std::nullopt, std::nullopt, 8, task_group());
+    ASSERT_EQ(empty_scan.num_workers(), 0);
+    ASSERT_FALSE(empty_scan.next().has_value());
+
+    // The row limit stops handing out morsels.
+    ParallelScanOperator limited_scan(
+        "users", test_data_dir, std::nullopt, std::nullopt, std::nullopt, 4, task_group());
+    limited_scan.set_row_limit(10);
+    simpledb::execution::Batch batch;
+    ASSERT_TRUE(limited_scan.next_batch(batch));
+    ASSERT_FALSE(limited_scan.next_batch(batch));
+
+    // Destroying a scan that wasn't read to the end waits for its running tasks.
+    auto abandoned_scan = std::make_unique<ParallelScanOperator>(
+        "users", test_data_dir, std::nullopt, std::nullopt, std::nullopt, 4, task_group());
+    ASSERT_TRUE(abandoned_scan->next().has_value());
+    abandoned_scan.reset();
+}
+
+TEST_F(ParallelScanOperatorTest, IsUsedByThePlannerForLargeTables) {
+    ast::SelectCommand select_cmd;
+    select_cmd.table_name = "users";
+    select_cmd.projection = {"name", "id"};
+    select_cmd.where_clause = ast::WhereClause{"id", ast::ComparisonOp::GREATER_THAN_OR_EQUAL, "100"};
+    std::vector<row::Row> expected;
+    for (int i = 100; i < NUM_ROWS; ++i) {
+        expected.push_back({"user_" + std::to_string(i), std::to_string(i)});
+    }
+    ASSERT_EQ(collect(*planner::plan_select(select_cmd, test_data_dir)), expected);
+}
+
+// Death tests run in a fork()ed child, which has none of the worker threads of the process-wide scheduler.
+using ParallelScanOperatorDeathTest = ParallelScanOperatorTest;
+
+TEST_F(ParallelScanOperatorDeathTest, ProcessCanExitAfterAParallelQuery) {
+    // The planner runs parallel scans on the process-wide scheduler, which starts its workers on first use.
+    ast::SelectCommand select_cmd;
+    select_cmd.table_name = "users";
+    ASSERT_EQ(collect(*planner::plan_select(select_cmd, test_data_dir)).size(), NUM_ROWS);
+
+    // Exiting must not wait for the workers, which the child doesn't have.
+    ASSERT_EXIT(std::exit(3), ::testing::ExitedWithCode(3), "");
+}
@@ -22,8 +22,9 @@
  */
 class MockScanOperator : public simpledb::execution::Operator {
    public:
-    // Constructor takes the data it should produce.
-    explicit MockScanOperator(std::vector<row::Row> data) : data_(std::move(data)), current_index_(0) {}
+    // Constructor takes the data it should produce, and optionally the signature of its rows.
+    explicit MockScanOperator(std::vector<row::Row> data, std::optional<row::Signature> signature = std::nullopt)
+        : data_(std::move(data)), current_index_(0), signature_(std::move(signature)) {}
 
     // The next() method returns the next row from the internal vector.
     std::optional<row::Row> next() override {
@@ -36,9 +37,12 @@ class MockScanOperator : public simpledb::execution::Operator {
         return std::nullopt;
     }
 
+    std::optional<row::Signature> signature() const override { return signature_; }
+
    private:
     std::vector<row::Row> data_;
     size_t current_index_;
+    std::optional<row::Signature> signature_;
 };
 
 class ProjectionOperatorTest : public ::testing::Test {
@@ -172,3 +176,28 @@ TEST_F(ProjectionOperatorTest, ProjectWithNonExistentColumn) {
         ASSERT_STREQ("Projection column not found in table schema: non_existent_column", e.what());
     }
 }
+
+TEST_F(ProjectionOperatorTest, ProjectFromRowsWithSignature) {
+    std::string table_name = "table_name";
+    catalog::TableSchema schema;
+    schema.table_name = table_name;
+    schema.column_definitions = {
+        {"id", command::Datatype::INT}, {"name", command::Datatype::TEXT}, {"email", command::Datatype::TEXT}};
+    catalog::add_table(schema);
+
+    // The child only returns the id and email columns, as a scan that skipped the name column would.
+    std::vector<row::Row> source_data = {{"1", "alice@example.com"}, {"2", "bob@example.com"}};
+    auto mock_scan = std::make_unique<MockScanOperator>(source_data, row::Signature{0, 2});
+
+    simpledb::execution::ProjectionOperator proj_op(table_name, std::move(mock_scan), {"email", "id"});
+    ASSERT_EQ(proj_op.signature(), std::optional<row::Signature>(row::Signature{2, 0}));
+
+    auto first_row = proj_op.next();
+    ASSERT_TRUE(first_row.has_value());
+    ASSERT_EQ(*first_row, row::Row({"alice@example.com", "1"}));
+
+    // Projecting a column that the child doesn't return is an error.
+    ASSERT_THROW(simpledb::execution::ProjectionOperator(
+                     table_name, std::make_unique<MockScanOperator>(source_data, row::Signature{0, 2}), {"name"}),
+                 std::runtime_error);
+}
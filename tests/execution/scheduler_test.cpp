@@ -0,0 +1,115 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/execution/scheduler.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using simpledb::execution::Scheduler;
+using simpledb::execution::TaskGroup;
+
+TEST(SchedulerTest, RunsAllTasksOfAGroup) {
+    Scheduler scheduler(4);
+    ASSERT_EQ(scheduler.num_threads(), 4);
+
+    std::atomic<int> sum{0};
+    TaskGroup group(scheduler);
+    for (int i = 1; i <= 1000; ++i) {
+        group.submit([&sum, i] { sum += i; });
+    }
+    group.wait();
+    ASSERT_EQ(sum, 500500);
+
+    // A group can be reused after waiting.
+    group.submit([&sum] { sum = 0; });
+    group.wait();
+    ASSERT_EQ(sum, 0);
+}
+
+TEST(SchedulerTest, RunsTasksSubmittedByTasks) {
+    // Tasks submitted on a worker thread go to its deque, the other workers steal them. Waiting inside a task runs
+    // the queued tasks instead of blocking the worker, so this works even with a single worker.
+    for (size_t num_threads : {1, 4}) {
+        Scheduler scheduler(num_threads);
+        std::atomic<int> num_leaves{0};
+        TaskGroup outer(scheduler);
+        for (int i = 0; i < 8; ++i) {
+            outer.submit([&scheduler, &num_leaves] {
+                TaskGroup inner(scheduler);
+                for (int j = 0; j < 100; ++j) {
+                    inner.submit([&num_leaves] { num_leaves += 1; });
+                }
+                inner.wait();
+            });
+        }
+        outer.wait();
+        ASSERT_EQ(num_leaves, 800);
+    }
+}
+
+TEST(SchedulerTest, RethrowsTheFirstExceptionOfAGroup) {
+    Scheduler scheduler(2);
+    std::atomic<int> num_run{0};
+    TaskGroup group(scheduler);
+    for (int i = 0; i < 10; ++i) {
+        group.submit([&num_run, i] {
+            num_run += 1;
+            if (i == 3) {
+                throw std::runtime_error("task failed");
+            }
+        });
+    }
+    ASSERT_THROW(group.wait(), std::runtime_error);
+    // The other tasks still ran, and the exception is only thrown once.
+    ASSERT_EQ(num_run, 10);
+    group.wait();
+}
+
+TEST(SchedulerTest, GroupsTakeTurns) {
+    Scheduler scheduler(1);
+    std::mutex mutex;
+    std::condition_variable released;
+    bool release = false;
+    std::vector<std::string> order;
+
+    // Keep the only worker busy while both groups queue their tasks.
+    TaskGroup blocker(scheduler);
+    blocker.submit([&] {
+        std::unique_lock<std::mutex> lock(mutex);
+        released.wait(lock, [&] { return release; });
+    });
+
+    TaskGroup large_query(scheduler);
+    for (int i = 0; i < 100; ++i) {
+        large_query.submit([&] {
+            std::lock_guard<std::mutex> guard(mutex);
+            order.push_back("large");
+        });
+    }
+    TaskGroup small_query(scheduler);
+    small_query.submit([&] {
+        std::lock_guard<std::mutex> guard(mutex);
+        order.push_back("small");
+    });
+
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        release = true;
+        released.notify_all();
+    }
+    small_query.wait();
+    large_query.wait();
+    blocker.wait();
+
+    // The small query's task runs right after the large query's first one, instead of after all of them.
+    ASSERT_EQ(order.size(), 101);
+    ASSERT_EQ(order[0], "large");
+    ASSERT_EQ(order[1], "small");
+}
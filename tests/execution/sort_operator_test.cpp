@@ -0,0 +1,225 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/execution/sort_operator.h"
+#include "simpledb/execution/table_scan_operator.h"
+#include "simpledb/ast/ast.h"
+#include "simpledb/catalog.h"
+#include "simpledb/command.h"
+#include "simpledb/executor.h"
+#include "simpledb/planner.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using simpledb::execution::SortKey;
+using simpledb::execution::SortKeyType;
+using simpledb::execution::SortOperator;
+
+namespace {
+    std::vector<row::Row> collect(simpledb::execution::Operator& op) {
+        std::vector<row::Row> rows;
+        while (auto row = op.next()) {
+            rows.push_back(*row);
+        }
+        return rows;
+    }
+
+    ast::OrderByItem order_by(const std::string& column_name,
+                              bool descending = false,
+                              std::optional<ast::AggregateFunction> aggregate = std::nullopt) {
+        return {{column_name, aggregate}, descending};
+    }
+}  // namespace
+
+class SortOperatorTest : public ::testing::Test {
+   protected:
+    static constexpr int NUM_ROWS = 12000;
+    std::filesystem::path test_data_dir;
+    // The rows of the sales table, in the order they were loaded: id, region, amount.
+    std::vector<row::Row> table_rows;
+
+    void SetUp() override {
+        // Create a unique temporary file path for each test.
+        const ::testing::TestInfo* const test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+        test_data_dir = std::filesystem::temp_directory_path().string() + "/simpledb_" + test_info->test_suite_name() +
+                        "_" + test_info->name();
+        if (std::filesystem::exists(test_data_dir)) {
+            std::filesystem::remove_all(test_data_dir);
+        }
+        std::filesystem::create_directories(test_data_dir);
+
+        catalog::initialize(test_data_dir);
+
+        command::CreateTableCommand create_cmd;
+        create_cmd.table_name = "sales";
+        create_cmd.column_definitions.push_back({"id", command::Datatype::INT});
+        create_cmd.column_definitions.push_back({"region", command::Datatype::TEXT});
+        create_cmd.column_definitions.push_back({"amount", command::Datatype::INT});
+        executor::execute_create_table_command(create_cmd, test_data_dir);
+
+        command::InsertCommand load_cmd;
+        load_cmd.table_name = "sales";
+        for (int i = 0; i < NUM_ROWS; ++i) {
+            table_rows.push_back(
+                {std::to_string(i), "region_" + std::to_string(i % 37), std::to_string((i * 7919) % 1000 - 300)});
+        }
+        load_cmd.rows = table_rows;
+        executor::execute_insert_command(load_cmd, test_data_dir);
+    }
+
+    void TearDown() override {
+        if (std::filesystem::exists(test_data_dir)) {
+            std::filesystem::remove_all(test_data_dir);
+        }
+    }
+
+    std::vector<row::Row> select(std::vector<std::string> projection,
+                                 std::vector<ast::OrderByItem> order_by_items,
+                                 std::optional<ast::LimitClause> limit_clause = std::nullopt) {
+        ast::SelectCommand select_cmd;
+        select_cmd.table_name = "sales";
+        select_cmd.projection = std::move(projection);
+        select_cmd.order_by = std::move(order_by_items);
+        select_cmd.limit_clause = limit_clause;
+        auto plan = planner::plan_select(select_cmd, test_data_dir);
+        return collect(*plan);
+    }
+
+    // Sorts the whole sales table by region, then amount descending, with the given memory budget.
+    std::vector<row::Row> sort_sales(size_t memory_budget, size_t& num_runs, size_t row_limit = SIZE_MAX) {
+        SortOperator op(std::make_unique<simpledb::execution::TableScanOperator>("sales", test_data_dir),
+                        {{1, SortKeyType::TEXT, false}, {2, SortKeyType::INT, true}},
+                        memory_budget,
+                        test_data_dir / "tmp");
+        op.set_row_limit(row_limit);
+        std::vector<row::Row> rows;
+        while (rows.size() < row_limit) {
+            std::optional<row::Row> row = op.next();
+            if (!row.has_value()) {
+                break;
+            }
+            rows.push_back(*row);
+        }
+        num_runs = op.num_runs();
+        return rows;
+    }
+
+    // The table rows, sorted by region, then amount descending.
+    std::vector<row::Row> expected_sales() const {
+        std::vector<row::Row> expected = table_rows;
+        std::stable_sort(expected.begin(), expected.end(), [](const row::Row& a, const row::Row& b) {
+            if (a[1] != b[1]) {
+                return a[1] < b[1];
+            }
+            return std::stoi(a[2]) > std::stoi(b[2]);
+        });
+        return expected;
+    }
+};
+
+TEST_F(SortOperatorTest, SortsByTypedKeysAndKeepsTiesInOrder) {
+    // INT keys compare as numbers (so -300 comes first), and rows with equal keys keep the table's order.
+    std::vector<row::Row> expected;
+    for (const row::Row& row : table_rows) {
+        expected.push_back({row[2], row[0]});
+    }
+    std::stable_sort(expected.begin(), expected.end(), [](const row::Row& a, const row::Row& b) {
+        return std::stoi(a[0]) < std::stoi(b[0]);
+    });
+    ASSERT_EQ(select({"amount", "id"}, {order_by("amount")}), expected);
+
+    // Descending, on a column that isn't projected.
+    std::vector<row::Row> rows = select({"id"}, {order_by("amount", true), order_by("id", true)});
+    ASSERT_EQ(rows.size(), NUM_ROWS);
+    for (size_t i = 1; i < rows.size(); ++i) {
+        const row::Row& previous = table_rows[std::stoi(rows[i - 1][0])];
+        const row::Row& current = table_rows[std::stoi(rows[i][0])];
+        ASSERT_GE(std::stoi(previous[2]), std::stoi(current[2]));
+        if (previous[2] == current[2]) {
+            ASSERT_GT(std::stoi(previous[0]), std::stoi(current[0]));
+        }
+    }
+
+    // TEXT keys, then INT keys.
+    ASSERT_EQ(select({"id", "region", "amount"}, {order_by("region"), order_by("amount", true)}), expected_sales());
+}
+
+TEST_F(SortOperatorTest, MergesSortedRunsOverTheMemoryBudget) {
+    size_t num_runs = 0;
+    ASSERT_EQ(sort_sales(1 << 30, num_runs), expected_sales());
+    ASSERT_EQ(num_runs, 0);
+
+    // A few runs, merged at once.
+    ASSERT_EQ(sort_sales(512 * 1024, num_runs), expected_sales());
+    ASSERT_GT(num_runs, 1);
+    ASSERT_LE(num_runs, SortOperator::MAX_MERGE_FAN_IN);
+
+    // Too many runs to merge at once: they're first merged into longer runs.
+    ASSERT_EQ(sort_sales(8 * 1024, num_runs), expected_sales());
+    ASSERT_GT(num_runs, SortOperator::MAX_MERGE_FAN_IN);
+
+    // The runs are all removed, even when the operator isn't read to the end.
+    ASSERT_EQ(sort_sales(8 * 1024, num_runs, 5).size(), 5);
+    ASSERT_TRUE(std::filesystem::is_empty(test_data_dir / "tmp"));
+}
+
+TEST_F(SortOperatorTest, KeepsOnlyTheFirstRowsWithARowLimit) {
+    const std::vector<row::Row> expected = expected_sales();
+
+    // The first rows fit in memory, even though the whole table wouldn't.
+    size_t num_runs = 0;
+    ASSERT_EQ(sort_sales(64 * 1024, num_runs, 10),
+              std::vector<row::Row>(expected.begin(), expected.begin() + 10));
+    ASSERT_EQ(num_runs, 0);
+
+    // They don't fit either: the operator falls back to an external sort.
+    ASSERT_EQ(sort_sales(8 * 1024, num_runs, 1000),
+              std::vector<row::Row>(expected.begin(), expected.begin() + 1000));
+    ASSERT_GT(num_runs, 0);
+
+    // Through LIMIT and OFFSET.
+    ASSERT_EQ(select({"id", "region", "amount"},
+                     {order_by("region"), order_by("amount", true)},
+                     ast::LimitClause{5, 100}),
+              std::vector<row::Row>(expected.begin() + 100, expected.begin() + 105));
+    ASSERT_TRUE(select({"id"}, {order_by("region")}, ast::LimitClause{0, 0}).empty());
+}
+
+TEST_F(SortOperatorTest, OrdersTheResultsOfAnAggregation) {
+    ast::SelectCommand select_cmd;
+    select_cmd.table_name = "sales";
+    select_cmd.select_items = {{"region", std::nullopt},
+                               {"", ast::AggregateFunction::COUNT},
+                               {"amount", ast::AggregateFunction::AVG}};
+    select_cmd.group_by = {"region"};
+    select_cmd.order_by = {order_by("", true, ast::AggregateFunction::COUNT), order_by("region")};
+    std::vector<row::Row> rows = collect(*planner::plan_select(select_cmd, test_data_dir));
+
+    // 12000 = 37 * 324 + 12: regions 0 to 11 have one more row.
+    ASSERT_EQ(rows.size(), 37);
+    ASSERT_EQ(rows[0][0], "region_0");
+    ASSERT_EQ(rows[0][1], "325");
+    ASSERT_EQ(rows[1][0], "region_1");
+    ASSERT_EQ(rows[2][0], "region_10");
+    ASSERT_EQ(rows[12][0], "region_12");
+    ASSERT_EQ(rows[12][1], "324");
+
+    // AVG values compare as numbers.
+    select_cmd.order_by = {order_by("amount", false, ast::AggregateFunction::AVG)};
+    rows = collect(*planner::plan_select(select_cmd, test_data_dir));
+    for (size_t i = 1; i < rows.size(); ++i) {
+        ASSERT_LE(std::stod(rows[i - 1][2]), std::stod(rows[i][2]));
+    }
+
+    // The ORDER BY items of an aggregate query must be in its SELECT list.
+    select_cmd.order_by = {order_by("amount", false, ast::AggregateFunction::SUM)};
+    ASSERT_THROW(planner::plan_select(select_cmd, test_data_dir), std::runtime_error);
+    ASSERT_THROW(select({"id"}, {order_by("", false, ast::AggregateFunction::COUNT)}), std::runtime_error);
+    ASSERT_THROW(select({"id"}, {order_by("price")}), std::runtime_error);
+}
@@ -61,7 +61,7 @@ TEST_F(TableScanOperatorTest, ScanSingleRowTable) {
 
     command::InsertCommand insert_cmd;
     insert_cmd.table_name = "single_row_table";
-    insert_cmd.values = row;
+    insert_cmd.rows = {row};
     executor::execute_insert_command(insert_cmd, test_data_dir);
 
     simpledb::execution::TableScanOperator scan_operator("single_row_table", test_data_dir);
@@ -91,7 +91,7 @@ TEST_F(TableScanOperatorTest, ScanMultiPageTable) {
 
     // Fill 2 pages with records.
     for (int i = 0; i < num_records_to_fill_page * 2; ++i) {
-        insert_cmd.values = {std::string(record_data)};
+        insert_cmd.rows = {{std::string(record_data)}};
         executor::execute_insert_command(insert_cmd, test_data_dir);
     }
     simpledb::execution::TableScanOperator scan_operator("multi_page_table", test_data_dir);
@@ -108,3 +108,103 @@ TEST_F(TableScanOperatorTest, ScanMultiPageTable) {
     }
     ASSERT_EQ(num_records_to_fill_page * 2, count);
 }
+
+TEST_F(TableScanOperatorTest, ScanWithPushedDownPredicate) {
+    command::CreateTableCommand create_cmd;
+    create_cmd.table_name = "people";
+    create_cmd.column_definitions.push_back({"id", command::Datatype::INT});
+    create_cmd.column_definitions.push_back({"name", command::Datatype::TEXT});
+    executor::execute_create_table_command(create_cmd, test_data_dir);
+
+    command::InsertCommand insert_cmd;
+    insert_cmd.table_name = "people";
+    insert_cmd.rows = {{"5", "Alice"}, {"10", "Bob"}, {"20", "Carol"}, {"100", "Dave"}};
+    executor::execute_insert_command(insert_cmd, test_data_dir);
+
+    catalog::TableSchemaPtr schema = catalog::get_table_schema("people");
+    ASSERT_NE(schema, nullptr);
+
+    // INT columns are compared numerically, straight from the record bytes.
+    simpledb::execution::TableScanOperator int_scan(
+        "people",
+        test_data_dir,
+        simpledb::execution::CompiledPredicate::compile({"id", ast::ComparisonOp::GREATER_THAN_OR_EQUAL, "10"},
+                                                        *schema));
+    std::vector<row::Row> rows;
+    while (auto row = int_scan.next()) {
+        rows.push_back(*row);
+    }
+    ASSERT_EQ(rows, std::vector<row::Row>({{"10", "Bob"}, {"20", "Carol"}, {"100", "Dave"}}));
+
+    simpledb::execution::TableScanOperator text_scan(
+        "people",
+        test_data_dir,
+        simpledb::execution::CompiledPredicate::compile({"name", ast::ComparisonOp::EQUALS, "Carol"}, *schema));
+    auto row = text_scan.next();
+    ASSERT_TRUE(row.has_value());
+    ASSERT_EQ(*row, row::Row({"20", "Carol"}));
+    ASSERT_FALSE(text_scan.next().has_value());
+}
+
+TEST_F(TableScanOperatorTest, ScanDeserializesOnlyRequestedColumns) {
+    command::CreateTableCommand create_cmd;
+    create_cmd.table_name = "wide_table";
+    create_cmd.column_definitions.push_back({"id", command::Datatype::INT});
+    create_cmd.column_definitions.push_back({"name", command::Datatype::TEXT});
+    create_cmd.column_definitions.push_back({"bio", command::Datatype::TEXT});
+    executor::execute_create_table_command(create_cmd, test_data_dir);
+
+    command::InsertCommand insert_cmd;
+    insert_cmd.table_name = "wide_table";
+    insert_cmd.rows = {{"1", "Alice", std::string(500, 'a')}, {"2", "Bob", std::string(500, 'b')}};
+    executor::execute_insert_command(insert_cmd, test_data_dir);
+
+    catalog::TableSchemaPtr schema = catalog::get_table_schema("wide_table");
+    ASSERT_NE(schema, nullptr);
+
+    // The predicate is on a column that isn't returned, it is read from the record bytes.
+    simpledb::execution::TableScanOperator scan_operator(
+        "wide_table",
+        test_data_dir,
+        simpledb::execution::CompiledPredicate::compile({"name", ast::ComparisonOp::EQUALS, "Bob"}, *schema),
+        row::Signature{0});
+    ASSERT_EQ(scan_operator.signature(), std::optional<row::Signature>(row::Signature{0}));
+
+    auto row = scan_operator.next();
+    ASSERT_TRUE(row.has_value());
+    ASSERT_EQ(*row, row::Row({"2"}));
+    ASSERT_FALSE(scan_operator.next().has_value());
+}
+
+TEST_F(TableScanOperatorTest, NextBatchReturnsTypedColumns) {
+    command::CreateTableCommand create_cmd;
+    create_cmd.table_name = "numbers";
+    create_cmd.column_definitions.push_back({"id", command::Datatype::INT});
+    create_cmd.column_definitions.push_back({"name", command::Datatype::TEXT});
+    executor::execute_create_table_command(create_cmd, test_data_dir);
+
+    const size_t num_rows = simpledb::execution::BATCH_CAPACITY + 100;
+    command::InsertCommand load_cmd;
+    load_cmd.table_name = "numbers";
+    for (size_t i = 0; i < num_rows; ++i) {
+        load_cmd.rows.push_back({std::to_string(i), "name" + std::to_string(i)});
+    }
+    executor::execute_insert_command(load_cmd, test_data_dir);
+
+    simpledb::execution::TableScanOperator scan_operator("numbers", test_data_dir);
+    simpledb::execution::Batch batch;
+
+    // The first batch is full, INT values are kept as ints.
+    ASSERT_TRUE(scan_operator.next_batch(batch));
+    ASSERT_EQ(batch.size(), simpledb::execution::BATCH_CAPACITY);
+    ASSERT_FALSE(batch.has_selection());
+    ASSERT_EQ(batch.column(0).type, command::Datatype::INT);
+    ASSERT_EQ(batch.column(0).ints[1000], 1000);
+    ASSERT_EQ(batch.column(1).texts[1000], "name1000");
+
+    // The second one has the remaining rows, and then the scan is exhausted.
+    ASSERT_TRUE(scan_operator.next_batch(batch));
+    ASSERT_EQ(batch.size(), 100);
+    ASSERT_EQ(batch.column(0).ints[99], static_cast<int32_t>(num_rows - 1));
+    ASSERT_FALSE(scan_operator.next_batch(batch));
+}
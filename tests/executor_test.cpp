@@ -6,8 +6,12 @@
 #include "simpledb/catalog.h"
 #include "simpledb/storage/page.h"
 #include "simpledb/serializer.h"
+#include "simpledb/storage/b_plus_tree.h"
+#include "simpledb/storage/hash_index.h"
 #include "simpledb/storage/table_heap.h"
+#include "simpledb/table_index.h"
 
+#include <algorithm>
 #include <gtest/gtest.h>
 #include <fstream>
 #include <filesystem>
@@ -58,15 +62,15 @@ class ExecutorTestBase : public ::testing::Test {
         }
     }
 
-    static void AssertCatalogDataEqual(const std::vector<catalog::TableSchema>& expected,
+    static void AssertCatalogDataEqual(const std::vector<catalog::TableSchemaPtr>& expected,
                                        const std::vector<catalog::TableSchema>& actual) {
         ASSERT_EQ(expected.size(), actual.size());
         for (size_t i = 0; i < expected.size(); ++i) {
-            ASSERT_EQ(expected[i].table_name, actual[i].table_name);
-            ASSERT_EQ(expected[i].column_definitions.size(), actual[i].column_definitions.size());
-            for (size_t j = 0; j < expected[i].column_definitions.size(); ++j) {
-                ASSERT_EQ(expected[i].column_definitions[j].column_name, actual[i].column_definitions[j].column_name);
-                ASSERT_EQ(expected[i].column_definitions[j].type, actual[i].column_definitions[j].type);
+            ASSERT_EQ(expected[i]->table_name, actual[i].table_name);
+            ASSERT_EQ(expected[i]->column_definitions.size(), actual[i].column_definitions.size());
+            for (size_t j = 0; j < expected[i]->column_definitions.size(); ++j) {
+                ASSERT_EQ(expected[i]->column_definitions[j].column_name, actual[i].column_definitions[j].column_name);
+                ASSERT_EQ(expected[i]->column_definitions[j].type, actual[i].column_definitions[j].type);
             }
         }
     }
@@ -135,7 +139,9 @@ class ExecutorInsertTablesTest : public ExecutorTestBase {
         std::vector<char> record_blob = page.GetRecord(slot);
 
         // 4. Deserialize and assert
-        std::vector<std::string> actual_values = serializer::deserialize(record_blob);
+        serializer::RecordLayout layout(catalog::get_table_schema("test_table")->column_definitions);
+        std::vector<std::string> actual_values =
+            serializer::deserialize(layout, {record_blob.data(), static_cast<uint16_t>(record_blob.size())});
         ASSERT_EQ(expected_values, actual_values);
     }
 };
@@ -154,12 +160,12 @@ TEST_F(ExecutorCreateTableTest, SuccessfulCreateTable) {
     // Verify the in-memory catalog was updated
     const auto& in_memory_catalog_after_create = catalog::get_all_schemas();
     ASSERT_EQ(in_memory_catalog_after_create.size(), 1);
-    ASSERT_EQ(in_memory_catalog_after_create[0].table_name, "test_table");
-    ASSERT_EQ(in_memory_catalog_after_create[0].column_definitions.size(), 2);
-    ASSERT_EQ(in_memory_catalog_after_create[0].column_definitions[0].column_name, "id");
-    ASSERT_EQ(in_memory_catalog_after_create[0].column_definitions[0].type, command::Datatype::INT);
-    ASSERT_EQ(in_memory_catalog_after_create[0].column_definitions[1].column_name, "name");
-    ASSERT_EQ(in_memory_catalog_after_create[0].column_definitions[1].type, command::Datatype::TEXT);
+    ASSERT_EQ(in_memory_catalog_after_create[0]->table_name, "test_table");
+    ASSERT_EQ(in_memory_catalog_after_create[0]->column_definitions.size(), 2);
+    ASSERT_EQ(in_memory_catalog_after_create[0]->column_definitions[0].column_name, "id");
+    ASSERT_EQ(in_memory_catalog_after_create[0]->column_definitions[0].type, command::Datatype::INT);
+    ASSERT_EQ(in_memory_catalog_after_create[0]->column_definitions[1].column_name, "name");
+    ASSERT_EQ(in_memory_catalog_after_create[0]->column_definitions[1].type, command::Datatype::TEXT);
 
     // Verify the catalog file was created and contains the correct data
     auto loaded_catalog = loadCatalogFromDisk();
@@ -171,6 +177,86 @@ TEST_F(ExecutorCreateTableTest, SuccessfulCreateTable) {
     ASSERT_TRUE(std::filesystem::exists(data_file_path));
 }
 
+TEST_F(ExecutorCreateTableTest, CreateTableWithConstraintsCreatesUniqueIndexes) {
+    command::CreateTableCommand cmd;
+    cmd.table_name = "users";
+    cmd.column_definitions.push_back({"id", command::Datatype::INT, command::ColumnConstraint::PRIMARY_KEY});
+    cmd.column_definitions.push_back({"email", command::Datatype::TEXT, command::ColumnConstraint::UNIQUE});
+    cmd.column_definitions.push_back({"name", command::Datatype::TEXT});
+    ASSERT_EQ(executor::execute_create_table_command(cmd, test_data_dir).get_message(),
+              "OK (Table 'users' created successfully)");
+
+    auto loaded_catalog = loadCatalogFromDisk();
+    ASSERT_TRUE(loaded_catalog.has_value());
+    const catalog::TableSchema& schema = loaded_catalog->at(0);
+    ASSERT_EQ(schema.column_definitions[0].constraint, command::ColumnConstraint::PRIMARY_KEY);
+    ASSERT_EQ(schema.column_definitions[1].constraint, command::ColumnConstraint::UNIQUE);
+    ASSERT_EQ(schema.column_definitions[2].constraint, command::ColumnConstraint::NONE);
+    ASSERT_EQ(schema.indexes.size(), 2);
+    ASSERT_EQ(schema.indexes[0].index_name, "users_pkey");
+    ASSERT_EQ(schema.indexes[0].column_name, "id");
+    ASSERT_TRUE(schema.indexes[0].unique);
+    ASSERT_EQ(schema.indexes[1].index_name, "users_email_key");
+    ASSERT_EQ(schema.indexes[1].column_name, "email");
+    ASSERT_TRUE(schema.indexes[1].unique);
+    ASSERT_TRUE(std::filesystem::exists(table_index::index_file_path(test_data_dir, "users", "users_pkey")));
+    ASSERT_TRUE(std::filesystem::exists(table_index::index_file_path(test_data_dir, "users", "users_email_key")));
+
+    cmd.table_name = "orders";
+    cmd.column_definitions = {{"id", command::Datatype::INT, command::ColumnConstraint::PRIMARY_KEY},
+                              {"number", command::Datatype::INT, command::ColumnConstraint::PRIMARY_KEY}};
+    ASSERT_EQ(executor::execute_create_table_command(cmd, test_data_dir).get_message(),
+              "ERROR: Table orders can't have more than one PRIMARY KEY.");
+    ASSERT_FALSE(catalog::table_exists("orders"));
+}
+
+TEST_F(ExecutorCreateTableTest, InsertsRejectDuplicateValuesOfUniqueColumns) {
+    command::CreateTableCommand create_cmd;
+    create_cmd.table_name = "users";
+    create_cmd.column_definitions.push_back({"id", command::Datatype::INT, command::ColumnConstraint::PRIMARY_KEY});
+    create_cmd.column_definitions.push_back({"email", command::Datatype::TEXT, command::ColumnConstraint::UNIQUE});
+    executor::execute_create_table_command(create_cmd, test_data_dir);
+
+    command::InsertCommand insert_cmd;
+    insert_cmd.table_name = "users";
+    insert_cmd.rows = {{"1", "alice@example.com"}, {"2", "alice@example.org"}};
+    // The emails share their first 16 bytes (and so their index key), but they are different values.
+    ASSERT_EQ(executor::execute_insert_command(insert_cmd, test_data_dir).get_message(), "2 rows inserted.");
+
+    insert_cmd.rows = {{"3", "carol@example.com"}, {"1", "bob@example.com"}};
+    ASSERT_EQ(executor::execute_insert_command(insert_cmd, test_data_dir).get_message(),
+              "ERROR: Duplicate value '1' for column 'id', which must be unique. (row 2)");
+
+    insert_cmd.rows = {{"3", "alice@example.org"}};
+    ASSERT_EQ(executor::execute_insert_command(insert_cmd, test_data_dir).get_message(),
+              "ERROR: Duplicate value 'alice@example.org' for column 'email', which must be unique.");
+
+    // Duplicates within the statement are caught too, and the whole statement is rejected.
+    insert_cmd.rows = {{"3", "carol@example.com"}, {"3", "dave@example.com"}};
+    ASSERT_EQ(executor::execute_insert_command(insert_cmd, test_data_dir).get_message(),
+              "ERROR: Duplicate value '3' for column 'id', which must be unique. (row 2)");
+
+    std::filesystem::path csv_path = test_data_dir / "users.csv";
+    std::ofstream csv_file(csv_path);
+    csv_file << "5,grace@example.com\n6,alice@example.com\n";
+    csv_file.close();
+    command::CopyCommand copy_cmd{"users", csv_path.string()};
+    ASSERT_EQ(executor::execute_copy_command(copy_cmd, test_data_dir).get_message(),
+              "ERROR: Duplicate value 'alice@example.com' for column 'email', which must be unique. 0 row(s) were "
+              "loaded before the error.");
+
+    insert_cmd.rows = {{"3", "carol@example.com"}};
+    ASSERT_EQ(executor::execute_insert_command(insert_cmd, test_data_dir).get_message(), "1 row inserted.");
+    // Only the statements without duplicates inserted anything.
+    simpledb::storage::TableHeap table_heap((test_data_dir / "users.data").string());
+    simpledb::storage::TableHeap::Iterator iterator = table_heap.begin();
+    size_t num_records = 0;
+    while (iterator.next().has_value()) {
+        ++num_records;
+    }
+    ASSERT_EQ(num_records, 3);
+}
+
 TEST_F(ExecutorCreateTableTest, DuplicateTableName) {
     // Create the first table
     command::CreateTableCommand cmd1;
@@ -195,10 +281,10 @@ TEST_F(ExecutorCreateTableTest, DuplicateTableName) {
     // Verify the in-memory catalog was not updated
     const auto& in_memory_catalog = catalog::get_all_schemas();
     ASSERT_EQ(in_memory_catalog.size(), 1);
-    ASSERT_EQ(in_memory_catalog[0].table_name, "duplicate_table_name");
-    ASSERT_EQ(in_memory_catalog[0].column_definitions.size(), 2);
-    ASSERT_EQ(in_memory_catalog[0].column_definitions[0].column_name, "id");
-    ASSERT_EQ(in_memory_catalog[0].column_definitions[1].column_name, "name");
+    ASSERT_EQ(in_memory_catalog[0]->table_name, "duplicate_table_name");
+    ASSERT_EQ(in_memory_catalog[0]->column_definitions.size(), 2);
+    ASSERT_EQ(in_memory_catalog[0]->column_definitions[0].column_name, "id");
+    ASSERT_EQ(in_memory_catalog[0]->column_definitions[1].column_name, "name");
 
     // Verify the catalog file was created and contains the correct data
     auto loaded_catalog = loadCatalogFromDisk();
@@ -232,9 +318,38 @@ TEST_F(ExecutorDropTableTest, SuccessfulDropTable) {
     ASSERT_FALSE(std::filesystem::exists(test_data_dir / "test_table.data"));
 }
 
+TEST_F(ExecutorDropTableTest, DropTableWhileItIsBeingScanned) {
+    command::InsertCommand insert_cmd{"test_table", {}, {{"1", "Alice"}, {"2", "Bob"}}};
+    ASSERT_EQ(executor::execute_insert_command(insert_cmd, test_data_dir).get_message(), "2 rows inserted.");
+
+    command::DropTableCommand cmd = {"test_table"};
+    {
+        // A scan that stopped in the middle of a page keeps it pinned, e.g. while a cursor waits for the caller
+        // to read more rows.
+        simpledb::storage::TableHeap table_heap((test_data_dir / "test_table.data").string());
+        simpledb::storage::TableHeap::Iterator iterator = table_heap.begin();
+        ASSERT_TRUE(iterator.next().has_value());
+
+        results::ExecutionResult result = executor::execute_drop_table_command(cmd, test_data_dir);
+        ASSERT_EQ(result.get_status(), results::ResultStatus::ERROR);
+        ASSERT_NE(result.get_message()->find("is in use"), std::string::npos) << result.get_message().value();
+        ASSERT_TRUE(catalog::table_exists(cmd.table_name));
+        ASSERT_TRUE(std::filesystem::exists(test_data_dir / "test_table.data"));
+
+        // The scan can still read the rest of the table.
+        ASSERT_TRUE(iterator.next().has_value());
+        ASSERT_FALSE(iterator.next().has_value());
+    }
+
+    // Once the scan is done, the table can be dropped.
+    ASSERT_EQ(executor::execute_drop_table_command(cmd, test_data_dir).get_message(),
+              "OK (Table 'test_table' dropped successfully)");
+    ASSERT_FALSE(catalog::table_exists(cmd.table_name));
+}
+
 TEST_F(ExecutorDropTableTest, DropNonExistentTable) {
     // Get state before DROP TABLE
-    const std::vector<catalog::TableSchema>& expected_catalog_state_before_drop = catalog::get_all_schemas();
+    const std::vector<catalog::TableSchemaPtr> expected_catalog_state_before_drop = catalog::get_all_schemas();
 
     // Attempt to drop a non-existent table
     command::DropTableCommand cmd = {"non_existent_table"};
@@ -285,7 +400,7 @@ TEST_F(ExecutorTestBase, SuccessfulShowTablesWhenNoTablesExist) {
 TEST_F(ExecutorInsertTablesTest, SuccessfulInsertIntoTable) {
     command::InsertCommand cmd;
     cmd.table_name = "test_table";
-    cmd.values = {"1", "Alice"};
+    cmd.rows = {{"1", "Alice"}};
 
     results::ExecutionResult result = executor::execute_insert_command(cmd, test_data_dir);
     ASSERT_EQ(result.get_message(), "1 row inserted.");
@@ -295,7 +410,7 @@ TEST_F(ExecutorInsertTablesTest, SuccessfulInsertIntoTable) {
 TEST_F(ExecutorInsertTablesTest, SuccessfulInsertIntoWithColumnsSpecified) {
     command::InsertCommand cmd;
     cmd.table_name = "test_table";
-    cmd.values = {"1", "Alice"};
+    cmd.rows = {{"1", "Alice"}};
     cmd.columns = {"id", "name"};  // Specify columns explicitly
 
     results::ExecutionResult result = executor::execute_insert_command(cmd, test_data_dir);
@@ -306,7 +421,7 @@ TEST_F(ExecutorInsertTablesTest, SuccessfulInsertIntoWithColumnsSpecified) {
 TEST_F(ExecutorInsertTablesTest, SuccessfulInsertIntoWithColumnsReordered) {
     command::InsertCommand cmd;
     cmd.table_name = "test_table";
-    cmd.values = {"Alice", "1"};
+    cmd.rows = {{"Alice", "1"}};
     cmd.columns = {"name", "id"};  // Specify columns explicitly with a different order
 
     results::ExecutionResult result = executor::execute_insert_command(cmd, test_data_dir);
@@ -317,7 +432,7 @@ TEST_F(ExecutorInsertTablesTest, SuccessfulInsertIntoWithColumnsReordered) {
 TEST_F(ExecutorInsertTablesTest, InsertFailsWithTypeMismatchedValues) {
     command::InsertCommand cmd;
     cmd.table_name = "test_table";
-    cmd.values = {"bad value for id", "Alice"};
+    cmd.rows = {{"bad value for id", "Alice"}};
     cmd.columns = {"id", "name"};
 
     results::ExecutionResult result = executor::execute_insert_command(cmd, test_data_dir);
@@ -327,18 +442,44 @@ TEST_F(ExecutorInsertTablesTest, InsertFailsWithTypeMismatchedValues) {
 TEST_F(ExecutorInsertTablesTest, InsertFailsWithNonExistentColumn) {
     command::InsertCommand cmd;
     cmd.table_name = "test_table";
-    cmd.values = {"1", "Alice"};
+    cmd.rows = {{"1", "Alice"}};
     cmd.columns = {"id", "nonexistentcolumn"};  // Specify a column that does not exist
 
     results::ExecutionResult result = executor::execute_insert_command(cmd, test_data_dir);
     ASSERT_EQ(result.get_message(), "ERROR: Column 'nonexistentcolumn' does not exist in table 'test_table'.");
 }
 
+TEST_F(ExecutorInsertTablesTest, SuccessfulMultiRowInsert) {
+    command::InsertCommand cmd;
+    cmd.table_name = "test_table";
+    cmd.columns = {"name", "id"};
+    cmd.rows = {{"Alice", "1"}, {"Bob", "2"}, {"Carol", "3"}};
+
+    results::ExecutionResult result = executor::execute_insert_command(cmd, test_data_dir);
+    ASSERT_EQ(result.get_message(), "3 rows inserted.");
+    AssertRecordForSlot(0, 0, std::vector<std::string>({"1", "Alice"}));
+    AssertRecordForSlot(0, 1, std::vector<std::string>({"2", "Bob"}));
+    AssertRecordForSlot(0, 2, std::vector<std::string>({"3", "Carol"}));
+}
+
+TEST_F(ExecutorInsertTablesTest, MultiRowInsertRejectsWholeStatementOnInvalidRow) {
+    command::InsertCommand cmd;
+    cmd.table_name = "test_table";
+    cmd.rows = {{"1", "Alice"}, {"2"}};
+
+    results::ExecutionResult result = executor::execute_insert_command(cmd, test_data_dir);
+    ASSERT_EQ(result.get_message(),
+              "ERROR: Number of values does not match number of columns in table 'test_table'. (row 2)");
+
+    // Not even the valid first row was inserted.
+    ASSERT_EQ(std::filesystem::file_size(test_data_dir / "test_table.data"), 0);
+}
+
 TEST_F(ExecutorInsertTablesTest, InsertFillsPageAndSpills) {
     // For simplicity, let's estimate the size.
-    // id "0" is 1 byte. name is 100 bytes. 2 length prefixes (2*2=4 bytes).
-    // Total ~ 1 + 100 + 4 = 105 bytes.
-    const size_t record_size_estimate = 105;
+    // 1 byte of null bitmap, 4 bytes for the id, a 4 byte slot for the name and the 100 bytes of the name.
+    // Total ~ 1 + 4 + 4 + 100 = 109 bytes.
+    const size_t record_size_estimate = 109;
     const size_t usable_space = simpledb::storage::PAGE_SIZE - simpledb::storage::Page::HEADER_SIZE;
     const size_t space_per_record = record_size_estimate + sizeof(simpledb::storage::Page::Slot);
     const int num_records_to_fill_page = usable_space / space_per_record;
@@ -349,7 +490,7 @@ TEST_F(ExecutorInsertTablesTest, InsertFillsPageAndSpills) {
 
     // Fill the page
     for (int i = 0; i < num_records_to_fill_page; ++i) {
-        cmd.values = {"0", fixed_name};
+        cmd.rows = {{"0", fixed_name}};
         results::ExecutionResult result = executor::execute_insert_command(cmd, test_data_dir);
         ASSERT_EQ(result.get_message(), "1 row inserted.");
     }
@@ -363,10 +504,165 @@ TEST_F(ExecutorInsertTablesTest, InsertFillsPageAndSpills) {
     // Use a different fixed name filled with 'B's to differentiate it
     const std::string fixed_name_b(100, 'B');  // A 100-byte string
 
-    cmd.values = {"1", fixed_name_b};
+    cmd.rows = {{"1", fixed_name_b}};
     results::ExecutionResult result = executor::execute_insert_command(cmd, test_data_dir);
     ASSERT_EQ(result.get_message(), "1 row inserted.");
 
     // Assert the second page is created and contains the new record
     AssertRecordForSlot(1, 0, std::vector<std::string>({"1", fixed_name_b}));
 }
+
+TEST_F(ExecutorInsertTablesTest, MultiRowInsertSpansPages) {
+    command::InsertCommand cmd;
+    cmd.table_name = "test_table";
+    const std::string fixed_name(100, 'A');
+    for (int i = 0; i < 100; ++i) {
+        cmd.rows.push_back({std::to_string(i), fixed_name});
+    }
+
+    results::ExecutionResult result = executor::execute_insert_command(cmd, test_data_dir);
+    ASSERT_EQ(result.get_message(), "100 rows inserted.");
+
+    // 113 bytes per record and slot, so 36 rows fit on a page.
+    AssertRecordForSlot(0, 0, std::vector<std::string>({"0", fixed_name}));
+    AssertRecordForSlot(1, 0, std::vector<std::string>({"36", fixed_name}));
+    ASSERT_EQ(std::filesystem::file_size(test_data_dir / "test_table.data"), 3 * simpledb::storage::PAGE_SIZE);
+}
+
+TEST_F(ExecutorInsertTablesTest, MultiRowInsertRejectsWholeStatementOnInvalidValue) {
+    command::InsertCommand cmd;
+    cmd.table_name = "test_table";
+    cmd.rows = {{"1", "Alice"}, {"not a number", "Bob"}};
+
+    results::ExecutionResult result = executor::execute_insert_command(cmd, test_data_dir);
+    ASSERT_EQ(result.get_message(), "ERROR: Value 'not a number' for column 'id' is not a valid integer. (row 2)");
+
+    // Not even the valid first row was inserted.
+    ASSERT_EQ(std::filesystem::file_size(test_data_dir / "test_table.data"), 0);
+}
+
+TEST_F(ExecutorInsertTablesTest, SuccessfulCopyFromCsv) {
+    std::filesystem::path csv_path = test_data_dir / "rows.csv";
+    std::ofstream csv_file(csv_path);
+    csv_file << "id,name\n1,Alice\n2,\"Smith, Bob\"\n\n3,Carol\n";
+    csv_file.close();
+
+    command::CopyCommand cmd;
+    cmd.table_name = "test_table";
+    cmd.file_path = csv_path.string();
+    cmd.header = true;
+
+    results::ExecutionResult result = executor::execute_copy_command(cmd, test_data_dir);
+    ASSERT_EQ(result.get_message(), "3 rows inserted.");
+    AssertRecordForSlot(0, 0, std::vector<std::string>({"1", "Alice"}));
+    AssertRecordForSlot(0, 1, std::vector<std::string>({"2", "Smith, Bob"}));
+    AssertRecordForSlot(0, 2, std::vector<std::string>({"3", "Carol"}));
+}
+
+TEST_F(ExecutorInsertTablesTest, CopyReportsLineOfInvalidRow) {
+    std::filesystem::path csv_path = test_data_dir / "rows.csv";
+    std::ofstream csv_file(csv_path);
+    csv_file << "1,Alice\n2,Bob\nthree,Carol\n";
+    csv_file.close();
+
+    command::CopyCommand cmd;
+    cmd.table_name = "test_table";
+    cmd.file_path = csv_path.string();
+
+    results::ExecutionResult result = executor::execute_copy_command(cmd, test_data_dir);
+    ASSERT_EQ(result.get_message(),
+              "ERROR: Value 'three' for column 'id' is not a valid integer. (line 3) 0 row(s) were loaded before the "
+              "error.");
+}
+
+TEST_F(ExecutorInsertTablesTest, CopyFailsForMissingFile) {
+    command::CopyCommand cmd;
+    cmd.table_name = "test_table";
+    cmd.file_path = (test_data_dir / "missing.csv").string();
+
+    results::ExecutionResult result = executor::execute_copy_command(cmd, test_data_dir);
+    ASSERT_EQ(result.get_message(), "ERROR: File '" + cmd.file_path + "' does not exist.");
+}
+
+TEST_F(ExecutorInsertTablesTest, CreateIndexIndexesExistingAndNewRows) {
+    command::InsertCommand insert_cmd;
+    insert_cmd.table_name = "test_table";
+    insert_cmd.rows = {{"3", "Carol"}, {"1", "Alice"}};
+    executor::execute_insert_command(insert_cmd, test_data_dir);
+
+    command::CreateIndexCommand cmd{"test_table_by_id", "test_table", "id"};
+    results::ExecutionResult result = executor::execute_create_index_command(cmd, test_data_dir);
+    ASSERT_EQ(result.get_message(), "OK (Index 'test_table_by_id' created successfully)");
+
+    std::optional<std::vector<catalog::TableSchema>> catalog_data = loadCatalogFromDisk();
+    ASSERT_TRUE(catalog_data.has_value());
+    ASSERT_EQ(catalog_data->at(0).indexes.size(), 1);
+    ASSERT_EQ(catalog_data->at(0).indexes[0].index_name, "test_table_by_id");
+    ASSERT_EQ(catalog_data->at(0).indexes[0].column_name, "id");
+
+    // Rows inserted after the index was created are added to it.
+    insert_cmd.rows = {{"2", "Bob"}};
+    executor::execute_insert_command(insert_cmd, test_data_dir);
+
+    std::filesystem::path index_path = table_index::index_file_path(test_data_dir, "test_table", "test_table_by_id");
+    {
+        simpledb::storage::BPlusTree tree(index_path.string(), table_index::key_size(command::Datatype::INT));
+        simpledb::storage::BPlusTree::Iterator iterator = tree.Begin();
+        std::string_view key;
+        simpledb::storage::RecordId record_id;
+        std::vector<simpledb::storage::RecordId> record_ids;
+        while (iterator.Next(key, record_id)) {
+            record_ids.push_back(record_id);
+        }
+        // In the order of the ids: Alice (slot 1), Bob (slot 2), Carol (slot 0).
+        std::vector<simpledb::storage::RecordId> expected = {{0, 1}, {0, 2}, {0, 0}};
+        ASSERT_EQ(record_ids, expected);
+    }
+
+    // Dropping the table removes its indexes too.
+    executor::execute_drop_table_command({"test_table"}, test_data_dir);
+    ASSERT_FALSE(std::filesystem::exists(index_path));
+}
+
+TEST_F(ExecutorInsertTablesTest, CreateHashIndexIndexesExistingAndNewRows) {
+    command::InsertCommand insert_cmd;
+    insert_cmd.table_name = "test_table";
+    insert_cmd.rows = {{"3", "Carol"}, {"1", "Alice"}};
+    executor::execute_insert_command(insert_cmd, test_data_dir);
+
+    command::CreateIndexCommand cmd{"test_table_by_name", "test_table", "name", command::IndexType::HASH};
+    results::ExecutionResult result = executor::execute_create_index_command(cmd, test_data_dir);
+    ASSERT_EQ(result.get_message(), "OK (Index 'test_table_by_name' created successfully)");
+
+    std::optional<std::vector<catalog::TableSchema>> catalog_data = loadCatalogFromDisk();
+    ASSERT_TRUE(catalog_data.has_value());
+    ASSERT_EQ(catalog_data->at(0).indexes.size(), 1);
+    ASSERT_EQ(catalog_data->at(0).indexes[0].index_type, command::IndexType::HASH);
+
+    insert_cmd.rows = {{"2", "Alice"}};
+    executor::execute_insert_command(insert_cmd, test_data_dir);
+
+    std::filesystem::path index_path = table_index::index_file_path(test_data_dir, "test_table", "test_table_by_name");
+    simpledb::storage::HashIndex index(index_path.string(), table_index::key_size(command::Datatype::TEXT));
+    std::vector<simpledb::storage::RecordId> record_ids;
+    index.Find(table_index::encode_text_key("Alice"), record_ids);
+    std::sort(record_ids.begin(), record_ids.end());
+    std::vector<simpledb::storage::RecordId> expected = {{0, 1}, {0, 2}};
+    ASSERT_EQ(record_ids, expected);
+}
+
+TEST_F(ExecutorInsertTablesTest, CreateIndexFailsForInvalidColumnOrDuplicateName) {
+    command::CreateIndexCommand cmd{"test_table_by_age", "test_table", "age"};
+    ASSERT_EQ(executor::execute_create_index_command(cmd, test_data_dir).get_message(),
+              "ERROR: Column 'age' does not exist in table 'test_table'.");
+
+    cmd = {"test_table_by_id", "missing_table", "id"};
+    ASSERT_EQ(executor::execute_create_index_command(cmd, test_data_dir).get_message(),
+              "ERROR: Table 'missing_table' does not exist.");
+
+    cmd = {"test_table_by_id", "test_table", "id"};
+    ASSERT_EQ(executor::execute_create_index_command(cmd, test_data_dir).get_status(), results::ResultStatus::SUCCESS);
+    cmd.column_name = "name";
+    ASSERT_EQ(executor::execute_create_index_command(cmd, test_data_dir).get_message(),
+              "ERROR: Index test_table_by_id already exists.");
+}
@@ -124,6 +124,20 @@ TEST(AntlrParser, ParsesCreateTable) {
     EXPECT_EQ(cmd->column_definitions[1].type, command::Datatype::TEXT);
 }
 
+TEST(AntlrParser, ParsesCreateTableWithConstraints) {
+    auto result = parser::parse_sql("CREATE TABLE users (id INT PRIMARY KEY, email TEXT unique, name TEXT)");
+    ASSERT_TRUE(result.has_value());
+
+    auto* cmd = std::get_if<command::CreateTableCommand>(&(*result));
+    ASSERT_NE(cmd, nullptr);
+    ASSERT_EQ(cmd->column_definitions.size(), 3);
+    EXPECT_EQ(cmd->column_definitions[0].constraint, command::ColumnConstraint::PRIMARY_KEY);
+    EXPECT_EQ(cmd->column_definitions[1].constraint, command::ColumnConstraint::UNIQUE);
+    EXPECT_EQ(cmd->column_definitions[2].constraint, command::ColumnConstraint::NONE);
+
+    EXPECT_FALSE(parser::parse_sql("CREATE TABLE users (id INT PRIMARY)").has_value());
+}
+
 TEST(AntlrParser, ParsesDropTable) {
     std::string query = "DROP TABLE customers";
     auto result = parser::parse_sql(query);
@@ -135,6 +149,36 @@ TEST(AntlrParser, ParsesDropTable) {
     EXPECT_EQ(cmd->table_name, "customers");
 }
 
+TEST(AntlrParser, ParsesCreateIndex) {
+    auto result = parser::parse_sql("CREATE INDEX customers_by_age ON customers (age);");
+    ASSERT_TRUE(result.has_value());
+
+    auto* cmd = std::get_if<command::CreateIndexCommand>(&(*result));
+    ASSERT_NE(cmd, nullptr);
+    EXPECT_EQ(cmd->index_name, "customers_by_age");
+    EXPECT_EQ(cmd->table_name, "customers");
+    EXPECT_EQ(cmd->column_name, "age");
+    EXPECT_EQ(cmd->index_type, command::IndexType::BTREE);
+}
+
+TEST(AntlrParser, ParsesCreateIndexUsingHash) {
+    auto result = parser::parse_sql("create index customers_by_id on customers using hash (id)");
+    ASSERT_TRUE(result.has_value());
+
+    auto* cmd = std::get_if<command::CreateIndexCommand>(&(*result));
+    ASSERT_NE(cmd, nullptr);
+    EXPECT_EQ(cmd->index_name, "customers_by_id");
+    EXPECT_EQ(cmd->table_name, "customers");
+    EXPECT_EQ(cmd->column_name, "id");
+    EXPECT_EQ(cmd->index_type, command::IndexType::HASH);
+
+    result = parser::parse_sql("CREATE INDEX customers_by_id ON customers USING BTREE (id)");
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(std::get<command::CreateIndexCommand>(*result).index_type, command::IndexType::BTREE);
+
+    ASSERT_FALSE(parser::parse_sql("CREATE INDEX customers_by_id ON customers USING BITMAP (id)").has_value());
+}
+
 TEST(AntlrParser, ParsesShowTables) {
     std::string query = "SHOW TABLES";
     auto result = parser::parse_sql(query);
@@ -153,8 +197,8 @@ TEST(AntlrParser, ParsesInsertWithColumns) {
     EXPECT_EQ(cmd->table_name, "customers");
     std::vector<std::string> expected_cols = {"id", "name"};
     EXPECT_EQ(cmd->columns, expected_cols);
-    std::vector<std::string> expected_vals = {"123", "ACME Corp"};
-    EXPECT_EQ(cmd->values, expected_vals);
+    std::vector<std::vector<std::string>> expected_rows = {{"123", "ACME Corp"}};
+    EXPECT_EQ(cmd->rows, expected_rows);
 }
 
 TEST(AntlrParser, ParsesInsertWithoutColumns) {
@@ -167,8 +211,147 @@ TEST(AntlrParser, ParsesInsertWithoutColumns) {
 
     EXPECT_EQ(cmd->table_name, "customers");
     EXPECT_TRUE(cmd->columns.empty());
-    std::vector<std::string> expected_vals = {"123", "ACME Corp"};
-    EXPECT_EQ(cmd->values, expected_vals);
+    std::vector<std::vector<std::string>> expected_rows = {{"123", "ACME Corp"}};
+    EXPECT_EQ(cmd->rows, expected_rows);
+}
+
+TEST(AntlrParser, ParsesInsertWithMultipleRows) {
+    std::string query = "INSERT INTO customers (id, name) VALUES ('1', 'ACME Corp'), ('2', 'Globex'), ('3', 'Initech')";
+    auto result = parser::parse_sql(query);
+    ASSERT_TRUE(result.has_value());
+
+    auto* cmd = std::get_if<command::InsertCommand>(&(*result));
+    ASSERT_NE(cmd, nullptr);
+
+    EXPECT_EQ(cmd->table_name, "customers");
+    std::vector<std::vector<std::string>> expected_rows = {{"1", "ACME Corp"}, {"2", "Globex"}, {"3", "Initech"}};
+    EXPECT_EQ(cmd->rows, expected_rows);
+}
+
+TEST(AntlrParser, ParsesCopy) {
+    auto result = parser::parse_sql("COPY customers FROM '/tmp/customers.csv' WITH HEADER;");
+    ASSERT_TRUE(result.has_value());
+
+    auto* cmd = std::get_if<command::CopyCommand>(&(*result));
+    ASSERT_NE(cmd, nullptr);
+    EXPECT_EQ(cmd->table_name, "customers");
+    EXPECT_EQ(cmd->file_path, "/tmp/customers.csv");
+    EXPECT_TRUE(cmd->header);
+
+    result = parser::parse_sql("copy customers from 'customers.csv'");
+    ASSERT_TRUE(result.has_value());
+    cmd = std::get_if<command::CopyCommand>(&(*result));
+    ASSERT_NE(cmd, nullptr);
+    EXPECT_FALSE(cmd->header);
+}
+
+TEST(AntlrParser, ParsesNonReservedKeywordsAsNames) {
+    // COPY, WITH and HEADER are only keywords inside a COPY statement.
+    auto result = parser::parse_sql("COPY copy FROM 'copy.csv' WITH HEADER");
+    ASSERT_TRUE(result.has_value());
+    auto* copy_cmd = std::get_if<command::CopyCommand>(&(*result));
+    ASSERT_NE(copy_cmd, nullptr);
+    EXPECT_EQ(copy_cmd->table_name, "copy");
+    EXPECT_TRUE(copy_cmd->header);
+
+    result = parser::parse_sql("CREATE TABLE with (header TEXT, copy INT)");
+    ASSERT_TRUE(result.has_value());
+    auto* create_cmd = std::get_if<command::CreateTableCommand>(&(*result));
+    ASSERT_NE(create_cmd, nullptr);
+    EXPECT_EQ(create_cmd->table_name, "with");
+    ASSERT_EQ(create_cmd->column_definitions.size(), 2);
+    EXPECT_EQ(create_cmd->column_definitions[0].column_name, "header");
+    EXPECT_EQ(create_cmd->column_definitions[1].column_name, "copy");
+
+    result = parser::parse_sql("INSERT INTO with (header, copy) VALUES ('a', 1)");
+    ASSERT_TRUE(result.has_value());
+    auto* insert_cmd = std::get_if<command::InsertCommand>(&(*result));
+    ASSERT_NE(insert_cmd, nullptr);
+    EXPECT_EQ(insert_cmd->columns, std::vector<std::string>({"header", "copy"}));
+
+    result = parser::parse_sql("SELECT header, with.copy FROM with WHERE copy = 1");
+    ASSERT_TRUE(result.has_value());
+    auto* select_cmd = std::get_if<ast::SelectCommand>(&(*result));
+    ASSERT_NE(select_cmd, nullptr);
+    EXPECT_EQ(select_cmd->table_name, "with");
+    EXPECT_EQ(select_cmd->projection, std::vector<std::string>({"header", "with.copy"}));
+    EXPECT_EQ(select_cmd->where_clause->column_name, "copy");
+
+    // INDEX, USING, BTREE and HASH are only keywords inside a CREATE INDEX statement.
+    result = parser::parse_sql("CREATE INDEX index ON hash USING HASH (btree)");
+    ASSERT_TRUE(result.has_value());
+    auto* index_cmd = std::get_if<command::CreateIndexCommand>(&(*result));
+    ASSERT_NE(index_cmd, nullptr);
+    EXPECT_EQ(index_cmd->index_name, "index");
+    EXPECT_EQ(index_cmd->table_name, "hash");
+    EXPECT_EQ(index_cmd->column_name, "btree");
+    EXPECT_EQ(index_cmd->index_type, command::IndexType::HASH);
+
+    result = parser::parse_sql("SELECT using FROM index WHERE hash > 1");
+    ASSERT_TRUE(result.has_value());
+    select_cmd = std::get_if<ast::SelectCommand>(&(*result));
+    ASSERT_NE(select_cmd, nullptr);
+    EXPECT_EQ(select_cmd->table_name, "index");
+    EXPECT_EQ(select_cmd->projection, std::vector<std::string>({"using"}));
+
+    // PRIMARY, KEY and UNIQUE are only keywords after a column's type.
+    result = parser::parse_sql("CREATE TABLE unique (key INT PRIMARY KEY, primary TEXT UNIQUE, unique TEXT)");
+    ASSERT_TRUE(result.has_value());
+    create_cmd = std::get_if<command::CreateTableCommand>(&(*result));
+    ASSERT_NE(create_cmd, nullptr);
+    EXPECT_EQ(create_cmd->table_name, "unique");
+    ASSERT_EQ(create_cmd->column_definitions.size(), 3);
+    EXPECT_EQ(create_cmd->column_definitions[0].column_name, "key");
+    EXPECT_EQ(create_cmd->column_definitions[0].constraint, command::ColumnConstraint::PRIMARY_KEY);
+    EXPECT_EQ(create_cmd->column_definitions[1].column_name, "primary");
+    EXPECT_EQ(create_cmd->column_definitions[1].constraint, command::ColumnConstraint::UNIQUE);
+    EXPECT_EQ(create_cmd->column_definitions[2].column_name, "unique");
+    EXPECT_EQ(create_cmd->column_definitions[2].constraint, command::ColumnConstraint::NONE);
+
+    // LIMIT and OFFSET are only keywords at the end of a SELECT.
+    result = parser::parse_sql("SELECT limit, offset FROM offset WHERE limit > 5 LIMIT 10 OFFSET 20");
+    ASSERT_TRUE(result.has_value());
+    select_cmd = std::get_if<ast::SelectCommand>(&(*result));
+    ASSERT_NE(select_cmd, nullptr);
+    EXPECT_EQ(select_cmd->table_name, "offset");
+    EXPECT_EQ(select_cmd->projection, std::vector<std::string>({"limit", "offset"}));
+    EXPECT_EQ(select_cmd->where_clause->column_name, "limit");
+    ASSERT_TRUE(select_cmd->limit_clause.has_value());
+    EXPECT_EQ(select_cmd->limit_clause->limit, 10);
+    EXPECT_EQ(select_cmd->limit_clause->offset, 20);
+
+    // Aggregate function names are only keywords right before a parenthesis.
+    result = parser::parse_sql("SELECT count, SUM(sum), COUNT(avg) FROM min WHERE max = 3 GROUP BY count");
+    ASSERT_TRUE(result.has_value());
+    select_cmd = std::get_if<ast::SelectCommand>(&(*result));
+    ASSERT_NE(select_cmd, nullptr);
+    EXPECT_EQ(select_cmd->table_name, "min");
+    ASSERT_EQ(select_cmd->select_items.size(), 3);
+    EXPECT_EQ(select_cmd->select_items[0].column_name, "count");
+    EXPECT_FALSE(select_cmd->select_items[0].aggregate.has_value());
+    EXPECT_EQ(select_cmd->select_items[1].column_name, "sum");
+    EXPECT_EQ(select_cmd->select_items[1].aggregate, ast::AggregateFunction::SUM);
+    EXPECT_EQ(select_cmd->select_items[2].column_name, "avg");
+    EXPECT_EQ(select_cmd->select_items[2].aggregate, ast::AggregateFunction::COUNT);
+    EXPECT_EQ(select_cmd->where_clause->column_name, "max");
+    EXPECT_EQ(select_cmd->group_by, std::vector<std::string>({"count"}));
+
+    // ASC and DESC are only keywords after an ORDER BY key.
+    result = parser::parse_sql("SELECT asc FROM desc ORDER BY asc DESC, desc");
+    ASSERT_TRUE(result.has_value());
+    select_cmd = std::get_if<ast::SelectCommand>(&(*result));
+    ASSERT_NE(select_cmd, nullptr);
+    EXPECT_EQ(select_cmd->table_name, "desc");
+    ASSERT_EQ(select_cmd->order_by.size(), 2);
+    EXPECT_EQ(select_cmd->order_by[0].key.column_name, "asc");
+    EXPECT_TRUE(select_cmd->order_by[0].descending);
+    EXPECT_EQ(select_cmd->order_by[1].key.column_name, "desc");
+    EXPECT_FALSE(select_cmd->order_by[1].descending);
+
+    // Keywords that structure a statement stay reserved.
+    EXPECT_FALSE(parser::parse_sql("CREATE TABLE from (id INT)").has_value());
+    EXPECT_FALSE(parser::parse_sql("SELECT select FROM users").has_value());
+    EXPECT_FALSE(parser::parse_sql("SELECT * FROM order").has_value());
 }
 
 TEST(AntlrParser, HandlesWhitespaceAndCase) {
@@ -262,6 +445,133 @@ TEST(AntlrParser, ParsesSelectWithDoubleQuotedColumnInWhere) {
     EXPECT_EQ(where.column_name, "user id");
 }
 
+TEST(AntlrParser, ParsesSelectWithLimitAndOffset) {
+    auto result = parser::parse_sql("SELECT name FROM users WHERE id > 5 LIMIT 10 OFFSET 20;");
+    ASSERT_TRUE(result.has_value());
+    auto* cmd = std::get_if<ast::SelectCommand>(&(*result));
+    ASSERT_NE(cmd, nullptr);
+    ASSERT_TRUE(cmd->where_clause.has_value());
+    ASSERT_TRUE(cmd->limit_clause.has_value());
+    EXPECT_EQ(cmd->limit_clause->limit, 10);
+    EXPECT_EQ(cmd->limit_clause->offset, 20);
+
+    result = parser::parse_sql("select * from users limit 0");
+    ASSERT_TRUE(result.has_value());
+    cmd = std::get_if<ast::SelectCommand>(&(*result));
+    ASSERT_NE(cmd, nullptr);
+    ASSERT_TRUE(cmd->limit_clause.has_value());
+    EXPECT_EQ(cmd->limit_clause->limit, 0);
+    EXPECT_EQ(cmd->limit_clause->offset, 0);
+
+    EXPECT_FALSE(parser::parse_sql("SELECT * FROM users LIMIT").has_value());
+    EXPECT_FALSE(parser::parse_sql("SELECT * FROM users LIMIT 'ten'").has_value());
+    EXPECT_FALSE(parser::parse_sql("SELECT * FROM users OFFSET 5").has_value());
+    EXPECT_THROW(parser::parse_sql("SELECT * FROM users LIMIT 99999999999999999999999"), std::runtime_error);
+}
+
+TEST(AntlrParser, ParsesSelectWithAggregatesAndGroupBy) {
+    auto result = parser::parse_sql("SELECT dept, count(*), SUM(salary), Avg(\"base pay\") FROM staff GROUP BY dept");
+    ASSERT_TRUE(result.has_value());
+    auto* cmd = std::get_if<ast::SelectCommand>(&(*result));
+    ASSERT_NE(cmd, nullptr);
+    EXPECT_TRUE(cmd->projection.empty());
+    ASSERT_EQ(cmd->select_items.size(), 4);
+    EXPECT_EQ(cmd->select_items[0].column_name, "dept");
+    EXPECT_FALSE(cmd->select_items[0].aggregate.has_value());
+    EXPECT_EQ(cmd->select_items[1].column_name, "");
+    EXPECT_EQ(cmd->select_items[1].aggregate, ast::AggregateFunction::COUNT);
+    EXPECT_EQ(cmd->select_items[2].column_name, "salary");
+    EXPECT_EQ(cmd->select_items[2].aggregate, ast::AggregateFunction::SUM);
+    EXPECT_EQ(cmd->select_items[3].column_name, "base pay");
+    EXPECT_EQ(cmd->select_items[3].aggregate, ast::AggregateFunction::AVG);
+    EXPECT_EQ(cmd->group_by, std::vector<std::string>({"dept"}));
+    EXPECT_EQ(ast::select_item_name(cmd->select_items[1]), "COUNT(*)");
+    EXPECT_EQ(ast::select_item_name(cmd->select_items[2]), "SUM(salary)");
+
+    // Aggregates without GROUP BY, and with a WHERE clause and a LIMIT.
+    result = parser::parse_sql("SELECT MIN(age), MAX(age), COUNT(name) FROM users WHERE age > 5 LIMIT 1");
+    ASSERT_TRUE(result.has_value());
+    cmd = std::get_if<ast::SelectCommand>(&(*result));
+    ASSERT_NE(cmd, nullptr);
+    ASSERT_EQ(cmd->select_items.size(), 3);
+    EXPECT_TRUE(cmd->group_by.empty());
+    EXPECT_TRUE(cmd->where_clause.has_value());
+    EXPECT_TRUE(cmd->limit_clause.has_value());
+
+    // Plain column lists still fill the projection.
+    result = parser::parse_sql("SELECT name, age FROM users");
+    ASSERT_TRUE(result.has_value());
+    cmd = std::get_if<ast::SelectCommand>(&(*result));
+    ASSERT_NE(cmd, nullptr);
+    EXPECT_EQ(cmd->projection, std::vector<std::string>({"name", "age"}));
+    EXPECT_TRUE(cmd->select_items.empty());
+
+    EXPECT_FALSE(parser::parse_sql("SELECT SUM(*) FROM users").has_value());
+    EXPECT_FALSE(parser::parse_sql("SELECT COUNT() FROM users").has_value());
+    EXPECT_FALSE(parser::parse_sql("SELECT COUNT(*) FROM users GROUP BY").has_value());
+    EXPECT_THROW(parser::parse_sql("SELECT * FROM users GROUP BY name"), std::runtime_error);
+}
+
+TEST(AntlrParser, ParsesSelectWithOrderBy) {
+    auto result = parser::parse_sql("SELECT name FROM users WHERE age > 5 ORDER BY age DESC, name ASC, id LIMIT 3");
+    ASSERT_TRUE(result.has_value());
+    auto* cmd = std::get_if<ast::SelectCommand>(&(*result));
+    ASSERT_NE(cmd, nullptr);
+    ASSERT_EQ(cmd->order_by.size(), 3);
+    EXPECT_EQ(cmd->order_by[0].key.column_name, "age");
+    EXPECT_TRUE(cmd->order_by[0].descending);
+    EXPECT_EQ(cmd->order_by[1].key.column_name, "name");
+    EXPECT_FALSE(cmd->order_by[1].descending);
+    EXPECT_EQ(cmd->order_by[2].key.column_name, "id");
+    EXPECT_FALSE(cmd->order_by[2].descending);
+    EXPECT_TRUE(cmd->limit_clause.has_value());
+
+    // Ordering by an aggregate.
+    result = parser::parse_sql("SELECT dept, COUNT(*) FROM staff GROUP BY dept ORDER BY count(*) desc");
+    ASSERT_TRUE(result.has_value());
+    cmd = std::get_if<ast::SelectCommand>(&(*result));
+    ASSERT_NE(cmd, nullptr);
+    ASSERT_EQ(cmd->order_by.size(), 1);
+    EXPECT_EQ(cmd->order_by[0].key.aggregate, ast::AggregateFunction::COUNT);
+    EXPECT_TRUE(cmd->order_by[0].descending);
+
+    EXPECT_FALSE(parser::parse_sql("SELECT * FROM users ORDER BY").has_value());
+    EXPECT_FALSE(parser::parse_sql("SELECT * FROM users ORDER age").has_value());
+    EXPECT_FALSE(parser::parse_sql("SELECT * FROM users LIMIT 5 ORDER BY age").has_value());
+}
+
+TEST(AntlrParser, ParsesSelectWithJoin) {
+    auto result = parser::parse_sql(
+        "SELECT users.name, total FROM users JOIN orders ON users.id = orders.user_id WHERE orders.total > 10");
+    ASSERT_TRUE(result.has_value());
+    auto* cmd = std::get_if<ast::SelectCommand>(&(*result));
+    ASSERT_NE(cmd, nullptr);
+    EXPECT_EQ(cmd->table_name, "users");
+    ASSERT_TRUE(cmd->join_clause.has_value());
+    EXPECT_EQ(cmd->join_clause->table_name, "orders");
+    EXPECT_EQ(cmd->join_clause->left_column, "users.id");
+    EXPECT_EQ(cmd->join_clause->right_column, "orders.user_id");
+    EXPECT_EQ(cmd->projection, std::vector<std::string>({"users.name", "total"}));
+    ASSERT_TRUE(cmd->where_clause.has_value());
+    EXPECT_EQ(cmd->where_clause->column_name, "orders.total");
+
+    // INNER JOIN, with qualified names in aggregates, GROUP BY and ORDER BY.
+    result = parser::parse_sql(
+        "SELECT users.city, SUM(orders.total) FROM users INNER JOIN orders ON id = user_id GROUP BY users.city "
+        "ORDER BY users.city");
+    ASSERT_TRUE(result.has_value());
+    cmd = std::get_if<ast::SelectCommand>(&(*result));
+    ASSERT_NE(cmd, nullptr);
+    ASSERT_TRUE(cmd->join_clause.has_value());
+    EXPECT_EQ(cmd->select_items[1].column_name, "orders.total");
+    EXPECT_EQ(cmd->group_by, std::vector<std::string>({"users.city"}));
+    EXPECT_EQ(cmd->order_by[0].key.column_name, "users.city");
+
+    EXPECT_FALSE(parser::parse_sql("SELECT * FROM users JOIN orders").has_value());
+    EXPECT_FALSE(parser::parse_sql("SELECT * FROM users JOIN orders ON users.id > orders.user_id").has_value());
+    EXPECT_FALSE(parser::parse_sql("SELECT * FROM users JOIN ON users.id = orders.user_id").has_value());
+}
+
 TEST(AntlrParser, ReturnsNulloptOnInvalidSyntax) {
     // --- Completely Unknown Commands ---
     EXPECT_FALSE(parser::parse_sql("ALTER TABLE my_table ADD COLUMN new_col INT").has_value());
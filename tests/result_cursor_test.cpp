@@ -0,0 +1,115 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/result_cursor.h"
+#include "simpledb/ast/ast.h"
+#include "simpledb/catalog.h"
+#include "simpledb/command.h"
+#include "simpledb/executor.h"
+#include "simpledb/planner.h"
+#include "simpledb/storage/buffer_pool_manager.h"
+
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using simpledb::storage::BufferPoolManager;
+using simpledb::storage::BufferPoolStats;
+
+class ResultCursorTest : public ::testing::Test {
+   protected:
+    static constexpr int NUM_ROWS = 20000;
+    std::filesystem::path test_data_dir;
+
+    void SetUp() override {
+        // Create a unique temporary file path for each test.
+        const ::testing::TestInfo* const test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+        test_data_dir = std::filesystem::temp_directory_path().string() + "/simpledb_" + test_info->test_suite_name() +
+                        "_" + test_info->name();
+        if (std::filesystem::exists(test_data_dir)) {
+            std::filesystem::remove_all(test_data_dir);
+        }
+        std::filesystem::create_directories(test_data_dir);
+
+        catalog::initialize(test_data_dir);
+
+        command::CreateTableCommand create_cmd;
+        create_cmd.table_name = "events";
+        create_cmd.column_definitions.push_back({"id", command::Datatype::INT});
+        create_cmd.column_definitions.push_back({"payload", command::Datatype::TEXT});
+        executor::execute_create_table_command(create_cmd, test_data_dir);
+
+        command::InsertCommand load_cmd;
+        load_cmd.table_name = "events";
+        for (int i = 0; i < NUM_ROWS; ++i) {
+            load_cmd.rows.push_back({std::to_string(i), "a_reasonably_long_event_payload_" + std::to_string(i)});
+        }
+        executor::execute_insert_command(load_cmd, test_data_dir);
+    }
+
+    void TearDown() override {
+        if (std::filesystem::exists(test_data_dir)) {
+            std::filesystem::remove_all(test_data_dir);
+        }
+    }
+
+    results::ResultCursor open_cursor(std::vector<std::string> projection) {
+        ast::SelectCommand select_cmd;
+        select_cmd.table_name = "events";
+        select_cmd.projection = projection;
+        return results::ResultCursor(std::move(projection), planner::plan_select(select_cmd, test_data_dir));
+    }
+};
+
+TEST_F(ResultCursorTest, ReadsRowsOneAtATimeAndInBatches) {
+    results::ResultCursor cursor = open_cursor({"id"});
+    ASSERT_EQ(cursor.headers(), std::vector<std::string>({"id"}));
+
+    ASSERT_EQ(cursor.next(), row::Row({"0"}));
+    ASSERT_EQ(cursor.next(), row::Row({"1"}));
+
+    std::vector<row::Row> rows;
+    ASSERT_TRUE(cursor.next_rows(rows, 100));
+    ASSERT_EQ(rows.size(), 100);
+    ASSERT_EQ(rows.front(), row::Row({"2"}));
+    ASSERT_EQ(rows.back(), row::Row({"101"}));
+    ASSERT_EQ(cursor.num_rows_read(), 102);
+
+    // The rest of the rows, then nothing more.
+    size_t num_rows = 0;
+    while (cursor.next_rows(rows, 3000)) {
+        num_rows += rows.size();
+    }
+    ASSERT_EQ(num_rows, NUM_ROWS - 102);
+    ASSERT_TRUE(rows.empty());
+    ASSERT_EQ(cursor.next(), std::nullopt);
+    ASSERT_EQ(cursor.num_rows_read(), NUM_ROWS);
+}
+
+TEST_F(ResultCursorTest, CollectsRemainingRowsIntoAResultSet) {
+    results::ResultCursor cursor = open_cursor({"payload", "id"});
+    for (int i = 0; i < 5; ++i) {
+        cursor.next();
+    }
+
+    results::ResultSet result_set = cursor.to_result_set();
+    ASSERT_EQ(result_set.headers, std::vector<std::string>({"payload", "id"}));
+    ASSERT_EQ(result_set.rows.size(), NUM_ROWS - 5);
+    ASSERT_EQ(result_set.rows.front(), row::Row({"a_reasonably_long_event_payload_5", "5"}));
+    ASSERT_TRUE(cursor.to_result_set().rows.empty());
+}
+
+TEST_F(ResultCursorTest, FirstRowDoesNotReadTheWholeTable) {
+    BufferPoolManager::Instance().ResetStats();
+    results::ResultCursor cursor = open_cursor({"id"});
+    ASSERT_EQ(cursor.next(), row::Row({"0"}));
+    BufferPoolStats first_row_stats = BufferPoolManager::Instance().GetStats();
+
+    cursor.to_result_set();
+    BufferPoolStats all_rows_stats = BufferPoolManager::Instance().GetStats();
+
+    // Only the pages holding the first batch of rows were read for the first row.
+    ASSERT_LT((first_row_stats.hits + first_row_stats.misses) * 10, all_rows_stats.hits + all_rows_stats.misses);
+}
@@ -38,8 +38,8 @@ class SelectIntegrationTest : public ::testing::Test {
         // Insert some sample data into the table.
         row::Row row1 = {"1", "Alice", "alice@example.com"};
         row::Row row2 = {"2", "Bob", "bob@example.com"};
-        executor::execute_insert_command({"test_table", {"id", "name", "email"}, row1}, test_data_dir);
-        executor::execute_insert_command({"test_table", {"id", "name", "email"}, row2}, test_data_dir);
+        executor::execute_insert_command({"test_table", {"id", "name", "email"}, {row1}}, test_data_dir);
+        executor::execute_insert_command({"test_table", {"id", "name", "email"}, {row2}}, test_data_dir);
     }
 
     void TearDown() override {
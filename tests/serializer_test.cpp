@@ -0,0 +1,70 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/serializer.h"
+
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+class SerializerTest : public ::testing::Test {
+   protected:
+    serializer::RecordLayout layout{{{"id", command::Datatype::INT},
+                                     {"name", command::Datatype::TEXT},
+                                     {"age", command::Datatype::INT},
+                                     {"email", command::Datatype::TEXT}}};
+
+    static simpledb::storage::RecordView view_of(const std::vector<char>& record_data) {
+        return {record_data.data(), static_cast<uint16_t>(record_data.size())};
+    }
+};
+
+TEST_F(SerializerTest, LayoutPlacesSlotsAfterNullBitmap) {
+    ASSERT_EQ(layout.null_bitmap_size(), 1);
+    ASSERT_EQ(layout.slot_offset(0), 1);
+    ASSERT_EQ(layout.slot_offset(1), 5);
+    ASSERT_EQ(layout.slot_offset(2), 9);
+    ASSERT_EQ(layout.slot_offset(3), 13);
+    ASSERT_EQ(layout.fixed_size(), 17);
+}
+
+TEST_F(SerializerTest, RoundTrip) {
+    std::vector<std::string> values = {"-42", "Alice", "2147483647", ""};
+    std::vector<char> record_data = serializer::serialize(layout, values);
+
+    // Fixed part plus the TEXT data, the ints take 4 bytes no matter how many digits they have.
+    ASSERT_EQ(record_data.size(), layout.fixed_size() + 5);
+    ASSERT_EQ(serializer::deserialize(layout, view_of(record_data)), values);
+}
+
+TEST_F(SerializerTest, ReadsAnyColumnDirectly) {
+    std::vector<char> record_data = serializer::serialize(layout, {"7", "Bob", "30", "bob@db.com"});
+    simpledb::storage::RecordView record = view_of(record_data);
+
+    ASSERT_EQ(serializer::read_int(layout, record, 2), 30);
+    ASSERT_EQ(serializer::read_text(layout, record, 3), "bob@db.com");
+    ASSERT_EQ(serializer::read_int(layout, record, 0), 7);
+    ASSERT_EQ(serializer::read_text(layout, record, 1), "Bob");
+    ASSERT_FALSE(serializer::is_null(layout, record, 1));
+
+    // Ints are stored little-endian.
+    ASSERT_EQ(record_data[layout.slot_offset(2)], 30);
+    ASSERT_EQ(record_data[layout.slot_offset(2) + 3], 0);
+}
+
+TEST_F(SerializerTest, DeserializesRequestedColumnsOnly) {
+    std::vector<char> record_data = serializer::serialize(layout, {"7", "Bob", "30", "bob@db.com"});
+
+    // Values come back in the requested order, and the strings of the output vector are reused.
+    std::vector<std::string> values = {"stale", "stale", "stale", "stale"};
+    serializer::deserialize(layout, view_of(record_data), {3, 0}, values);
+    ASSERT_EQ(values, std::vector<std::string>({"bob@db.com", "7"}));
+}
+
+TEST_F(SerializerTest, RejectsInvalidRows) {
+    ASSERT_THROW(serializer::serialize(layout, {"1", "Alice"}), std::invalid_argument);
+    ASSERT_THROW(serializer::serialize(layout, {"12abc", "Alice", "1", "a@b.c"}), std::invalid_argument);
+    ASSERT_THROW(serializer::serialize(layout, {"1", "Alice", "99999999999", "a@b.c"}), std::invalid_argument);
+}
@@ -0,0 +1,163 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/storage/b_plus_tree.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+using simpledb::storage::BPlusTree;
+using simpledb::storage::IndexEntry;
+using simpledb::storage::RecordId;
+
+namespace {
+    constexpr uint16_t KEY_SIZE = 8;
+
+    // Zero-padded decimal keys, so that the byte order of the keys matches the order of the numbers.
+    std::string make_key(int value) {
+        char buffer[KEY_SIZE + 1];
+        snprintf(buffer, sizeof(buffer), "%08d", value);
+        return std::string(buffer, KEY_SIZE);
+    }
+
+    // Collects the entries of the tree from the iterator's position to the end.
+    std::vector<IndexEntry> collect(BPlusTree::Iterator iterator) {
+        std::vector<IndexEntry> entries;
+        std::string_view key;
+        RecordId record_id;
+        while (iterator.Next(key, record_id)) {
+            entries.push_back({std::string(key), record_id});
+        }
+        return entries;
+    }
+
+    bool entry_less(const IndexEntry& lhs, const IndexEntry& rhs) {
+        return lhs.key != rhs.key ? lhs.key < rhs.key : lhs.record_id < rhs.record_id;
+    }
+}  // namespace
+
+class BPlusTreeTest : public ::testing::Test {
+   protected:
+    std::string test_file_path;
+
+    void SetUp() override {
+        // Create a unique temporary file path for each test.
+        const ::testing::TestInfo* const test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+        test_file_path = std::filesystem::temp_directory_path().string() + "/simpledb_b_plus_tree_" +
+                         test_info->test_suite_name() + "_" + test_info->name() + ".index";
+    }
+
+    void TearDown() override { std::filesystem::remove(test_file_path); }
+};
+
+TEST_F(BPlusTreeTest, EmptyTree) {
+    BPlusTree tree(test_file_path, KEY_SIZE);
+    ASSERT_EQ(tree.GetHeight(), 1);
+    ASSERT_TRUE(collect(tree.Begin()).empty());
+    ASSERT_TRUE(collect(tree.Seek(make_key(5))).empty());
+}
+
+TEST_F(BPlusTreeTest, InsertsInRandomOrderAndSplits) {
+    std::vector<IndexEntry> expected;
+    for (int i = 0; i < 20000; ++i) {
+        expected.push_back({make_key(i), RecordId{static_cast<uint32_t>(i / 100), static_cast<uint16_t>(i % 100)}});
+    }
+    std::vector<IndexEntry> shuffled = expected;
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(42));
+
+    BPlusTree tree(test_file_path, KEY_SIZE);
+    for (const IndexEntry& entry : shuffled) {
+        tree.Insert(entry.key, entry.record_id);
+    }
+    // Inserting an entry twice doesn't add it again.
+    tree.Insert(expected[7].key, expected[7].record_id);
+
+    // 20000 entries need hundreds of leaves, and therefore inner nodes.
+    ASSERT_GE(tree.GetHeight(), 2);
+
+    std::vector<IndexEntry> entries = collect(tree.Begin());
+    ASSERT_EQ(entries.size(), expected.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        ASSERT_EQ(entries[i].key, expected[i].key);
+        ASSERT_EQ(entries[i].record_id, expected[i].record_id);
+    }
+}
+
+TEST_F(BPlusTreeTest, SeekFindsAllDuplicatesOfAKey) {
+    BPlusTree tree(test_file_path, KEY_SIZE);
+    // Many records per key, so the duplicates of a key span several leaves.
+    for (uint16_t slot = 0; slot < 1000; ++slot) {
+        for (int key = 0; key < 5; ++key) {
+            tree.Insert(make_key(key * 10), RecordId{static_cast<uint32_t>(key), slot});
+        }
+    }
+
+    // Seeking to a key that isn't in the tree lands on the next larger key.
+    for (std::string seek_key : {make_key(20), make_key(15)}) {
+        BPlusTree::Iterator iterator = tree.Seek(seek_key);
+        std::string_view key;
+        RecordId record_id;
+        for (uint16_t slot = 0; slot < 1000; ++slot) {
+            ASSERT_TRUE(iterator.Next(key, record_id));
+            ASSERT_EQ(key, make_key(20));
+            ASSERT_EQ(record_id, (RecordId{2, slot}));
+        }
+        ASSERT_TRUE(iterator.Next(key, record_id));
+        ASSERT_EQ(key, make_key(30));
+    }
+
+    ASSERT_TRUE(collect(tree.Seek(make_key(41))).empty());
+    ASSERT_EQ(collect(tree.Seek(make_key(0))).size(), 5000);
+}
+
+TEST_F(BPlusTreeTest, BulkLoadMatchesInserts) {
+    std::vector<IndexEntry> entries;
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<int> distribution(0, 999);
+    for (uint32_t i = 0; i < 50000; ++i) {
+        entries.push_back({make_key(distribution(generator)), RecordId{i / 64, static_cast<uint16_t>(i % 64)}});
+    }
+
+    BPlusTree tree(test_file_path, KEY_SIZE);
+    tree.BulkLoad(entries);
+    ASSERT_GE(tree.GetHeight(), 2);
+
+    std::sort(entries.begin(), entries.end(), entry_less);
+    std::vector<IndexEntry> loaded = collect(tree.Begin());
+    ASSERT_EQ(loaded.size(), entries.size());
+    for (size_t i = 0; i < loaded.size(); ++i) {
+        ASSERT_EQ(loaded[i].key, entries[i].key);
+        ASSERT_EQ(loaded[i].record_id, entries[i].record_id);
+    }
+
+    // The bulk loaded tree takes inserts like any other.
+    tree.Insert(make_key(500), RecordId{100000, 0});
+    std::vector<IndexEntry> from_500 = collect(tree.Seek(make_key(500)));
+    size_t expected_from_500 =
+        entries.end() - std::lower_bound(entries.begin(), entries.end(), IndexEntry{make_key(500), {}}, entry_less);
+    ASSERT_EQ(from_500.size(), expected_from_500 + 1);
+
+    ASSERT_THROW(tree.BulkLoad(entries), std::runtime_error);
+}
+
+TEST_F(BPlusTreeTest, ReopensPersistedTree) {
+    {
+        BPlusTree tree(test_file_path, KEY_SIZE);
+        for (int i = 0; i < 3000; ++i) {
+            tree.Insert(make_key(i), RecordId{static_cast<uint32_t>(i), 0});
+        }
+    }
+
+    BPlusTree reopened(test_file_path, KEY_SIZE);
+    std::vector<IndexEntry> entries = collect(reopened.Seek(make_key(2990)));
+    ASSERT_EQ(entries.size(), 10);
+    ASSERT_EQ(entries.front().record_id, (RecordId{2990, 0}));
+
+    ASSERT_THROW(BPlusTree(test_file_path, KEY_SIZE + 1), std::runtime_error);
+}
@@ -0,0 +1,219 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/storage/buffer_pool_manager.h"
+#include "simpledb/storage/page.h"
+#include "simpledb/storage/replacer.h"
+#include "simpledb/storage/table_heap.h"
+
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <sys/resource.h>
+#include <vector>
+
+class BufferPoolManagerTest : public ::testing::Test {
+   protected:
+    std::string test_file_path;
+
+    void SetUp() override {
+        // Create a unique temporary file path for each test.
+        const ::testing::TestInfo* const test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+        test_file_path = std::filesystem::temp_directory_path().string() + "/simpledb_buffer_pool_" +
+                         test_info->test_suite_name() + "_" + test_info->name() + ".data";
+
+        // Write a few pages directly to the file, each with the page number stored as the version.
+        std::ofstream file(test_file_path, std::ios::binary);
+        for (uint8_t i = 0; i < NUM_PAGES; ++i) {
+            simpledb::storage::Page page;
+            page.Initialize();
+            page.SetVersion(i);
+            file.write(page.GetData(), simpledb::storage::PAGE_SIZE);
+        }
+    }
+
+    void TearDown() override { std::filesystem::remove(test_file_path); }
+
+    static constexpr uint8_t NUM_PAGES = 5;
+};
+
+TEST(LruReplacerTest, EvictsLeastRecentlyUsedFrame) {
+    simpledb::storage::LruReplacer replacer;
+    for (simpledb::storage::FrameId frame_id = 0; frame_id < 3; ++frame_id) {
+        replacer.RecordAccess(frame_id);
+        replacer.SetEvictable(frame_id, true);
+    }
+    ASSERT_EQ(replacer.Size(), 3);
+
+    // Frame 0 becomes the most recently used frame.
+    replacer.RecordAccess(0);
+    // Frame 1 is pinned, so it can't be evicted.
+    replacer.SetEvictable(1, false);
+
+    ASSERT_EQ(replacer.Evict(), 2);
+    ASSERT_EQ(replacer.Evict(), 0);
+    ASSERT_FALSE(replacer.Evict().has_value());
+}
+
+TEST(ClockReplacerTest, GivesAccessedFramesASecondChance) {
+    simpledb::storage::ClockReplacer replacer(3);
+    for (simpledb::storage::FrameId frame_id = 0; frame_id < 3; ++frame_id) {
+        replacer.SetEvictable(frame_id, true);
+    }
+    replacer.RecordAccess(0);
+    ASSERT_EQ(replacer.Size(), 3);
+
+    // Frame 0 has its reference bit set, so the hand skips it the first time around.
+    ASSERT_EQ(replacer.Evict(), 1);
+    ASSERT_EQ(replacer.Evict(), 2);
+    ASSERT_EQ(replacer.Evict(), 0);
+    ASSERT_FALSE(replacer.Evict().has_value());
+}
+
+TEST_F(BufferPoolManagerTest, FetchCountsHitsAndMisses) {
+    simpledb::storage::BufferPoolManager pool(4, std::make_unique<simpledb::storage::LruReplacer>());
+    simpledb::storage::FileId file_id = pool.OpenFile(test_file_path);
+
+    simpledb::storage::Page* page = pool.FetchPage(file_id, 2);
+    ASSERT_EQ(page->GetVersion(), 2);
+    ASSERT_TRUE(pool.UnpinPage(file_id, 2, false));
+
+    page = pool.FetchPage(file_id, 2);
+    ASSERT_EQ(page->GetVersion(), 2);
+    ASSERT_TRUE(pool.UnpinPage(file_id, 2, false));
+
+    simpledb::storage::BufferPoolStats stats = pool.GetStats();
+    ASSERT_EQ(stats.misses, 1);
+    ASSERT_EQ(stats.hits, 1);
+    ASSERT_EQ(stats.evictions, 0);
+
+    // Unpinning a page that is no longer pinned is rejected.
+    ASSERT_FALSE(pool.UnpinPage(file_id, 2, false));
+}
+
+TEST_F(BufferPoolManagerTest, EvictionWritesBackDirtyPages) {
+    simpledb::storage::BufferPoolManager pool(2, std::make_unique<simpledb::storage::LruReplacer>());
+    simpledb::storage::FileId file_id = pool.OpenFile(test_file_path);
+
+    simpledb::storage::Page* page = pool.FetchPage(file_id, 0);
+    page->SetVersion(42);
+    pool.UnpinPage(file_id, 0, true);
+
+    // Page 0 is the least recently used page once pages 1 and 2 are fetched.
+    for (simpledb::storage::PageId page_id = 1; page_id <= 2; ++page_id) {
+        pool.FetchPage(file_id, page_id);
+        pool.UnpinPage(file_id, page_id, false);
+    }
+    ASSERT_EQ(pool.GetStats().evictions, 1);
+    ASSERT_EQ(pool.GetStats().writebacks, 1);
+
+    // Read the file directly to check that the modification reached the disk.
+    std::ifstream file(test_file_path, std::ios::binary);
+    simpledb::storage::Page on_disk;
+    file.read(on_disk.GetData(), simpledb::storage::PAGE_SIZE);
+    ASSERT_EQ(on_disk.GetVersion(), 42);
+}
+
+TEST_F(BufferPoolManagerTest, FetchThrowsWhenAllFramesArePinned) {
+    simpledb::storage::BufferPoolManager pool(2, std::make_unique<simpledb::storage::ClockReplacer>(2));
+    simpledb::storage::FileId file_id = pool.OpenFile(test_file_path);
+
+    pool.FetchPage(file_id, 0);
+    pool.FetchPage(file_id, 1);
+    ASSERT_THROW(pool.FetchPage(file_id, 2), std::runtime_error);
+
+    // Once a page is unpinned, its frame can be reused.
+    pool.UnpinPage(file_id, 0, false);
+    ASSERT_EQ(pool.FetchPage(file_id, 2)->GetVersion(), 2);
+}
+
+TEST_F(BufferPoolManagerTest, FailedWriteBackKeepsTheFrameEvictable) {
+    simpledb::storage::BufferPoolManager pool(1, std::make_unique<simpledb::storage::LruReplacer>());
+    simpledb::storage::FileId file_id = pool.OpenFile(test_file_path);
+    pool.NewPage(file_id, 10);
+    pool.UnpinPage(file_id, 10, true);
+
+    // Limit the size of files to what the file already has, so that writing page 10 back fails.
+    rlimit original_limit{};
+    ASSERT_EQ(getrlimit(RLIMIT_FSIZE, &original_limit), 0);
+    rlimit limit = original_limit;
+    limit.rlim_cur = NUM_PAGES * simpledb::storage::PAGE_SIZE;
+    auto original_handler = std::signal(SIGXFSZ, SIG_IGN);
+    ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &limit), 0);
+    ASSERT_THROW(pool.FetchPage(file_id, 0), std::runtime_error);
+    // The frame is still a candidate for eviction: this fails on the write-back again, not on a full pool.
+    try {
+        pool.FetchPage(file_id, 0);
+        ADD_FAILURE() << "The write-back should have failed again.";
+    } catch (const std::runtime_error& e) {
+        ASSERT_EQ(std::string(e.what()).find("Buffer pool is full"), std::string::npos) << e.what();
+    }
+    setrlimit(RLIMIT_FSIZE, &original_limit);
+    std::signal(SIGXFSZ, original_handler);
+
+    // Once the disk accepts the write, the page is written back and the frame reused.
+    ASSERT_EQ(pool.FetchPage(file_id, 0)->GetVersion(), 0);
+    ASSERT_EQ(pool.GetStats().writebacks, 1);
+    ASSERT_EQ(pool.GetStats().evictions, 1);
+}
+
+TEST_F(BufferPoolManagerTest, DiscardFileDropsCachedPages) {
+    simpledb::storage::BufferPoolManager pool(4, std::make_unique<simpledb::storage::LruReplacer>());
+    simpledb::storage::FileId file_id = pool.OpenFile(test_file_path);
+    pool.FetchPage(file_id, 0)->SetVersion(42);
+    pool.UnpinPage(file_id, 0, true);
+
+    pool.DiscardFile(test_file_path);
+
+    // The dirty page was dropped without being written back, and the file gets a new id.
+    simpledb::storage::FileId new_file_id = pool.OpenFile(test_file_path);
+    ASSERT_NE(file_id, new_file_id);
+    ASSERT_EQ(pool.FetchPage(new_file_id, 0)->GetVersion(), 0);
+    ASSERT_EQ(pool.GetStats().writebacks, 0);
+}
+
+TEST_F(BufferPoolManagerTest, DiscardFileRefusesPinnedPages) {
+    simpledb::storage::BufferPoolManager pool(4, std::make_unique<simpledb::storage::LruReplacer>());
+    simpledb::storage::FileId file_id = pool.OpenFile(test_file_path);
+    pool.FetchPage(file_id, 0);
+    pool.FetchPage(file_id, 1);
+    pool.UnpinPage(file_id, 1, false);
+
+    // Page 0 is still being read, so nothing of the file is discarded.
+    ASSERT_THROW(pool.DiscardFile(test_file_path), std::runtime_error);
+    ASSERT_EQ(pool.OpenFile(test_file_path), file_id);
+    ASSERT_EQ(pool.FetchPage(file_id, 1)->GetVersion(), 1);
+    ASSERT_EQ(pool.GetStats().hits, 1);
+    pool.UnpinPage(file_id, 1, false);
+
+    pool.UnpinPage(file_id, 0, false);
+    pool.DiscardFile(test_file_path);
+    ASSERT_NE(pool.OpenFile(test_file_path), file_id);
+}
+
+TEST_F(BufferPoolManagerTest, TableHeapScanReadsEachPageOnce) {
+    std::filesystem::remove(test_file_path);
+    simpledb::storage::BufferPoolManager pool(16, std::make_unique<simpledb::storage::LruReplacer>());
+    simpledb::storage::TableHeap table_heap(test_file_path, pool);
+
+    // 3 pages worth of records.
+    std::vector<char> record_data(1000, 'A');
+    for (int i = 0; i < 12; ++i) {
+        ASSERT_TRUE(table_heap.InsertRecord(record_data));
+    }
+    pool.ResetStats();
+
+    simpledb::storage::TableHeap::Iterator iterator = table_heap.begin();
+    int count = 0;
+    while (iterator.next().has_value()) {
+        count++;
+    }
+    ASSERT_EQ(count, 12);
+
+    // All pages are still cached from the inserts, so the scan never touches the disk.
+    ASSERT_EQ(pool.GetStats().misses, 0);
+}
@@ -0,0 +1,174 @@
+//
+// Created by Akshat Jain on 18/10/26.
+//
+
+#include "simpledb/storage/b_plus_tree.h"
+#include "simpledb/storage/hash_index.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using simpledb::storage::BufferPoolManager;
+using simpledb::storage::HashIndex;
+using simpledb::storage::IndexEntry;
+using simpledb::storage::RecordId;
+
+namespace {
+    constexpr uint16_t KEY_SIZE = 8;
+
+    std::string make_key(int value) {
+        char buffer[KEY_SIZE + 1];
+        snprintf(buffer, sizeof(buffer), "%08d", value);
+        return std::string(buffer, KEY_SIZE);
+    }
+
+    // The records with a key, sorted (the index returns them in no particular order).
+    std::vector<RecordId> find(HashIndex& index, const std::string& key) {
+        std::vector<RecordId> record_ids;
+        index.Find(key, record_ids);
+        std::sort(record_ids.begin(), record_ids.end());
+        return record_ids;
+    }
+}  // namespace
+
+class HashIndexTest : public ::testing::Test {
+   protected:
+    std::string test_file_path;
+
+    void SetUp() override {
+        // Create a unique temporary file path for each test.
+        const ::testing::TestInfo* const test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+        test_file_path = std::filesystem::temp_directory_path().string() + "/simpledb_hash_index_" +
+                         test_info->test_suite_name() + "_" + test_info->name() + ".index";
+    }
+
+    void TearDown() override { std::filesystem::remove(test_file_path); }
+};
+
+TEST_F(HashIndexTest, EmptyIndex) {
+    HashIndex index(test_file_path, KEY_SIZE);
+    ASSERT_EQ(index.GetNumBuckets(), 1);
+    ASSERT_EQ(index.GetNumEntries(), 0);
+    ASSERT_TRUE(find(index, make_key(5)).empty());
+    ASSERT_THROW(find(index, "short"), std::invalid_argument);
+}
+
+TEST_F(HashIndexTest, InsertsInRandomOrderAndSplits) {
+    // 5 records for each of 4000 keys.
+    std::map<std::string, std::vector<RecordId>> expected;
+    std::vector<IndexEntry> entries;
+    for (int i = 0; i < 20000; ++i) {
+        RecordId record_id{static_cast<uint32_t>(i / 100), static_cast<uint16_t>(i % 100)};
+        entries.push_back({make_key(i % 4000), record_id});
+        expected[make_key(i % 4000)].push_back(record_id);
+    }
+    std::shuffle(entries.begin(), entries.end(), std::mt19937(42));
+
+    HashIndex index(test_file_path, KEY_SIZE);
+    for (const IndexEntry& entry : entries) {
+        index.Insert(entry.key, entry.record_id);
+    }
+    // Inserting an entry twice doesn't add it again.
+    index.Insert(entries[7].key, entries[7].record_id);
+    ASSERT_EQ(index.GetNumEntries(), 20000);
+
+    // 20000 entries need dozens of buckets.
+    ASSERT_GT(index.GetNumBuckets(), 50);
+
+    for (const auto& [key, record_ids] : expected) {
+        ASSERT_EQ(find(index, key), record_ids) << key;
+    }
+    ASSERT_TRUE(find(index, make_key(4000)).empty());
+}
+
+TEST_F(HashIndexTest, FindsManyDuplicatesInOverflowPages) {
+    HashIndex index(test_file_path, KEY_SIZE);
+    // Far more records than fit on a page share a key, so its bucket needs overflow pages however it is split.
+    std::vector<RecordId> expected;
+    for (uint16_t slot = 0; slot < 3000; ++slot) {
+        index.Insert(make_key(1), RecordId{1, slot});
+        index.Insert(make_key(2), RecordId{2, slot});
+        expected.push_back(RecordId{1, slot});
+    }
+    ASSERT_EQ(find(index, make_key(1)), expected);
+    ASSERT_EQ(find(index, make_key(2)).size(), 3000);
+}
+
+TEST_F(HashIndexTest, BulkLoadMatchesInserts) {
+    std::vector<IndexEntry> entries;
+    std::map<std::string, std::vector<RecordId>> expected;
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<int> distribution(0, 9999);
+    for (uint32_t i = 0; i < 50000; ++i) {
+        RecordId record_id{i / 64, static_cast<uint16_t>(i % 64)};
+        entries.push_back({make_key(distribution(generator)), record_id});
+        expected[entries.back().key].push_back(record_id);
+    }
+    // Duplicate entries are only added once.
+    entries.push_back(entries.front());
+
+    HashIndex index(test_file_path, KEY_SIZE);
+    index.BulkLoad(entries);
+    ASSERT_EQ(index.GetNumEntries(), 50000);
+
+    // The bulk loaded index takes inserts like any other.
+    index.Insert(make_key(500), RecordId{100000, 0});
+    expected[make_key(500)].push_back(RecordId{100000, 0});
+
+    for (auto& [key, record_ids] : expected) {
+        std::sort(record_ids.begin(), record_ids.end());
+        ASSERT_EQ(find(index, key), record_ids) << key;
+    }
+
+    ASSERT_THROW(index.BulkLoad(entries), std::runtime_error);
+}
+
+TEST_F(HashIndexTest, LookupReadsTwoPagesOfALargeIndex) {
+    {
+        std::vector<IndexEntry> entries;
+        for (uint32_t i = 0; i < 200000; ++i) {
+            entries.push_back({make_key(static_cast<int>(i)), RecordId{i / 100, static_cast<uint16_t>(i % 100)}});
+        }
+        HashIndex index(test_file_path, KEY_SIZE);
+        index.BulkLoad(std::move(entries));
+    }
+
+    HashIndex reopened(test_file_path, KEY_SIZE);
+    ASSERT_EQ(reopened.GetNumEntries(), 200000);
+    for (int value : {0, 12345, 199999}) {
+        BufferPoolManager::Instance().ResetStats();
+        std::vector<RecordId> record_ids = find(reopened, make_key(value));
+        simpledb::storage::BufferPoolStats stats = BufferPoolManager::Instance().GetStats();
+        ASSERT_EQ(record_ids, std::vector<RecordId>({{static_cast<uint32_t>(value / 100),
+                                                      static_cast<uint16_t>(value % 100)}}));
+        // The directory page, then the bucket (and rarely an overflow page).
+        ASSERT_LE(stats.hits + stats.misses, 3) << value;
+    }
+}
+
+TEST_F(HashIndexTest, ReopensPersistedIndex) {
+    {
+        HashIndex index(test_file_path, KEY_SIZE);
+        for (int i = 0; i < 3000; ++i) {
+            index.Insert(make_key(i), RecordId{static_cast<uint32_t>(i), 0});
+        }
+    }
+
+    HashIndex reopened(test_file_path, KEY_SIZE);
+    ASSERT_EQ(reopened.GetNumEntries(), 3000);
+    ASSERT_EQ(find(reopened, make_key(2990)), std::vector<RecordId>({{2990, 0}}));
+    ASSERT_THROW(HashIndex(test_file_path, KEY_SIZE + 1), std::runtime_error);
+
+    // A B+ tree file isn't a hash index.
+    std::string tree_file_path = test_file_path + ".tree";
+    { simpledb::storage::BPlusTree tree(tree_file_path, KEY_SIZE); }
+    ASSERT_THROW(HashIndex(tree_file_path, KEY_SIZE), std::runtime_error);
+    BufferPoolManager::Instance().DiscardFile(tree_file_path);
+    std::filesystem::remove(tree_file_path);
+}
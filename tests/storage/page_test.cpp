@@ -2,9 +2,12 @@
 // Created by Akshat Jain on 14/06/25.
 //
 
+#include "simpledb/serializer.h"
 #include "simpledb/storage/page.h"
 
 #include <gtest/gtest.h>
+#include <string_view>
+#include <vector>
 
 TEST(PageTest, Initialization) {
     simpledb::storage::Page page;
@@ -73,3 +76,23 @@ TEST(PageTest, AddRecordExceedingFreeSpace) {
     ASSERT_FALSE(page.AddRecord(record_data));  // Should fail to add the record
     ASSERT_EQ(page.GetNumRecords(), 0);         // No records should be added
 }
+
+TEST(PageTest, RecordViewPointsIntoThePage) {
+    simpledb::storage::Page page;
+    page.Initialize();
+
+    serializer::RecordLayout layout({{"id", command::Datatype::INT}, {"name", command::Datatype::TEXT}});
+    std::vector<char> record_data = serializer::serialize(layout, {"1", "hello"});
+    ASSERT_TRUE(page.AddRecord(record_data));
+
+    auto slot = page.GetSlot(0);
+    simpledb::storage::RecordView view = page.GetRecordView(slot);
+    ASSERT_EQ(view.data, page.GetData() + slot.record_offset);
+    ASSERT_EQ(view.ToVector(), record_data);
+
+    // Values can be read straight out of the page's buffer as well.
+    ASSERT_EQ(serializer::read_int(layout, view, 0), 1);
+    std::string_view name = serializer::read_text(layout, view, 1);
+    ASSERT_EQ(name, "hello");
+    ASSERT_EQ(name.data(), view.data + layout.fixed_size());
+}
@@ -6,7 +6,9 @@
 #include "simpledb/storage/table_heap.h"
 
 #include <filesystem>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <memory>
 #include <vector>
 
 class TableHeapIteratorTest : public ::testing::Test {
@@ -35,7 +37,7 @@ TEST_F(TableHeapIteratorTest, IterateOverSingleRecord) {
     ASSERT_TRUE(tableHeap.InsertRecord(record_data));
 
     simpledb::storage::TableHeap::Iterator iterator = tableHeap.begin();
-    ASSERT_EQ(record_data, iterator.next().value());
+    ASSERT_EQ(record_data, iterator.next()->ToVector());
 
     // Validate that there are no more records
     ASSERT_FALSE(iterator.next().has_value());
@@ -51,7 +53,7 @@ TEST_F(TableHeapIteratorTest, IterateOverMultipleRecordsInSinglePage) {
     simpledb::storage::TableHeap::Iterator iterator = tableHeap.begin();
     for (int i = 0; i < 5; ++i) {
         std::vector<char> expected_record_data(100 + i, 'A');
-        ASSERT_EQ(expected_record_data, iterator.next().value());
+        ASSERT_EQ(expected_record_data, iterator.next()->ToVector());
     }
 
     // Validate that there are no more records
@@ -73,7 +75,7 @@ TEST_F(TableHeapIteratorTest, IterateOverMultiplePages) {
 
     simpledb::storage::TableHeap::Iterator iterator = tableHeap.begin();
     for (int i = 0; i < num_records_to_fill_page * 2; ++i) {
-        ASSERT_EQ(record_data, iterator.next().value());
+        ASSERT_EQ(record_data, iterator.next()->ToVector());
     }
 
     // Validate that there are no more records
@@ -110,7 +112,70 @@ TEST_F(TableHeapIteratorTest, IterateOverTableWithEmptyPageInBetween) {
     simpledb::storage::TableHeap tableHeap(test_file_path);
     simpledb::storage::TableHeap::Iterator iterator = tableHeap.begin();
     for (int i = 0; i < num_records_page0 + num_records_page2; ++i) {
-        ASSERT_EQ(record_data, iterator.next().value());
+        ASSERT_EQ(record_data, iterator.next()->ToVector());
     }
     ASSERT_FALSE(iterator.next().has_value());
 }
+
+TEST_F(TableHeapIteratorTest, NextPageReturnsAllRecordsOfAPage) {
+    simpledb::storage::Page page0;
+    page0.Initialize();
+    for (int i = 0; i < 5; ++i) {
+        page0.AddRecord(std::vector<char>(100 + i, 'A'));
+    }
+
+    simpledb::storage::Page page1;
+    page1.Initialize();  // This page will be empty
+
+    simpledb::storage::Page page2;
+    page2.Initialize();
+    for (int i = 0; i < 3; ++i) {
+        page2.AddRecord(std::vector<char>(10 + i, 'B'));
+    }
+
+    // Write pages to the file directly for testing
+    std::ofstream file(test_file_path, std::ios::binary);
+    file.write(page0.GetData(), simpledb::storage::PAGE_SIZE);
+    file.write(page1.GetData(), simpledb::storage::PAGE_SIZE);
+    file.write(page2.GetData(), simpledb::storage::PAGE_SIZE);
+    file.close();
+
+    simpledb::storage::TableHeap tableHeap(test_file_path);
+    simpledb::storage::TableHeap::Iterator iterator = tableHeap.begin();
+
+    const std::vector<simpledb::storage::RecordView>& first_page = iterator.NextPage();
+    ASSERT_EQ(first_page.size(), 5);
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_EQ(first_page[i].ToVector(), std::vector<char>(100 + i, 'A'));
+    }
+
+    // The empty page is skipped.
+    const std::vector<simpledb::storage::RecordView>& second_page = iterator.NextPage();
+    ASSERT_EQ(second_page.size(), 3);
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_EQ(second_page[i].ToVector(), std::vector<char>(10 + i, 'B'));
+    }
+
+    ASSERT_TRUE(iterator.NextPage().empty());
+}
+
+TEST_F(TableHeapIteratorTest, IteratorFetchesEachPageOnce) {
+    simpledb::storage::BufferPoolManager buffer_pool(8, std::make_unique<simpledb::storage::LruReplacer>());
+    simpledb::storage::TableHeap tableHeap(test_file_path, buffer_pool);
+    std::vector<char> record_data(1000, 'A');
+    const int num_records = 12;  // 3 pages worth of records.
+    for (int i = 0; i < num_records; ++i) {
+        ASSERT_TRUE(tableHeap.InsertRecord(record_data));
+    }
+    ASSERT_EQ(tableHeap.GetNumPages(), 3);
+    buffer_pool.ResetStats();
+
+    simpledb::storage::TableHeap::Iterator iterator = tableHeap.begin();
+    for (int i = 0; i < num_records; ++i) {
+        ASSERT_EQ(record_data, iterator.next()->ToVector());
+    }
+    ASSERT_FALSE(iterator.next().has_value());
+
+    simpledb::storage::BufferPoolStats stats = buffer_pool.GetStats();
+    ASSERT_EQ(stats.hits + stats.misses, 3);
+}
@@ -7,6 +7,7 @@
 
 #include <filesystem>
 #include <gtest/gtest.h>
+#include <optional>
 #include <vector>
 
 class TableHeapTest : public ::testing::Test {
@@ -68,3 +69,119 @@ TEST_F(TableHeapTest, InsertFailsIfRecordTooLarge) {
     ASSERT_TRUE(std::filesystem::exists(test_file_path));
     ASSERT_EQ(std::filesystem::file_size(test_file_path), 0);
 }
+
+TEST_F(TableHeapTest, TracksNumberOfPages) {
+    const size_t usable_space = simpledb::storage::PAGE_SIZE - simpledb::storage::Page::HEADER_SIZE;
+    const int record_size = usable_space / 2 - sizeof(simpledb::storage::Page::Slot);
+    std::vector<char> record_data(record_size, 'A');  // Two of these fill a page.
+
+    {
+        simpledb::storage::TableHeap table_heap(test_file_path);
+        ASSERT_EQ(table_heap.GetNumPages(), 0);
+
+        ASSERT_TRUE(table_heap.InsertRecord(record_data));
+        ASSERT_TRUE(table_heap.InsertRecord(record_data));
+        ASSERT_EQ(table_heap.GetNumPages(), 1);
+
+        ASSERT_TRUE(table_heap.InsertRecord(record_data));
+        ASSERT_EQ(table_heap.GetNumPages(), 2);
+    }
+
+    // A freshly opened heap picks up the page count from the size of the data file.
+    simpledb::storage::TableHeap reopened_table_heap(test_file_path);
+    ASSERT_EQ(reopened_table_heap.GetNumPages(), 2);
+}
+
+TEST_F(TableHeapTest, InsertRecordsFillsPagesInOneBatch) {
+    const size_t usable_space = simpledb::storage::PAGE_SIZE - simpledb::storage::Page::HEADER_SIZE;
+    const int record_size = usable_space / 2 - sizeof(simpledb::storage::Page::Slot);
+    std::vector<char> record_data(record_size, 'A');  // Two of these fill a page.
+
+    simpledb::storage::TableHeap table_heap(test_file_path);
+    ASSERT_TRUE(table_heap.InsertRecord(record_data));
+
+    // The first record of the batch tops up the existing page, the other four need two more pages.
+    std::vector<std::vector<char>> records(5, record_data);
+    ASSERT_TRUE(table_heap.InsertRecords(records));
+    ASSERT_EQ(table_heap.GetNumPages(), 3);
+
+    // The batch is flushed to the data file before InsertRecords() returns.
+    ASSERT_EQ(std::filesystem::file_size(test_file_path), 3 * simpledb::storage::PAGE_SIZE);
+
+    simpledb::storage::TableHeap::Iterator iterator = table_heap.begin();
+    for (int i = 0; i < 6; ++i) {
+        ASSERT_EQ(iterator.next()->ToVector(), record_data);
+    }
+    ASSERT_FALSE(iterator.next().has_value());
+}
+
+TEST_F(TableHeapTest, InsertRecordsRejectsBatchWithOversizedRecord) {
+    simpledb::storage::TableHeap table_heap(test_file_path);
+    std::vector<std::vector<char>> records = {std::vector<char>(100, 'A'),
+                                              std::vector<char>(simpledb::storage::PAGE_SIZE, 'B')};
+
+    ASSERT_FALSE(table_heap.InsertRecords(records));
+    ASSERT_EQ(table_heap.GetNumPages(), 0);
+    ASSERT_EQ(std::filesystem::file_size(test_file_path), 0);
+}
+
+TEST_F(TableHeapTest, InsertRecordsReturnsRecordIdsForGetRecord) {
+    const size_t usable_space = simpledb::storage::PAGE_SIZE - simpledb::storage::Page::HEADER_SIZE;
+    const int record_size = usable_space / 2 - sizeof(simpledb::storage::Page::Slot);
+
+    simpledb::storage::TableHeap table_heap(test_file_path);
+    std::vector<std::vector<char>> records = {
+        std::vector<char>(record_size, 'A'), std::vector<char>(record_size, 'B'), std::vector<char>(10, 'C')};
+    std::vector<simpledb::storage::RecordId> record_ids;
+    ASSERT_TRUE(table_heap.InsertRecords(records, &record_ids));
+
+    // Two records fill the first page, the third one starts the second page.
+    ASSERT_EQ(record_ids.size(), 3);
+    ASSERT_EQ(record_ids[0], (simpledb::storage::RecordId{0, 0}));
+    ASSERT_EQ(record_ids[1], (simpledb::storage::RecordId{0, 1}));
+    ASSERT_EQ(record_ids[2], (simpledb::storage::RecordId{1, 0}));
+
+    std::vector<char> record_data;
+    for (size_t i = 0; i < records.size(); ++i) {
+        ASSERT_TRUE(table_heap.GetRecord(record_ids[i], record_data));
+        ASSERT_EQ(record_data, records[i]);
+    }
+    ASSERT_FALSE(table_heap.GetRecord({1, 1}, record_data));
+    ASSERT_FALSE(table_heap.GetRecord({2, 0}, record_data));
+}
+
+TEST_F(TableHeapTest, InsertRecordReturnsStableRecordIds) {
+    const size_t usable_space = simpledb::storage::PAGE_SIZE - simpledb::storage::Page::HEADER_SIZE;
+    const int record_size = usable_space / 2 - sizeof(simpledb::storage::Page::Slot);
+
+    std::vector<std::vector<char>> records;
+    std::vector<simpledb::storage::RecordId> record_ids;
+    {
+        simpledb::storage::TableHeap table_heap(test_file_path);
+        for (char c : {'A', 'B', 'C', 'D', 'E'}) {
+            records.emplace_back(record_size, c);
+            std::optional<simpledb::storage::RecordId> record_id = table_heap.InsertRecord(records.back());
+            ASSERT_TRUE(record_id.has_value());
+            record_ids.push_back(record_id.value());
+        }
+        ASSERT_FALSE(table_heap.InsertRecord(std::vector<char>(simpledb::storage::PAGE_SIZE, 'X')).has_value());
+    }
+
+    // Two records fit on a page.
+    ASSERT_EQ(record_ids, std::vector<simpledb::storage::RecordId>({{0, 0}, {0, 1}, {1, 0}, {1, 1}, {2, 0}}));
+
+    // The ids still point at the same records after reopening the table, and match what a scan reports.
+    simpledb::storage::TableHeap table_heap(test_file_path);
+    std::vector<char> record_data;
+    for (size_t i = 0; i < records.size(); ++i) {
+        ASSERT_TRUE(table_heap.GetRecord(record_ids[i], record_data));
+        ASSERT_EQ(record_data, records[i]);
+    }
+
+    simpledb::storage::TableHeap::Iterator iterator = table_heap.begin();
+    for (size_t i = 0; i < records.size(); ++i) {
+        ASSERT_TRUE(iterator.next().has_value());
+        ASSERT_EQ(iterator.GetRecordId(), record_ids[i]);
+    }
+    ASSERT_FALSE(iterator.next().has_value());
+}